@@ -0,0 +1,46 @@
+using ArbSh.Terminal.Rendering;
+using BenchmarkDotNet.Attributes;
+
+namespace ArbSh.Benchmarks;
+
+/// <summary>
+/// ANSI SGR parsing of plain and styled output lines.
+/// </summary>
+public class AnsiSgrParserBenchmarks
+{
+    private readonly AnsiSgrParser _parser = new();
+    private string[] _plain = [];
+    private string[] _styled = [];
+
+    [GlobalSetup]
+    public void Setup()
+    {
+        string[] lines = BenchmarkData.UniqueLines(BenchmarkData.OutputLines, 1000);
+        _plain = lines.Where(line => !line.Contains('\u001b')).ToArray();
+        _styled = lines.Where(line => line.Contains('\u001b')).ToArray();
+    }
+
+    [Benchmark(Baseline = true)]
+    public int Parse_PlainLines()
+    {
+        int spans = 0;
+        foreach (string line in _plain)
+        {
+            spans += _parser.Parse(line).StyleSpans.Count;
+        }
+
+        return spans;
+    }
+
+    [Benchmark]
+    public int Parse_StyledLines()
+    {
+        int spans = 0;
+        foreach (string line in _styled)
+        {
+            spans += _parser.Parse(line).StyleSpans.Count;
+        }
+
+        return spans;
+    }
+}
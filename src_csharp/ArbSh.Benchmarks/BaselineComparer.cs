@@ -0,0 +1,157 @@
+using System.Globalization;
+using System.Text.Json;
+
+namespace ArbSh.Benchmarks;
+
+/// <summary>
+/// Stores BenchmarkDotNet JSON results as a baseline and compares later runs against it.
+/// </summary>
+/// <remarks>
+/// Results are read from the <c>*-report-full.json</c> files written by the JSON exporter.
+/// A benchmark regresses when its mean time or allocated bytes per operation grow by more
+/// than the threshold (10% by default) relative to the baseline.
+/// </remarks>
+internal static class BaselineComparer
+{
+    private const string ReportPattern = "*-report-full.json";
+    private const string DefaultResultsDirectory = "BenchmarkDotNet.Artifacts/results";
+    private const double DefaultThresholdPercent = 10;
+
+    /// <summary>
+    /// Runs <c>baseline save &lt;dir&gt;</c> or <c>baseline compare &lt;dir&gt;</c>.
+    /// </summary>
+    /// <param name="args">The arguments after <c>baseline</c>.</param>
+    /// <returns>0 on success, 1 when a benchmark regressed, 2 on usage errors.</returns>
+    public static int Run(string[] args)
+    {
+        if (args.Length < 2 || (args[0] != "save" && args[0] != "compare"))
+        {
+            Console.Error.WriteLine("Usage: baseline save <dir> [--results <dir>]");
+            Console.Error.WriteLine("       baseline compare <dir> [--results <dir>] [--threshold <percent>]");
+            return 2;
+        }
+
+        string baselineDirectory = args[1];
+        string resultsDirectory = GetOption(args, "--results") ?? DefaultResultsDirectory;
+        double threshold = double.Parse(GetOption(args, "--threshold") ?? DefaultThresholdPercent.ToString(CultureInfo.InvariantCulture), CultureInfo.InvariantCulture);
+
+        if (!Directory.Exists(resultsDirectory))
+        {
+            Console.Error.WriteLine($"No benchmark results found in '{resultsDirectory}'. Run the benchmarks first.");
+            return 2;
+        }
+
+        return args[0] == "save"
+            ? Save(resultsDirectory, baselineDirectory)
+            : Compare(resultsDirectory, baselineDirectory, threshold);
+    }
+
+    private static int Save(string resultsDirectory, string baselineDirectory)
+    {
+        Directory.CreateDirectory(baselineDirectory);
+        int copied = 0;
+        foreach (string report in Directory.EnumerateFiles(resultsDirectory, ReportPattern))
+        {
+            File.Copy(report, Path.Combine(baselineDirectory, Path.GetFileName(report)), overwrite: true);
+            copied++;
+        }
+
+        Console.WriteLine($"Saved {copied} report(s) to '{baselineDirectory}'.");
+        return 0;
+    }
+
+    private static int Compare(string resultsDirectory, string baselineDirectory, double thresholdPercent)
+    {
+        Dictionary<string, Measurement> baseline = Load(baselineDirectory);
+        Dictionary<string, Measurement> current = Load(resultsDirectory);
+        double limit = 1 + thresholdPercent / 100;
+        int regressions = 0;
+
+        Console.WriteLine($"{"Benchmark",-70} {"Time",10} {"Alloc",10}");
+        foreach ((string name, Measurement now) in current.OrderBy(pair => pair.Key, StringComparer.Ordinal))
+        {
+            if (!baseline.TryGetValue(name, out Measurement before))
+            {
+                Console.WriteLine($"{name,-70} {"new",10} {"new",10}");
+                continue;
+            }
+
+            double timeRatio = Ratio(now.MeanNanoseconds, before.MeanNanoseconds);
+            double allocRatio = Ratio(now.AllocatedBytes, before.AllocatedBytes);
+            bool regressed = timeRatio > limit || allocRatio > limit;
+            if (regressed)
+            {
+                regressions++;
+            }
+
+            Console.WriteLine($"{name,-70} {FormatRatio(timeRatio),10} {FormatRatio(allocRatio),10}{(regressed ? "  REGRESSION" : string.Empty)}");
+        }
+
+        Console.WriteLine(regressions == 0
+            ? $"No regressions above {thresholdPercent.ToString(CultureInfo.InvariantCulture)}%."
+            : $"{regressions} benchmark(s) regressed by more than {thresholdPercent.ToString(CultureInfo.InvariantCulture)}%.");
+        return regressions == 0 ? 0 : 1;
+    }
+
+    private static Dictionary<string, Measurement> Load(string directory)
+    {
+        var measurements = new Dictionary<string, Measurement>(StringComparer.Ordinal);
+        if (!Directory.Exists(directory))
+        {
+            return measurements;
+        }
+
+        foreach (string report in Directory.EnumerateFiles(directory, ReportPattern))
+        {
+            using JsonDocument document = JsonDocument.Parse(File.ReadAllBytes(report));
+            if (!document.RootElement.TryGetProperty("Benchmarks", out JsonElement benchmarks))
+            {
+                continue;
+            }
+
+            foreach (JsonElement benchmark in benchmarks.EnumerateArray())
+            {
+                if (!benchmark.TryGetProperty("FullName", out JsonElement name)
+                    || !benchmark.TryGetProperty("Statistics", out JsonElement statistics)
+                    || statistics.ValueKind != JsonValueKind.Object)
+                {
+                    continue;
+                }
+
+                double mean = statistics.GetProperty("Mean").GetDouble();
+                double allocated = benchmark.TryGetProperty("Memory", out JsonElement memory)
+                    && memory.TryGetProperty("BytesAllocatedPerOperation", out JsonElement bytes)
+                    ? bytes.GetDouble()
+                    : 0;
+
+                measurements[name.GetString()!] = new Measurement(mean, allocated);
+            }
+        }
+
+        return measurements;
+    }
+
+    // A zero baseline only regresses when the current value is non-zero.
+    private static double Ratio(double current, double baseline)
+    {
+        if (baseline == 0)
+        {
+            return current == 0 ? 1 : double.PositiveInfinity;
+        }
+
+        return current / baseline;
+    }
+
+    private static string FormatRatio(double ratio)
+    {
+        return double.IsPositiveInfinity(ratio) ? "+inf" : ratio.ToString("0.00x", CultureInfo.InvariantCulture);
+    }
+
+    private static string? GetOption(string[] args, string name)
+    {
+        int index = Array.IndexOf(args, name);
+        return index >= 0 && index + 1 < args.Length ? args[index + 1] : null;
+    }
+
+    private readonly record struct Measurement(double MeanNanoseconds, double AllocatedBytes);
+}
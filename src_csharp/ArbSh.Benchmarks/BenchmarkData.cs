@@ -0,0 +1,110 @@
+using ArbSh.Terminal.Rendering;
+
+namespace ArbSh.Benchmarks;
+
+/// <summary>
+/// Shared inputs for the benchmarks.
+/// </summary>
+internal static class BenchmarkData
+{
+    /// <summary>
+    /// Command lines in the shape users type them: Arabic commands and parameters, quoting,
+    /// pipelines, redirection, sub-expressions and type literals.
+    /// </summary>
+    public static readonly string[] ScriptLines =
+    [
+        "اطبع مرحبا بالعالم",
+        "اطبع \"سطر مقتبس مع مسافات\" | اطبع | اطبع",
+        "اعرض -المسار ./المستندات -مخفي | اطبع > قائمة.txt",
+        "انتقل ../مجلد-اخر ; المسار",
+        "اطبع $(اطبع داخلي) -النص 'نص حرفي' 2>&1",
+        "اختبار-مصفوفة -نصوص أ ب ج د -مبدل",
+        "اختبار-نوع -عدد-صحيح [int] 42 # تعليق في النهاية",
+        "اطبع < مدخلات.txt | اطبع >> سجل.txt",
+        "مساعدة اطبع",
+        "الأوامر | اطبع"
+    ];
+
+    /// <summary>
+    /// Terminal output lines mixing Arabic, Latin, digits and ANSI SGR styling.
+    /// </summary>
+    public static readonly string[] OutputLines =
+    [
+        "مرحبا بكم في أربش",
+        "file-0042.txt    1024 bytes",
+        "\u001b[32mنجاح:\u001b[0m تم إنشاء الملف report.txt",
+        "\u001b[1;31mخطأ:\u001b[0m الأمر غير موجود: foo",
+        "المجلد الحالي: /home/user/المستندات",
+        "\u001b[38;5;208mتحذير\u001b[39m - القيمة 3.14 خارج النطاق",
+        "Build succeeded in 12.5s",
+        "لا توجد عناصر مطابقة (0 نتيجة)"
+    ];
+
+    /// <summary>
+    /// Returns <paramref name="count"/> lines cycled from <paramref name="source"/>, each made unique
+    /// by a numeric suffix so caches keyed by text see distinct strings.
+    /// </summary>
+    public static string[] UniqueLines(string[] source, int count)
+    {
+        var lines = new string[count];
+        for (int i = 0; i < count; i++)
+        {
+            lines[i] = $"{source[i % source.Length]} {i}";
+        }
+
+        return lines;
+    }
+
+    /// <summary>
+    /// Finds <c>ref/BidiTest.txt</c>.
+    /// </summary>
+    public static string FindBidiTestFile()
+    {
+        return FindReferenceFile("BidiTest.txt")
+            ?? throw new FileNotFoundException("ref/BidiTest.txt was not found above " + AppContext.BaseDirectory);
+    }
+
+    /// <summary>
+    /// Finds <c>ref/&lt;fileName&gt;</c> by walking up from the benchmark output directory,
+    /// then from the current directory.
+    /// </summary>
+    /// <returns>The full path, or null when the file does not exist.</returns>
+    public static string? FindReferenceFile(string fileName)
+    {
+        foreach (string start in new[] { AppContext.BaseDirectory, Environment.CurrentDirectory })
+        {
+            for (DirectoryInfo? dir = new(start); dir != null; dir = dir.Parent)
+            {
+                string candidate = Path.Combine(dir.FullName, "ref", fileName);
+                if (File.Exists(candidate))
+                {
+                    return candidate;
+                }
+            }
+        }
+
+        return null;
+    }
+
+    /// <summary>
+    /// Loads every BidiTest.txt case paired with each paragraph level it applies to.
+    /// </summary>
+    public static (string Text, int Level)[] LoadBidiCorpus(string path)
+    {
+        return BidiConformanceCorpus.ReadBidiTest(path)
+            .SelectMany(testCase => testCase.ParagraphLevels.Select(level => (testCase.Text, level)))
+            .ToArray();
+    }
+}
+
+/// <summary>
+/// Deterministic measurer that charges one unit per character, so layout benchmarks
+/// measure the engine rather than Avalonia text formatting.
+/// </summary>
+internal sealed class FakeTextMeasurer : ITextMeasurer
+{
+    public double MeasureWidth(string visualText, TerminalRenderConfig config)
+    {
+        return visualText.Length;
+    }
+}
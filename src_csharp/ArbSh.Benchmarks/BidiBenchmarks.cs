@@ -0,0 +1,44 @@
+using ArbSh.Core.I18n;
+using BenchmarkDotNet.Attributes;
+
+namespace ArbSh.Benchmarks;
+
+/// <summary>
+/// UAX #9 run resolution over the full <c>ref/BidiTest.txt</c> corpus and over typical output lines.
+/// </summary>
+public class BidiBenchmarks
+{
+    private (string Text, int Level)[] _corpus = [];
+    private string[] _outputLines = [];
+
+    [GlobalSetup]
+    public void Setup()
+    {
+        _corpus = BenchmarkData.LoadBidiCorpus(BenchmarkData.FindBidiTestFile());
+        _outputLines = BenchmarkData.UniqueLines(BenchmarkData.OutputLines, 1000);
+    }
+
+    [Benchmark]
+    public int ProcessRuns_BidiTestCorpus()
+    {
+        int runs = 0;
+        foreach ((string text, int level) in _corpus)
+        {
+            runs += BidiAlgorithm.ProcessRuns(text, level).Count;
+        }
+
+        return runs;
+    }
+
+    [Benchmark]
+    public int ProcessRuns_OutputLines()
+    {
+        int runs = 0;
+        foreach (string line in _outputLines)
+        {
+            runs += BidiAlgorithm.ProcessRuns(line, -1).Count;
+        }
+
+        return runs;
+    }
+}
@@ -0,0 +1,203 @@
+using System.Globalization;
+using System.Text;
+
+namespace ArbSh.Benchmarks;
+
+/// <summary>
+/// One conformance case: the input text, the paragraph levels to run it at
+/// (-1 auto, 0 LTR, 1 RTL), and the expected results.
+/// </summary>
+/// <param name="LineNumber">The 1-based line in the source file.</param>
+/// <param name="Text">The input text.</param>
+/// <param name="ParagraphLevels">The paragraph levels the case is checked at.</param>
+/// <param name="ExpectedParagraphLevel">The expected resolved paragraph level, or null when the file does not state it.</param>
+/// <param name="ExpectedLevels">The expected level of each code point; null entries are removed by X9 and not checked.</param>
+/// <param name="CodePointOffsets">The UTF-16 offset of each code point, or null when every code point is one char.</param>
+internal sealed record BidiConformanceCase(
+    int LineNumber,
+    string Text,
+    int[] ParagraphLevels,
+    int? ExpectedParagraphLevel,
+    int?[] ExpectedLevels,
+    int[]? CodePointOffsets);
+
+/// <summary>
+/// Streams the cases of the Unicode <c>BidiTest.txt</c> and <c>BidiCharacterTest.txt</c> files.
+/// </summary>
+internal static class BidiConformanceCorpus
+{
+    private static readonly int[] AutoLevel = [-1];
+    private static readonly int[] LeftToRightLevel = [0];
+    private static readonly int[] RightToLeftLevel = [1];
+
+    // Bitset 1 = auto, 2 = LTR, 4 = RTL; the eight combinations are shared by all cases.
+    private static readonly int[][] LevelsByBitset = Enumerable.Range(0, 8)
+        .Select(bitset => new[] { (1, -1), (2, 0), (4, 1) }
+            .Where(pair => (bitset & pair.Item1) != 0)
+            .Select(pair => pair.Item2)
+            .ToArray())
+        .ToArray();
+
+    /// <summary>
+    /// Reads <c>BidiTest.txt</c>. Each data line is one case; its text is built from representative
+    /// characters of the listed bidi classes and it is checked at every paragraph level in its bitset.
+    /// Cases under the same <c>@Levels</c> header share their expectation array.
+    /// </summary>
+    public static IEnumerable<BidiConformanceCase> ReadBidiTest(string path)
+    {
+        int?[] levels = [];
+        var text = new StringBuilder();
+        int lineNumber = 0;
+
+        foreach (string rawLine in File.ReadLines(path))
+        {
+            lineNumber++;
+            ReadOnlySpan<char> line = rawLine.AsSpan().Trim();
+            if (line.IsEmpty || line[0] == '#')
+            {
+                continue;
+            }
+
+            if (line.StartsWith("@Levels:"))
+            {
+                levels = ParseLevels(line["@Levels:".Length..]);
+                continue;
+            }
+
+            int separator = line.IndexOf(';');
+            if (line[0] == '@' || separator < 0 || !int.TryParse(line[(separator + 1)..].Trim(), out int bitset))
+            {
+                continue;
+            }
+
+            text.Clear();
+            foreach (Range field in SplitFields(line[..separator]))
+            {
+                text.Append(RepresentativeChar(line[..separator][field]));
+            }
+
+            yield return new BidiConformanceCase(lineNumber, text.ToString(), GetParagraphLevels(bitset), null, levels, null);
+        }
+    }
+
+    /// <summary>
+    /// Reads <c>BidiCharacterTest.txt</c>: code points, paragraph direction (0 LTR, 1 RTL, 2 auto),
+    /// resolved paragraph level, resolved levels and visual order, separated by semicolons.
+    /// The visual order follows from the levels and is not read.
+    /// </summary>
+    public static IEnumerable<BidiConformanceCase> ReadBidiCharacterTest(string path)
+    {
+        var text = new StringBuilder();
+        var offsets = new List<int>();
+        int lineNumber = 0;
+
+        foreach (string rawLine in File.ReadLines(path))
+        {
+            lineNumber++;
+            string line = rawLine.Trim();
+            if (line.Length == 0 || line[0] == '#')
+            {
+                continue;
+            }
+
+            string[] fields = line.Split(';');
+            if (fields.Length < 4)
+            {
+                continue;
+            }
+
+            text.Clear();
+            offsets.Clear();
+            bool hasSurrogates = false;
+            foreach (Range field in SplitFields(fields[0]))
+            {
+                int codePoint = int.Parse(fields[0].AsSpan()[field], NumberStyles.HexNumber, CultureInfo.InvariantCulture);
+                offsets.Add(text.Length);
+                hasSurrogates |= codePoint > 0xFFFF;
+                text.Append(char.ConvertFromUtf32(codePoint));
+            }
+
+            int[] paragraphLevels = fields[1].Trim() switch
+            {
+                "0" => LeftToRightLevel,
+                "1" => RightToLeftLevel,
+                _ => AutoLevel
+            };
+
+            yield return new BidiConformanceCase(
+                lineNumber,
+                text.ToString(),
+                paragraphLevels,
+                int.Parse(fields[2], CultureInfo.InvariantCulture),
+                ParseLevels(fields[3]),
+                hasSurrogates ? offsets.ToArray() : null);
+        }
+    }
+
+    private static int[] GetParagraphLevels(int bitset)
+    {
+        return LevelsByBitset[bitset & 7];
+    }
+
+    private static int?[] ParseLevels(ReadOnlySpan<char> text)
+    {
+        var levels = new List<int?>();
+        foreach (Range field in SplitFields(text))
+        {
+            ReadOnlySpan<char> value = text[field];
+            levels.Add(value is "x" ? null : int.Parse(value, CultureInfo.InvariantCulture));
+        }
+
+        return levels.ToArray();
+    }
+
+    private static List<Range> SplitFields(ReadOnlySpan<char> text)
+    {
+        var fields = new List<Range>();
+        int start = -1;
+        for (int i = 0; i <= text.Length; i++)
+        {
+            bool separator = i == text.Length || text[i] == ' ' || text[i] == '\t';
+            if (!separator && start < 0)
+            {
+                start = i;
+            }
+            else if (separator && start >= 0)
+            {
+                fields.Add(start..i);
+                start = -1;
+            }
+        }
+
+        return fields;
+    }
+
+    // Same representative characters as the conformance test framework.
+    private static char RepresentativeChar(ReadOnlySpan<char> bidiClass) => bidiClass switch
+    {
+        "L" => 'A',
+        "R" => '\u05D0',
+        "AL" => '\u0627',
+        "EN" => '1',
+        "ES" => '+',
+        "ET" => '$',
+        "AN" => '\u0660',
+        "CS" => ',',
+        "NSM" => '\u0300',
+        "BN" => '\u200B',
+        "B" => '\n',
+        "S" => '\t',
+        "WS" => ' ',
+        "ON" => '!',
+        "LRE" => '\u202A',
+        "LRO" => '\u202D',
+        "RLE" => '\u202B',
+        "RLO" => '\u202E',
+        "PDF" => '\u202C',
+        "LRI" => '\u2066',
+        "RLI" => '\u2067',
+        "FSI" => '\u2068',
+        "PDI" => '\u2069',
+        _ => '?'
+    };
+}
@@ -0,0 +1,53 @@
+using ArbSh.Core;
+using BenchmarkDotNet.Attributes;
+
+namespace ArbSh.Benchmarks;
+
+/// <summary>
+/// History lookups over a full in-memory history, as done on every keystroke of recall and search.
+/// </summary>
+/// <remarks>
+/// Each entry is a script line with a numbered suffix, so most entries are distinct and the common
+/// prefixes and trigrams have long posting lists.
+/// </remarks>
+public class CommandHistoryBenchmarks
+{
+    private CommandHistory _history = new();
+
+    [Params(CommandHistory.DefaultMaxEntries)]
+    public int EntryCount { get; set; }
+
+    [GlobalSetup]
+    public void Setup()
+    {
+        _history = new CommandHistory();
+        for (int i = 0; i < EntryCount; i++)
+        {
+            _history.Add($"{BenchmarkData.ScriptLines[i % BenchmarkData.ScriptLines.Length]} {i}");
+        }
+    }
+
+    [Benchmark]
+    public int FindPrefix_Recall()
+    {
+        return _history.FindPrefix("اعرض -المسار", _history.Count);
+    }
+
+    [Benchmark]
+    public int FindContaining_ReverseSearch()
+    {
+        return _history.FindContaining("قائمة.txt", _history.Count);
+    }
+
+    [Benchmark]
+    public int FindContaining_NoMatch()
+    {
+        return _history.FindContaining("غير موجود", _history.Count);
+    }
+
+    [Benchmark]
+    public int FindFuzzy_Typo()
+    {
+        return _history.FindFuzzy("اعرض المسار المستندت", maxResults: 1).Count;
+    }
+}
@@ -0,0 +1,252 @@
+using System.Diagnostics;
+using System.Globalization;
+using System.Threading.Channels;
+using ArbSh.Core.I18n;
+
+namespace ArbSh.Benchmarks;
+
+/// <summary>
+/// Checks <see cref="BidiAlgorithm"/> against the Unicode BiDi conformance files in parallel and
+/// reports the pass rate together with throughput.
+/// </summary>
+/// <remarks>
+/// Each file is read once as a stream and handed to the workers in batches, so the corpus is never
+/// held in memory. Every worker resolves levels with its own <see cref="BidiParagraph"/>, the engine
+/// behind <see cref="BidiAlgorithm.ProcessRuns"/>. A case passes when the resolved level of every
+/// code point not removed by X9 matches, at every paragraph level it lists, and, for
+/// <c>BidiCharacterTest.txt</c>, when the resolved paragraph level matches as well.
+/// </remarks>
+internal static class ConformanceRunner
+{
+    private const int BatchSize = 1024;
+    private const int ReportedFailures = 10;
+
+    /// <summary>
+    /// Runs <c>conformance [--bidi-test &lt;path&gt;] [--character-test &lt;path&gt;] [--threads &lt;n&gt;] [--min-pass-rate &lt;percent&gt;]</c>.
+    /// Files default to <c>ref/BidiTest.txt</c> and <c>ref/BidiCharacterTest.txt</c>; a missing default file is skipped.
+    /// </summary>
+    /// <param name="args">The arguments after <c>conformance</c>.</param>
+    /// <returns>0 on success, 1 when a corpus passed below the minimum rate, 2 when no corpus was found.</returns>
+    public static int Run(string[] args)
+    {
+        int threads = int.Parse(GetOption(args, "--threads") ?? Environment.ProcessorCount.ToString(CultureInfo.InvariantCulture), CultureInfo.InvariantCulture);
+        double minPassRate = double.Parse(GetOption(args, "--min-pass-rate") ?? "0", CultureInfo.InvariantCulture);
+        threads = Math.Max(1, threads);
+
+        var corpora = new List<(string Name, IEnumerable<BidiConformanceCase> Cases)>();
+        AddCorpus(corpora, GetOption(args, "--bidi-test"), "BidiTest.txt", BidiConformanceCorpus.ReadBidiTest);
+        AddCorpus(corpora, GetOption(args, "--character-test"), "BidiCharacterTest.txt", BidiConformanceCorpus.ReadBidiCharacterTest);
+
+        if (corpora.Count == 0)
+        {
+            Console.Error.WriteLine("No conformance files found. Pass --bidi-test or --character-test.");
+            return 2;
+        }
+
+        bool belowMinimum = false;
+        foreach ((string name, IEnumerable<BidiConformanceCase> cases) in corpora)
+        {
+            ConformanceResult result = RunCorpus(cases, threads);
+            Report(name, result, threads);
+            belowMinimum |= result.PassRate < minPassRate;
+        }
+
+        return belowMinimum ? 1 : 0;
+    }
+
+    private static void AddCorpus(
+        List<(string, IEnumerable<BidiConformanceCase>)> corpora,
+        string? explicitPath,
+        string fileName,
+        Func<string, IEnumerable<BidiConformanceCase>> reader)
+    {
+        string? path = explicitPath ?? BenchmarkData.FindReferenceFile(fileName);
+        if (path == null)
+        {
+            Console.WriteLine($"{fileName}: skipped (not found under ref/)");
+            return;
+        }
+
+        if (!File.Exists(path))
+        {
+            throw new FileNotFoundException("Conformance file not found.", path);
+        }
+
+        corpora.Add((Path.GetFileName(path), reader(path)));
+    }
+
+    private static ConformanceResult RunCorpus(IEnumerable<BidiConformanceCase> cases, int threads)
+    {
+        var batches = Channel.CreateBounded<BidiConformanceCase[]>(new BoundedChannelOptions(threads * 4)
+        {
+            SingleWriter = true,
+            FullMode = BoundedChannelFullMode.Wait
+        });
+        var total = new ConformanceResult();
+        var wall = Stopwatch.StartNew();
+
+        Task producer = Task.Run(async () =>
+        {
+            try
+            {
+                var batch = new List<BidiConformanceCase>(BatchSize);
+                foreach (BidiConformanceCase testCase in cases)
+                {
+                    batch.Add(testCase);
+                    if (batch.Count == BatchSize)
+                    {
+                        await batches.Writer.WriteAsync(batch.ToArray());
+                        batch.Clear();
+                    }
+                }
+
+                if (batch.Count > 0)
+                {
+                    await batches.Writer.WriteAsync(batch.ToArray());
+                }
+
+                batches.Writer.Complete();
+            }
+            catch (Exception ex)
+            {
+                batches.Writer.Complete(ex);
+            }
+        });
+
+        Task[] workers = Enumerable.Range(0, threads).Select(_ => Task.Run(async () =>
+        {
+            var local = new ConformanceResult();
+            using var paragraph = new BidiParagraph();
+            var timer = new Stopwatch();
+
+            await foreach (BidiConformanceCase[] batch in batches.Reader.ReadAllAsync())
+            {
+                timer.Start();
+                foreach (BidiConformanceCase testCase in batch)
+                {
+                    Check(paragraph, testCase, local);
+                }
+
+                timer.Stop();
+            }
+
+            local.AlgorithmTicks = timer.ElapsedTicks;
+            lock (total)
+            {
+                total.Merge(local);
+            }
+        })).ToArray();
+
+        Task.WaitAll([producer, .. workers]);
+        wall.Stop();
+        total.WallTicks = wall.ElapsedTicks;
+        return total;
+    }
+
+    private static void Check(BidiParagraph paragraph, BidiConformanceCase testCase, ConformanceResult result)
+    {
+        bool passed = true;
+        try
+        {
+            foreach (int paragraphLevel in testCase.ParagraphLevels)
+            {
+                paragraph.Process(testCase.Text, paragraphLevel);
+                result.Characters += testCase.Text.Length;
+                passed &= Matches(paragraph, testCase);
+            }
+        }
+        catch (Exception)
+        {
+            result.Errors++;
+            passed = false;
+        }
+
+        result.Cases++;
+        if (passed)
+        {
+            result.Passed++;
+        }
+        else if (result.FailedLines.Count < ReportedFailures)
+        {
+            result.FailedLines.Add(testCase.LineNumber);
+        }
+    }
+
+    private static bool Matches(BidiParagraph paragraph, BidiConformanceCase testCase)
+    {
+        if (testCase.ExpectedParagraphLevel is int expectedParagraph && paragraph.ParagraphLevel != expectedParagraph)
+        {
+            return false;
+        }
+
+        int?[] expected = testCase.ExpectedLevels;
+        int codePoints = testCase.CodePointOffsets?.Length ?? testCase.Text.Length;
+        if (expected.Length != codePoints)
+        {
+            return false;
+        }
+
+        ReadOnlySpan<int> levels = paragraph.Levels;
+        for (int i = 0; i < expected.Length; i++)
+        {
+            int offset = testCase.CodePointOffsets?[i] ?? i;
+            if (expected[i] is int level && levels[offset] != level)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    private static void Report(string name, ConformanceResult result, int threads)
+    {
+        double wallSeconds = (double)result.WallTicks / Stopwatch.Frequency;
+        double algorithmSeconds = (double)result.AlgorithmTicks / Stopwatch.Frequency;
+
+        Console.WriteLine($"=== {name} ===");
+        Console.WriteLine($"Cases:  {result.Cases:N0} ({threads} worker(s), {wallSeconds:F2}s)");
+        Console.WriteLine($"Passed: {result.Passed:N0} ({result.PassRate:F2}%)");
+        Console.WriteLine($"Failed: {result.Cases - result.Passed:N0} (errors: {result.Errors:N0})");
+        Console.WriteLine($"Throughput: {result.Characters / Math.Max(wallSeconds, 1e-9):N0} chars/s overall, "
+            + $"{result.Characters / Math.Max(algorithmSeconds, 1e-9):N0} chars/s per worker");
+
+        if (result.FailedLines.Count > 0)
+        {
+            result.FailedLines.Sort();
+            Console.WriteLine($"Sample failing lines: {string.Join(", ", result.FailedLines.Take(ReportedFailures))}");
+        }
+    }
+
+    private static string? GetOption(string[] args, string name)
+    {
+        int index = Array.IndexOf(args, name);
+        return index >= 0 && index + 1 < args.Length ? args[index + 1] : null;
+    }
+
+    /// <summary>
+    /// Counters for one corpus, accumulated per worker and merged at the end.
+    /// </summary>
+    private sealed class ConformanceResult
+    {
+        public long Cases;
+        public long Passed;
+        public long Errors;
+        public long Characters;
+        public long AlgorithmTicks;
+        public long WallTicks;
+        public List<int> FailedLines { get; } = [];
+
+        public double PassRate => Cases == 0 ? 0 : (double)Passed / Cases * 100;
+
+        public void Merge(ConformanceResult other)
+        {
+            Cases += other.Cases;
+            Passed += other.Passed;
+            Errors += other.Errors;
+            Characters += other.Characters;
+            AlgorithmTicks += other.AlgorithmTicks;
+            FailedLines.AddRange(other.FailedLines);
+        }
+    }
+}
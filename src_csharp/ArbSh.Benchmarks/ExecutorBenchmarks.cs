@@ -0,0 +1,58 @@
+using ArbSh.Core;
+using BenchmarkDotNet.Attributes;
+
+namespace ArbSh.Benchmarks;
+
+/// <summary>
+/// Multi-stage pipelines fed from a redirected file, executed into a discarding sink.
+/// </summary>
+public class ExecutorBenchmarks
+{
+    private readonly IExecutionSink _sink = NullExecutionSink.Instance;
+    private string _directory = string.Empty;
+    private List<List<ParsedCommand>> _singleStage = [];
+    private List<List<ParsedCommand>> _fourStages = [];
+    private CompiledScript? _compiled;
+    private ShellSessionState? _session;
+
+    [Params(10_000)]
+    public int InputLines { get; set; }
+
+    [GlobalSetup]
+    public void Setup()
+    {
+        _directory = Path.Combine(Path.GetTempPath(), "arbsh-bench-" + Guid.NewGuid().ToString("N"));
+        Directory.CreateDirectory(_directory);
+        string input = Path.Combine(_directory, "input.txt");
+        File.WriteAllLines(input, BenchmarkData.UniqueLines(BenchmarkData.OutputLines, InputLines));
+
+        _session = new ShellSessionState(_directory);
+        _singleStage = Parser.Parse($"اطبع < \"{input}\"");
+        _fourStages = Parser.Parse($"اطبع < \"{input}\" | اطبع | اطبع | اطبع");
+        _compiled = ShellEngine.Compile($"اطبع < \"{input}\" | اطبع\nاطبع تم", _sink);
+    }
+
+    [GlobalCleanup]
+    public void Cleanup()
+    {
+        Directory.Delete(_directory, recursive: true);
+    }
+
+    [Benchmark(Baseline = true)]
+    public void Execute_SingleStage()
+    {
+        Executor.Execute(_singleStage, _sink);
+    }
+
+    [Benchmark]
+    public void Execute_FourStages()
+    {
+        Executor.Execute(_fourStages, _sink);
+    }
+
+    [Benchmark]
+    public void ShellEngine_ExecuteCompiled()
+    {
+        ShellEngine.Execute(_compiled!, _sink, session: _session);
+    }
+}
@@ -0,0 +1,77 @@
+using ArbSh.Terminal.Models;
+using ArbSh.Terminal.Rendering;
+using Avalonia;
+using BenchmarkDotNet.Attributes;
+
+namespace ArbSh.Benchmarks;
+
+/// <summary>
+/// Frame layout over a large scrollback with a fake measurer, with and without cached visual runs,
+/// and over wrapped output where frames jump to arbitrary scroll positions.
+/// </summary>
+public class LayoutBenchmarks
+{
+    private readonly TerminalRenderConfig _config = new() { Padding = new Thickness(10), LineHeight = 20 };
+    private readonly Size _surface = new(1200, 800);
+    private readonly TerminalTextPipeline _pipeline = new(new FakeTextMeasurer());
+    private readonly TerminalLayoutEngine _engine = new();
+    private readonly TerminalLayoutEngine _wrappedEngine = new();
+    private readonly Size _narrowSurface = new(40, 800);
+    private List<TerminalLine> _lines = [];
+    private int _scrollOffset;
+    private int _maxWrappedOffset;
+
+    [Params(10_000)]
+    public int ScrollbackLines { get; set; }
+
+    [GlobalSetup]
+    public void Setup()
+    {
+        DateTimeOffset timestamp = DateTimeOffset.UnixEpoch;
+        _lines = BenchmarkData.UniqueLines(BenchmarkData.OutputLines, ScrollbackLines)
+            .Select(text => new TerminalLine(text, TerminalLineKind.Output, timestamp))
+            .ToList();
+
+        BuildFrame(0);
+        _maxWrappedOffset = _wrappedEngine
+            .BuildFrameLayout(_lines, "أربش< ", "اطبع مرحبا", _narrowSurface, _config, _pipeline, 0)
+            .MaxScrollbackOffsetLines;
+    }
+
+    [Benchmark(Baseline = true)]
+    public int BuildFrameLayout_Cached()
+    {
+        return BuildFrame(0);
+    }
+
+    [Benchmark]
+    public int BuildFrameLayout_Uncached()
+    {
+        // Also drops the wrap index, so every line is measured again.
+        _engine.InvalidateCache();
+        return BuildFrame(0);
+    }
+
+    [Benchmark]
+    public int BuildFrameLayout_Scrolling()
+    {
+        // Each call scrolls one line, so one new run is built per frame.
+        _scrollOffset = (_scrollOffset + 1) % (ScrollbackLines / 2);
+        return BuildFrame(_scrollOffset);
+    }
+
+    [Benchmark]
+    public int BuildFrameLayout_WrappedJump()
+    {
+        // Most lines wrap at this width; each frame jumps far enough that no visible run is cached.
+        _scrollOffset = (_scrollOffset + 7919) % Math.Max(1, _maxWrappedOffset);
+        return _wrappedEngine.BuildFrameLayout(_lines, "أربش< ", "اطبع مرحبا", _narrowSurface, _config, _pipeline, _scrollOffset)
+            .Instructions.Count;
+    }
+
+    private int BuildFrame(int scrollbackOffset)
+    {
+        return _engine.BuildFrameLayout(_lines, "أربش< ", "اطبع مرحبا", _surface, _config, _pipeline, scrollbackOffset)
+            .Instructions.Count;
+    }
+}
@@ -0,0 +1,60 @@
+using ArbSh.Core;
+using ArbSh.Core.Parsing;
+using BenchmarkDotNet.Attributes;
+
+namespace ArbSh.Benchmarks;
+
+/// <summary>
+/// Tokenizer and parser throughput over a script of typical Arabic command lines.
+/// </summary>
+public class ParserBenchmarks
+{
+    private string[] _lines = [];
+
+    [Params(100)]
+    public int LineCount { get; set; }
+
+    [GlobalSetup]
+    public void Setup()
+    {
+        _lines = Enumerable.Range(0, LineCount)
+            .Select(i => BenchmarkData.ScriptLines[i % BenchmarkData.ScriptLines.Length])
+            .ToArray();
+    }
+
+    [Benchmark(Baseline = true)]
+    public int RegexTokenizer_Tokenize()
+    {
+        int tokens = 0;
+        foreach (string line in _lines)
+        {
+            tokens += RegexTokenizer.Tokenize(line).Count;
+        }
+
+        return tokens;
+    }
+
+    [Benchmark]
+    public int Lexer_Tokenize()
+    {
+        int tokens = 0;
+        foreach (string line in _lines)
+        {
+            tokens += Lexer.Tokenize(line).Count;
+        }
+
+        return tokens;
+    }
+
+    [Benchmark]
+    public int Parser_Parse()
+    {
+        int statements = 0;
+        foreach (string line in _lines)
+        {
+            statements += Parser.Parse(line).Count;
+        }
+
+        return statements;
+    }
+}
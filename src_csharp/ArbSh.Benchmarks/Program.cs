@@ -0,0 +1,40 @@
+using BenchmarkDotNet.Configs;
+using BenchmarkDotNet.Diagnosers;
+using BenchmarkDotNet.Exporters.Json;
+using BenchmarkDotNet.Running;
+
+namespace ArbSh.Benchmarks;
+
+/// <summary>
+/// Entry point for the ArbSh benchmark suite.
+/// </summary>
+/// <remarks>
+/// <c>dotnet run -c Release -- [BenchmarkDotNet options]</c> runs benchmarks (for example <c>--filter *Parser*</c>).
+/// <c>dotnet run -c Release -- baseline save &lt;dir&gt;</c> stores the latest results as a baseline, and
+/// <c>dotnet run -c Release -- baseline compare &lt;dir&gt; [--threshold &lt;percent&gt;]</c> compares the latest
+/// results against it and exits with a non-zero code when a benchmark regressed.
+/// <c>dotnet run -c Release -- conformance</c> checks the BiDi conformance files in parallel and reports
+/// pass rate and throughput (see <see cref="ConformanceRunner"/>).
+/// </remarks>
+public static class Program
+{
+    public static int Main(string[] args)
+    {
+        if (args.Length > 0 && args[0] == "baseline")
+        {
+            return BaselineComparer.Run(args[1..]);
+        }
+
+        if (args.Length > 0 && args[0] == "conformance")
+        {
+            return ConformanceRunner.Run(args[1..]);
+        }
+
+        IConfig config = DefaultConfig.Instance
+            .AddDiagnoser(MemoryDiagnoser.Default)
+            .AddExporter(JsonExporter.Full);
+
+        BenchmarkSwitcher.FromAssembly(typeof(Program).Assembly).Run(args, config);
+        return 0;
+    }
+}
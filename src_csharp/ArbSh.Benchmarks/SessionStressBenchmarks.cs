@@ -0,0 +1,71 @@
+using ArbSh.Core;
+using BenchmarkDotNet.Attributes;
+
+namespace ArbSh.Benchmarks;
+
+/// <summary>
+/// Independent sessions executing interactive input at the same time, one thread per session.
+/// </summary>
+/// <remarks>
+/// Every session runs the same fixed amount of work, so the mean should stay roughly flat as
+/// <see cref="Sessions"/> grows up to the core count. Time that grows with the session count points
+/// at process-wide state or locks shared between sessions.
+/// </remarks>
+public class SessionStressBenchmarks
+{
+    private const int LinesPerSession = 200;
+
+    // Cached pipelines, deferred lines that expand session variables, and a subexpression.
+    private static readonly string[] Inputs =
+    [
+        "اطبع أ | اطبع | اطبع",
+        "اطبع $رقم | اطبع",
+        "اطبع $testVar ثابت",
+        "اطبع $(اطبع داخلي) خارجي"
+    ];
+
+    private readonly IExecutionSink _sink = NullExecutionSink.Instance;
+    private ShellSessionState[] _sessions = [];
+
+    [Params(1, 4, 16)]
+    public int Sessions { get; set; }
+
+    [GlobalSetup]
+    public void Setup()
+    {
+        _sessions = new ShellSessionState[Sessions];
+        for (int i = 0; i < Sessions; i++)
+        {
+            _sessions[i] = new ShellSessionState();
+            _sessions[i].SetVariable("رقم", i.ToString());
+        }
+
+        // Builds command discovery and the input cache before measuring.
+        RunSession(_sessions[0]);
+    }
+
+    [Benchmark]
+    public void ExecuteInput_ConcurrentSessions()
+    {
+        var threads = new Thread[Sessions];
+        for (int i = 0; i < Sessions; i++)
+        {
+            ShellSessionState session = _sessions[i];
+            threads[i] = new Thread(() => RunSession(session));
+            threads[i].Start();
+        }
+
+        foreach (Thread thread in threads)
+        {
+            thread.Join();
+        }
+    }
+
+    private void RunSession(ShellSessionState session)
+    {
+        for (int line = 0; line < LinesPerSession; line++)
+        {
+            ShellEngine.ExecuteInput(Inputs[line % Inputs.Length], _sink, session: session);
+        }
+    }
+}
@@ -0,0 +1,60 @@
+using ArbSh.Core.I18n;
+using BenchmarkDotNet.Attributes;
+
+namespace ArbSh.Benchmarks;
+
+/// <summary>
+/// Arabic shaping of output lines: repeated lines (cache hits), distinct lines and the span overload.
+/// </summary>
+public class ShapingBenchmarks
+{
+    private string[] _repeated = [];
+    private string[] _distinct = [];
+    private char[] _buffer = [];
+
+    [GlobalSetup]
+    public void Setup()
+    {
+        _repeated = Enumerable.Range(0, 1000)
+            .Select(i => BenchmarkData.OutputLines[i % BenchmarkData.OutputLines.Length])
+            .ToArray();
+        _distinct = BenchmarkData.UniqueLines(BenchmarkData.OutputLines, 1000);
+        _buffer = new char[_distinct.Max(line => line.Length)];
+    }
+
+    [Benchmark(Baseline = true)]
+    public int Shape_RepeatedLines()
+    {
+        int length = 0;
+        foreach (string line in _repeated)
+        {
+            length += ArabicShaper.Shape(line).Length;
+        }
+
+        return length;
+    }
+
+    [Benchmark]
+    public int Shape_DistinctLines()
+    {
+        int length = 0;
+        foreach (string line in _distinct)
+        {
+            length += ArabicShaper.Shape(line).Length;
+        }
+
+        return length;
+    }
+
+    [Benchmark]
+    public int Shape_Span()
+    {
+        int length = 0;
+        foreach (string line in _distinct)
+        {
+            length += ArabicShaper.Shape(line, _buffer);
+        }
+
+        return length;
+    }
+}
@@ -6,6 +6,7 @@ namespace ArbSh.Console;
 
 /// <summary>
 /// Routes core execution output to the interactive console host.
+/// Lines are batched in <see cref="ConsoleOutputBuffer"/>; the host flushes it after each command.
 /// </summary>
 public sealed class ConsoleExecutionSink : IExecutionSink
 {
@@ -23,7 +24,7 @@ public sealed class ConsoleExecutionSink : IExecutionSink
             return;
         }
 
-        System.Console.WriteLine(message);
+        ConsoleOutputBuffer.WriteLine(message);
     }
 
     /// <inheritdoc />
@@ -51,20 +52,10 @@ public sealed class ConsoleExecutionSink : IExecutionSink
             return;
         }
 
-        var previousColor = System.Console.ForegroundColor;
-        System.Console.ForegroundColor = color;
+        string displayText = BiDiTextProcessor.ContainsArabicText(message)
+            ? ConsoleRTLDisplay.ProcessTextForRTLDisplay(message)
+            : message;
 
-        try
-        {
-            string displayText = BiDiTextProcessor.ContainsArabicText(message)
-                ? ConsoleRTLDisplay.ProcessTextForRTLDisplay(message)
-                : message;
-
-            System.Console.WriteLine(displayText);
-        }
-        finally
-        {
-            System.Console.ForegroundColor = previousColor;
-        }
+        ConsoleOutputBuffer.WriteLine(displayText, color);
     }
 }
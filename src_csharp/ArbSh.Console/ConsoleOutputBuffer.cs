@@ -0,0 +1,173 @@
+using System.Text;
+using ArbSh.Console.I18n;
+
+namespace ArbSh.Console;
+
+/// <summary>
+/// Collects console output and writes it in large batches instead of one call per line.
+/// </summary>
+/// <remarks>
+/// Text is written when the buffer fills, one frame after the first pending write, or when
+/// <see cref="Flush"/> is called. Buffered text goes to the Windows console with one <c>WriteConsoleW</c>
+/// call per chunk, and elsewhere (or when output is redirected) to stdout as UTF-8 in one write.
+/// Callers flush before anything that bypasses the buffer, such as cursor moves and reads, and write
+/// colored lines with <see cref="WriteLine(ReadOnlySpan{char}, ConsoleColor)"/>. Every flush, including
+/// the frame timer's, takes the same lock as the writes.
+/// </remarks>
+public static class ConsoleOutputBuffer
+{
+    private const int Capacity = 64 * 1024;
+    private static readonly TimeSpan FrameInterval = TimeSpan.FromMilliseconds(16);
+
+    private static readonly object Sync = new();
+    private static readonly char[] Pending = new char[Capacity];
+    private static readonly Encoder Utf8Encoder = new UTF8Encoding(false).GetEncoder();
+    private static readonly Timer FrameTimer = new(_ => Flush());
+    private static byte[] _encoded = [];
+    private static Stream? _stdout;
+    private static int _length;
+
+    /// <summary>
+    /// Queues text for output.
+    /// </summary>
+    /// <param name="text">The text to write.</param>
+    public static void Write(ReadOnlySpan<char> text)
+    {
+        lock (Sync)
+        {
+            if (text.Length > Capacity - _length)
+            {
+                FlushPending();
+                if (text.Length > Capacity)
+                {
+                    WriteThrough(text);
+                    return;
+                }
+            }
+
+            // The first write into an empty buffer starts the frame; later writes join it.
+            if (_length == 0)
+            {
+                FrameTimer.Change(FrameInterval, Timeout.InfiniteTimeSpan);
+            }
+
+            text.CopyTo(Pending.AsSpan(_length));
+            _length += text.Length;
+        }
+    }
+
+    /// <summary>
+    /// Queues a character repeated a number of times, for padding.
+    /// </summary>
+    /// <param name="c">The character.</param>
+    /// <param name="count">How many times to write it.</param>
+    public static void Write(char c, int count)
+    {
+        Span<char> chunk = stackalloc char[256];
+        chunk.Fill(c);
+        while (count > 0)
+        {
+            int length = Math.Min(count, chunk.Length);
+            Write(chunk[..length]);
+            count -= length;
+        }
+    }
+
+    /// <summary>
+    /// Queues text followed by a line terminator.
+    /// </summary>
+    /// <param name="text">The text to write.</param>
+    public static void WriteLine(ReadOnlySpan<char> text)
+    {
+        lock (Sync)
+        {
+            Write(text);
+            Write(Environment.NewLine);
+        }
+    }
+
+    /// <summary>
+    /// Writes a line in a foreground color, after any queued text.
+    /// </summary>
+    /// <param name="text">The text to write.</param>
+    /// <param name="color">The color of the line.</param>
+    public static void WriteLine(ReadOnlySpan<char> text, ConsoleColor color)
+    {
+        // The color applies to everything written while it is set, so the lock is held until it is
+        // restored; the frame timer and other threads cannot flush their text in this color.
+        lock (Sync)
+        {
+            FlushPending();
+            ConsoleColor previousColor = System.Console.ForegroundColor;
+            System.Console.ForegroundColor = color;
+            try
+            {
+                WriteLine(text);
+                FlushPending();
+            }
+            finally
+            {
+                System.Console.ForegroundColor = previousColor;
+            }
+        }
+    }
+
+    /// <summary>
+    /// Queues a line terminator.
+    /// </summary>
+    public static void WriteLine()
+    {
+        Write(Environment.NewLine);
+    }
+
+    /// <summary>
+    /// Writes all queued text to the console.
+    /// </summary>
+    public static void Flush()
+    {
+        lock (Sync)
+        {
+            FlushPending();
+        }
+    }
+
+    private static void FlushPending()
+    {
+        if (_length == 0)
+        {
+            return;
+        }
+
+        WriteThrough(Pending.AsSpan(0, _length));
+        _length = 0;
+    }
+
+    private static void WriteThrough(ReadOnlySpan<char> text)
+    {
+        try
+        {
+            if (WindowsConsoleApi.TryWriteConsole(text, out int charsWritten))
+            {
+                return;
+            }
+
+            // A console write that failed partway is continued on stdout from where it stopped.
+            text = text.Slice(charsWritten);
+
+            int byteCount = Utf8Encoder.GetByteCount(text, flush: false);
+            if (_encoded.Length < byteCount)
+            {
+                _encoded = new byte[Math.Max(byteCount, Capacity * 3)];
+            }
+
+            int written = Utf8Encoder.GetBytes(text, _encoded, flush: false);
+            _stdout ??= System.Console.OpenStandardOutput();
+            _stdout.Write(_encoded, 0, written);
+            _stdout.Flush();
+        }
+        catch (IOException)
+        {
+            // The reader went away (for example a closed pipe); the output is dropped as Console.Out would.
+        }
+    }
+}
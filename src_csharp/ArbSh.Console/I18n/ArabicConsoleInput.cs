@@ -80,6 +80,9 @@ namespace ArbSh.Console.I18n
                 Initialize();
             }
 
+            // Queued output must be on screen before the read blocks; the readers below write directly.
+            ConsoleOutputBuffer.Flush();
+
             string? result = null;
             
             try
@@ -233,7 +236,7 @@ namespace ArbSh.Console.I18n
             }
             catch (Exception ex)
             {
-                System.Console.WriteLine($"DEBUG: Failed to initialize StreamReader: {ex.Message}");
+                ConsoleOutputBuffer.WriteLine($"DEBUG: Failed to initialize StreamReader: {ex.Message}");
                 _stdinReader = null;
             }
         }
@@ -253,7 +256,7 @@ namespace ArbSh.Console.I18n
             // Check for null character conversion issues (Arabic → U+0000)
             if (input.Contains('\0'))
             {
-                System.Console.WriteLine("DEBUG: Detected null characters in input - possible Arabic encoding issue");
+                ConsoleOutputBuffer.WriteLine("DEBUG: Detected null characters in input - possible Arabic encoding issue");
                 
                 // Count null characters vs total length for diagnostics
                 int nullCount = 0;
@@ -262,13 +265,13 @@ namespace ArbSh.Console.I18n
                     if (c == '\0') nullCount++;
                 }
                 
-                System.Console.WriteLine($"DEBUG: Input length: {input.Length}, Null chars: {nullCount}");
+                ConsoleOutputBuffer.WriteLine($"DEBUG: Input length: {input.Length}, Null chars: {nullCount}");
                 
                 // If the input is mostly null characters, it's likely Arabic that got converted
                 if (nullCount > 0)
                 {
-                    System.Console.WriteLine("WARNING: Arabic characters may have been converted to null characters");
-                    System.Console.WriteLine("This is a known Windows Console limitation with RTL text input");
+                    ConsoleOutputBuffer.WriteLine("WARNING: Arabic characters may have been converted to null characters");
+                    ConsoleOutputBuffer.WriteLine("This is a known Windows Console limitation with RTL text input");
                     
                     // For now, return the input as-is but log the issue
                     // In the future, we might implement character recovery strategies
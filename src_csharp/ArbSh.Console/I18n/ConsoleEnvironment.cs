@@ -93,21 +93,21 @@ namespace ArbSh.Console.I18n
         {
             var info = DetectConsoleEnvironment();
             
-            System.Console.WriteLine("=== Console Environment Information ===");
-            System.Console.WriteLine($"Console Host: {info.ConsoleHost}");
-            System.Console.WriteLine($"Windows Terminal: {info.IsWindowsTerminal}");
-            System.Console.WriteLine($"PowerShell: {info.IsPowerShell}");
-            System.Console.WriteLine($"Arabic Support: {info.ArabicSupport}");
-            System.Console.WriteLine($"Input Redirected: {info.IsInputRedirected}");
-            System.Console.WriteLine($"Output Redirected: {info.IsOutputRedirected}");
-            System.Console.WriteLine();
+            ConsoleOutputBuffer.WriteLine("=== Console Environment Information ===");
+            ConsoleOutputBuffer.WriteLine($"Console Host: {info.ConsoleHost}");
+            ConsoleOutputBuffer.WriteLine($"Windows Terminal: {info.IsWindowsTerminal}");
+            ConsoleOutputBuffer.WriteLine($"PowerShell: {info.IsPowerShell}");
+            ConsoleOutputBuffer.WriteLine($"Arabic Support: {info.ArabicSupport}");
+            ConsoleOutputBuffer.WriteLine($"Input Redirected: {info.IsInputRedirected}");
+            ConsoleOutputBuffer.WriteLine($"Output Redirected: {info.IsOutputRedirected}");
+            ConsoleOutputBuffer.WriteLine();
             
             // Provide recommendations
             if (info.ArabicSupport == ArabicSupportLevel.Poor)
             {
-                System.Console.WriteLine("⚠️  WARNING: Current terminal has poor Arabic support!");
-                System.Console.WriteLine("💡 RECOMMENDATION: Use Windows Terminal or Command Prompt for better Arabic display.");
-                System.Console.WriteLine();
+                ConsoleOutputBuffer.WriteLine("⚠️  WARNING: Current terminal has poor Arabic support!");
+                ConsoleOutputBuffer.WriteLine("💡 RECOMMENDATION: Use Windows Terminal or Command Prompt for better Arabic display.");
+                ConsoleOutputBuffer.WriteLine();
             }
         }
         
@@ -7,6 +7,7 @@ namespace ArbSh.Console.I18n
     /// <summary>
     /// Handles RTL (Right-to-Left) display formatting for console output.
     /// Addresses Windows Console limitations with Arabic text positioning and character shaping.
+    /// Output goes through <see cref="ConsoleOutputBuffer"/>, so callers flush before reading input.
     /// </summary>
     public static class ConsoleRTLDisplay
     {
@@ -19,6 +20,12 @@ namespace ArbSh.Console.I18n
         {
             get
             {
+                // Redirected output has no window; asking for its width throws on every line.
+                if (System.Console.IsOutputRedirected)
+                {
+                    return 80;
+                }
+
                 try
                 {
                     return System.Console.WindowWidth;
@@ -58,7 +65,7 @@ namespace ArbSh.Console.I18n
             else
             {
                 // Standard left-aligned prompt for LTR content
-                System.Console.Write(promptText);
+                ConsoleOutputBuffer.Write(promptText);
             }
         }
 
@@ -90,19 +97,18 @@ namespace ArbSh.Console.I18n
                 // Standard Console.ReadLine starts wherever the cursor is.
                 // This is perfect for RTL typing!
                 
-                string paddedPrompt = new string(' ', padding) + processedPrompt;
-                
                 // Write without newline so input happens on same line
-                System.Console.Write(paddedPrompt);
+                ConsoleOutputBuffer.Write(' ', padding);
+                ConsoleOutputBuffer.Write(processedPrompt);
                 
                 // Note: Windows Console cursor will be at the end of the line (Right side).
                 // This mimics RTL input start position.
             }
             catch (Exception ex)
             {
-                System.Console.WriteLine($"DEBUG (RTL): RTL prompt display failed: {ex.Message}");
+                ConsoleOutputBuffer.WriteLine($"DEBUG (RTL): RTL prompt display failed: {ex.Message}");
                 // Fallback to normal prompt display
-                System.Console.Write(promptText);
+                ConsoleOutputBuffer.Write(promptText);
             }
         }
         
@@ -167,7 +173,7 @@ namespace ArbSh.Console.I18n
             }
             else
             {
-                System.Console.WriteLine(processedText);
+                ConsoleOutputBuffer.WriteLine(processedText);
             }
         }
 
@@ -206,35 +212,23 @@ namespace ArbSh.Console.I18n
         {
             try
             {
-                string[] lines = text.Split('\n');
-                
-                foreach (string line in lines)
-                {
-                    if (string.IsNullOrEmpty(line))
-                    {
-                        System.Console.WriteLine();
-                        continue;
-                    }
+                int consoleWidth = ConsoleWidth;
 
+                foreach (ReadOnlySpan<char> line in text.AsSpan().EnumerateLines())
+                {
                     int lineLength = GetDisplayLength(line);
-                    int consoleWidth = ConsoleWidth;
-                    
-                    if (lineLength < consoleWidth)
+                    if (lineLength > 0 && lineLength < consoleWidth)
                     {
-                        int padding = consoleWidth - lineLength;
-                        string paddedLine = new string(' ', padding) + line;
-                        System.Console.WriteLine(paddedLine);
-                    }
-                    else
-                    {
-                        System.Console.WriteLine(line);
+                        ConsoleOutputBuffer.Write(' ', consoleWidth - lineLength);
                     }
+
+                    ConsoleOutputBuffer.WriteLine(line);
                 }
             }
             catch (Exception ex)
             {
-                System.Console.WriteLine($"DEBUG (RTL): Right alignment failed: {ex.Message}");
-                System.Console.WriteLine(text);
+                ConsoleOutputBuffer.WriteLine($"DEBUG (RTL): Right alignment failed: {ex.Message}");
+                ConsoleOutputBuffer.WriteLine(text);
             }
         }
         
@@ -247,9 +241,9 @@ namespace ArbSh.Console.I18n
         /// </summary>
         /// <param name="text">Text to measure</param>
         /// <returns>Display length</returns>
-        private static int GetDisplayLength(string text)
+        private static int GetDisplayLength(ReadOnlySpan<char> text)
         {
-            if (string.IsNullOrEmpty(text))
+            if (text.IsEmpty)
             {
                 return 0;
             }
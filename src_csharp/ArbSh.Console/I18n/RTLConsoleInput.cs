@@ -1,5 +1,6 @@
 using System;
 using System.Text;
+using ArbSh.Core;
 
 namespace ArbSh.Console.I18n
 {
@@ -9,15 +10,23 @@ namespace ArbSh.Console.I18n
     /// </summary>
     public static class RTLConsoleInput
     {
+        private const string Prompt = "أربش> ";
+        private static string? _processedPrompt;
+
         #region RTL Input Implementation
         
         /// <summary>
         /// Reads a line of input with proper RTL handling for Arabic text.
         /// Captures keys manually to control display and cursor positioning.
+        /// Up/Down recall earlier commands starting with the typed text, and Ctrl+R earlier commands containing it.
         /// </summary>
+        /// <param name="history">Command history to recall from, or null to disable recall</param>
         /// <returns>Input line with proper RTL processing</returns>
-        public static string? ReadRTLLine()
+        public static string? ReadRTLLine(CommandHistory? history = null)
         {
+            // Output still queued from the last command must be on screen before the cursor is read.
+            ConsoleOutputBuffer.Flush();
+
             // Reset cursor to known state if needed, though we rely on Redraw
             int startLeft = System.Console.CursorLeft;
             int startTop = System.Console.CursorTop;
@@ -25,20 +34,52 @@ namespace ArbSh.Console.I18n
 
             StringBuilder buffer = new StringBuilder();
             int logicalCursorPos = 0; // 0 means before the first char (logically)
+            string? renderedLine = null; // What the last redraw put on screen
+
+            // Recall keeps the text typed before the first Up/Down/Ctrl+R; any edit starts over.
+            int recallIndex = -1;
+            string? recallQuery = null;
+
+            void ResetRecall()
+            {
+                recallIndex = -1;
+                recallQuery = null;
+            }
+
+            void Recall(bool older, bool containing)
+            {
+                recallQuery ??= buffer.ToString();
+                int from = recallIndex < 0 ? history!.Count : recallIndex;
+                int match = containing
+                    ? history!.FindContaining(recallQuery, from, older)
+                    : history!.FindPrefix(recallQuery, from, older);
+
+                if (match >= 0)
+                {
+                    recallIndex = match;
+                    buffer.Clear().Append(history[match]);
+                }
+                else if (!older && recallIndex >= 0)
+                {
+                    // Past the newest match: back to the text as typed.
+                    buffer.Clear().Append(recallQuery);
+                    ResetRecall();
+                }
+
+                logicalCursorPos = buffer.Length;
+            }
 
-            // We need to keep track of history/navigation eventually, but for now just basic input
-            
             while (true)
             {
                 // Redraw the line first
-                RedrawLine(buffer.ToString(), logicalCursorPos, startTop, consoleWidth);
+                RedrawLine(buffer.ToString(), logicalCursorPos, startTop, consoleWidth, ref renderedLine);
 
                 ConsoleKeyInfo keyInfo = System.Console.ReadKey(true); // Intercept key
 
                 // Handle Enter
                 if (keyInfo.Key == ConsoleKey.Enter)
                 {
-                    System.Console.WriteLine(); // Move to next line
+                    ConsoleOutputBuffer.WriteLine(); // Move to next line
                     return buffer.ToString();
                 }
                 
@@ -50,6 +91,7 @@ namespace ArbSh.Console.I18n
                         buffer.Remove(logicalCursorPos - 1, 1);
                         logicalCursorPos--;
                     }
+                    ResetRecall();
                     continue;
                 }
 
@@ -60,6 +102,20 @@ namespace ArbSh.Console.I18n
                     {
                         buffer.Remove(logicalCursorPos, 1);
                     }
+                    ResetRecall();
+                    continue;
+                }
+
+                // Handle History Recall
+                if (history != null && (keyInfo.Key == ConsoleKey.UpArrow || keyInfo.Key == ConsoleKey.DownArrow))
+                {
+                    Recall(older: keyInfo.Key == ConsoleKey.UpArrow, containing: false);
+                    continue;
+                }
+
+                if (history != null && keyInfo.Key == ConsoleKey.R && keyInfo.Modifiers.HasFlag(ConsoleModifiers.Control))
+                {
+                    Recall(older: true, containing: true);
                     continue;
                 }
 
@@ -97,6 +153,7 @@ namespace ArbSh.Console.I18n
                 {
                     buffer.Insert(logicalCursorPos, keyInfo.KeyChar);
                     logicalCursorPos++;
+                    ResetRecall();
                 }
             }
         }
@@ -105,37 +162,35 @@ namespace ArbSh.Console.I18n
 
         #region Private Methods
 
-        private static void RedrawLine(string logicalText, int logicalCursorPos, int startTop, int consoleWidth)
+        private static void RedrawLine(string logicalText, int logicalCursorPos, int startTop, int consoleWidth, ref string? renderedLine)
         {
             // 1. Process text for Display (Shape -> Reorder)
             // This ensures the user sees connected letters while typing!
             string visualText = ConsoleRTLDisplay.ProcessTextForRTLDisplay(logicalText);
             
-            // 2. Prepare Prompt
-            string prompt = "أربش> "; 
-            string processedPrompt = ConsoleRTLDisplay.ProcessTextForRTLDisplay(prompt); // >شبرأ
+            // 2. Prepare Prompt (shaped once, it never changes)
+            string processedPrompt = _processedPrompt ??= ConsoleRTLDisplay.ProcessTextForRTLDisplay(Prompt); // >شبرأ
             
             // 3. Construct Full Line for Display
             // Layout: [Padding] [VisualText] [Prompt]
             // We want the prompt pinned to the right.
+            // The line is padded to the full width so it also erases what the last redraw left behind.
             
+            int lineWidth = consoleWidth - 1;
             int totalContentLength = visualText.Length + processedPrompt.Length;
-            int padding = Math.Max(0, consoleWidth - totalContentLength - 1);
+            int padding = Math.Max(0, lineWidth - totalContentLength);
 
-            // Clear current line
-            System.Console.SetCursorPosition(0, startTop);
-            System.Console.Write(new string(' ', consoleWidth - 1));
-            System.Console.SetCursorPosition(0, startTop);
-
-            // Write Padding + Text + Prompt
             // Note: VisualText is already reversed (RTL). 
             // So if logical is "ABC", Visual is "CBA".
             // Display: "       CBA >Prompt"
             
-            string fullLine = new string(' ', padding) + visualText + processedPrompt;
-            System.Console.Write(fullLine);
+            string fullLine = (new string(' ', padding) + visualText + processedPrompt).PadRight(lineWidth);
+
+            // 4. Write only the cells that differ from the last redraw
+            WriteChangedCells(renderedLine, fullLine, startTop);
+            renderedLine = fullLine;
 
-            // 4. Position Cursor
+            // 5. Position Cursor
             // This is the tricky part. We need to map Logical Index -> Visual Index.
             // Simplified approach for pure RTL text:
             // Visual X = Padding + (Length - LogicalIndex)
@@ -155,6 +210,46 @@ namespace ArbSh.Console.I18n
 
             System.Console.SetCursorPosition(cursorLeft, startTop);
         }
+
+        /// <summary>
+        /// Writes the span of cells where the new line differs from the one on screen.
+        /// A keystroke usually changes a few cells next to the cursor, so this avoids rewriting the whole row.
+        /// </summary>
+        /// <param name="previous">Line from the last redraw, or null on the first</param>
+        /// <param name="next">Line to show</param>
+        /// <param name="top">Row of the line</param>
+        private static void WriteChangedCells(string? previous, string next, int top)
+        {
+            int start = 0;
+            int end = next.Length;
+
+            if (previous != null && previous.Length == next.Length)
+            {
+                while (start < end && previous[start] == next[start]) start++;
+                if (start == end) return;
+                while (end > start && previous[end - 1] == next[end - 1]) end--;
+
+                // Keep surrogate pairs whole
+                if (start > 0 && char.IsLowSurrogate(next[start])) start--;
+                if (end < next.Length && char.IsLowSurrogate(next[end])) end++;
+            }
+            else if (previous != null && previous.Length > next.Length)
+            {
+                // An over-long line wrapped; blank the cells it used past the new end
+                next = next.PadRight(previous.Length);
+                end = next.Length;
+            }
+
+            ReadOnlySpan<char> cells = next.AsSpan(start, end - start);
+
+            // On Windows the cells go straight into the screen buffer in one call
+            if (!WindowsConsoleApi.TryWriteAt(cells, start, top))
+            {
+                System.Console.SetCursorPosition(start, top);
+                ConsoleOutputBuffer.Write(cells);
+                ConsoleOutputBuffer.Flush();
+            }
+        }
         
         #endregion
     }
@@ -59,8 +59,8 @@ namespace ArbSh.Console.I18n
         {
             if (showHelp)
             {
-                System.Console.WriteLine(GetRTLInputHelp());
-                System.Console.WriteLine();
+                ConsoleOutputBuffer.WriteLine(GetRTLInputHelp());
+                ConsoleOutputBuffer.WriteLine();
             }
         }
         
@@ -90,14 +90,14 @@ namespace ArbSh.Console.I18n
                 // Log for debugging
                 if (arabicInput != normalized)
                 {
-                    System.Console.WriteLine($"DEBUG (RTL Input): Normalized '{arabicInput}' → '{normalized}'");
+                    ConsoleOutputBuffer.WriteLine($"DEBUG (RTL Input): Normalized '{arabicInput}' → '{normalized}'");
                 }
                 
                 return normalized;
             }
             catch (Exception ex)
             {
-                System.Console.WriteLine($"WARNING (RTL Input): Arabic input processing failed: {ex.Message}");
+                ConsoleOutputBuffer.WriteLine($"WARNING (RTL Input): Arabic input processing failed: {ex.Message}");
                 return arabicInput;
             }
         }
@@ -115,6 +115,9 @@ namespace ArbSh.Console.I18n
         {
             try
             {
+                // Queued output moves the cursor once it is written.
+                ConsoleOutputBuffer.Flush();
+
                 // Get current cursor position
                 int currentLeft = System.Console.CursorLeft;
                 int currentTop = System.Console.CursorTop;
@@ -126,11 +129,11 @@ namespace ArbSh.Console.I18n
                 // For now, we'll leave the cursor where the console puts it
                 // since fighting the console input system causes more problems
                 
-                System.Console.WriteLine($"DEBUG (RTL): Cursor at ({currentLeft}, {currentTop}) after prompt length {promptLength}");
+                ConsoleOutputBuffer.WriteLine($"DEBUG (RTL): Cursor at ({currentLeft}, {currentTop}) after prompt length {promptLength}");
             }
             catch (Exception ex)
             {
-                System.Console.WriteLine($"DEBUG (RTL): Cursor positioning failed: {ex.Message}");
+                ConsoleOutputBuffer.WriteLine($"DEBUG (RTL): Cursor positioning failed: {ex.Message}");
             }
         }
 
@@ -143,7 +146,8 @@ namespace ArbSh.Console.I18n
             {
                 // Add a subtle RTL indicator
                 // This helps users understand they're in RTL input mode
-                System.Console.Write("◄"); // RTL arrow indicator
+                ConsoleOutputBuffer.Write("◄"); // RTL arrow indicator
+                ConsoleOutputBuffer.Flush();
                 
                 // Move cursor back to overwrite the indicator when typing starts
                 if (System.Console.CursorLeft > 0)
@@ -153,7 +157,7 @@ namespace ArbSh.Console.I18n
             }
             catch (Exception ex)
             {
-                System.Console.WriteLine($"DEBUG (RTL): RTL indicator failed: {ex.Message}");
+                ConsoleOutputBuffer.WriteLine($"DEBUG (RTL): RTL indicator failed: {ex.Message}");
             }
         }
         
@@ -6,7 +6,8 @@ namespace ArbSh.Console.I18n
 {
     /// <summary>
     /// Direct Windows Console API wrapper to handle Arabic input properly.
-    /// Uses ReadConsoleW to bypass Console.ReadLine limitations with RTL text.
+    /// Uses ReadConsoleW to bypass Console.ReadLine limitations with RTL text,
+    /// and WriteConsoleW/WriteConsoleOutputCharacterW to write output in bulk.
     /// </summary>
     public static class WindowsConsoleApi
     {
@@ -27,9 +28,18 @@ namespace ArbSh.Console.I18n
         private const uint ENABLE_EXTENDED_FLAGS = 0x0080;
         private const uint ENABLE_AUTO_POSITION = 0x0100;
         private const uint ENABLE_VIRTUAL_TERMINAL_INPUT = 0x0200;
+
+        // Older conhost versions reject single writes much larger than 64 KB.
+        private const int MaxCharsPerWrite = 16 * 1024;
         
         #endregion
 
+        #region Output State
+
+        private static readonly Lazy<IntPtr> ConsoleOutputHandle = new(GetConsoleOutputHandle);
+
+        #endregion
+
         #region Windows API Imports
         
         [DllImport("kernel32.dll", SetLastError = true)]
@@ -51,6 +61,29 @@ namespace ArbSh.Console.I18n
         
         [DllImport("kernel32.dll", SetLastError = true)]
         private static extern uint GetLastError();
+
+        [DllImport("kernel32.dll", SetLastError = true)]
+        private static extern bool WriteConsoleW(
+            IntPtr hConsoleOutput,
+            ref char lpBuffer,
+            uint nNumberOfCharsToWrite,
+            out uint lpNumberOfCharsWritten,
+            IntPtr lpReserved);
+
+        [DllImport("kernel32.dll", SetLastError = true)]
+        private static extern bool WriteConsoleOutputCharacterW(
+            IntPtr hConsoleOutput,
+            ref char lpCharacter,
+            uint nLength,
+            Coord dwWriteCoord,
+            out uint lpNumberOfCharsWritten);
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct Coord
+        {
+            public short X;
+            public short Y;
+        }
         
         #endregion
 
@@ -115,6 +148,61 @@ namespace ArbSh.Console.I18n
             }
         }
 
+        /// <summary>
+        /// Writes text at the cursor with WriteConsoleW, a few calls for any amount of text.
+        /// </summary>
+        /// <param name="text">Text to write</param>
+        /// <param name="charsWritten">Characters written before the call returned, also when it failed partway</param>
+        /// <returns>False when stdout is not a Windows console (for example redirected output) or a write failed</returns>
+        public static bool TryWriteConsole(ReadOnlySpan<char> text, out int charsWritten)
+        {
+            charsWritten = 0;
+            IntPtr handle = ConsoleOutputHandle.Value;
+            if (handle == IntPtr.Zero)
+            {
+                return false;
+            }
+
+            while (charsWritten < text.Length)
+            {
+                ReadOnlySpan<char> rest = text.Slice(charsWritten);
+                int length = Math.Min(rest.Length, MaxCharsPerWrite);
+                if (!WriteConsoleW(handle, ref MemoryMarshal.GetReference(rest), (uint)length, out uint written, IntPtr.Zero)
+                    || written == 0)
+                {
+                    return false;
+                }
+
+                charsWritten += (int)written;
+            }
+
+            return true;
+        }
+
+        /// <summary>
+        /// Writes characters into the screen buffer at a position without moving the cursor.
+        /// </summary>
+        /// <param name="text">Characters to write, one cell each</param>
+        /// <param name="left">Column of the first cell</param>
+        /// <param name="top">Row in the screen buffer</param>
+        /// <returns>False when stdout is not a Windows console or the write failed</returns>
+        public static bool TryWriteAt(ReadOnlySpan<char> text, int left, int top)
+        {
+            IntPtr handle = ConsoleOutputHandle.Value;
+            if (handle == IntPtr.Zero)
+            {
+                return false;
+            }
+
+            if (text.IsEmpty)
+            {
+                return true;
+            }
+
+            var coord = new Coord { X = (short)left, Y = (short)top };
+            return WriteConsoleOutputCharacterW(handle, ref MemoryMarshal.GetReference(text), (uint)text.Length, coord, out _);
+        }
+
         /// <summary>
         /// Checks if the current environment supports Windows Console API.
         /// </summary>
@@ -180,6 +268,27 @@ namespace ArbSh.Console.I18n
         #endregion
 
         #region Private Methods
+
+        /// <summary>
+        /// Gets the stdout handle when it is a console screen buffer.
+        /// </summary>
+        /// <returns>The handle, or zero when not on Windows or when stdout is redirected</returns>
+        private static IntPtr GetConsoleOutputHandle()
+        {
+            if (!RuntimeInformation.IsOSPlatform(OSPlatform.Windows))
+            {
+                return IntPtr.Zero;
+            }
+
+            IntPtr handle = GetStdHandle(STD_OUTPUT_HANDLE);
+            if (handle == IntPtr.Zero || handle == new IntPtr(-1))
+            {
+                return IntPtr.Zero;
+            }
+
+            // GetConsoleMode fails for files and pipes, which WriteConsoleW cannot write to.
+            return GetConsoleMode(handle, out _) ? handle : IntPtr.Zero;
+        }
         
         /// <summary>
         /// Configures the console input mode for optimal Arabic text handling.
@@ -29,13 +29,15 @@ namespace ArbSh.Console
 
             ConsoleRTLDisplay.DisplayRTLText("مرحباً بكم في أربش (النموذج الأولي)!", rightAlign: true);
             ConsoleRTLDisplay.DisplayRTLText("اكتب 'اخرج' للخروج.", rightAlign: true);
-            System.Console.WriteLine();
+            ConsoleOutputBuffer.WriteLine();
+            ConsoleOutputBuffer.Flush();
 
             if (executionOptions.EmitDebug)
             {
                 ConsoleEnvironment.DisplayConsoleInfo();
-                System.Console.WriteLine(ArabicConsoleInput.GetInputInfo());
-                System.Console.WriteLine();
+                ConsoleOutputBuffer.WriteLine(ArabicConsoleInput.GetInputInfo());
+                ConsoleOutputBuffer.WriteLine();
+                ConsoleOutputBuffer.Flush();
             }
             else
             {
@@ -44,12 +46,18 @@ namespace ArbSh.Console
                 {
                     ConsoleRTLDisplay.DisplayRTLText("⚠️  تحذير: المحطة الحالية لا تدعم النص العربي بشكل جيد", rightAlign: true);
                     ConsoleRTLDisplay.DisplayRTLText("💡 نصيحة: استخدم Windows Terminal للحصول على أفضل عرض للنص العربي", rightAlign: true);
-                    System.Console.WriteLine();
+                    ConsoleOutputBuffer.WriteLine();
+                    ConsoleOutputBuffer.Flush();
                 }
             }
 
             ArabicConsoleInput.Initialize(ArabicConsoleInput.InputStrategy.Auto);
 
+            // Only interactive sessions are recorded; piped scripts would flood the history.
+            CommandHistory? history = System.Console.IsInputRedirected
+                ? null
+                : CommandHistory.Open(CommandHistory.DefaultPath, diagnostics: sink);
+
             try
             {
                 while (true)
@@ -59,7 +67,7 @@ namespace ArbSh.Console
                     if (!System.Console.IsInputRedirected)
                     {
                         // Read RTL interactively while preserving logical order for parser/executor.
-                        inputLine = RTLConsoleInput.ReadRTLLine();
+                        inputLine = RTLConsoleInput.ReadRTLLine(history);
                     }
                     else
                     {
@@ -77,6 +85,8 @@ namespace ArbSh.Console
                         continue;
                     }
 
+                    history?.Add(inputLine);
+
                     if (string.Equals(inputLine, ExitCommand, StringComparison.Ordinal))
                     {
                         break;
@@ -94,6 +104,9 @@ namespace ArbSh.Console
                     {
                         sink.WriteError($"ERROR: {ex.Message}");
                     }
+
+                    // One batch per command: its output reaches the console before the next prompt.
+                    ConsoleOutputBuffer.Flush();
                 }
             }
             catch (Exception ex)
@@ -102,11 +115,14 @@ namespace ArbSh.Console
             }
             finally
             {
+                history?.Dispose();
                 ArabicConsoleInput.Cleanup();
                 if (!System.Console.IsInputRedirected)
                 {
-                    System.Console.WriteLine("تم إغلاق أربش.");
+                    ConsoleOutputBuffer.WriteLine("تم إغلاق أربش.");
                 }
+
+                ConsoleOutputBuffer.Flush();
             }
         }
 
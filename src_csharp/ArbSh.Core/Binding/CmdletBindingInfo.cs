@@ -0,0 +1,289 @@
+using System.Collections.Concurrent;
+using System.ComponentModel;
+using System.Linq.Expressions;
+using System.Reflection;
+using System.Runtime.CompilerServices;
+
+namespace ArbSh.Core;
+
+/// <summary>
+/// Precomputed binding metadata for a single cmdlet type.
+/// Built at compile time by the ArbSh.Generators command table generator (see
+/// <see cref="CommandDiscovery"/>) so the executor can create and bind cmdlets without
+/// attribute lookups or reflection-based property assignment. There is no runtime fallback:
+/// factories and setters are generated code only, which keeps binding trimming- and AOT-safe.
+/// </summary>
+internal sealed class CmdletBindingInfo
+{
+    /// <summary>
+    /// Creates binding metadata. Called from generated code.
+    /// </summary>
+    /// <param name="commandName">The Arabic command name, or null for unregistered types.</param>
+    /// <param name="cmdletType">The cmdlet type.</param>
+    /// <param name="factory">Creates a new cmdlet instance.</param>
+    /// <param name="parameters">The bindable parameters in declaration order.</param>
+    public CmdletBindingInfo(
+        string? commandName,
+        Type cmdletType,
+        Func<CmdletBase> factory,
+        CmdletParameterInfo[] parameters)
+    {
+        CommandName = commandName;
+        CmdletType = cmdletType;
+        Factory = factory;
+        Parameters = parameters;
+
+        PipelineParameters = parameters
+            .Where(p => p.Attribute.ValueFromPipeline || p.Attribute.ValueFromPipelineByPropertyName)
+            .ToArray();
+    }
+
+    /// <summary>
+    /// The Arabic command name from <see cref="ArabicNameAttribute"/>, if any.
+    /// </summary>
+    public string? CommandName { get; }
+
+    /// <summary>
+    /// The cmdlet type described by this metadata.
+    /// </summary>
+    public Type CmdletType { get; }
+
+    /// <summary>
+    /// Compiled constructor for the cmdlet type.
+    /// </summary>
+    public Func<CmdletBase> Factory { get; }
+
+    /// <summary>
+    /// All bindable parameters in declaration order.
+    /// </summary>
+    public IReadOnlyList<CmdletParameterInfo> Parameters { get; }
+
+    /// <summary>
+    /// Parameters that accept pipeline input by value or by property name.
+    /// </summary>
+    public IReadOnlyList<CmdletParameterInfo> PipelineParameters { get; }
+}
+
+/// <summary>
+/// Precomputed metadata and a generated setter for one cmdlet parameter property.
+/// </summary>
+internal sealed class CmdletParameterInfo
+{
+    private static readonly ConcurrentDictionary<Type, TypeConverter> Converters = new();
+
+    private static readonly ConcurrentDictionary<(Type InputType, CmdletParameterInfo Parameter), PipelinePropertySource?> PropertySources = new();
+
+    /// <summary>
+    /// Creates parameter metadata. Called from generated code.
+    /// </summary>
+    /// <param name="name">The CLR property name.</param>
+    /// <param name="parameterType">The property type.</param>
+    /// <param name="arabicName">The Arabic parameter name, if declared.</param>
+    /// <param name="attribute">The property's parameter attribute.</param>
+    /// <param name="setter">Assigns a value to the property on a cmdlet instance.</param>
+    public CmdletParameterInfo(
+        string name,
+        Type parameterType,
+        string? arabicName,
+        ParameterAttribute attribute,
+        Action<CmdletBase, object?> setter)
+    {
+        Attribute = attribute;
+        Name = name;
+        ParameterType = parameterType;
+        ArabicName = arabicName;
+        NamedKey = ArabicName != null ? $"-{ArabicName}" : null;
+        IsSwitch = ParameterType == typeof(bool);
+        ElementType = ParameterType.IsArray ? ParameterType.GetElementType() : null;
+        Converter = GetConverter(ParameterType);
+        ConverterAcceptsString = Converter.CanConvertFrom(typeof(string));
+        if (ElementType != null)
+        {
+            ElementConverter = GetConverter(ElementType);
+            ElementConverterAcceptsString = ElementConverter.CanConvertFrom(typeof(string));
+        }
+        Setter = setter;
+    }
+
+    /// <summary>
+    /// The parameter attribute declared on the property.
+    /// </summary>
+    public ParameterAttribute Attribute { get; }
+
+    /// <summary>
+    /// The CLR property name.
+    /// </summary>
+    public string Name { get; }
+
+    /// <summary>
+    /// The property type.
+    /// </summary>
+    public Type ParameterType { get; }
+
+    /// <summary>
+    /// The Arabic parameter name, if declared.
+    /// </summary>
+    public string? ArabicName { get; }
+
+    /// <summary>
+    /// The command-line form of the Arabic name (<c>-الاسم</c>), or null when the parameter has no Arabic name.
+    /// </summary>
+    public string? NamedKey { get; }
+
+    /// <summary>
+    /// Indicates a boolean switch parameter.
+    /// </summary>
+    public bool IsSwitch { get; }
+
+    /// <summary>
+    /// Indicates an array parameter that consumes remaining positional arguments.
+    /// </summary>
+    public bool IsArray => ElementType != null;
+
+    /// <summary>
+    /// The array element type for array parameters.
+    /// </summary>
+    public Type? ElementType { get; }
+
+    /// <summary>
+    /// Cached type converter for <see cref="ParameterType"/>.
+    /// </summary>
+    public TypeConverter Converter { get; }
+
+    /// <summary>
+    /// Indicates whether <see cref="Converter"/> can convert from string.
+    /// </summary>
+    public bool ConverterAcceptsString { get; }
+
+    /// <summary>
+    /// Cached type converter for <see cref="ElementType"/>, or null for non-array parameters.
+    /// </summary>
+    public TypeConverter? ElementConverter { get; }
+
+    /// <summary>
+    /// Indicates whether <see cref="ElementConverter"/> can convert from string.
+    /// </summary>
+    public bool ElementConverterAcceptsString { get; }
+
+    /// <summary>
+    /// Generated property setter.
+    /// </summary>
+    public Action<CmdletBase, object?> Setter { get; }
+
+    /// <summary>
+    /// Converts a string argument to <see cref="ParameterType"/> using the cached converter,
+    /// falling back to <see cref="Convert.ChangeType(object, Type)"/>.
+    /// </summary>
+    /// <param name="value">The string value.</param>
+    /// <returns>The converted value.</returns>
+    public object? ConvertFromString(string value)
+    {
+        return ConverterAcceptsString
+            ? Converter.ConvertFromString(value)
+            : Convert.ChangeType(value, ParameterType);
+    }
+
+    /// <summary>
+    /// Converts a string argument to <see cref="ElementType"/> using the cached element converter,
+    /// falling back to <see cref="Convert.ChangeType(object, Type)"/>.
+    /// </summary>
+    /// <param name="value">The string value.</param>
+    /// <returns>The converted element.</returns>
+    /// <exception cref="InvalidOperationException">The parameter is not an array.</exception>
+    public object ConvertElementFromString(string value)
+    {
+        Type elementType = ElementType ?? throw new InvalidOperationException($"Parameter '{Name}' is not an array.");
+        return ElementConverterAcceptsString
+            ? ElementConverter!.ConvertFromString(value)!
+            : Convert.ChangeType(value, elementType);
+    }
+
+    /// <summary>
+    /// Converts a value already converted to another type (for example by a type literal) to <see cref="ElementType"/>.
+    /// </summary>
+    /// <param name="value">The value to convert.</param>
+    /// <returns>The converted element.</returns>
+    /// <exception cref="InvalidOperationException">The parameter is not an array.</exception>
+    public object ConvertToElement(object value)
+    {
+        Type elementType = ElementType ?? throw new InvalidOperationException($"Parameter '{Name}' is not an array.");
+        return ElementConverter!.CanConvertFrom(value.GetType())
+            ? ElementConverter.ConvertFrom(value)!
+            : Convert.ChangeType(value, elementType);
+    }
+
+    /// <summary>
+    /// Returns the cached type converter for a type.
+    /// Used for parameter types and for type literal overrides such as <c>[int]</c>.
+    /// </summary>
+    /// <param name="type">The type to convert to.</param>
+    /// <returns>The type converter.</returns>
+    public static TypeConverter GetConverter(Type type)
+    {
+        return Converters.GetOrAdd(type, static t => TypeDescriptor.GetConverter(t));
+    }
+
+    /// <summary>
+    /// Converts a string to a type using the cached converter for that type,
+    /// falling back to <see cref="Convert.ChangeType(object, Type)"/>.
+    /// </summary>
+    /// <param name="value">The string value.</param>
+    /// <param name="targetType">The type to convert to.</param>
+    /// <returns>The converted value.</returns>
+    public static object? ConvertFromString(string value, Type targetType)
+    {
+        TypeConverter converter = GetConverter(targetType);
+        return converter.CanConvertFrom(typeof(string))
+            ? converter.ConvertFromString(value)
+            : Convert.ChangeType(value, targetType);
+    }
+
+    /// <summary>
+    /// Finds the public instance property of a pipeline input type that this parameter binds from
+    /// by property name (case-insensitive). The lookup and the compiled getter are cached per
+    /// input type, so repeated pipeline items of the same type do not use reflection.
+    /// </summary>
+    /// <param name="inputType">The runtime type of the pipeline input value.</param>
+    /// <returns>The source property, or null when the input type has no readable property of that name.</returns>
+    public PipelinePropertySource? GetPropertySource(Type inputType)
+    {
+        return PropertySources.GetOrAdd((inputType, this), static key => PipelinePropertySource.Create(key.InputType, key.Parameter.Name));
+    }
+}
+
+/// <summary>
+/// A property read from pipeline input for <see cref="ParameterAttribute.ValueFromPipelineByPropertyName"/> binding.
+/// </summary>
+/// <param name="PropertyType">The declared type of the source property.</param>
+/// <param name="Getter">Compiled getter that reads the property from a boxed input value.</param>
+internal sealed record PipelinePropertySource(Type PropertyType, Func<object, object?> Getter)
+{
+    /// <summary>
+    /// Looks up a readable public instance property by name (case-insensitive) and compiles its getter.
+    /// Where dynamic code is not compiled (NativeAOT), the property is read through reflection instead
+    /// of an interpreted expression tree.
+    /// </summary>
+    /// <param name="inputType">The input type to search.</param>
+    /// <param name="name">The property name.</param>
+    /// <returns>The source property, or null when there is no matching readable property.</returns>
+    public static PipelinePropertySource? Create(Type inputType, string name)
+    {
+        PropertyInfo? property = inputType.GetProperty(name, BindingFlags.IgnoreCase | BindingFlags.Public | BindingFlags.Instance);
+        if (property == null || !property.CanRead || property.GetIndexParameters().Length != 0)
+        {
+            return null;
+        }
+
+        if (!RuntimeFeature.IsDynamicCodeCompiled)
+        {
+            return new PipelinePropertySource(property.PropertyType, property.GetValue);
+        }
+
+        ParameterExpression input = Expression.Parameter(typeof(object), "input");
+        Expression read = Expression.Convert(
+            Expression.Property(Expression.Convert(input, inputType), property),
+            typeof(object));
+
+        return new PipelinePropertySource(property.PropertyType, Expression.Lambda<Func<object, object?>>(read, input).Compile());
+    }
+}
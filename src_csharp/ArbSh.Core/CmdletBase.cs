@@ -1,8 +1,6 @@
 ﻿using System;
-using System.Collections.Concurrent;
 using System.Collections.Generic;
 using System.ComponentModel;
-using System.Reflection;
 
 namespace ArbSh.Core
 {
@@ -10,12 +8,17 @@ namespace ArbSh.Core
     /// Base class for all cmdlets. Provides common functionality.
     /// Inspired by System.Management.Automation.Cmdlet.
     /// </summary>
+    /// <remarks>
+    /// A cmdlet that holds resources across lifecycle calls, such as worker threads, implements
+    /// <see cref="IAsyncDisposable"/>. The Executor disposes it when the stage ends, also when the stage
+    /// faulted or stopped before <see cref="EndProcessingAsync"/>.
+    /// </remarks>
     public abstract class CmdletBase
     {
         /// <summary>
-        /// Internal collection for cmdlet output. The Executor assigns this.
+        /// Internal bounded channel for cmdlet output. The Executor assigns this.
         /// </summary>
-        internal BlockingCollection<PipelineObject>? OutputCollection { get; set; }
+        internal PipelineChannel? OutputCollection { get; set; }
 
         /// <summary>
         /// Called once before ProcessRecord is invoked for the first time.
@@ -31,38 +34,118 @@ namespace ArbSh.Core
         /// <param name="input">The input object from the pipeline (can be null).</param>
         public virtual void ProcessRecord(PipelineObject? input) { }
 
+        /// <summary>
+        /// Asynchronous form of <see cref="ProcessRecord"/>, awaited by the Executor for each input object.
+        /// Cmdlets that hand records to other threads override this to suspend while too much work is in flight,
+        /// so the previous stage is held back instead of the records piling up in memory.
+        /// The default implementation calls <see cref="ProcessRecord"/>.
+        /// </summary>
+        /// <param name="input">The input object from the pipeline (can be null).</param>
+        public virtual ValueTask ProcessRecordAsync(PipelineObject? input)
+        {
+            ProcessRecord(input);
+            return ValueTask.CompletedTask;
+        }
+
         /// <summary>
         /// Called once after all calls to ProcessRecord are complete.
         /// Override for one-time cleanup or final output tasks.
         /// </summary>
         public virtual void EndProcessing() { }
 
+        /// <summary>
+        /// Asynchronous form of <see cref="EndProcessing"/>, awaited by the Executor.
+        /// Cmdlets that produce many objects override this and write with <see cref="WriteObjectAsync"/>,
+        /// so output streams to the next stage as it is produced instead of being held until the call returns.
+        /// The default implementation calls <see cref="EndProcessing"/>.
+        /// </summary>
+        public virtual ValueTask EndProcessingAsync()
+        {
+            EndProcessing();
+            return ValueTask.CompletedTask;
+        }
+
         /// <summary>
         /// Writes a single object to the output pipeline.
+        /// A <see cref="PipelineObject"/> is written as is, keeping its error flag.
         /// </summary>
         /// <param name="output">The object to write.</param>
         protected void WriteObject(object? output)
         {
-            if (OutputCollection != null && !OutputCollection.IsAddingCompleted)
+            WriteObject(output is PipelineObject item ? item : new PipelineObject(output));
+        }
+
+        /// <summary>
+        /// Writes a string to the output pipeline.
+        /// </summary>
+        /// <param name="output">The string to write.</param>
+        protected void WriteObject(string? output) => WriteObject(new PipelineObject(output));
+
+        /// <summary>
+        /// Writes an integer to the output pipeline without boxing it.
+        /// </summary>
+        /// <param name="output">The value to write.</param>
+        protected void WriteObject(int output) => WriteObject(new PipelineObject(output));
+
+        /// <summary>
+        /// Writes an integer to the output pipeline without boxing it.
+        /// </summary>
+        /// <param name="output">The value to write.</param>
+        protected void WriteObject(long output) => WriteObject(new PipelineObject(output));
+
+        /// <summary>
+        /// Writes a number to the output pipeline without boxing it.
+        /// </summary>
+        /// <param name="output">The value to write.</param>
+        protected void WriteObject(double output) => WriteObject(new PipelineObject(output));
+
+        /// <summary>
+        /// Writes a pipeline item, such as an error record, to the output pipeline.
+        /// </summary>
+        /// <param name="output">The item to write.</param>
+        protected void WriteObject(PipelineObject output)
+        {
+            if (OutputCollection != null && !OutputCollection.IsCompleted)
             {
-                try
-                {
-                    OutputCollection.Add(new PipelineObject(output));
-                }
-                catch (InvalidOperationException)
-                {
-                    // Ignore if collection was completed concurrently, though ideally Executor manages this.
-                    CoreConsole.WriteLine("WARN (CmdletBase): Attempted to write to completed output collection.");
-                }
+                // Never blocks: batches held back by a full channel are published at the next flush.
+                // Past the channel's hold limit this throws and faults the stage; bulk output uses WriteObjectAsync.
+                // A false result means the consumer discarded the channel; the object is dropped silently.
+                OutputCollection.Write(output);
             }
             else
             {
                 // Fallback or error? If OutputCollection is null, something is wrong in Executor setup.
                 // If IsAddingCompleted, the cmdlet is trying to write after EndProcessing or after pipeline completion signal.
-                CoreConsole.WriteLine($"WARN (CmdletBase): OutputCollection not available or completed. Cannot write object: {output}");
+                CoreConsole.LogWarning("CmdletBase", $"OutputCollection not available or completed. Cannot write object: {output}");
             }
         }
 
+        /// <summary>
+        /// Writes a single object to the output pipeline, suspending while the next stage is behind.
+        /// </summary>
+        /// <param name="output">The object to write.</param>
+        /// <returns>False when the downstream stage stopped reading; the cmdlet should stop producing.</returns>
+        protected ValueTask<bool> WriteObjectAsync(object? output)
+        {
+            return WriteObjectAsync(output is PipelineObject item ? item : new PipelineObject(output));
+        }
+
+        /// <summary>
+        /// Writes a pipeline item, suspending while the next stage is behind.
+        /// </summary>
+        /// <param name="output">The item to write.</param>
+        /// <returns>False when the downstream stage stopped reading; the cmdlet should stop producing.</returns>
+        protected ValueTask<bool> WriteObjectAsync(PipelineObject output)
+        {
+            if (OutputCollection != null && !OutputCollection.IsCompleted)
+            {
+                return OutputCollection.WriteAsync(output);
+            }
+
+            CoreConsole.LogWarning("CmdletBase", $"OutputCollection not available or completed. Cannot write object: {output}");
+            return ValueTask.FromResult(false);
+        }
+
         /// <summary>
         /// Writes multiple objects to the output pipeline.
         /// </summary>
@@ -93,108 +176,116 @@ namespace ArbSh.Core
         /// <param name="input">The current pipeline input object.</param>
         internal virtual void BindPipelineParameters(PipelineObject? input)
         {
-            if (input?.Value == null) return; // Nothing to bind from
+            if (input is not PipelineObject item || item.Kind == PipelineValueKind.None) return; // Nothing to bind from
 
             var cmdletType = this.GetType();
-            var properties = cmdletType.GetProperties()
-                .Select(p => new { Property = p, Attr = p.GetCustomAttribute<ParameterAttribute>() })
-                .Where(p => p.Attr != null && (p.Attr.ValueFromPipeline || p.Attr.ValueFromPipelineByPropertyName))
-                .ToList();
+            // Pipeline parameters are precomputed once per cmdlet type.
+            IReadOnlyList<CmdletParameterInfo> properties = CommandDiscovery.GetBindingInfo(cmdletType).PipelineParameters;
 
-            if (!properties.Any()) return; // No pipeline parameters defined
+            if (properties.Count == 0) return; // No pipeline parameters defined
 
-            object inputValue = input.Value;
-            Type? inputType = inputValue?.GetType();
+            // Numbers stay unboxed: they are boxed only for a parameter that takes them as they are,
+            // or for the general converter fallback.
+            Type? inputType = item.GetValueType();
+            bool isNumber = item.Kind is PipelineValueKind.Int32 or PipelineValueKind.Int64 or PipelineValueKind.Double;
+            object? inputValue = isNumber ? null : item.Value;
 
             // CoreConsole.WriteLine($"DEBUG (BindPipeline): Attempting pipeline binding for input type {inputType?.Name ?? "null"} to {cmdletType.Name}");
 
-            foreach (var propInfo in properties)
+            // Indexed loop: enumerating the IReadOnlyList would allocate an enumerator per pipeline item.
+            for (int i = 0; i < properties.Count; i++)
             {
+                CmdletParameterInfo propInfo = properties[i];
                 object? valueToSet = null;
                 bool bound = false;
 
                 // 1. Try ValueFromPipeline = true
-                if (propInfo.Attr!.ValueFromPipeline)
+                if (propInfo.Attribute.ValueFromPipeline)
                 {
                     // Check if the target property type is assignable from the input object's type
-                    if (propInfo.Property.PropertyType.IsAssignableFrom(inputType))
+                    if (propInfo.ParameterType.IsAssignableFrom(inputType))
                     {
-                        valueToSet = inputValue;
+                        valueToSet = inputValue ?? item.Value;
                         bound = true;
-                        // CoreConsole.WriteLine($"DEBUG (BindPipeline): Bound '{propInfo.Property.Name}' ByValue.");
+                        // CoreConsole.WriteLine($"DEBUG (BindPipeline): Bound '{propInfo.Name}' ByValue.");
                     }
                     else
                     {
                         // Attempt type conversion if direct assignment isn't possible
                         try
                         {
-                            TypeConverter converter = TypeDescriptor.GetConverter(propInfo.Property.PropertyType);
-                            if (converter != null && converter.CanConvertFrom(inputType))
+                            TypeConverter converter = propInfo.Converter;
+                            if (isNumber && TryConvertNumber(item, propInfo.ParameterType, out valueToSet))
+                            {
+                                bound = true;
+                            }
+                            else if (converter.CanConvertFrom(inputType))
                             {
-                                valueToSet = converter.ConvertFrom(inputValue);
+                                valueToSet = converter.ConvertFrom(inputValue ??= item.Value!);
                                 bound = true;
-                                // CoreConsole.WriteLine($"DEBUG (BindPipeline): Converted and bound '{propInfo.Property.Name}' ByValue.");
+                                // CoreConsole.WriteLine($"DEBUG (BindPipeline): Converted and bound '{propInfo.Name}' ByValue.");
                             }
-                            else if (inputValue is IConvertible) // Fallback using IConvertible
+                            else if ((inputValue ??= item.Value) is IConvertible) // Fallback using IConvertible
                             {
-                                valueToSet = Convert.ChangeType(inputValue, propInfo.Property.PropertyType);
+                                valueToSet = Convert.ChangeType(inputValue, propInfo.ParameterType);
                                 bound = true;
-                                // CoreConsole.WriteLine($"DEBUG (BindPipeline): ChangeType and bound '{propInfo.Property.Name}' ByValue.");
+                                // CoreConsole.WriteLine($"DEBUG (BindPipeline): ChangeType and bound '{propInfo.Name}' ByValue.");
                             }
                         }
                         catch (Exception ex)
                         {
-                            CoreConsole.WriteLine($"WARN (BindPipeline): Failed to convert pipeline input type '{inputType?.Name}' to parameter '{propInfo.Property.Name}' type '{propInfo.Property.PropertyType.Name}' for ByValue binding. Error: {ex.Message}");
+                            CoreConsole.LogWarning("BindPipeline", $"Failed to convert pipeline input type '{inputType?.Name}' to parameter '{propInfo.Name}' type '{propInfo.ParameterType.Name}' for ByValue binding. Error: {ex.Message}");
                         }
                     }
                 }
 
                 // 2. Try ValueFromPipelineByPropertyName = true (only if not already bound by value)
-                if (!bound && propInfo.Attr!.ValueFromPipelineByPropertyName && inputType != null)
+                if (!bound && propInfo.Attribute.ValueFromPipelineByPropertyName && !isNumber && inputValue != null && inputType != null)
                 {
-                    // Find a property on the *input object* that matches the *parameter name*
-                    PropertyInfo? inputObjectProperty = inputType.GetProperty(propInfo.Property.Name, BindingFlags.IgnoreCase | BindingFlags.Public | BindingFlags.Instance);
+                    // Find a property on the *input object* that matches the *parameter name*.
+                    // The lookup and its compiled getter are cached per (input type, parameter).
+                    PipelinePropertySource? inputObjectProperty = propInfo.GetPropertySource(inputType);
 
                     if (inputObjectProperty != null)
                     {
-                        object? sourceValue = inputObjectProperty.GetValue(inputValue);
+                        object? sourceValue = inputObjectProperty.Getter(inputValue);
 
                         // Check if the target parameter property type is assignable from the source property type
-                        if (sourceValue != null && propInfo.Property.PropertyType.IsAssignableFrom(inputObjectProperty.PropertyType))
+                        if (sourceValue != null && propInfo.ParameterType.IsAssignableFrom(inputObjectProperty.PropertyType))
                         {
                             valueToSet = sourceValue;
                             bound = true;
-                            // CoreConsole.WriteLine($"DEBUG (BindPipeline): Bound '{propInfo.Property.Name}' ByPropertyName.");
+                            // CoreConsole.WriteLine($"DEBUG (BindPipeline): Bound '{propInfo.Name}' ByPropertyName.");
                         }
                         else if (sourceValue != null) // Attempt conversion
                         {
                             try
                             {
-                                TypeConverter converter = TypeDescriptor.GetConverter(propInfo.Property.PropertyType);
-                                if (converter != null && converter.CanConvertFrom(inputObjectProperty.PropertyType))
+                                TypeConverter converter = propInfo.Converter;
+                                if (converter.CanConvertFrom(inputObjectProperty.PropertyType))
                                 {
                                     valueToSet = converter.ConvertFrom(sourceValue);
                                     bound = true;
-                                    // CoreConsole.WriteLine($"DEBUG (BindPipeline): Converted and bound '{propInfo.Property.Name}' ByPropertyName.");
+                                    // CoreConsole.WriteLine($"DEBUG (BindPipeline): Converted and bound '{propInfo.Name}' ByPropertyName.");
                                 }
                                 else if (sourceValue is IConvertible)
                                 {
-                                    valueToSet = Convert.ChangeType(sourceValue, propInfo.Property.PropertyType);
+                                    valueToSet = Convert.ChangeType(sourceValue, propInfo.ParameterType);
                                     bound = true;
-                                    // CoreConsole.WriteLine($"DEBUG (BindPipeline): ChangeType and bound '{propInfo.Property.Name}' ByPropertyName.");
+                                    // CoreConsole.WriteLine($"DEBUG (BindPipeline): ChangeType and bound '{propInfo.Name}' ByPropertyName.");
                                 }
                             }
                             catch (Exception ex)
                             {
-                                CoreConsole.WriteLine($"WARN (BindPipeline): Failed to convert pipeline input property '{inputObjectProperty.Name}' type '{inputObjectProperty.PropertyType.Name}' to parameter '{propInfo.Property.Name}' type '{propInfo.Property.PropertyType.Name}' for ByPropertyName binding. Error: {ex.Message}");
+                                CoreConsole.LogWarning("BindPipeline", $"Failed to convert pipeline input property '{propInfo.Name}' type '{inputObjectProperty.PropertyType.Name}' to parameter '{propInfo.Name}' type '{propInfo.ParameterType.Name}' for ByPropertyName binding. Error: {ex.Message}");
                             }
                         }
-                        else if (sourceValue == null && propInfo.Property.PropertyType.IsClass || Nullable.GetUnderlyingType(propInfo.Property.PropertyType) != null)
+                        else if (sourceValue == null && propInfo.ParameterType.IsClass || Nullable.GetUnderlyingType(propInfo.ParameterType) != null)
                         {
                             // Allow setting null if the source property is null and the target is nullable/class
                             valueToSet = null;
                             bound = true;
-                            // CoreConsole.WriteLine($"DEBUG (BindPipeline): Bound null '{propInfo.Property.Name}' ByPropertyName.");
+                            // CoreConsole.WriteLine($"DEBUG (BindPipeline): Bound null '{propInfo.Name}' ByPropertyName.");
                         }
                     }
                 }
@@ -204,16 +295,54 @@ namespace ArbSh.Core
                 {
                     try
                     {
-                        propInfo.Property.SetValue(this, valueToSet);
+                        propInfo.Setter(this, valueToSet);
                     }
                     catch (Exception ex)
                     {
                         // Error setting the property value
-                        CoreConsole.WriteLine($"ERROR (BindPipeline): Failed to set pipeline-bound property '{propInfo.Property.Name}': {ex.Message}");
+                        CoreConsole.LogError("BindPipeline", $"Failed to set pipeline-bound property '{propInfo.Name}': {ex.Message}");
                     }
                 }
             }
         }
+
+        /// <summary>
+        /// Converts a numeric pipeline value to a string or another numeric parameter type
+        /// through the typed accessors, without boxing the input.
+        /// </summary>
+        /// <param name="item">A pipeline item holding an <see cref="int"/>, <see cref="long"/> or <see cref="double"/>.</param>
+        /// <param name="targetType">The parameter type.</param>
+        /// <param name="value">The converted value.</param>
+        /// <returns>False when the target type needs the general converter path.</returns>
+        /// <exception cref="OverflowException">The value does not fit the target type.</exception>
+        private static bool TryConvertNumber(in PipelineObject item, Type targetType, out object? value)
+        {
+            if (targetType == typeof(string))
+            {
+                value = item.ToString();
+                return true;
+            }
+
+            if (item.TryGetInt64(out long integer))
+            {
+                value = targetType == typeof(int) ? checked((int)integer)
+                    : targetType == typeof(long) ? integer
+                    : targetType == typeof(double) ? (double)integer
+                    : null;
+            }
+            else if (item.TryGetDouble(out double real))
+            {
+                value = targetType == typeof(int) ? Convert.ToInt32(real)
+                    : targetType == typeof(long) ? Convert.ToInt64(real)
+                    : null;
+            }
+            else
+            {
+                value = null;
+            }
+
+            return value != null;
+        }
     }
 }
 
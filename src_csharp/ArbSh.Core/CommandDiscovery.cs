@@ -1,4 +1,4 @@
-using System.Reflection;
+using System.Collections.Frozen;
 
 namespace ArbSh.Core
 {
@@ -8,7 +8,9 @@ namespace ArbSh.Core
     /// </summary>
     public static class CommandDiscovery
     {
-        private static Dictionary<string, Type>? _commandCache;
+        // Built once on first use by any session and immutable afterwards, so lookups from concurrent
+        // sessions take no lock.
+        private static readonly Lazy<CommandTable> Table = new(BuildCache, LazyThreadSafetyMode.ExecutionAndPublication);
 
         /// <summary>
         /// يعثر على نوع الأمر الموافق للاسم العربي المعطى.
@@ -17,12 +19,7 @@ namespace ArbSh.Core
         /// <returns>نوع الأمر أو null إذا لم يوجد.</returns>
         public static Type? Find(string commandName)
         {
-            if (_commandCache == null)
-            {
-                BuildCache();
-            }
-
-            _commandCache!.TryGetValue(commandName, out Type? cmdletType);
+            Table.Value.Commands.TryGetValue(commandName, out Type? cmdletType);
             return cmdletType;
         }
 
@@ -32,50 +29,67 @@ namespace ArbSh.Core
         /// <returns>قاموس أوامر قابل للقراءة.</returns>
         public static IReadOnlyDictionary<string, Type> GetAllCommands()
         {
-            if (_commandCache == null)
+            return Table.Value.Commands;
+        }
+
+        /// <summary>
+        /// يرجع بيانات الربط المولَّدة وقت الترجمة لنوع الأمر.
+        /// لا يوجد بديل بالانعكاس، فالأنواع خارج الجدول المولَّد مرفوضة.
+        /// </summary>
+        /// <param name="cmdletType">نوع الأمر.</param>
+        /// <returns>بيانات الربط المخزنة.</returns>
+        /// <exception cref="InvalidOperationException">النوع ليس في جدول الأوامر المولَّد.</exception>
+        internal static CmdletBindingInfo GetBindingInfo(Type cmdletType)
+        {
+            if (Table.Value.Bindings.TryGetValue(cmdletType, out CmdletBindingInfo? binding))
             {
-                BuildCache();
+                return binding;
             }
 
-            return _commandCache!;
+            throw new InvalidOperationException(
+                $"Cmdlet type '{cmdletType.FullName}' is not in the generated command table. " +
+                "Only non-abstract CmdletBase subclasses in ArbSh.Core with [ArabicName] can be bound.");
         }
 
         /// <summary>
-        /// يبني مخزن الأوامر عبر فحص الأنواع في التجميعة الحالية.
+        /// يبني مخزن الأوامر من الجدول المولَّد وقت الترجمة (ArbSh.Generators)،
+        /// دون أي فحص للأنواع بالانعكاس عند بدء التشغيل.
         /// </summary>
-        private static void BuildCache()
+        private static CommandTable BuildCache()
         {
-            CoreConsole.WriteLine("DEBUG (Discovery): Building Arabic command cache...");
-            _commandCache = new Dictionary<string, Type>(StringComparer.OrdinalIgnoreCase);
-
-            Assembly currentAssembly = Assembly.GetExecutingAssembly();
-            IEnumerable<Type> cmdletTypes = currentAssembly.GetTypes()
-                .Where(t => t.IsSubclassOf(typeof(CmdletBase)) && !t.IsAbstract);
+            CoreConsole.LogDebug("Discovery", "Building Arabic command cache...");
+            var commandCache = new Dictionary<string, Type>(StringComparer.OrdinalIgnoreCase);
+            var bindingCache = new Dictionary<Type, CmdletBindingInfo>();
 
-            foreach (Type type in cmdletTypes)
+            foreach (CmdletBindingInfo binding in GeneratedCommandTable.CreateBindings())
             {
-                ArabicNameAttribute? arabicNameAttr = type.GetCustomAttribute<ArabicNameAttribute>();
-                if (arabicNameAttr == null)
+                Type type = binding.CmdletType;
+                string arabicName = binding.CommandName!;
+                if (!commandCache.ContainsKey(arabicName))
                 {
-                    CoreConsole.WriteLine($"DEBUG (Discovery): Skipping '{type.Name}' (no ArabicName).");
+                    commandCache.Add(arabicName, type);
+                    bindingCache.TryAdd(type, binding);
+                    CoreConsole.LogDebug("Discovery", $"Registered '{arabicName}' -> {type.FullName}");
                     continue;
                 }
 
-                string arabicName = arabicNameAttr.Name;
-                if (!_commandCache.ContainsKey(arabicName))
+                if (commandCache[arabicName] != type)
                 {
-                    _commandCache.Add(arabicName, type);
-                    CoreConsole.WriteLine($"DEBUG (Discovery): Registered '{arabicName}' -> {type.FullName}");
-                    continue;
-                }
-
-                if (_commandCache[arabicName] != type)
-                {
-                    CoreConsole.WriteLine($"WARN (Discovery): Duplicate Arabic command '{arabicName}' between {type.FullName} and {_commandCache[arabicName].FullName}.");
+                    CoreConsole.LogWarning("Discovery", $"Duplicate Arabic command '{arabicName}' between {type.FullName} and {commandCache[arabicName].FullName}.");
                 }
             }
 
-            CoreConsole.WriteLine($"DEBUG (Discovery): Arabic cache built with {_commandCache.Count} command(s).");
+            CoreConsole.LogDebug("Discovery", $"Arabic cache built with {commandCache.Count} command(s).");
+
+            // Both tables are published together through the Lazy, so readers that see a command also see its binder.
+            return new CommandTable(commandCache.ToFrozenDictionary(StringComparer.OrdinalIgnoreCase), bindingCache.ToFrozenDictionary());
         }
+
+        /// <summary>
+        /// جدول الأوامر المكتشفة وبيانات ربطها.
+        /// </summary>
+        private sealed record CommandTable(
+            FrozenDictionary<string, Type> Commands,
+            FrozenDictionary<Type, CmdletBindingInfo> Bindings);
     }
 }
@@ -0,0 +1,201 @@
+using System.Threading.Channels;
+
+namespace ArbSh.Core.Commands
+{
+    /// <summary>
+    /// ينفذ أمراً على كل عنصر يصل من خط الأنابيب، موزعاً العناصر على عدة خيوط.
+    /// </summary>
+    /// <remarks>
+    /// A fixed set of workers on the thread pool share one queue of items; each takes the next item as soon as
+    /// it is free, so uneven items balance across them. Each item runs the command as its own nested pipeline,
+    /// with the item piped into the first stage. At most <see cref="MaxInFlightPerWorker"/> items per worker
+    /// are queued, running or waiting to be written; while that window is full this stage stops reading its
+    /// input, so a slow command or a slow next stage holds back the producer as elsewhere in the pipeline.
+    /// The workers are stopped in <see cref="DisposeAsync"/>, which the Executor calls however the stage ends.
+    /// </remarks>
+    [ArabicName("لكل")]
+    public sealed class ForEachParallelCmdlet : CmdletBase, IAsyncDisposable
+    {
+        private const int MaxInFlightPerWorker = 4;
+
+        private readonly Dictionary<long, List<PipelineObject>> _reorderBuffer = new();
+        private readonly CancellationTokenSource _cancellation = new();
+        private List<ParsedCommand>? _pipeline;
+        private Channel<WorkItem>? _work;
+        private Channel<WorkResult>? _results;
+        private Task[] _workers = [];
+        private long _nextSequence;
+        private long _nextToWrite;
+        private int _inFlight;
+        private int _window;
+        private bool _stopped;
+
+        /// <summary>
+        /// الأمر المنفذ لكل عنصر.
+        /// </summary>
+        [Parameter(Position = 0, Mandatory = true, HelpMessage = "الأمر المنفذ لكل عنصر؛ يصله العنصر عبر خط الأنابيب.")]
+        [ArabicName("الأمر")]
+        public string? Command { get; set; }
+
+        /// <summary>
+        /// أقصى عدد من العناصر تُعالج في وقت واحد.
+        /// </summary>
+        [Parameter(HelpMessage = "أقصى عدد من العناصر تُعالج في وقت واحد (الافتراضي عدد المعالجات).")]
+        [ArabicName("التوازي")]
+        public int ThrottleLimit { get; set; } = Environment.ProcessorCount;
+
+        /// <summary>
+        /// يخرج النتائج بترتيب المدخلات بدلاً من ترتيب انتهائها.
+        /// </summary>
+        [Parameter(HelpMessage = "إخراج النتائج بترتيب المدخلات.")]
+        [ArabicName("بالترتيب")]
+        public bool Ordered { get; set; }
+
+        /// <inheritdoc />
+        public override void BeginProcessing()
+        {
+            List<List<ParsedCommand>> statements = string.IsNullOrWhiteSpace(Command) ? [] : Parser.Parse(Command!);
+            if (statements.Count != 1 || statements[0].Count == 0)
+            {
+                WriteObject(new PipelineObject("يجب أن يكون الأمر خط أنابيب واحداً.", isError: true));
+                _stopped = true;
+                return;
+            }
+
+            // Parsed and bound once; every item runs the same commands without looking them up again.
+            _pipeline = statements[0];
+            CompiledScript.ResolveBindings(_pipeline);
+
+            int workerCount = Math.Max(1, ThrottleLimit);
+            _window = workerCount * MaxInFlightPerWorker;
+            _work = Channel.CreateUnbounded<WorkItem>(new UnboundedChannelOptions { SingleWriter = true });
+            _results = Channel.CreateUnbounded<WorkResult>(new UnboundedChannelOptions { SingleReader = true });
+
+            // Task.Run flows the session and output sink of this stage into the workers.
+            _workers = new Task[workerCount];
+            for (int i = 0; i < workerCount; i++)
+            {
+                _workers[i] = Task.Run(RunWorkerAsync);
+            }
+        }
+
+        /// <inheritdoc />
+        public override async ValueTask ProcessRecordAsync(PipelineObject? input)
+        {
+            if (input is not PipelineObject item || _stopped)
+            {
+                return;
+            }
+
+            // The window is full: write finished results until a slot frees up before reading more input.
+            while (_inFlight >= _window && !_stopped)
+            {
+                await WriteResultAsync(await _results!.Reader.ReadAsync());
+            }
+
+            if (_stopped)
+            {
+                return;
+            }
+
+            _inFlight++;
+            _work!.Writer.TryWrite(new WorkItem(_nextSequence++, item));
+
+            while (!_stopped && _results!.Reader.TryRead(out WorkResult finished))
+            {
+                await WriteResultAsync(finished);
+            }
+        }
+
+        /// <inheritdoc />
+        public override async ValueTask EndProcessingAsync()
+        {
+            if (_work == null)
+            {
+                return;
+            }
+
+            _work.Writer.TryComplete();
+            while (_inFlight > 0 && !_stopped)
+            {
+                await WriteResultAsync(await _results!.Reader.ReadAsync());
+            }
+        }
+
+        /// <summary>
+        /// يوقف العمال وينتظر انتهاءهم.
+        /// </summary>
+        /// <remarks>
+        /// Items still queued are left unprocessed: the next stage stopped reading, or this stage faulted.
+        /// </remarks>
+        public async ValueTask DisposeAsync()
+        {
+            _work?.Writer.TryComplete();
+            _cancellation.Cancel();
+            await Task.WhenAll(_workers);
+            _cancellation.Dispose();
+        }
+
+        private async Task RunWorkerAsync()
+        {
+            CancellationToken token = _cancellation.Token;
+            try
+            {
+                await foreach (WorkItem item in _work!.Reader.ReadAllAsync(token).ConfigureAwait(false))
+                {
+                    List<PipelineObject> output;
+                    try
+                    {
+                        output = Executor.InvokePipeline(_pipeline!, item.Input);
+                    }
+                    catch (Exception ex)
+                    {
+                        output = [new PipelineObject($"[ERROR: {ex.Message}]", isError: true)];
+                    }
+
+                    _results!.Writer.TryWrite(new WorkResult(item.Sequence, output));
+                }
+            }
+            catch (OperationCanceledException)
+            {
+            }
+        }
+
+        private async ValueTask WriteResultAsync(WorkResult result)
+        {
+            if (!Ordered)
+            {
+                _inFlight--;
+                await WriteOutputAsync(result.Output);
+                return;
+            }
+
+            // Items that finish early wait here, inside the window, until every earlier item is written.
+            _reorderBuffer.Add(result.Sequence, result.Output);
+            while (!_stopped && _reorderBuffer.Remove(_nextToWrite, out List<PipelineObject>? output))
+            {
+                _nextToWrite++;
+                _inFlight--;
+                await WriteOutputAsync(output);
+            }
+        }
+
+        private async ValueTask WriteOutputAsync(List<PipelineObject> output)
+        {
+            foreach (PipelineObject item in output)
+            {
+                if (!await WriteObjectAsync(item))
+                {
+                    _stopped = true;
+                    _work!.Writer.TryComplete();
+                    _cancellation.Cancel();
+                    return;
+                }
+            }
+        }
+
+        private readonly record struct WorkItem(long Sequence, PipelineObject Input);
+
+        private readonly record struct WorkResult(long Sequence, List<PipelineObject> Output);
+    }
+}
@@ -1,4 +1,3 @@
-using System.Reflection;
 using System.Text;
 
 namespace ArbSh.Core.Commands
@@ -79,14 +78,8 @@ namespace ArbSh.Core.Commands
         {
             var helpBuilder = new StringBuilder();
 
-            string commandName = CommandDiscovery.GetAllCommands()
-                .FirstOrDefault(kvp => kvp.Value == cmdletType).Key;
-
-            if (string.IsNullOrWhiteSpace(commandName))
-            {
-                ArabicNameAttribute? nameAttr = cmdletType.GetCustomAttribute<ArabicNameAttribute>();
-                commandName = nameAttr?.Name ?? cmdletType.Name;
-            }
+            CmdletBindingInfo bindingInfo = CommandDiscovery.GetBindingInfo(cmdletType);
+            string commandName = bindingInfo.CommandName ?? cmdletType.Name;
 
             helpBuilder.AppendLine("\nالاسم");
             helpBuilder.AppendLine($"  {commandName}");
@@ -94,23 +87,19 @@ namespace ArbSh.Core.Commands
             helpBuilder.AppendLine("\nالصيغة");
             helpBuilder.Append($"  {commandName}");
 
-            List<(PropertyInfo Property, ParameterAttribute Attr)> parameters = cmdletType.GetProperties()
-                .Select(p => (Property: p, Attr: p.GetCustomAttribute<ParameterAttribute>()))
-                .Where(x => x.Attr != null)
-                .Select(x => (Property: x.Property, Attr: x.Attr!))
-                .OrderBy(x => x.Attr.Position >= 0 ? x.Attr.Position : int.MaxValue)
-                .ThenBy(x => x.Property.Name)
+            List<CmdletParameterInfo> parameters = bindingInfo.Parameters
+                .OrderBy(p => p.Attribute.Position >= 0 ? p.Attribute.Position : int.MaxValue)
+                .ThenBy(p => p.Name)
                 .ToList();
 
-            foreach ((PropertyInfo property, ParameterAttribute attr) in parameters)
+            foreach (CmdletParameterInfo parameter in parameters)
             {
-                ArabicNameAttribute? arabicNameAttr = property.GetCustomAttribute<ArabicNameAttribute>();
-                string parameterName = arabicNameAttr?.Name ?? property.Name;
+                string parameterName = parameter.ArabicName ?? parameter.Name;
 
                 string paramSyntax = $" [-{parameterName}";
-                if (property.PropertyType != typeof(bool))
+                if (!parameter.IsSwitch)
                 {
-                    paramSyntax += $" <{property.PropertyType.Name}>";
+                    paramSyntax += $" <{parameter.ParameterType.Name}>";
                 }
 
                 paramSyntax += "]";
@@ -126,12 +115,12 @@ namespace ArbSh.Core.Commands
             }
 
             helpBuilder.AppendLine("\nالمعاملات");
-            foreach ((PropertyInfo property, ParameterAttribute attr) in parameters)
+            foreach (CmdletParameterInfo parameter in parameters)
             {
-                ArabicNameAttribute? arabicNameAttr = property.GetCustomAttribute<ArabicNameAttribute>();
-                string parameterName = arabicNameAttr?.Name ?? property.Name;
+                ParameterAttribute attr = parameter.Attribute;
+                string parameterName = parameter.ArabicName ?? parameter.Name;
 
-                helpBuilder.AppendLine($"  -{parameterName} <{property.PropertyType.Name}>");
+                helpBuilder.AppendLine($"  -{parameterName} <{parameter.ParameterType.Name}>");
                 if (!string.IsNullOrWhiteSpace(attr.HelpMessage))
                 {
                     helpBuilder.AppendLine($"    {attr.HelpMessage}");
@@ -1,5 +1,6 @@
 using System.IO;
 using System.Linq;
+using ArbSh.Core.Models;
 
 namespace ArbSh.Core.Commands
 {
@@ -23,8 +24,22 @@ namespace ArbSh.Core.Commands
         [ArabicName("مخفي")]
         public bool IncludeHidden { get; set; }
 
+        /// <summary>
+        /// يعرض محتويات المجلدات الفرعية أيضاً، مع استعراضها بالتوازي.
+        /// </summary>
+        [Parameter(HelpMessage = "عرض محتويات المجلدات الفرعية أيضاً.")]
+        [ArabicName("متكرر")]
+        public bool Recurse { get; set; }
+
+        /// <summary>
+        /// يرتب النتائج (المجلدات أولاً ثم بالاسم) بدلاً من إخراجها فور قراءتها.
+        /// </summary>
+        [Parameter(HelpMessage = "ترتيب النتائج: المجلدات أولاً ثم بالاسم.")]
+        [ArabicName("مرتب")]
+        public bool Sorted { get; set; }
+
         /// <inheritdoc />
-        public override void EndProcessing()
+        public override async ValueTask EndProcessingAsync()
         {
             string logicalTarget = string.IsNullOrWhiteSpace(TargetPath)
                 ? ShellSessionContext.CurrentDirectory
@@ -53,35 +68,63 @@ namespace ArbSh.Core.Commands
                 return;
             }
 
-            IEnumerable<FileSystemInfo> entries;
+            // Entries are written as they are enumerated; only -مرتب collects the listing first.
+            using var cancellation = new CancellationTokenSource();
             try
             {
-                entries = new DirectoryInfo(resolvedPath).EnumerateFileSystemInfos();
+                if (Sorted)
+                {
+                    var entries = new List<DirectoryEntry>();
+                    if (Recurse)
+                    {
+                        await foreach (DirectoryEntry entry in DirectoryWalker.WalkAsync(resolvedPath, IncludeHidden, cancellation.Token))
+                        {
+                            entries.Add(entry);
+                        }
+                    }
+                    else
+                    {
+                        entries.AddRange(DirectoryWalker.Enumerate(resolvedPath, IncludeHidden));
+                    }
+
+                    await WriteEntriesAsync(entries
+                        .OrderBy(entry => entry.IsDirectory ? 0 : 1)
+                        .ThenBy(entry => entry.Name, StringComparer.OrdinalIgnoreCase));
+                }
+                else if (Recurse)
+                {
+                    await foreach (DirectoryEntry entry in DirectoryWalker.WalkAsync(resolvedPath, IncludeHidden, cancellation.Token))
+                    {
+                        if (!await WriteObjectAsync(entry))
+                        {
+                            break;
+                        }
+                    }
+                }
+                else
+                {
+                    await WriteEntriesAsync(DirectoryWalker.Enumerate(resolvedPath, IncludeHidden));
+                }
             }
-            catch (Exception ex)
+            catch (Exception ex) when (ex is IOException or UnauthorizedAccessException)
             {
                 WriteObject(new PipelineObject($"تعذّر قراءة المجلد: {logicalTarget}. التفاصيل: {ex.Message}", isError: true));
-                return;
             }
-
-            if (!IncludeHidden)
+            finally
             {
-                entries = entries.Where(entry =>
-                    (entry.Attributes & FileAttributes.Hidden) == 0 &&
-                    (entry.Attributes & FileAttributes.System) == 0);
+                // Stops recursive workers when the downstream stage stopped reading.
+                cancellation.Cancel();
             }
+        }
 
-            entries = entries
-                .OrderBy(entry => entry is DirectoryInfo ? 0 : 1)
-                .ThenBy(entry => entry.Name, StringComparer.OrdinalIgnoreCase);
-
-            foreach (FileSystemInfo entry in entries)
+        private async ValueTask WriteEntriesAsync(IEnumerable<DirectoryEntry> entries)
+        {
+            foreach (DirectoryEntry entry in entries)
             {
-                string output = entry is DirectoryInfo
-                    ? $"{entry.Name}/"
-                    : entry.Name;
-
-                WriteObject(output);
+                if (!await WriteObjectAsync(entry))
+                {
+                    break;
+                }
             }
         }
     }
@@ -0,0 +1,81 @@
+using System.Diagnostics;
+using System.Globalization;
+
+namespace ArbSh.Core.Commands
+{
+    /// <summary>
+    /// ينفذ أمراً ويعرض زمن التحليل وتفصيل الزمن والعناصر لكل مرحلة من خط الأنابيب.
+    /// </summary>
+    /// <remarks>
+    /// The command's output is counted and dropped, like PowerShell's Measure-Command; error records are
+    /// still written so a failing stage is visible. Waits are times a stage was suspended on its channels,
+    /// so a stage with a large input wait is starved and one with a large output wait is held back.
+    /// </remarks>
+    [ArabicName("قس")]
+    public sealed class MeasurePipelineCmdlet : CmdletBase
+    {
+        /// <summary>
+        /// الأمر المراد قياسه.
+        /// </summary>
+        [Parameter(Position = 0, Mandatory = true, HelpMessage = "الأمر أو خط الأنابيب المراد قياس زمنه.")]
+        [ArabicName("الأمر")]
+        public string? Command { get; set; }
+
+        /// <inheritdoc />
+        public override void EndProcessing()
+        {
+            if (string.IsNullOrWhiteSpace(Command))
+            {
+                WriteObject(new PipelineObject("لا يوجد أمر لقياسه.", isError: true));
+                return;
+            }
+
+            long parseStart = Stopwatch.GetTimestamp();
+            List<List<ParsedCommand>> statements = Parser.Parse(Command!);
+            WriteObject($"التحليل: {FormatMilliseconds(Stopwatch.GetElapsedTime(parseStart))} ms");
+
+            foreach (List<ParsedCommand> statement in statements)
+            {
+                if (statement.Count == 0)
+                {
+                    continue;
+                }
+
+                var stageStats = new PipelineStageStats[statement.Count];
+                long outputCount = 0;
+                long runStart = Stopwatch.GetTimestamp();
+                // Output is counted and dropped as it streams; only error records are kept.
+                Executor.InvokePipeline(statement, item =>
+                {
+                    outputCount++;
+                    if (item.IsError)
+                    {
+                        WriteObject(item);
+                    }
+                }, collectedStats: stageStats);
+                TimeSpan elapsed = Stopwatch.GetElapsedTime(runStart);
+
+                WriteObject("المرحلة | داخل | خارج | أقصى طابور | الربط ms | انتظار الإدخال ms | انتظار الإخراج ms | الزمن ms");
+                foreach (PipelineStageStats stats in stageStats)
+                {
+                    WriteObject(string.Join(" | ",
+                        stats.CommandName,
+                        stats.ObjectsIn.ToString(CultureInfo.InvariantCulture),
+                        stats.ObjectsOut.ToString(CultureInfo.InvariantCulture),
+                        stats.MaxQueueDepth.ToString(CultureInfo.InvariantCulture),
+                        FormatMilliseconds(stats.BindTime),
+                        FormatMilliseconds(stats.InputWaitTime),
+                        FormatMilliseconds(stats.OutputWaitTime),
+                        FormatMilliseconds(stats.Elapsed)));
+                }
+
+                WriteObject($"الإجمالي: {FormatMilliseconds(elapsed)} ms، المخرجات: {outputCount}");
+            }
+        }
+
+        private static string FormatMilliseconds(TimeSpan time)
+        {
+            return time.TotalMilliseconds.ToString("0.###", CultureInfo.InvariantCulture);
+        }
+    }
+}
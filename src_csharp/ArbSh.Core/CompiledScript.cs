@@ -0,0 +1,115 @@
+using ArbSh.Core.Parsing;
+
+namespace ArbSh.Core;
+
+/// <summary>
+/// Script that has been tokenized, parsed and bound once and can be executed many times
+/// through <see cref="ShellEngine.Execute(CompiledScript, IExecutionSink, ExecutionOptions?, ShellSessionState?)"/>.
+/// </summary>
+/// <remarks>
+/// Lines that reference variables are expanded by the parser, so they are kept as source
+/// and parsed again on every run; all other lines reuse their parsed commands.
+/// </remarks>
+public sealed class CompiledScript
+{
+    private readonly CompiledLine[] _lines;
+
+    private CompiledScript(string source, CompiledLine[] lines)
+    {
+        Source = source;
+        _lines = lines;
+    }
+
+    /// <summary>
+    /// Gets the source text the script was compiled from.
+    /// </summary>
+    public string Source { get; }
+
+    /// <summary>
+    /// Gets the number of non-empty lines in the script.
+    /// </summary>
+    public int LineCount => _lines.Length;
+
+    /// <summary>
+    /// Gets the number of lines that are parsed again on each run because they reference variables.
+    /// </summary>
+    public int DeferredLineCount => _lines.Count(line => line.Statements == null);
+
+    internal IReadOnlyList<CompiledLine> Lines => _lines;
+
+    /// <summary>
+    /// Compiles the given logical lines. Must run inside a <see cref="CoreConsole"/> sink scope
+    /// so parse diagnostics reach the host.
+    /// </summary>
+    internal static CompiledScript Compile(string source, IEnumerable<string> lines)
+    {
+        var compiled = new List<CompiledLine>();
+        foreach (string line in lines)
+        {
+            if (string.IsNullOrWhiteSpace(line))
+            {
+                continue;
+            }
+
+            List<List<ParsedCommand>>? statements = null;
+            if (!ReferencesVariables(line))
+            {
+                statements = Parser.Parse(line);
+                foreach (List<ParsedCommand> statement in statements)
+                {
+                    ResolveBindings(statement);
+                }
+            }
+
+            compiled.Add(new CompiledLine(line, statements));
+        }
+
+        return new CompiledScript(source, compiled.ToArray());
+    }
+
+    private static bool ReferencesVariables(string line)
+    {
+        ReadOnlySpan<char> text = line;
+        int position = 0;
+        while (position < text.Length)
+        {
+            position += Lexer.Scan(text, position, out TokenType type);
+            if (type == TokenType.Variable)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /// <summary>
+    /// Replaces each command found at compile time with a bound copy, before the pipeline is published.
+    /// Sub-expression pipelines are bound in place, which also updates the external argument list that shares them.
+    /// </summary>
+    internal static void ResolveBindings(List<ParsedCommand> pipeline)
+    {
+        for (int i = 0; i < pipeline.Count; i++)
+        {
+            ParsedCommand command = pipeline[i];
+            foreach (object argument in command.Arguments)
+            {
+                if (argument is List<ParsedCommand> subPipeline)
+                {
+                    ResolveBindings(subPipeline);
+                }
+            }
+
+            Type? cmdletType = CommandDiscovery.Find(command.CommandName);
+            if (cmdletType != null)
+            {
+                pipeline[i] = command.WithBinding(CommandDiscovery.GetBindingInfo(cmdletType));
+            }
+        }
+    }
+
+    /// <summary>
+    /// One source line and, unless deferred, its parsed statements.
+    /// </summary>
+    internal sealed record CompiledLine(string Source, List<List<ParsedCommand>>? Statements);
+}
@@ -0,0 +1,126 @@
+using System.IO.Enumeration;
+using System.Threading.Channels;
+using ArbSh.Core.Models;
+
+namespace ArbSh.Core;
+
+/// <summary>
+/// Streams the entries of a directory, optionally walking subdirectories in parallel.
+/// Entries are produced straight from the enumeration (no <see cref="FileSystemInfo"/> per entry),
+/// so listing a directory never reads per-file metadata.
+/// </summary>
+internal static class DirectoryWalker
+{
+    /// <summary>
+    /// Maximum number of directories enumerated concurrently in a recursive walk.
+    /// </summary>
+    public static readonly int MaxConcurrency = Math.Clamp(Environment.ProcessorCount, 1, 8);
+
+    private const int OutputCapacity = 1024;
+
+    /// <summary>
+    /// Enumerates the direct children of <paramref name="directory"/> lazily.
+    /// Errors opening the directory surface on the first <c>MoveNext</c>.
+    /// </summary>
+    /// <param name="directory">The absolute directory path.</param>
+    /// <param name="includeHidden">Whether hidden and system entries are included.</param>
+    /// <returns>The entries in file system order.</returns>
+    public static IEnumerable<DirectoryEntry> Enumerate(string directory, bool includeHidden)
+    {
+        return CreateEnumerable(directory, string.Empty, includeHidden, new EnumerationOptions
+        {
+            IgnoreInaccessible = false,
+            AttributesToSkip = 0
+        });
+    }
+
+    /// <summary>
+    /// Walks <paramref name="root"/> and all of its subdirectories using up to <see cref="MaxConcurrency"/>
+    /// thread-pool workers. Entry names are relative to <paramref name="root"/>; the order across
+    /// directories is not defined. Inaccessible subdirectories and directory links are skipped.
+    /// </summary>
+    /// <param name="root">The absolute directory path.</param>
+    /// <param name="includeHidden">Whether hidden and system entries are included.</param>
+    /// <param name="cancellationToken">Stops the walk when the consumer is no longer reading.</param>
+    /// <returns>The entries, produced while the walk is in progress.</returns>
+    public static IAsyncEnumerable<DirectoryEntry> WalkAsync(string root, bool includeHidden, CancellationToken cancellationToken)
+    {
+        var output = Channel.CreateBounded<DirectoryEntry>(new BoundedChannelOptions(OutputCapacity)
+        {
+            SingleReader = true,
+            FullMode = BoundedChannelFullMode.Wait
+        });
+        var pending = Channel.CreateUnbounded<(string Path, string Prefix)>();
+        var options = new EnumerationOptions { IgnoreInaccessible = true, AttributesToSkip = 0 };
+        int outstanding = 1;
+
+        pending.Writer.TryWrite((root, string.Empty));
+
+        async Task WorkerAsync()
+        {
+            await foreach ((string path, string prefix) in pending.Reader.ReadAllAsync(cancellationToken).ConfigureAwait(false))
+            {
+                try
+                {
+                    foreach (DirectoryEntry entry in CreateEnumerable(path, prefix, includeHidden, options))
+                    {
+                        if (entry.IsDirectory && !IsLink(entry.FullPath))
+                        {
+                            Interlocked.Increment(ref outstanding);
+                            pending.Writer.TryWrite((entry.FullPath, entry.Name + "/"));
+                        }
+
+                        await output.Writer.WriteAsync(entry, cancellationToken).ConfigureAwait(false);
+                    }
+                }
+                catch (Exception ex) when (prefix.Length > 0 && ex is IOException or UnauthorizedAccessException)
+                {
+                    // A subdirectory that vanished or cannot be opened does not stop the walk; the root does.
+                }
+                finally
+                {
+                    if (Interlocked.Decrement(ref outstanding) == 0)
+                    {
+                        pending.Writer.TryComplete();
+                    }
+                }
+            }
+        }
+
+        Task[] workers = Enumerable.Range(0, MaxConcurrency).Select(_ => Task.Run(WorkerAsync, cancellationToken)).ToArray();
+        _ = Task.WhenAll(workers).ContinueWith(
+            completed => output.Writer.TryComplete(completed.IsCanceled ? null : completed.Exception?.GetBaseException()),
+            CancellationToken.None,
+            TaskContinuationOptions.ExecuteSynchronously,
+            TaskScheduler.Default);
+
+        return output.Reader.ReadAllAsync(cancellationToken);
+    }
+
+    private static FileSystemEnumerable<DirectoryEntry> CreateEnumerable(string directory, string prefix, bool includeHidden, EnumerationOptions options)
+    {
+        return new FileSystemEnumerable<DirectoryEntry>(
+            directory,
+            (ref FileSystemEntry entry) => new DirectoryEntry(
+                prefix + entry.FileName.ToString(),
+                entry.ToFullPath(),
+                entry.IsDirectory),
+            options)
+        {
+            ShouldIncludePredicate = (ref FileSystemEntry entry) => includeHidden || !IsHiddenOrSystem(ref entry)
+        };
+    }
+
+    private static bool IsHiddenOrSystem(ref FileSystemEntry entry)
+    {
+        // On Unix IsHidden is a name check; attributes would cost an lstat per entry.
+        return OperatingSystem.IsWindows()
+            ? (entry.Attributes & (FileAttributes.Hidden | FileAttributes.System)) != 0
+            : entry.IsHidden;
+    }
+
+    private static bool IsLink(string directory)
+    {
+        return (File.GetAttributes(directory) & FileAttributes.ReparsePoint) != 0;
+    }
+}
@@ -1,9 +1,8 @@
 ﻿using System;
 using System.Collections.Generic;
 using System.Linq;
-using System.Reflection;
-using System.Collections.Concurrent;
 using System.ComponentModel;
+using System.Diagnostics;
 using System.IO; // For StreamWriter
 using System.Threading.Tasks; // Added for Task support
 using ArbSh.Core.Commands;
@@ -12,13 +11,15 @@ using static ArbSh.Core.ParsedCommand; // For RedirectionInfo etc.
 namespace ArbSh.Core
 {
     /// <summary>
-    /// Responsible for executing parsed commands and managing the pipeline using Tasks for concurrency.
+    /// Responsible for executing parsed commands and managing the pipeline.
+    /// Each statement's stages run as cooperative async tasks on a <see cref="PipelineScheduler"/>
+    /// pumped by the calling thread, so deep or nested pipelines do not tie up thread-pool workers.
     /// </summary>
     public static class Executor
     {
         /// <summary>
         /// Executes a list of statements, where each statement is a list of parsed commands forming a pipeline.
-        /// Executes pipeline stages concurrently within each statement.
+        /// Executes pipeline stages cooperatively within each statement on the calling thread.
         /// </summary>
         /// <param name="allStatements">A list where each element is a list of ParsedCommand objects for a single statement's pipeline.</param>
         /// <param name="sink">The output sink for host rendering.</param>
@@ -29,7 +30,7 @@ namespace ArbSh.Core
             ExecutionOptions? options = null)
         {
             using var sinkScope = CoreConsole.PushSink(sink, options);
-            CoreConsole.WriteLine($"DEBUG (Executor): Executing {allStatements.Count} statement(s)...");
+            CoreConsole.LogDebug("Executor", $"Executing {allStatements.Count} statement(s)...");
 
             foreach (var statementCommands in allStatements)
             {
@@ -38,68 +39,83 @@ namespace ArbSh.Core
                     continue; // Skip empty statements
                 }
 
-                CoreConsole.WriteLine($"DEBUG (Executor): --- Executing Statement ({statementCommands.Count} command(s)) ---");
+                CoreConsole.LogDebug("Executor", $"--- Executing Statement ({statementCommands.Count} command(s)) ---");
 
-                // Pipeline execution using Tasks for concurrency.
-                BlockingCollection<PipelineObject>? inputForCurrentStage = null; 
+                // Pipeline execution using cooperative stage tasks.
+                // Stages are linked by bounded channels, so a fast producer waits for a slow consumer
+                // instead of buffering its whole output in memory. Waiting stages are suspended, not blocked:
+                // the scheduler only runs while this thread pumps it.
+                var scheduler = new PipelineScheduler();
+                PipelineChannel? inputForCurrentStage = null; 
                 List<Task> pipelineTasks = new List<Task>(); // List to hold tasks for the current pipeline
-                BlockingCollection<PipelineObject>? outputOfLastStage = null; // To hold the final output collection
-                StreamReader? inputRedirectReader = null; // For handling < redirection
+                PipelineChannel? outputOfLastStage = null; // To hold the final output channel
+                RedirectionLineReader? inputRedirectReader = null; // For handling < redirection
+                ExternalProcessStage? previousExternalStage = null; // Adjacent external stages are joined process to process
+                string? externalInputPath = null; // '<' file copied as bytes to a first-stage external command
 
                 // --- Handle Input Redirection for the FIRST command ---
-                if (statementCommands.Count > 0 && !string.IsNullOrEmpty(statementCommands[0].InputRedirectPath))
+                // External programs get the file's bytes unchanged on stdin instead of decoded lines.
+                if (!string.IsNullOrEmpty(statementCommands[0].InputRedirectPath) && IsExternalCommand(statementCommands[0]))
+                {
+                    externalInputPath = ShellSessionContext.ResolvePath(statementCommands[0].InputRedirectPath!);
+                    CoreConsole.LogDebug("Executor", $"Input redirection from '{externalInputPath}' goes to the external command's stdin.");
+                }
+                else if (statementCommands.Count > 0 && !string.IsNullOrEmpty(statementCommands[0].InputRedirectPath))
                 {
                     string inputFile = ShellSessionContext.ResolvePath(statementCommands[0].InputRedirectPath!);
-                    CoreConsole.WriteLine($"DEBUG (Executor): Attempting input redirection from '{inputFile}' for first command.");
+                    CoreConsole.LogDebug("Executor", $"Attempting input redirection from '{inputFile}' for first command.");
                     try
                     {
-                        // Use UTF8 without BOM by default for reading
-                        var utf8NoBom = new System.Text.UTF8Encoding(false); 
-                        inputRedirectReader = new StreamReader(inputFile, utf8NoBom);
+                        // Large pooled buffers decoded in chunks; big files are memory-mapped.
+                        inputRedirectReader = RedirectionLineReader.Open(inputFile, options);
                         
-                        // Prepare a collection to feed the file content into the first stage
-                        var fileInputCollection = new BlockingCollection<PipelineObject>();
+                        // Prepare a channel to feed the file content into the first stage
+                        var fileInputCollection = PipelineChannel.Create(options);
                         inputForCurrentStage = fileInputCollection; // This will be the input for the first stage
 
-                        // Start a task to read the file and populate the collection asynchronously
-                        // This prevents blocking the main executor thread if the file is large.
-                        Task.Run(() => {
+                        // Start a stage task that reads the file and feeds the channel asynchronously.
+                        // It is awaited together with the cmdlet stages so the reader is always disposed.
+                        pipelineTasks.Add(scheduler.Start(async () => {
                             try
                             {
                                 string? line;
-                                while ((line = inputRedirectReader.ReadLine()) != null)
+                                while ((line = await inputRedirectReader.ReadLineAsync()) != null)
                                 {
-                                    fileInputCollection.Add(new PipelineObject(line));
+                                    // WriteAsync waits while the first stage is behind; false means it stopped consuming.
+                                    if (!await fileInputCollection.WriteAsync(new PipelineObject(line)))
+                                    {
+                                        break;
+                                    }
                                 }
                             }
                             catch (Exception ex)
                             {
                                 // Log error reading file - maybe add error object to collection?
                                 CoreConsole.ForegroundColor = ConsoleColor.Red;
-                                CoreConsole.WriteLine($"ERROR reading input redirect file '{inputFile}': {ex.Message}");
+                                CoreConsole.LogError("Executor", $"Failed reading input redirect file '{inputFile}': {ex.Message}");
                                 CoreConsole.ResetColor();
                                 // Add an error object to signal downstream cmdlets?
-                                fileInputCollection.Add(new PipelineObject($"ERROR reading input file: {ex.Message}", isError: true));
+                                fileInputCollection.Write(new PipelineObject($"ERROR reading input file: {ex.Message}", isError: true));
                             }
                             finally
                             {
-                                fileInputCollection.CompleteAdding(); // Signal end of file input
+                                await fileInputCollection.CompleteAsync(); // Signal end of file input
                                 inputRedirectReader?.Dispose(); // Dispose the reader when done
-                                CoreConsole.WriteLine($"DEBUG (Executor): Finished reading input redirect file '{inputFile}'. Input collection marked complete.");
+                                CoreConsole.LogDebug("Executor", $"Finished reading input redirect file '{inputFile}'. Input collection marked complete.");
                             }
-                        });
+                        }));
                     }
                     catch (Exception ex)
                     {
                         // Handle file open errors (e.g., FileNotFoundException, IOException)
                         CoreConsole.ForegroundColor = ConsoleColor.Red;
-                        CoreConsole.WriteLine($"ERROR opening input redirect file '{inputFile}': {ex.Message}");
+                        CoreConsole.LogError("Executor", $"Failed opening input redirect file '{inputFile}': {ex.Message}");
                         CoreConsole.ResetColor();
                         // Can't proceed with this statement if input redirection fails critically
                         // We could add an error object to a dummy input collection, or just skip the statement.
                         // Let's skip the statement for now.
-                        inputForCurrentStage = new BlockingCollection<PipelineObject>(); // Provide empty input
-                        inputForCurrentStage.CompleteAdding(); // Mark as complete immediately
+                        inputForCurrentStage = PipelineChannel.Create(options); // Provide empty input
+                        inputForCurrentStage.Complete(); // Mark as complete immediately
                         // Skip setting up tasks for this statement by breaking the loop
                         break; 
                     }
@@ -112,7 +128,7 @@ namespace ArbSh.Core
                     // Capture loop variables for closure to avoid issues in lambda expressions
                     var currentCommand = statementCommands[i];
                     var currentInputCollection = inputForCurrentStage; // Input for *this* stage comes from the previous stage's output
-                    var outputCollection = new BlockingCollection<PipelineObject>(); // Output collection for *this* stage
+                    var outputCollection = PipelineChannel.Create(options); // Output channel for *this* stage
                     bool isLastStage = (i == statementCommands.Count - 1);
 
                     // Prepare the output of this stage to be the input for the next stage
@@ -123,73 +139,110 @@ namespace ArbSh.Core
                     }
 
                     string commandName = currentCommand.CommandName; // Use captured variable
-                    CoreConsole.WriteLine($"DEBUG (Executor Pipeline): Preparing stage {i}: '{commandName}'...");
+                    CoreConsole.LogDebug("Executor Pipeline", $"Preparing stage {i}: '{commandName}'...");
 
                     // --- Cmdlet Discovery ---
-                    Type? cmdletType = CommandDiscovery.Find(commandName);
+                    // Compiled scripts carry the binding resolved at compile time; otherwise look the command up now.
+                    CmdletBindingInfo? bindingInfo = ResolveBinding(currentCommand);
 
-                    // TODO: Add logic here to check for external commands if cmdletType is null
-                    // TODO: Implement redirection handling *before* cmdlet execution (e.g., setting StdOut/StdErr for the task/process)
+                    // Commands that are not cmdlets are looked up as executables.
+                    ExternalProcessStage? externalStage = bindingInfo == null ? ResolveExternalStage(currentCommand) : null;
+
+                    if (externalStage != null)
+                    {
+                        if (previousExternalStage != null)
+                        {
+                            // a | b with two programs: bytes go from one process to the next, not through the channel.
+                            previousExternalStage.PipeTo(externalStage);
+                        }
+                        else if (i == 0)
+                        {
+                            externalStage.InputFilePath = externalInputPath;
+                        }
 
-                    if (cmdletType != null)
+                        previousExternalStage = externalStage;
+                        var stage = externalStage;
+                        var stageStats = new PipelineStageStats(currentCommand.CommandName);
+                        pipelineTasks.Add(scheduler.Start(() =>
+                            RunExternalStageAsync(stage, currentCommand, currentInputCollection, outputCollection, stageStats)));
+                    }
+                    else if (bindingInfo != null)
                     {
+                        previousExternalStage = null;
                         // --- Create and add the task for this pipeline stage ---
-                        var pipelineTask = Task.Run(() =>
+                        var pipelineTask = scheduler.Start(async () =>
                         {
                             CmdletBase? cmdletInstance = null; // Instance specific to this task
-                            CoreConsole.WriteLine($"DEBUG (Executor Task): Starting task for '{currentCommand.CommandName}'...");
+                            var stageStats = new PipelineStageStats(currentCommand.CommandName);
+                            long stageStart = Stopwatch.GetTimestamp();
+                            CoreConsole.LogDebug("Executor Task", $"Starting task for '{currentCommand.CommandName}'...");
                             try
                             {
                                 // --- Instantiate Cmdlet (Inside Task) ---
-                                cmdletInstance = Activator.CreateInstance(cmdletType) as CmdletBase;
-                                if (cmdletInstance == null)
-                                {
-                                    // Log error and potentially signal pipeline failure
-                                    throw new InvalidOperationException($"Failed to activate cmdlet type {cmdletType.FullName}");
-                                }
+                                // Uses the compiled factory from the cached binding metadata.
+                                cmdletInstance = bindingInfo.Factory();
 
                                 // --- Parameter Binding Step (Inside Task) ---
-                                BindParameters(cmdletInstance, currentCommand); // Use captured command
+                                BindParameters(cmdletInstance, bindingInfo, currentCommand); // Use captured command
+                                stageStats.BindTime = Stopwatch.GetElapsedTime(stageStart);
 
                                 // Assign the output collection for this stage to the cmdlet instance
                                 cmdletInstance.OutputCollection = outputCollection;
 
                                 // --- Cmdlet Execution Lifecycle (Inside Task) ---
                                 cmdletInstance.BeginProcessing();
+                                await outputCollection.FlushAsync();
 
                                 // Process pipeline input (if any) from the previous stage
                                 if (currentInputCollection != null)
                                 {
-                                    CoreConsole.WriteLine($"DEBUG (Executor Task): '{currentCommand.CommandName}' consuming input...");
-                                    // Consume the input from the previous command's output collection
-                                    // GetConsumingEnumerable blocks until the collection is marked CompleteAdding or items are available
-                                    foreach (var inputObject in currentInputCollection.GetConsumingEnumerable())
+                                    CoreConsole.LogDebug("Executor Task", $"'{currentCommand.CommandName}' consuming input...");
+                                    // Consume the input from the previous command's output channel one batch at a time.
+                                    // WaitToReadAsync suspends this stage until a batch is published or the channel is completed.
+                                    while (await currentInputCollection.WaitToReadAsync())
                                     {
-                                        // Bind parameters that accept pipeline input *before* calling ProcessRecord
-                                        cmdletInstance.BindPipelineParameters(inputObject);
+                                        while (currentInputCollection.TryRead(out ArraySegment<PipelineObject> inputBatch))
+                                        {
+                                            foreach (var inputObject in inputBatch)
+                                            {
+                                                // Bind parameters that accept pipeline input *before* calling ProcessRecord
+                                                cmdletInstance.BindPipelineParameters(inputObject);
+
+                                                // Now process the record. Most cmdlets finish synchronously; skipping the
+                                                // await then keeps the per-item cost of this loop as low as a direct call.
+                                                ValueTask processing = cmdletInstance.ProcessRecordAsync(inputObject);
+                                                if (!processing.IsCompletedSuccessfully)
+                                                {
+                                                    await processing;
+                                                }
+                                            }
 
-                                        // Now process the record
-                                        cmdletInstance.ProcessRecord(inputObject);
+                                            // Items are copied out; hand the batch array back to the pool.
+                                            currentInputCollection.Release(inputBatch);
+
+                                            // Publish whatever this batch produced; suspends while the next stage is behind.
+                                            await outputCollection.FlushAsync();
+                                        }
                                     }
-                                    CoreConsole.WriteLine($"DEBUG (Executor Task): '{currentCommand.CommandName}' finished consuming input.");
+                                    CoreConsole.LogDebug("Executor Task", $"'{currentCommand.CommandName}' finished consuming input.");
                                 }
                                 else
                                 {
-                                    CoreConsole.WriteLine($"DEBUG (Executor Task): '{currentCommand.CommandName}' has no pipeline input, calling ProcessRecord once.");
+                                    CoreConsole.LogDebug("Executor Task", $"'{currentCommand.CommandName}' has no pipeline input, calling ProcessRecord once.");
                                     // Call ProcessRecord once even without pipeline input,
                                     // allowing cmdlets like الأوامر or اطبع with arguments to run.
                                     // TODO: Handle subexpression arguments here - execute them first?
-                                    cmdletInstance.ProcessRecord(null);
+                                    await cmdletInstance.ProcessRecordAsync(null);
                                 }
 
-                                cmdletInstance.EndProcessing();
-                                CoreConsole.WriteLine($"DEBUG (Executor Task): '{currentCommand.CommandName}' finished processing.");
+                                await cmdletInstance.EndProcessingAsync();
+                                CoreConsole.LogDebug("Executor Task", $"'{currentCommand.CommandName}' finished processing.");
                             }
                             catch (ParameterBindingException bindEx)
                             {
                                 // Log binding errors - these stop the *current* cmdlet task
                                 CoreConsole.ForegroundColor = ConsoleColor.Red;
-                                CoreConsole.WriteLine($"Task Error (ParameterBinding) in '{currentCommand.CommandName}': {bindEx.Message}");
+                                CoreConsole.LogError("ParameterBinding", $"Task '{currentCommand.CommandName}': {bindEx.Message}");
                                 CoreConsole.ResetColor();
                                 // Re-throw to mark the task as faulted
                                 throw;
@@ -198,7 +251,7 @@ namespace ArbSh.Core
                             {
                                 // Log general cmdlet execution errors
                                 CoreConsole.ForegroundColor = ConsoleColor.Magenta;
-                                CoreConsole.WriteLine($"Task Error in '{currentCommand.CommandName}': {ex.GetType().Name} - {ex.Message}");
+                                CoreConsole.LogError("Executor", $"Task '{currentCommand.CommandName}' failed: {ex.GetType().Name} - {ex.Message}");
                                 // Consider adding ex.StackTrace for detailed debugging
                                 CoreConsole.ResetColor();
                                 // Re-throw to mark the task as faulted
@@ -206,13 +259,23 @@ namespace ArbSh.Core
                             }
                             finally
                             {
-                                // CRITICAL: Signal that this stage is done adding items to its output collection.
-                                // This unblocks the GetConsumingEnumerable() in the *next* stage's task (if any)
+                                // CRITICAL: Signal that this stage is done adding items to its output channel.
+                                // This unblocks the reader in the *next* stage's task (if any)
                                 // or allows the final output handling to proceed.
-                                outputCollection.CompleteAdding();
-                                CoreConsole.WriteLine($"DEBUG (Executor Task): Stage '{currentCommand.CommandName}' completed adding output.");
+                                await outputCollection.CompleteAsync();
+
+                                // Release the previous stage if this one stopped early (e.g. it faulted),
+                                // otherwise it would wait forever on a full channel nobody reads.
+                                currentInputCollection?.Discard();
+
+                                if (cmdletInstance is IAsyncDisposable disposable)
+                                {
+                                    await disposable.DisposeAsync();
+                                }
+                                stageStats.Complete(currentInputCollection, outputCollection, stageStart);
+                                CoreConsole.LogDebug("Executor Task", $"Stage '{currentCommand.CommandName}' completed adding output.");
                             }
-                        }); // End Task.Run
+                        }); // End stage task
 
                         pipelineTasks.Add(pipelineTask);
                     }
@@ -223,55 +286,20 @@ namespace ArbSh.Core
                         CoreConsole.WriteLine($"الأمر غير موجود: {currentCommand.CommandName}. سيتم إيقاف إعداد خط الأنابيب لهذه العبارة.");
                         CoreConsole.ResetColor();
 
-                        // Clean up collections created so far for this statement to prevent deadlocks
-                        inputForCurrentStage?.CompleteAdding(); // Mark the current output as complete
-                        currentInputCollection?.Dispose(); // Dispose the input collection we were going to read from
-                        outputCollection.Dispose(); // Dispose the collection we just created
+                        // Discard the channel we were going to read from so earlier stages do not block on it.
+                        // The stages that were already started are run to completion, and their faults observed,
+                        // by the wait below like any other statement's stages.
+                        currentInputCollection?.Discard();
+                        outputCollection.Discard();
 
-                        pipelineTasks.Clear(); // Prevent waiting on an incomplete/invalid pipeline
                         outputOfLastStage = null; // Ensure we don't try to process output from a failed pipeline
                         break; // Stop setting up more stages for this statement
                     }
                 } // End of pipeline stage setup loop for the current statement
 
-                // --- Wait for all tasks in the current statement's pipeline to complete ---
-                if (pipelineTasks.Any())
-                {
-                    CoreConsole.WriteLine($"DEBUG (Executor): Waiting for {pipelineTasks.Count} task(s) in the pipeline to complete...");
-                    try
-                    {
-                        // Wait for all tasks associated with the current statement's pipeline
-                        Task.WhenAll(pipelineTasks).Wait();
-                        CoreConsole.WriteLine($"DEBUG (Executor): All pipeline tasks for the statement completed.");
-                    }
-                    catch (AggregateException ae)
-                    {
-                        // Log errors from faulted tasks
-                        CoreConsole.ForegroundColor = ConsoleColor.DarkRed;
-                        CoreConsole.WriteLine($"ERROR (Executor): One or more pipeline tasks failed:");
-                        foreach (var ex in ae.Flatten().InnerExceptions)
-                        {
-                            // Avoid logging the ParameterBindingException again if already logged in the task
-                            if (!(ex is ParameterBindingException))
-                            {
-                                CoreConsole.WriteLine($"  - {ex.GetType().Name}: {ex.Message}");
-                            }
-                        }
-                        CoreConsole.ResetColor();
-                        // Pipeline failed, don't process output. Fall through to cleanup.
-                        outputOfLastStage = null; // Prevent output processing
-                    }
-                    catch (Exception ex) // Catch other potential waiting errors
-                    {
-                        CoreConsole.ForegroundColor = ConsoleColor.DarkRed;
-                        CoreConsole.WriteLine($"ERROR (Executor): Unexpected error waiting for pipeline tasks: {ex.Message}");
-                        CoreConsole.ResetColor();
-                        outputOfLastStage = null; // Prevent output processing
-                    }
-                }
-
-                // --- Output Handling for the completed statement ---
-                // Process the output from the *last* stage's collection, if the pipeline didn't fail
+                // --- Output Handling for the statement ---
+                // Consume the output of the *last* stage while the pipeline is still running.
+                // The stage channels are bounded, so waiting for the tasks first could deadlock.
                 if (outputOfLastStage != null)
                 {
                     ParsedCommand lastCommandConfig = statementCommands.Last(); // Get config (like redirection) from the original last command
@@ -297,21 +325,21 @@ namespace ArbSh.Core
                                     if (redir.SourceStreamHandle == 2 && targetHandle == 1) // 2>&1
                                     {
                                         mergeStderrToStdout = true;
-                                        CoreConsole.WriteLine($"DEBUG (Executor): Detected stderr merge to stdout (2>&1).");
+                                        CoreConsole.LogDebug("Executor", $"Detected stderr merge to stdout (2>&1).");
                                     }
                                     else if (redir.SourceStreamHandle == 1 && targetHandle == 2) // 1>&2
                                     {
                                         mergeStdoutToStderr = true;
-                                        CoreConsole.WriteLine($"DEBUG (Executor): Detected stdout merge to stderr (1>&2).");
+                                        CoreConsole.LogDebug("Executor", $"Detected stdout merge to stderr (1>&2).");
                                     }
                                     else
                                     {
-                                         CoreConsole.WriteLine($"WARN (Executor): Stream handle redirection from {redir.SourceStreamHandle} to {redir.Target} is parsed but not yet implemented.");
+                                         CoreConsole.LogWarning("Executor", $"Stream handle redirection from {redir.SourceStreamHandle} to {redir.Target} is parsed but not yet implemented.");
                                     }
                                 }
                                 else
                                 {
-                                     CoreConsole.WriteLine($"WARN (Executor): Invalid target stream handle '{redir.Target}' in redirection.");
+                                     CoreConsole.LogWarning("Executor", $"Invalid target stream handle '{redir.Target}' in redirection.");
                                 }
                             }
 
@@ -334,14 +362,13 @@ namespace ArbSh.Core
                                         stdoutRedirectPath = ShellSessionContext.ResolvePath(redir.Target);
                                         try
                                         {
-                                            var utf8NoBom = new System.Text.UTF8Encoding(false);
-                                            stdoutRedirectWriter = new StreamWriter(stdoutRedirectPath, redir.Append, utf8NoBom);
-                                            CoreConsole.WriteLine($"DEBUG (Executor): Redirecting stdout {(redir.Append ? ">>" : ">")} {stdoutRedirectPath}");
+                                            stdoutRedirectWriter = RedirectionFile.OpenWriter(stdoutRedirectPath, redir.Append, options);
+                                            CoreConsole.LogDebug("Executor", $"Redirecting stdout {(redir.Append ? ">>" : ">")} {stdoutRedirectPath}");
                                         }
                                         catch (Exception ex)
                                         {
                                             CoreConsole.ForegroundColor = ConsoleColor.Red;
-                                            CoreConsole.WriteLine($"ERROR: Cannot open file '{stdoutRedirectPath}' for stdout redirection: {ex.Message}");
+                                            CoreConsole.LogError("Executor", $"Cannot open file '{stdoutRedirectPath}' for stdout redirection: {ex.Message}");
                                             CoreConsole.ResetColor();
                                             stdoutRedirectWriter = null; // Ensure it's null
                                             writeStdOutToConsole = true; // Fallback to console if file open fails
@@ -352,15 +379,14 @@ namespace ArbSh.Core
                                         stderrRedirectPath = ShellSessionContext.ResolvePath(redir.Target);
                                         try
                                         {
-                                            var utf8NoBom = new System.Text.UTF8Encoding(false);
-                                            stderrRedirectWriter = new StreamWriter(stderrRedirectPath, redir.Append, utf8NoBom);
-                                            CoreConsole.WriteLine($"DEBUG (Executor): Redirecting stderr {(redir.Append ? "2>>" : "2>")} {stderrRedirectPath}");
+                                            stderrRedirectWriter = RedirectionFile.OpenWriter(stderrRedirectPath, redir.Append, options);
+                                            CoreConsole.LogDebug("Executor", $"Redirecting stderr {(redir.Append ? "2>>" : "2>")} {stderrRedirectPath}");
                                             // writeStdErrToConsole = false; // Already handled above based on merge flags
                                         }
                                         catch (Exception ex)
                                         {
                                             CoreConsole.ForegroundColor = ConsoleColor.Red;
-                                            CoreConsole.WriteLine($"ERROR: Cannot open file '{stderrRedirectPath}' for stderr redirection: {ex.Message}");
+                                            CoreConsole.LogError("Executor", $"Cannot open file '{stderrRedirectPath}' for stderr redirection: {ex.Message}");
                                             CoreConsole.ResetColor();
                                             stderrRedirectWriter = null;
                                             writeStdErrToConsole = true; // Fallback stderr to console
@@ -368,7 +394,7 @@ namespace ArbSh.Core
                                     }
                                     else
                                     {
-                                        CoreConsole.WriteLine($"WARN (Executor): File redirection from unsupported source handle '{redir.SourceStreamHandle}' ignored.");
+                                        CoreConsole.LogWarning("Executor", $"File redirection from unsupported source handle '{redir.SourceStreamHandle}' ignored.");
                                     }
                                 }
                                 // Stream handle redirections were processed in the first pass
@@ -376,19 +402,20 @@ namespace ArbSh.Core
                         } // End if Redirections.Any()
 
                         // --- Consume and Distribute Output ---
-                        CoreConsole.WriteLine($"DEBUG (Executor Output): Checking final output. IsCompleted={outputOfLastStage.IsCompleted}, Count={outputOfLastStage.Count}, IsAddingCompleted={outputOfLastStage.IsAddingCompleted}");
-                        if (writeStdOutToConsole) CoreConsole.WriteLine("DEBUG (Executor Output): Writing final stdout output to Console...");
-                        if (stdoutRedirectWriter != null) CoreConsole.WriteLine($"DEBUG (Executor Output): Writing final stdout output to file '{stdoutRedirectPath}'...");
-                        if (writeStdErrToConsole) CoreConsole.WriteLine("DEBUG (Executor Output): Writing final stderr output to Console...");
-                        if (stderrRedirectWriter != null) CoreConsole.WriteLine($"DEBUG (Executor Output): Writing final stderr output to file '{stderrRedirectPath}'...");
+                        CoreConsole.LogDebug("Executor Output", $"Streaming final output. Capacity={outputOfLastStage.Capacity}, BatchSize={outputOfLastStage.BatchSize}");
+                        if (writeStdOutToConsole) CoreConsole.LogDebug("Executor Output", "Writing final stdout output to Console...");
+                        if (stdoutRedirectWriter != null) CoreConsole.LogDebug("Executor Output", $"Writing final stdout output to file '{stdoutRedirectPath}'...");
+                        if (writeStdErrToConsole) CoreConsole.LogDebug("Executor Output", "Writing final stderr output to Console...");
+                        if (stderrRedirectWriter != null) CoreConsole.LogDebug("Executor Output", $"Writing final stderr output to file '{stderrRedirectPath}'...");
 
                         int outputCount = 0;
-                        foreach (var finalOutput in outputOfLastStage.GetConsumingEnumerable())
+                        // Reading pumps the scheduler, so the stages run on this thread as output is demanded.
+                        foreach (var finalOutput in outputOfLastStage.GetConsumingEnumerable(scheduler))
                         {
                             outputCount++;
                             bool isError = finalOutput.IsError; // Use the flag from PipelineObject
-                            string outputString = finalOutput?.ToString() ?? string.Empty;
-                            CoreConsole.WriteLine($"DEBUG (Executor Output): Processing output item #{outputCount} (IsError={isError}): '{outputString}'");
+                            string outputString = finalOutput.ToString(); // Strings pass through without copying or boxing
+                            CoreConsole.LogDebug("Executor Output", $"Processing output item #{outputCount} (IsError={isError}): '{outputString}'");
 
                             // Determine target(s) based on error status and merge flags
                             // StreamWriter? primaryWriter = null; // Unused
@@ -408,7 +435,7 @@ namespace ArbSh.Core
                                     targetFilePath = stdoutRedirectPath;
                                     writeToConsole = writeStdOutToConsole; // Use stdout's console status
                                     consoleStream = CoreConsole.Out;    // Write to stdout console if applicable
-                                    CoreConsole.WriteLine($"DEBUG (Executor Output): Routing error object via 2>&1 merge.");
+                                    CoreConsole.LogDebug("Executor Output", $"Routing error object via 2>&1 merge.");
                                 }
                                 else // Normal error (stderr) or 2>file
                                 {
@@ -426,7 +453,7 @@ namespace ArbSh.Core
                                     targetFilePath = stderrRedirectPath;
                                     writeToConsole = writeStdErrToConsole; // Use stderr's console status
                                     consoleStream = CoreConsole.Error;   // Write to stderr console if applicable
-                                    CoreConsole.WriteLine($"DEBUG (Executor Output): Routing regular object via 1>&2 merge.");
+                                    CoreConsole.LogDebug("Executor Output", $"Routing regular object via 1>&2 merge.");
                                 }
                                 else // Normal output (stdout) or 1>file
                                 {
@@ -442,14 +469,14 @@ namespace ArbSh.Core
                             {
                                 try
                                 {
+                                    // Buffered: the writer reaches the disk when its buffer fills and when it is disposed.
                                     targetFileWriter.WriteLine(outputString);
-                                    targetFileWriter.Flush(); // Flush immediately for testing
-                                    CoreConsole.WriteLine($"DEBUG (Executor Output): Item #{outputCount} written and flushed to target file '{targetFilePath}'.");
+                                    CoreConsole.LogDebug("Executor Output", $"Item #{outputCount} written to target file '{targetFilePath}'.");
                                 }
                                 catch (Exception ex)
                                 {
                                     CoreConsole.ForegroundColor = ConsoleColor.Red;
-                                    CoreConsole.WriteLine($"ERROR: Failed writing/flushing to redirect file '{targetFilePath}': {ex.GetType().Name} - {ex.Message}");
+                                    CoreConsole.LogError("Executor", $"Failed writing/flushing to redirect file '{targetFilePath}': {ex.GetType().Name} - {ex.Message}");
                                     CoreConsole.ResetColor();
                                     try { targetFileWriter.Dispose(); } catch { /* Ignore */ }
                                     
@@ -483,8 +510,8 @@ namespace ArbSh.Core
                                 consoleStream.WriteLine(outputString);
                             }
                         }
-                         if (outputCount == 0 && outputOfLastStage.IsAddingCompleted) {
-                              CoreConsole.WriteLine("DEBUG (Executor Output): Final output collection is complete and empty.");
+                         if (outputCount == 0 && outputOfLastStage.IsCompleted) {
+                              CoreConsole.LogDebug("Executor Output", "Final output collection is complete and empty.");
                          }
                     }
                     catch (OperationCanceledException) { /* Expected if collection is empty and completed */ }
@@ -492,16 +519,17 @@ namespace ArbSh.Core
                     {
                         // Catch unexpected errors during final output processing
                         CoreConsole.ForegroundColor = ConsoleColor.DarkCyan;
-                        CoreConsole.WriteLine($"ERROR: Unexpected error processing final output: {ex.Message}");
+                        CoreConsole.LogError("Executor", $"Unexpected error processing final output: {ex.Message}");
                         CoreConsole.ResetColor();
                     }
                     finally
                     {
-                        // Dispose any open stream writers
-                        stdoutRedirectWriter?.Dispose(); // Use null-conditional operator
-                        stderrRedirectWriter?.Dispose(); // Use null-conditional operator
+                        // Dispose any open stream writers; this writes out their last buffered batch
+                        CloseRedirectWriter(stdoutRedirectWriter, stdoutRedirectPath);
+                        CloseRedirectWriter(stderrRedirectWriter, stderrRedirectPath);
                         
-                        outputOfLastStage.Dispose(); // Dispose the final collection
+                        // Stop the last stage from blocking if output handling ended early
+                        outputOfLastStage.Discard();
                     }
                 }
                 else // outputOfLastStage was null (likely pipeline setup failed)
@@ -509,13 +537,48 @@ namespace ArbSh.Core
                     // Check if there were any commands to begin with, to avoid redundant message if statement was empty
                     if (statementCommands.Any())
                     {
-                        CoreConsole.WriteLine($"DEBUG (Executor): No final output to process (pipeline might have failed or produced no output).");
+                        CoreConsole.LogDebug("Executor", $"No final output to process (pipeline might have failed or produced no output).");
+                    }
+                }
+                // --- Wait for all tasks in the current statement's pipeline to complete ---
+                if (pipelineTasks.Any())
+                {
+                    CoreConsole.LogDebug("Executor", $"Waiting for {pipelineTasks.Count} task(s) in the pipeline to complete...");
+                    try
+                    {
+                        // Pump the remaining work for the current statement's pipeline, then observe faults
+                        Task allStages = Task.WhenAll(pipelineTasks);
+                        scheduler.RunUntilComplete(allStages);
+                        allStages.Wait();
+                        CoreConsole.LogDebug("Executor", $"All pipeline tasks for the statement completed.");
+                    }
+                    catch (AggregateException ae)
+                    {
+                        // Log errors from faulted tasks
+                        CoreConsole.ForegroundColor = ConsoleColor.DarkRed;
+                        CoreConsole.LogError("Executor", $"One or more pipeline tasks failed:");
+                        foreach (var ex in ae.Flatten().InnerExceptions)
+                        {
+                            // Avoid logging the ParameterBindingException again if already logged in the task
+                            if (!(ex is ParameterBindingException))
+                            {
+                                CoreConsole.LogError("Executor", $"  - {ex.GetType().Name}: {ex.Message}");
+                            }
+                        }
+                        CoreConsole.ResetColor();
+                    }
+                    catch (Exception ex) // Catch other potential waiting errors
+                    {
+                        CoreConsole.ForegroundColor = ConsoleColor.DarkRed;
+                        CoreConsole.LogError("Executor", $"Unexpected error waiting for pipeline tasks: {ex.Message}");
+                        CoreConsole.ResetColor();
                     }
                 }
-                CoreConsole.WriteLine($"DEBUG (Executor): --- Statement execution finished ---");
+
+                CoreConsole.LogDebug("Executor", $"--- Statement execution finished ---");
 
             } // End of loop for all statements
-            CoreConsole.WriteLine($"DEBUG (Executor): All statements executed.");
+            CoreConsole.LogDebug("Executor", $"All statements executed.");
         }
 
         /// <summary>
@@ -580,22 +643,22 @@ namespace ArbSh.Core
                             {
                                 int targetArgumentIndex = positionalToArgumentIndex[currentPositionalIndex];
                                 context.ArgumentTypeOverrides[targetArgumentIndex] = targetType;
-                                CoreConsole.WriteLine($"DEBUG (TypeLiteral): Type literal '[{typeName}]' will convert positional argument {currentPositionalIndex} (at argument index {targetArgumentIndex}) to {targetType.Name}");
+                                CoreConsole.LogDebug("TypeLiteral", $"Type literal '[{typeName}]' will convert positional argument {currentPositionalIndex} (at argument index {targetArgumentIndex}) to {targetType.Name}");
                                 currentPositionalIndex++; // Move to next positional argument for subsequent type literals
                             }
                             else
                             {
-                                CoreConsole.WriteLine($"WARN (TypeLiteral): Type literal '[{typeName}]' at index {i} has no corresponding positional argument");
+                                CoreConsole.LogWarning("TypeLiteral", $"Type literal '[{typeName}]' at index {i} has no corresponding positional argument");
                             }
                         }
                         else
                         {
-                            CoreConsole.WriteLine($"WARN (TypeLiteral): Could not resolve type name '{typeName}' from type literal at index {i}");
+                            CoreConsole.LogWarning("TypeLiteral", $"Could not resolve type name '{typeName}' from type literal at index {i}");
                         }
                     }
                     catch (Exception ex)
                     {
-                        CoreConsole.WriteLine($"ERROR (TypeLiteral): Failed to process type literal '{typeName}' at index {i}: {ex.Message}");
+                        CoreConsole.LogError("TypeLiteral", $"Failed to process type literal '{typeName}' at index {i}: {ex.Message}");
                     }
 
                     // Mark the type literal as used so it doesn't get processed as a regular argument
@@ -606,6 +669,26 @@ namespace ArbSh.Core
             return context;
         }
 
+        // Common type literal aliases, shared by every binding call.
+        private static readonly Dictionary<string, Type> TypeAliases = new Dictionary<string, Type>(StringComparer.OrdinalIgnoreCase)
+        {
+            { "int", typeof(int) },
+            { "string", typeof(string) },
+            { "bool", typeof(bool) },
+            { "double", typeof(double) },
+            { "float", typeof(float) },
+            { "decimal", typeof(decimal) },
+            { "long", typeof(long) },
+            { "short", typeof(short) },
+            { "byte", typeof(byte) },
+            { "char", typeof(char) },
+            { "object", typeof(object) },
+            { "datetime", typeof(DateTime) },
+            { "timespan", typeof(TimeSpan) },
+            { "guid", typeof(Guid) },
+            { "consolecolor", typeof(ConsoleColor) }
+        };
+
         /// <summary>
         /// Resolves a type name string to an actual Type object.
         /// Supports both simple names (int, string) and fully qualified names (CoreConsoleColor).
@@ -615,26 +698,7 @@ namespace ArbSh.Core
         private static Type? ResolveTypeName(string typeName)
         {
             // Handle common type aliases
-            var typeAliases = new Dictionary<string, Type>(StringComparer.OrdinalIgnoreCase)
-            {
-                { "int", typeof(int) },
-                { "string", typeof(string) },
-                { "bool", typeof(bool) },
-                { "double", typeof(double) },
-                { "float", typeof(float) },
-                { "decimal", typeof(decimal) },
-                { "long", typeof(long) },
-                { "short", typeof(short) },
-                { "byte", typeof(byte) },
-                { "char", typeof(char) },
-                { "object", typeof(object) },
-                { "datetime", typeof(DateTime) },
-                { "timespan", typeof(TimeSpan) },
-                { "guid", typeof(Guid) },
-                { "consolecolor", typeof(ConsoleColor) }
-            };
-
-            if (typeAliases.TryGetValue(typeName, out Type? aliasType))
+            if (TypeAliases.TryGetValue(typeName, out Type? aliasType))
             {
                 return aliasType;
             }
@@ -662,16 +726,118 @@ namespace ArbSh.Core
         }
 
         /// <summary>
-        /// Binds parameters from the parsed command to the cmdlet instance using reflection.
+        /// Flushes and closes an output redirection writer, reporting a failed final write instead of throwing.
+        /// </summary>
+        private static void CloseRedirectWriter(StreamWriter? writer, string? path)
+        {
+            if (writer == null)
+            {
+                return;
+            }
+
+            try
+            {
+                writer.Dispose();
+            }
+            catch (Exception ex)
+            {
+                CoreConsole.LogError("Executor", $"Failed writing/flushing to redirect file '{path}': {ex.GetType().Name} - {ex.Message}");
+            }
+        }
+
+        /// <summary>
+        /// Returns the binding metadata of a command: the one resolved at compile time if present,
+        /// otherwise the result of a <see cref="CommandDiscovery"/> lookup. Null if the command is not found.
+        /// </summary>
+        private static CmdletBindingInfo? ResolveBinding(ParsedCommand command)
+        {
+            if (command.Binding != null)
+            {
+                return command.Binding;
+            }
+
+            Type? cmdletType = CommandDiscovery.Find(command.CommandName);
+            return cmdletType != null ? CommandDiscovery.GetBindingInfo(cmdletType) : null;
+        }
+
+        /// <summary>
+        /// Indicates whether a command resolves to an executable rather than a cmdlet.
+        /// </summary>
+        private static bool IsExternalCommand(ParsedCommand command)
+        {
+            return ResolveBinding(command) == null && ExternalCommandResolver.Resolve(command.CommandName) != null;
+        }
+
+        /// <summary>
+        /// Creates the pipeline stage of an external command, or returns null if no executable matches its name.
+        /// </summary>
+        private static ExternalProcessStage? ResolveExternalStage(ParsedCommand command)
+        {
+            string? executablePath = ExternalCommandResolver.Resolve(command.CommandName);
+            return executablePath != null
+                ? new ExternalProcessStage(command.CommandName, executablePath, ShellSessionContext.CurrentDirectory)
+                : null;
+        }
+
+        /// <summary>
+        /// Builds the argument list of an external command in the order it was typed.
+        /// Parameter names are passed through as words and sub-expressions are expanded to their output.
+        /// </summary>
+        private static async Task RunExternalStageAsync(
+            ExternalProcessStage stage,
+            ParsedCommand command,
+            PipelineChannel? input,
+            PipelineChannel output,
+            PipelineStageStats stats)
+        {
+            long stageStart = Stopwatch.GetTimestamp();
+            try
+            {
+                // Arguments can hold subexpressions, so building them counts as binding.
+                List<string> arguments;
+                try
+                {
+                    arguments = BuildExternalArguments(command);
+                }
+                catch (Exception ex)
+                {
+                    CoreConsole.LogError("Executor", $"Task '{command.CommandName}' failed: {ex.GetType().Name} - {ex.Message}");
+                    // Joined processes on either side must not wait for a process that never starts.
+                    await stage.AbandonAsync(ex, input, output);
+                    return;
+                }
+
+                stats.BindTime = Stopwatch.GetElapsedTime(stageStart);
+                await stage.RunAsync(arguments, input, output);
+            }
+            finally
+            {
+                stats.Complete(input, output, stageStart);
+            }
+        }
+
+        private static List<string> BuildExternalArguments(ParsedCommand command)
+        {
+            var arguments = new List<string>(command.CommandLineArguments.Count);
+            foreach (object argument in command.CommandLineArguments)
+            {
+                arguments.Add(argument is List<ParsedCommand> subCommands
+                    ? ExecuteSubExpression(subCommands)
+                    : argument.ToString() ?? string.Empty);
+            }
+
+            return arguments;
+        }
+
+        /// <summary>
+        /// Binds parameters from the parsed command to the cmdlet instance.
+        /// Parameter metadata, converters and setters come from the per-type cache in
+        /// <see cref="CommandDiscovery"/>, so repeated invocations do no reflection.
         /// This is called within the context of the specific cmdlet's execution task.
         /// </summary>
-        private static void BindParameters(CmdletBase cmdlet, ParsedCommand command)
+        private static void BindParameters(CmdletBase cmdlet, CmdletBindingInfo bindingInfo, ParsedCommand command)
         {
-            CoreConsole.WriteLine($"DEBUG (Binder): Binding parameters for {cmdlet.GetType().Name}...");
-            var cmdletType = cmdlet.GetType();
-            var properties = cmdletType.GetProperties()
-                .Where(p => Attribute.IsDefined(p, typeof(ParameterAttribute)))
-                .ToList();
+            CoreConsole.LogDebug("Binder", $"Binding parameters for {cmdlet.GetType().Name}...");
 
             // Keep track of used positional arguments
             var usedPositionalArgs = new bool[command.Arguments.Count];
@@ -679,14 +845,12 @@ namespace ArbSh.Core
             // Pre-process type literals to create type conversion context
             var typeLiteralContext = ProcessTypeLiterals(command.Arguments, usedPositionalArgs);
 
-            foreach (var prop in properties)
+            foreach (CmdletParameterInfo parameter in bindingInfo.Parameters)
             {
-                var paramAttr = prop.GetCustomAttribute<ParameterAttribute>();
-                if (paramAttr == null) continue;
+                ParameterAttribute paramAttr = parameter.Attribute;
 
                 // Arabic-only named parameter binding.
-                var arabicNameAttr = prop.GetCustomAttribute<ArabicNameAttribute>();
-                string? arabicParamName = arabicNameAttr != null ? $"-{arabicNameAttr.Name}" : null;
+                string? arabicParamName = parameter.NamedKey;
 
                 object? valueToSet = null;
                 bool found = false;
@@ -694,19 +858,19 @@ namespace ArbSh.Core
                 string? namedValue = null; // The value found via named parameter
 
                 // 1. Try binding by Arabic parameter name only.
-                if (arabicParamName != null && command.Parameters.ContainsKey(arabicParamName))
+                if (arabicParamName != null && command.Parameters.TryGetValue(arabicParamName, out string? arabicNamedValue))
                 {
-                    namedValue = command.Parameters[arabicParamName];
+                    namedValue = arabicNamedValue;
                     boundName = arabicParamName;
                     found = true;
-                    CoreConsole.WriteLine($"DEBUG (Binder): Found parameter via Arabic name '{boundName}'.");
+                    CoreConsole.LogDebug("Binder", $"Found parameter via Arabic name '{boundName}'.");
                 }
 
                 // If found by either name, process the value
                 if (found)
                 {
                     // Handle boolean switch parameters
-                    if (prop.PropertyType == typeof(bool))
+                    if (parameter.IsSwitch)
                     {
                         // Switch is present if its name exists in the parsed parameters.
                         // Only consider the associated value if it's explicitly true/false.
@@ -729,39 +893,30 @@ namespace ArbSh.Core
                             valueToSet = true; // Default behavior for a present switch
                         }
                         // 'found' is already true here
-                        CoreConsole.WriteLine($"DEBUG (Binder): Bound switch parameter '{boundName}' to {valueToSet}.");
+                        CoreConsole.LogDebug("Binder", $"Bound switch parameter '{boundName}' to {valueToSet}.");
                     }
                     // Handle non-boolean named parameters
                     else if (!string.IsNullOrEmpty(namedValue)) // Only bind if parser provided a non-empty value (and it's not a bool prop)
                     {
                         try
                         {
-                            // Attempt conversion using TypeConverter first, then fallback
-                            TypeConverter converter = TypeDescriptor.GetConverter(prop.PropertyType);
-                            if (converter != null && converter.CanConvertFrom(typeof(string)))
-                            {
-                                valueToSet = converter.ConvertFromString(namedValue);
-                            }
-                            else
-                            {
-                                // Fallback for basic types if no specific converter found/applicable
-                                valueToSet = Convert.ChangeType(namedValue, prop.PropertyType);
-                            }
+                            // Attempt conversion using the cached TypeConverter first, then fallback
+                            valueToSet = parameter.ConvertFromString(namedValue);
                             // 'found' is already true here
-                            CoreConsole.WriteLine($"DEBUG (Binder): Bound named parameter '{boundName}' to value '{valueToSet}' (Type: {prop.PropertyType.Name})");
+                            CoreConsole.LogDebug("Binder", $"Bound named parameter '{boundName}' to value '{valueToSet}' (Type: {parameter.ParameterType.Name})");
                         }
                         catch (Exception ex) when (ex is FormatException || ex is InvalidCastException || ex is OverflowException || ex is NotSupportedException /*TypeConverter might throw this*/)
                         {
                             // Throw specific binding exception for conversion failure
-                            throw new ParameterBindingException($"Cannot process argument transformation for parameter '{boundName}'. Cannot convert value \"{namedValue}\" to type \"{prop.PropertyType.FullName}\".", ex)
+                            throw new ParameterBindingException($"Cannot process argument transformation for parameter '{boundName}'. Cannot convert value \"{namedValue}\" to type \"{parameter.ParameterType.FullName}\".", ex)
                             {
-                                ParameterName = prop.Name // Still use property name for identification
+                                ParameterName = parameter.Name // Still use property name for identification
                             };
                         }
                     }
                     // If found is true but namedValue is null/empty and it's not a bool, it means a named param was provided without a value (e.g., "-Name -OtherParam")
                     // This is generally an error unless it's a switch.
-                    else if (string.IsNullOrEmpty(namedValue) && prop.PropertyType != typeof(bool))
+                    else if (string.IsNullOrEmpty(namedValue) && !parameter.IsSwitch)
                     {
                         throw new ParameterBindingException($"Parameter '{boundName}' requires a value, but none was provided.");
                     }
@@ -774,9 +929,9 @@ namespace ArbSh.Core
                 if (!found && paramAttr.Position >= 0)
                 {
                     // Check if it's an array type meant to consume remaining arguments
-                    if (prop.PropertyType.IsArray && paramAttr.Position < command.Arguments.Count) // Ensure position is valid
+                    if (parameter.IsArray && paramAttr.Position < command.Arguments.Count) // Ensure position is valid
                     {
-                        Type? elementType = prop.PropertyType.GetElementType();
+                        Type? elementType = parameter.ElementType;
                         if (elementType != null)
                         {
                             List<object> arrayValues = new List<object>();
@@ -800,36 +955,32 @@ namespace ArbSh.Core
                                             {
                                                 targetType = overrideType;
                                                 conversionSource = "type literal";
-                                                CoreConsole.WriteLine($"DEBUG (TypeLiteral): Using type literal override {targetType.Name} for array argument at index {j}");
+                                                CoreConsole.LogDebug("TypeLiteral", $"Using type literal override {targetType.Name} for array argument at index {j}");
                                             }
 
-                                            // Attempt conversion
-                                            TypeConverter converter = TypeDescriptor.GetConverter(targetType);
-                                            object convertedValue = converter != null && converter.CanConvertFrom(typeof(string))
-                                                ? converter.ConvertFromString(argValue)! // Assume non-null if conversion succeeds
-                                                : Convert.ChangeType(argValue, targetType)!;
+                                            // Attempt conversion using the cached converters
+                                            object convertedValue = targetType == elementType
+                                                ? parameter.ConvertElementFromString(argValue)
+                                                : CmdletParameterInfo.ConvertFromString(argValue, targetType)!; // Assume non-null if conversion succeeds
 
                                             // If we used a type literal override, we may need to convert again to the array element type
                                             if (targetType != elementType)
                                             {
-                                                TypeConverter elementConverter = TypeDescriptor.GetConverter(elementType);
-                                                convertedValue = elementConverter != null && elementConverter.CanConvertFrom(targetType)
-                                                    ? elementConverter.ConvertFrom(convertedValue)!
-                                                    : Convert.ChangeType(convertedValue, elementType)!;
+                                                convertedValue = parameter.ConvertToElement(convertedValue);
                                             }
 
                                             arrayValues.Add(convertedValue);
                                             usedPositionalArgs[j] = true; // Mark as used
                                             argsConsumed++;
-                                            CoreConsole.WriteLine($"DEBUG (Binder): Added array element '{argValue}' converted to {elementType.Name} (via {conversionSource})");
+                                            CoreConsole.LogDebug("Binder", $"Added array element '{argValue}' converted to {elementType.Name} (via {conversionSource})");
                                         }
                                         catch (Exception ex) when (ex is FormatException || ex is InvalidCastException || ex is OverflowException || ex is NotSupportedException)
                                         {
                                             conversionError = true;
                                             // Throw specific binding exception for conversion failure within the array
-                                            throw new ParameterBindingException($"Cannot process argument transformation for array parameter '{prop.Name}'. Cannot convert value \"{argValue}\" at index {j} to type \"{elementType.FullName}\".", ex)
+                                            throw new ParameterBindingException($"Cannot process argument transformation for array parameter '{parameter.Name}'. Cannot convert value \"{argValue}\" at index {j} to type \"{elementType.FullName}\".", ex)
                                             {
-                                                ParameterName = prop.Name
+                                                ParameterName = parameter.Name
                                             };
                                         }
                                     }
@@ -837,27 +988,24 @@ namespace ArbSh.Core
                                     {
                                         try
                                         {
-                                            CoreConsole.WriteLine($"DEBUG (Binder): Executing subexpression for array parameter '{prop.Name}' at index {j}.");
+                                            CoreConsole.LogDebug("Binder", $"Executing subexpression for array parameter '{parameter.Name}' at index {j}.");
                                             string subExpressionResult = ExecuteSubExpression(subCommands);
 
                                             // Convert the subexpression result to the array element type
-                                            TypeConverter converter = TypeDescriptor.GetConverter(elementType);
-                                            object convertedValue = converter != null && converter.CanConvertFrom(typeof(string))
-                                                ? converter.ConvertFromString(subExpressionResult)! // Assume non-null if conversion succeeds
-                                                : Convert.ChangeType(subExpressionResult, elementType)!;
+                                            object convertedValue = parameter.ConvertElementFromString(subExpressionResult);
 
                                             arrayValues.Add(convertedValue);
                                             usedPositionalArgs[j] = true; // Mark as used
                                             argsConsumed++;
-                                            CoreConsole.WriteLine($"DEBUG (Binder): Added subexpression result '{subExpressionResult}' to array parameter '{prop.Name}' (Type: {elementType.Name})");
+                                            CoreConsole.LogDebug("Binder", $"Added subexpression result '{subExpressionResult}' to array parameter '{parameter.Name}' (Type: {elementType.Name})");
                                         }
                                         catch (Exception ex) when (ex is FormatException || ex is InvalidCastException || ex is OverflowException || ex is NotSupportedException)
                                         {
                                             conversionError = true;
                                             // Throw specific binding exception for conversion failure within the array
-                                            throw new ParameterBindingException($"Cannot process subexpression result for array parameter '{prop.Name}' at index {j} to type \"{elementType.FullName}\".", ex)
+                                            throw new ParameterBindingException($"Cannot process subexpression result for array parameter '{parameter.Name}' at index {j} to type \"{elementType.FullName}\".", ex)
                                             {
-                                                ParameterName = prop.Name
+                                                ParameterName = parameter.Name
                                             };
                                         }
                                     }
@@ -877,13 +1025,13 @@ namespace ArbSh.Core
                                 // arrayValues.CopyTo(finalArray, 0); // This caused type mismatch error
                                 valueToSet = finalArray;
                                 found = true;
-                                CoreConsole.WriteLine($"DEBUG (Binder): Bound {argsConsumed} remaining positional argument(s) starting at {paramAttr.Position} to array parameter '{prop.Name}' (Type: {prop.PropertyType.Name})");
+                                CoreConsole.LogDebug("Binder", $"Bound {argsConsumed} remaining positional argument(s) starting at {paramAttr.Position} to array parameter '{parameter.Name}' (Type: {parameter.ParameterType.Name})");
                             }
                             // If argsConsumed is 0, it means there were no unused args at or after the position, so don't bind.
                         }
                     }
                     // Handle non-array positional parameters (only if not already bound as array)
-                    else if (!prop.PropertyType.IsArray && typeLiteralContext.ParameterPositionToArgumentIndex.TryGetValue(paramAttr.Position, out int argumentIndex) && !usedPositionalArgs[argumentIndex])
+                    else if (!parameter.IsArray && typeLiteralContext.ParameterPositionToArgumentIndex.TryGetValue(paramAttr.Position, out int argumentIndex) && !usedPositionalArgs[argumentIndex])
                     {
                         object positionalArgument = command.Arguments[argumentIndex];
 
@@ -892,89 +1040,79 @@ namespace ArbSh.Core
                             try
                             {
                                 // Check if there's a type literal override for this argument
-                                Type targetType = prop.PropertyType; // Default to parameter type
+                                Type targetType = parameter.ParameterType; // Default to parameter type
                                 string conversionSource = "parameter type";
 
                                 if (typeLiteralContext.ArgumentTypeOverrides.TryGetValue(argumentIndex, out Type? overrideType))
                                 {
                                     targetType = overrideType;
                                     conversionSource = "type literal";
-                                    CoreConsole.WriteLine($"DEBUG (TypeLiteral): Using type literal override {targetType.Name} for argument at index {argumentIndex} (parameter position {paramAttr.Position})");
+                                    CoreConsole.LogDebug("TypeLiteral", $"Using type literal override {targetType.Name} for argument at index {argumentIndex} (parameter position {paramAttr.Position})");
                                 }
 
                                 // Attempt conversion using TypeConverter first, then fallback
-                                TypeConverter converter = TypeDescriptor.GetConverter(targetType);
-                                if (converter != null && converter.CanConvertFrom(typeof(string)))
+                                if (targetType == parameter.ParameterType)
                                 {
-                                    valueToSet = converter.ConvertFromString(positionalValue);
+                                    valueToSet = parameter.ConvertFromString(positionalValue);
                                 }
                                 else
                                 {
-                                    // Fallback for basic types
-                                    valueToSet = Convert.ChangeType(positionalValue, targetType);
+                                    valueToSet = CmdletParameterInfo.ConvertFromString(positionalValue, targetType);
                                 }
 
                                 // If we used a type literal override, we may need to convert again to the parameter type
-                                if (targetType != prop.PropertyType && valueToSet != null)
+                                if (targetType != parameter.ParameterType && valueToSet != null)
                                 {
                                     // Convert from type literal type to parameter type
-                                    TypeConverter paramConverter = TypeDescriptor.GetConverter(prop.PropertyType);
-                                    if (paramConverter != null && paramConverter.CanConvertFrom(targetType))
+                                    TypeConverter paramConverter = parameter.Converter;
+                                    if (paramConverter.CanConvertFrom(targetType))
                                     {
                                         valueToSet = paramConverter.ConvertFrom(valueToSet);
                                     }
                                     else
                                     {
-                                        valueToSet = Convert.ChangeType(valueToSet, prop.PropertyType);
+                                        valueToSet = Convert.ChangeType(valueToSet, parameter.ParameterType);
                                     }
                                 }
 
                                 found = true;
                                 usedPositionalArgs[argumentIndex] = true; // Mark as used
-                                CoreConsole.WriteLine($"DEBUG (Binder): Bound positional parameter at position {paramAttr.Position} (argument index {argumentIndex}, '{positionalValue}') to property '{prop.Name}' (Type: {prop.PropertyType.Name}, converted via {conversionSource})");
+                                CoreConsole.LogDebug("Binder", $"Bound positional parameter at position {paramAttr.Position} (argument index {argumentIndex}, '{positionalValue}') to property '{parameter.Name}' (Type: {parameter.ParameterType.Name}, converted via {conversionSource})");
                             }
                             catch (Exception ex) when (ex is FormatException || ex is InvalidCastException || ex is OverflowException || ex is NotSupportedException /*TypeConverter might throw this*/)
                             {
                                 // Throw specific binding exception for conversion failure
-                                string positionalParamName = arabicParamName ?? $"-{prop.Name}";
-                                throw new ParameterBindingException($"تعذر تحويل قيمة الوسيط \"{positionalValue}\" للمعامل '{positionalParamName}' في الموضع {paramAttr.Position}. النوع المطلوب: \"{prop.PropertyType.FullName}\".", ex)
+                                string positionalParamName = arabicParamName ?? $"-{parameter.Name}";
+                                throw new ParameterBindingException($"تعذر تحويل قيمة الوسيط \"{positionalValue}\" للمعامل '{positionalParamName}' في الموضع {paramAttr.Position}. النوع المطلوب: \"{parameter.ParameterType.FullName}\".", ex)
                                 {
-                                    ParameterName = prop.Name // Still use property name for identification
+                                    ParameterName = parameter.Name // Still use property name for identification
                                 };
                             }
                         } // End of string check for positionalValue
                         else if (positionalArgument is List<ParsedCommand> subCommands)
                         {
                             // Handle subexpression - execute it and use the result
-                            CoreConsole.WriteLine($"DEBUG (Binder): Executing subexpression for parameter '{prop.Name}' at position {paramAttr.Position}.");
+                            CoreConsole.LogDebug("Binder", $"Executing subexpression for parameter '{parameter.Name}' at position {paramAttr.Position}.");
                             string subExpressionResult = ExecuteSubExpression(subCommands);
 
                             try
                             {
                                 // Convert the subexpression result to the parameter type
-                                TypeConverter converter = TypeDescriptor.GetConverter(prop.PropertyType);
-                                if (converter != null && converter.CanConvertFrom(typeof(string)))
-                                {
-                                    valueToSet = converter.ConvertFromString(subExpressionResult);
-                                }
-                                else
-                                {
-                                    valueToSet = Convert.ChangeType(subExpressionResult, prop.PropertyType);
-                                }
+                                valueToSet = parameter.ConvertFromString(subExpressionResult);
                                 found = true;
                                 usedPositionalArgs[paramAttr.Position] = true;
-                                CoreConsole.WriteLine($"DEBUG (Binder): Bound subexpression result '{subExpressionResult}' to parameter '{prop.Name}' (Type: {prop.PropertyType.Name})");
+                                CoreConsole.LogDebug("Binder", $"Bound subexpression result '{subExpressionResult}' to parameter '{parameter.Name}' (Type: {parameter.ParameterType.Name})");
                             }
                             catch (Exception ex)
                             {
-                                CoreConsole.WriteLine($"ERROR (Binder): Failed to convert subexpression result '{subExpressionResult}' to type {prop.PropertyType.Name} for parameter '{prop.Name}': {ex.Message}");
-                                throw new ParameterBindingException($"Cannot convert subexpression result to parameter '{prop.Name}' of type {prop.PropertyType.Name}.", ex) { ParameterName = prop.Name };
+                                CoreConsole.LogError("Binder", $"Failed to convert subexpression result '{subExpressionResult}' to type {parameter.ParameterType.Name} for parameter '{parameter.Name}': {ex.Message}");
+                                throw new ParameterBindingException($"Cannot convert subexpression result to parameter '{parameter.Name}' of type {parameter.ParameterType.Name}.", ex) { ParameterName = parameter.Name };
                             }
                         }
                         else
                         {
                             // Handle other non-string positional arguments
-                            CoreConsole.WriteLine($"WARN (Binder): Skipping non-string positional argument of type {positionalArgument?.GetType().Name ?? "null"} at index {paramAttr.Position} for parameter '{prop.Name}'. Type not supported for parameter binding.");
+                            CoreConsole.LogWarning("Binder", $"Skipping non-string positional argument of type {positionalArgument?.GetType().Name ?? "null"} at index {paramAttr.Position} for parameter '{parameter.Name}'. Type not supported for parameter binding.");
                         }
                     }
                 } 
@@ -985,26 +1123,26 @@ namespace ArbSh.Core
                 {
                     try
                     {
-                        prop.SetValue(cmdlet, valueToSet);
+                        parameter.Setter(cmdlet, valueToSet);
                     }
                     catch (Exception ex)
                     {
                         // This might indicate a problem with the setter logic itself
-                        CoreConsole.WriteLine($"ERROR (Binder): Failed to set property '{prop.Name}': {ex.Message}");
-                        throw new ParameterBindingException($"Failed to set property '{prop.Name}'.", ex) { ParameterName = prop.Name };
+                        CoreConsole.LogError("Binder", $"Failed to set property '{parameter.Name}': {ex.Message}");
+                        throw new ParameterBindingException($"Failed to set property '{parameter.Name}'.", ex) { ParameterName = parameter.Name };
                     }
                 }
 
                 // 4. Check for Mandatory parameters that were not bound by name or position
                 if (!found && paramAttr.Mandatory)
                 {
-                    string requiredName = arabicParamName ?? $"-{prop.Name}";
+                    string requiredName = arabicParamName ?? $"-{parameter.Name}";
                     string missingParamMsg = $"المعامل الإلزامي '{requiredName}' مفقود للأمر '{cmdlet.GetType().Name}'.";
 
                     // Throw an exception to stop execution of this cmdlet's task
                     throw new ParameterBindingException(missingParamMsg)
                     {
-                        ParameterName = prop.Name // Store the property name
+                        ParameterName = parameter.Name // Store the property name
                     };
                 }
             } // <<< End of foreach loop for properties
@@ -1022,7 +1160,7 @@ namespace ArbSh.Core
                     {
                          // Don't warn about the TypeLiteral pseudo-arguments
                         if (!unusedStringArg.StartsWith("TypeLiteral:")) {
-                             CoreConsole.WriteLine($"WARN (Binder): Unused positional string argument detected: {unusedStringArg}");
+                             CoreConsole.LogWarning("Binder", $"Unused positional string argument detected: {unusedStringArg}");
                              // Depending on shell strictness, this could be an error:
                              // throw new ParameterBindingException($"Unexpected positional argument: {unusedStringArg}");
                         }
@@ -1030,13 +1168,13 @@ namespace ArbSh.Core
                     else if (command.Arguments[i] is List<ParsedCommand> subCommands)
                     {
                         // Execute unused subexpression (this might be needed for side effects)
-                        CoreConsole.WriteLine($"DEBUG (Binder): Executing unused subexpression at index {i} for potential side effects.");
+                        CoreConsole.LogDebug("Binder", $"Executing unused subexpression at index {i} for potential side effects.");
                         string subExpressionResult = ExecuteSubExpression(subCommands);
-                        CoreConsole.WriteLine($"DEBUG (Binder): Unused subexpression executed, result: '{subExpressionResult}'");
+                        CoreConsole.LogDebug("Binder", $"Unused subexpression executed, result: '{subExpressionResult}'");
                     }
                     else // Other object types
                     {
-                        CoreConsole.WriteLine($"WARN (Binder): Unused positional argument of type {command.Arguments[i]?.GetType().Name ?? "null"} detected at index {i}. Type not supported.");
+                        CoreConsole.LogWarning("Binder", $"Unused positional argument of type {command.Arguments[i]?.GetType().Name ?? "null"} detected at index {i}. Type not supported.");
                     }
                 }
             }
@@ -1050,129 +1188,204 @@ namespace ArbSh.Core
         {
             if (subCommands == null || subCommands.Count == 0)
             {
-                CoreConsole.WriteLine($"DEBUG (Executor): Empty subexpression, returning empty string.");
+                CoreConsole.LogDebug("Executor", $"Empty subexpression, returning empty string.");
                 return string.Empty;
             }
 
-            CoreConsole.WriteLine($"DEBUG (Executor): Executing subexpression with {subCommands.Count} command(s), starting with '{subCommands.FirstOrDefault()?.CommandName ?? "N/A"}'.");
+            CoreConsole.LogDebug("Executor", $"Executing subexpression with {subCommands.Count} command(s), starting with '{subCommands.FirstOrDefault()?.CommandName ?? "N/A"}'.");
 
             try
             {
-                // Create a temporary output collection to capture the subexpression's output
-                var subExpressionOutput = new BlockingCollection<PipelineObject>();
                 var outputResults = new List<string>();
+                foreach (var outputObject in InvokePipeline(subCommands))
+                {
+                    if (outputObject.Kind != PipelineValueKind.None)
+                    {
+                        outputResults.Add(outputObject.ToString());
+                    }
+                }
+
+                // Convert collected output to a single string
+                string result = string.Join(Environment.NewLine, outputResults);
+                CoreConsole.LogDebug("Executor SubExpr", $"Subexpression completed, returning: '{result}'");
+                return result;
+            }
+            catch (Exception ex)
+            {
+                CoreConsole.LogError("Executor SubExpr", $"Subexpression execution failed: {ex.Message}");
+                return $"[ERROR: {ex.Message}]";
+            }
+        }
+
+        /// <summary>
+        /// Runs a nested pipeline to completion on the calling thread and returns the objects written by its last stage.
+        /// The pipeline gets its own scheduler, so it can run inside a stage of another pipeline or on a worker thread.
+        /// </summary>
+        /// <param name="commands">The commands of the pipeline.</param>
+        /// <param name="input">An object piped into the first stage, or null to run it without pipeline input.</param>
+        /// <param name="collectedStats">Receives the statistics of each stage, by stage index, when not null.</param>
+        internal static List<PipelineObject> InvokePipeline(
+            List<ParsedCommand> commands,
+            PipelineObject? input = null,
+            PipelineStageStats[]? collectedStats = null)
+        {
+            var results = new List<PipelineObject>();
+            InvokePipeline(commands, results.Add, input, collectedStats);
+            return results;
+        }
+
+        /// <summary>
+        /// Runs a nested pipeline to completion on the calling thread, handing each object written by its last
+        /// stage to <paramref name="onOutput"/> as it arrives instead of collecting the output.
+        /// </summary>
+        /// <param name="commands">The commands of the pipeline.</param>
+        /// <param name="onOutput">Called on the calling thread for each output object, in order.</param>
+        /// <param name="input">An object piped into the first stage, or null to run it without pipeline input.</param>
+        /// <param name="collectedStats">Receives the statistics of each stage, by stage index, when not null.</param>
+        internal static void InvokePipeline(
+            List<ParsedCommand> commands,
+            Action<PipelineObject> onOutput,
+            PipelineObject? input = null,
+            PipelineStageStats[]? collectedStats = null)
+        {
+            // The nested pipeline's scheduler is pumped on this thread while the caller consumes the output.
+            ExecutionOptions? options = CoreConsole.Options;
+            var scheduler = new PipelineScheduler();
+            var pipelineOutput = PipelineChannel.Create(options);
+
+            PipelineChannel? inputForCurrentStage = null;
+            if (input is PipelineObject item)
+            {
+                inputForCurrentStage = PipelineChannel.Create(options);
+                inputForCurrentStage.Write(item);
+                inputForCurrentStage.Complete();
+            }
 
-                // Execute the subexpression pipeline using the same logic as the main Execute method
-                // but capture output instead of writing to console/file
-                BlockingCollection<PipelineObject>? inputForCurrentStage = null;
-                List<Task> pipelineTasks = new List<Task>();
+            List<Task> pipelineTasks = new List<Task>();
 
-                for (int i = 0; i < subCommands.Count; i++)
+            for (int i = 0; i < commands.Count; i++)
+            {
+                var currentCommand = commands[i];
+                var currentInputCollection = inputForCurrentStage;
+                var stageStats = new PipelineStageStats(currentCommand.CommandName);
+                if (collectedStats != null)
                 {
-                    var currentCommand = subCommands[i];
-                    var currentInputCollection = inputForCurrentStage;
-                    var outputCollection = (i == subCommands.Count - 1) ? subExpressionOutput : new BlockingCollection<PipelineObject>();
-                    bool isLastStage = (i == subCommands.Count - 1);
+                    collectedStats[i] = stageStats;
+                }
+                var outputCollection = (i == commands.Count - 1) ? pipelineOutput : PipelineChannel.Create(options);
+                bool isLastStage = (i == commands.Count - 1);
 
-                    inputForCurrentStage = outputCollection;
+                inputForCurrentStage = outputCollection;
 
-                    CoreConsole.WriteLine($"DEBUG (Executor SubExpr): Preparing stage {i}: '{currentCommand.CommandName}'...");
+                CoreConsole.LogDebug("Executor SubExpr", $"Preparing stage {i}: '{currentCommand.CommandName}'...");
 
-                    // Cmdlet Discovery
-                    Type? cmdletType = CommandDiscovery.Find(currentCommand.CommandName);
+                // Cmdlet Discovery
+                CmdletBindingInfo? bindingInfo = ResolveBinding(currentCommand);
 
-                    if (cmdletType != null)
+                if (bindingInfo != null)
+                {
+                    var pipelineTask = scheduler.Start(async () =>
                     {
-                        var pipelineTask = Task.Run(() =>
+                        CmdletBase? cmdletInstance = null;
+                        long stageStart = Stopwatch.GetTimestamp();
+                        CoreConsole.LogDebug("Executor SubExpr Task", $"Starting task for '{currentCommand.CommandName}'...");
+                        try
                         {
-                            CmdletBase? cmdletInstance = null;
-                            CoreConsole.WriteLine($"DEBUG (Executor SubExpr Task): Starting task for '{currentCommand.CommandName}'...");
-                            try
-                            {
-                                // Instantiate Cmdlet
-                                cmdletInstance = Activator.CreateInstance(cmdletType) as CmdletBase;
-                                if (cmdletInstance == null)
-                                {
-                                    throw new InvalidOperationException($"Failed to activate cmdlet type {cmdletType.FullName}");
-                                }
+                            // Instantiate Cmdlet
+                            cmdletInstance = bindingInfo.Factory();
 
-                                // Parameter Binding
-                                BindParameters(cmdletInstance, currentCommand);
+                            // Parameter Binding
+                            BindParameters(cmdletInstance, bindingInfo, currentCommand);
+                            stageStats.BindTime = Stopwatch.GetElapsedTime(stageStart);
 
-                                // Assign output collection
-                                cmdletInstance.OutputCollection = outputCollection;
+                            // Assign output collection
+                            cmdletInstance.OutputCollection = outputCollection;
 
-                                // Cmdlet Execution Lifecycle
-                                cmdletInstance.BeginProcessing();
+                            // Cmdlet Execution Lifecycle
+                            cmdletInstance.BeginProcessing();
+                            await outputCollection.FlushAsync();
 
-                                // Process pipeline input if any
-                                if (currentInputCollection != null)
+                            // Process pipeline input if any
+                            if (currentInputCollection != null)
+                            {
+                                CoreConsole.LogDebug("Executor SubExpr Task", $"'{currentCommand.CommandName}' consuming input...");
+                                while (await currentInputCollection.WaitToReadAsync())
                                 {
-                                    CoreConsole.WriteLine($"DEBUG (Executor SubExpr Task): '{currentCommand.CommandName}' consuming input...");
-                                    foreach (var inputObject in currentInputCollection.GetConsumingEnumerable())
+                                    while (currentInputCollection.TryRead(out ArraySegment<PipelineObject> inputBatch))
                                     {
-                                        cmdletInstance.BindPipelineParameters(inputObject);
-                                        cmdletInstance.ProcessRecord(inputObject);
+                                        foreach (var inputObject in inputBatch)
+                                        {
+                                            cmdletInstance.BindPipelineParameters(inputObject);
+                                            ValueTask processing = cmdletInstance.ProcessRecordAsync(inputObject);
+                                            if (!processing.IsCompletedSuccessfully)
+                                            {
+                                                await processing;
+                                            }
+                                        }
+
+                                        currentInputCollection.Release(inputBatch);
+
+                                        await outputCollection.FlushAsync();
                                     }
-                                    CoreConsole.WriteLine($"DEBUG (Executor SubExpr Task): '{currentCommand.CommandName}' finished consuming input.");
-                                }
-                                else
-                                {
-                                    // No pipeline input, just call ProcessRecord once
-                                    cmdletInstance.ProcessRecord(null);
                                 }
-
-                                cmdletInstance.EndProcessing();
-                                CoreConsole.WriteLine($"DEBUG (Executor SubExpr Task): '{currentCommand.CommandName}' completed successfully.");
+                                CoreConsole.LogDebug("Executor SubExpr Task", $"'{currentCommand.CommandName}' finished consuming input.");
                             }
-                            catch (Exception ex)
+                            else
                             {
-                                CoreConsole.WriteLine($"ERROR (Executor SubExpr Task): '{currentCommand.CommandName}' failed: {ex.Message}");
-                                // Add error to output collection
-                                outputCollection.Add(new PipelineObject($"[ERROR: {ex.Message}]", true));
+                                // No pipeline input, just call ProcessRecord once
+                                await cmdletInstance.ProcessRecordAsync(null);
                             }
-                            finally
+
+                            await cmdletInstance.EndProcessingAsync();
+                            CoreConsole.LogDebug("Executor SubExpr Task", $"'{currentCommand.CommandName}' completed successfully.");
+                        }
+                        catch (Exception ex)
+                        {
+                            CoreConsole.LogError("Executor SubExpr Task", $"'{currentCommand.CommandName}' failed: {ex.Message}");
+                            // Add error to output channel
+                            outputCollection.Write(new PipelineObject($"[ERROR: {ex.Message}]", true));
+                        }
+                        finally
+                        {
+                            // Mark this stage's output as complete and release the previous stage
+                            await outputCollection.CompleteAsync();
+                            currentInputCollection?.Discard();
+                            if (cmdletInstance is IAsyncDisposable disposable)
                             {
-                                // Mark this stage's output as complete
-                                outputCollection.CompleteAdding();
-                                CoreConsole.WriteLine($"DEBUG (Executor SubExpr Task): '{currentCommand.CommandName}' output collection marked complete.");
+                                await disposable.DisposeAsync();
                             }
-                        });
+                            stageStats.Complete(currentInputCollection, outputCollection, stageStart);
+                            CoreConsole.LogDebug("Executor SubExpr Task", $"'{currentCommand.CommandName}' output collection marked complete.");
+                        }
+                    });
 
-                        pipelineTasks.Add(pipelineTask);
-                    }
-                    else
-                    {
-                        CoreConsole.WriteLine($"ERROR (Executor SubExpr): الأمر '{currentCommand.CommandName}' غير موجود داخل التعبير الفرعي.");
-                        outputCollection.Add(new PipelineObject($"[خطأ: الأمر '{currentCommand.CommandName}' غير موجود]", true));
-                        outputCollection.CompleteAdding();
-                    }
+                    pipelineTasks.Add(pipelineTask);
                 }
-
-                // Wait for all pipeline tasks to complete
-                CoreConsole.WriteLine($"DEBUG (Executor SubExpr): Waiting for {pipelineTasks.Count} task(s) in the subexpression pipeline to complete...");
-                Task.WaitAll(pipelineTasks.ToArray());
-                CoreConsole.WriteLine($"DEBUG (Executor SubExpr): All subexpression pipeline tasks completed.");
-
-                // Collect all output from the final stage
-                foreach (var outputObject in subExpressionOutput.GetConsumingEnumerable())
+                else if (ResolveExternalStage(currentCommand) is ExternalProcessStage externalStage)
                 {
-                    if (outputObject?.Value != null)
-                    {
-                        outputResults.Add(outputObject.Value.ToString() ?? string.Empty);
-                    }
+                    pipelineTasks.Add(scheduler.Start(() =>
+                        RunExternalStageAsync(externalStage, currentCommand, currentInputCollection, outputCollection, stageStats)));
+                }
+                else
+                {
+                    CoreConsole.LogError("Executor SubExpr", $"الأمر '{currentCommand.CommandName}' غير موجود داخل التعبير الفرعي.");
+                    outputCollection.Write(new PipelineObject($"[خطأ: الأمر '{currentCommand.CommandName}' غير موجود]", true));
+                    outputCollection.Complete();
+                    currentInputCollection?.Discard();
                 }
-
-                // Convert collected output to a single string
-                string result = string.Join(Environment.NewLine, outputResults);
-                CoreConsole.WriteLine($"DEBUG (Executor SubExpr): Subexpression completed, returning: '{result}'");
-                return result;
             }
-            catch (Exception ex)
+
+            // Consume all output from the final stage while the stages run (bounded channels)
+            foreach (var outputObject in pipelineOutput.GetConsumingEnumerable(scheduler))
             {
-                CoreConsole.WriteLine($"ERROR (Executor SubExpr): Subexpression execution failed: {ex.Message}");
-                return $"[ERROR: {ex.Message}]";
+                onOutput(outputObject);
             }
+
+            // Wait for all pipeline tasks to complete
+            CoreConsole.LogDebug("Executor SubExpr", $"Waiting for {pipelineTasks.Count} task(s) in the nested pipeline to complete...");
+            scheduler.RunUntilComplete(Task.WhenAll(pipelineTasks));
+            Task.WaitAll(pipelineTasks.ToArray());
+            CoreConsole.LogDebug("Executor SubExpr", $"All nested pipeline tasks completed.");
         }
 
     }
@@ -0,0 +1,123 @@
+using System.Collections.Concurrent;
+
+namespace ArbSh.Core;
+
+/// <summary>
+/// Resolves command names that are not cmdlets to executables on disk.
+/// </summary>
+/// <remarks>
+/// Names containing a directory separator are resolved against the session directory.
+/// Bare names are searched on <c>PATH</c> (with <c>PATHEXT</c> extensions on Windows);
+/// executables found that way are cached until <c>PATH</c> changes. Misses are not cached, so a
+/// program installed during the session is found on its next use.
+/// </remarks>
+internal static class ExternalCommandResolver
+{
+    private const int MaxCachedLookups = 256;
+
+    // Lookups are tied to the PATH they were made with; a new PATH swaps in a new cache in one write,
+    // so concurrent sessions never mix entries from two PATH values.
+    private static PathLookupCache _pathLookups = new(string.Empty);
+
+    /// <summary>
+    /// Finds the executable for <paramref name="commandName"/>.
+    /// </summary>
+    /// <param name="commandName">The command name as typed.</param>
+    /// <returns>The full path of the executable, or null if none was found.</returns>
+    public static string? Resolve(string commandName)
+    {
+        if (string.IsNullOrWhiteSpace(commandName))
+        {
+            return null;
+        }
+
+        if (commandName.IndexOfAny([Path.DirectorySeparatorChar, Path.AltDirectorySeparatorChar]) >= 0)
+        {
+            return FindWithExtensions(ShellSessionContext.ResolvePath(commandName));
+        }
+
+        string pathVariable = Environment.GetEnvironmentVariable("PATH") ?? string.Empty;
+        PathLookupCache lookups = Volatile.Read(ref _pathLookups);
+        if (!string.Equals(pathVariable, lookups.PathVariable, StringComparison.Ordinal))
+        {
+            lookups = new PathLookupCache(pathVariable);
+            Volatile.Write(ref _pathLookups, lookups);
+        }
+
+        if (lookups.Entries.TryGetValue(commandName, out string? cached))
+        {
+            return cached;
+        }
+
+        string? resolved = SearchPath(commandName, pathVariable);
+        if (resolved == null)
+        {
+            return null;
+        }
+
+        if (lookups.Entries.Count >= MaxCachedLookups)
+        {
+            lookups.Entries.Clear();
+        }
+
+        lookups.Entries[commandName] = resolved;
+        return resolved;
+    }
+
+    private static string? SearchPath(string commandName, string pathVariable)
+    {
+        foreach (string directory in pathVariable.Split(Path.PathSeparator, StringSplitOptions.RemoveEmptyEntries | StringSplitOptions.TrimEntries))
+        {
+            string? candidate = FindWithExtensions(Path.Combine(directory, commandName));
+            if (candidate != null)
+            {
+                return candidate;
+            }
+        }
+
+        return null;
+    }
+
+    private static string? FindWithExtensions(string path)
+    {
+        if (!OperatingSystem.IsWindows())
+        {
+            return IsExecutableFile(path) ? path : null;
+        }
+
+        if (Path.HasExtension(path) && File.Exists(path))
+        {
+            return path;
+        }
+
+        string extensions = Environment.GetEnvironmentVariable("PATHEXT") ?? ".COM;.EXE;.BAT;.CMD";
+        foreach (string extension in extensions.Split(';', StringSplitOptions.RemoveEmptyEntries | StringSplitOptions.TrimEntries))
+        {
+            string candidate = path + extension;
+            if (File.Exists(candidate))
+            {
+                return candidate;
+            }
+        }
+
+        return null;
+    }
+
+    private static bool IsExecutableFile(string path)
+    {
+        if (!File.Exists(path) || OperatingSystem.IsWindows())
+        {
+            return false;
+        }
+
+        const UnixFileMode executeBits = UnixFileMode.UserExecute | UnixFileMode.GroupExecute | UnixFileMode.OtherExecute;
+        return (File.GetUnixFileMode(path) & executeBits) != 0;
+    }
+
+    private sealed class PathLookupCache(string pathVariable)
+    {
+        public string PathVariable { get; } = pathVariable;
+
+        public ConcurrentDictionary<string, string> Entries { get; } = new(StringComparer.Ordinal);
+    }
+}
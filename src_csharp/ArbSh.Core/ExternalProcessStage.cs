@@ -0,0 +1,536 @@
+using System.Buffers;
+using System.ComponentModel;
+using System.Diagnostics;
+using System.Text;
+using System.Threading.Channels;
+
+namespace ArbSh.Core;
+
+/// <summary>
+/// Runs an external program as a pipeline stage.
+/// </summary>
+/// <remarks>
+/// <para>
+/// Standard output and standard error are read concurrently on the thread pool with pooled
+/// buffers and decoded incrementally as UTF-8. Complete lines are handed to the stage in chunks
+/// through a small bounded queue, and the stage writes them to its <see cref="PipelineChannel"/>
+/// on the pipeline scheduler (stdout as output, stderr as error records). When the next stage
+/// falls behind, the queue fills, the readers stop reading, and the program blocks on its own
+/// pipe, so backpressure reaches the process without buffering its output in memory.
+/// </para>
+/// <para>
+/// Pipeline input is written to standard input as UTF-8 lines. When two external stages are
+/// adjacent (see <see cref="PipeTo"/>), the upstream's stdout bytes are copied straight into the
+/// downstream's stdin and never become pipeline objects; the upstream's stderr is written to
+/// <see cref="CoreConsole.Error"/>.
+/// </para>
+/// </remarks>
+internal sealed class ExternalProcessStage
+{
+    private const int BufferSize = 64 * 1024;
+    private const int ChunkQueueCapacity = 16;
+
+    // Output without line breaks is split into lines of at most about this many characters,
+    // so a program writing one endless line cannot grow the pending line without bound.
+    private const int MaxLineLength = 1024 * 1024;
+
+    private static readonly Encoding Utf8NoBom = new UTF8Encoding(encoderShouldEmitUTF8Identifier: false);
+
+    private readonly string _commandName;
+    private readonly string _executablePath;
+    private readonly string _workingDirectory;
+    private readonly TaskCompletionSource<Stream> _standardInputReady = new(TaskCreationOptions.RunContinuationsAsynchronously);
+    private ExternalProcessStage? _upstream;
+    private ExternalProcessStage? _downstream;
+
+    /// <summary>
+    /// Creates a stage for an executable resolved by <see cref="ExternalCommandResolver"/>.
+    /// </summary>
+    /// <param name="commandName">The command name as typed, used in messages.</param>
+    /// <param name="executablePath">The full path of the executable.</param>
+    /// <param name="workingDirectory">The working directory of the process.</param>
+    public ExternalProcessStage(string commandName, string executablePath, string workingDirectory)
+    {
+        _commandName = commandName;
+        _executablePath = executablePath;
+        _workingDirectory = workingDirectory;
+    }
+
+    /// <summary>
+    /// A file copied byte for byte to standard input instead of reading pipeline input
+    /// (<c>&lt; file</c> on the first stage).
+    /// </summary>
+    public string? InputFilePath { get; set; }
+
+    /// <summary>
+    /// Connects this stage's stdout directly to the stdin of the next external stage.
+    /// Must be called before the pipeline scheduler runs either stage.
+    /// </summary>
+    /// <param name="downstream">The next stage in the pipeline.</param>
+    public void PipeTo(ExternalProcessStage downstream)
+    {
+        _downstream = downstream;
+        downstream._upstream = this;
+    }
+
+    /// <summary>
+    /// Starts the process and streams it until it exits and its output is drained.
+    /// Always completes <paramref name="output"/>.
+    /// </summary>
+    /// <param name="arguments">The command-line arguments, passed without shell quoting.</param>
+    /// <param name="input">Pipeline input, or null; ignored when the stage is fed by a file or an upstream process.</param>
+    /// <param name="output">The stage output channel.</param>
+    public async Task RunAsync(IReadOnlyList<string> arguments, PipelineChannel? input, PipelineChannel output)
+    {
+        // The '<' file is opened before the process starts, so a missing file is reported
+        // instead of silently running the program with empty input.
+        FileStream? inputFile = null;
+        if (InputFilePath != null)
+        {
+            try
+            {
+                inputFile = new FileStream(InputFilePath, FileMode.Open, FileAccess.Read, FileShare.Read, BufferSize, FileOptions.Asynchronous | FileOptions.SequentialScan);
+            }
+            catch (Exception ex) when (ex is IOException or UnauthorizedAccessException)
+            {
+                CoreConsole.LogError("ExternalProcess", $"Failed opening input redirect file '{InputFilePath}': {ex.Message}");
+                await FailAsync($"تعذر فتح ملف الإدخال '{InputFilePath}': {ex.Message}", ex, input, output);
+                return;
+            }
+        }
+
+        Process process;
+        try
+        {
+            process = StartProcess(arguments);
+            CoreConsole.LogDebug("ExternalProcess", $"Started '{_executablePath}' (pid {process.Id}) with {arguments.Count} argument(s).");
+        }
+        catch (Exception ex) when (ex is Win32Exception or InvalidOperationException or IOException)
+        {
+            CoreConsole.LogError("ExternalProcess", $"Failed to start '{_executablePath}': {ex.Message}");
+            inputFile?.Dispose();
+            await AbandonAsync(ex, input, output);
+            return;
+        }
+
+        try
+        {
+            Task<string?> inputTask = FeedStandardInputAsync(process, input, inputFile);
+
+            var chunks = Channel.CreateBounded<OutputChunk>(new BoundedChannelOptions(ChunkQueueCapacity)
+            {
+                SingleReader = true,
+                FullMode = BoundedChannelFullMode.Wait
+            });
+
+            // The pipes are read on the thread pool; only this method touches the pipeline channel.
+            Task stdoutTask = _downstream != null
+                ? Task.Run(() => PipeToDownstreamAsync(process))
+                : Task.Run(() => ReadLinesAsync(process.StandardOutput.BaseStream, isError: false, chunks.Writer));
+            Task stderrTask = Task.Run(() => ReadLinesAsync(process.StandardError.BaseStream, isError: true, chunks.Writer));
+            Task readersDone = _downstream != null ? stderrTask : Task.WhenAll(stdoutTask, stderrTask);
+            _ = readersDone.ContinueWith(
+                _ => chunks.Writer.TryComplete(),
+                CancellationToken.None,
+                TaskContinuationOptions.ExecuteSynchronously,
+                TaskScheduler.Default);
+
+            // Drain every chunk even after the consumer stops, so the readers never wait on a full queue.
+            bool consuming = true;
+            while (await chunks.Reader.WaitToReadAsync())
+            {
+                while (chunks.Reader.TryRead(out OutputChunk chunk))
+                {
+                    if (consuming)
+                    {
+                        consuming = await WriteChunkAsync(chunk, output);
+                        if (!consuming)
+                        {
+                            CoreConsole.LogDebug("ExternalProcess", $"Output of '{_commandName}' is no longer consumed; stopping the process.");
+                            Stop(process);
+                        }
+                    }
+
+                    ArrayPool<PipelineObject>.Shared.Return(chunk.Items, clearArray: true);
+                }
+            }
+
+            await stdoutTask;
+            string? inputError = await inputTask;
+            if (inputError != null)
+            {
+                WriteError(inputError, output);
+            }
+
+            await process.WaitForExitAsync();
+            CoreConsole.LogDebug("ExternalProcess", $"'{_commandName}' exited with code {process.ExitCode}.");
+        }
+        finally
+        {
+            await output.CompleteAsync();
+            input?.Discard();
+            process.Dispose();
+        }
+    }
+
+    /// <summary>
+    /// Ends the stage without starting the process, for example when its arguments could not be built.
+    /// Reports the failure, gives a joined downstream process end-of-file, and completes <paramref name="output"/>.
+    /// </summary>
+    /// <param name="reason">Why the process was not started.</param>
+    /// <param name="input">Pipeline input, or null; it is discarded.</param>
+    /// <param name="output">The stage output channel.</param>
+    public Task AbandonAsync(Exception reason, PipelineChannel? input, PipelineChannel output)
+    {
+        return FailAsync($"تعذر تشغيل الأمر الخارجي '{_commandName}': {reason.Message}", reason, input, output);
+    }
+
+    private async Task FailAsync(string message, Exception reason, PipelineChannel? input, PipelineChannel output)
+    {
+        // A joined upstream process stops instead of waiting for a stdin that will never exist.
+        _standardInputReady.TrySetException(reason);
+        WriteError(message, output);
+        if (_downstream != null)
+        {
+            // The downstream process still needs end-of-file on its stdin.
+            await CopyToDownstreamAsync(Stream.Null);
+        }
+
+        await output.CompleteAsync();
+        input?.Discard();
+    }
+
+    private void WriteError(string message, PipelineChannel output)
+    {
+        if (_downstream != null)
+        {
+            // Nothing reads this stage's channel when its stdout goes to another process.
+            CoreConsole.Error.WriteLine(message);
+        }
+        else
+        {
+            output.Write(new PipelineObject(message, isError: true));
+        }
+    }
+
+    private Process StartProcess(IReadOnlyList<string> arguments)
+    {
+        var startInfo = new ProcessStartInfo(_executablePath)
+        {
+            WorkingDirectory = _workingDirectory,
+            UseShellExecute = false,
+            RedirectStandardInput = true,
+            RedirectStandardOutput = true,
+            RedirectStandardError = true,
+            CreateNoWindow = true
+        };
+
+        foreach (string argument in arguments)
+        {
+            startInfo.ArgumentList.Add(argument);
+        }
+
+        return Process.Start(startInfo) ?? throw new InvalidOperationException($"Process '{_executablePath}' did not start.");
+    }
+
+    /// <summary>
+    /// Writes the stage input to the process's stdin and closes it.
+    /// </summary>
+    /// <returns>A message for the user if the input file could not be read; otherwise null.</returns>
+    private async Task<string?> FeedStandardInputAsync(Process process, PipelineChannel? input, FileStream? inputFile)
+    {
+        Stream standardInput = process.StandardInput.BaseStream;
+
+        if (_upstream != null)
+        {
+            // The upstream stage copies its stdout here and closes the stream.
+            _standardInputReady.TrySetResult(standardInput);
+            return null;
+        }
+
+        try
+        {
+            if (inputFile != null)
+            {
+                return await CopyInputFileAsync(inputFile, standardInput);
+            }
+
+            if (input != null)
+            {
+                await WritePipelineInputAsync(standardInput, input);
+            }
+        }
+        catch (IOException ex)
+        {
+            // The process stopped reading (it exited or closed stdin); stop the previous stage too.
+            CoreConsole.LogDebug("ExternalProcess", $"Standard input of '{_commandName}' closed early: {ex.Message}");
+            input?.Discard();
+        }
+        finally
+        {
+            if (inputFile != null)
+            {
+                await inputFile.DisposeAsync();
+            }
+
+            try
+            {
+                standardInput.Dispose();
+            }
+            catch (IOException)
+            {
+                // Closing a broken pipe can fail; the process has already gone.
+            }
+        }
+
+        return null;
+    }
+
+    /// <summary>
+    /// Copies the '&lt;' file to stdin. Read failures are returned for the user; write failures
+    /// (the process closed its stdin) are thrown to the caller as <see cref="IOException"/>.
+    /// </summary>
+    private async Task<string?> CopyInputFileAsync(FileStream inputFile, Stream standardInput)
+    {
+        byte[] buffer = ArrayPool<byte>.Shared.Rent(BufferSize);
+        try
+        {
+            while (true)
+            {
+                int read;
+                try
+                {
+                    read = await inputFile.ReadAsync(buffer.AsMemory(0, BufferSize)).ConfigureAwait(false);
+                }
+                catch (Exception ex) when (ex is IOException or UnauthorizedAccessException)
+                {
+                    CoreConsole.LogError("ExternalProcess", $"Failed reading input redirect file '{InputFilePath}': {ex.Message}");
+                    return $"تعذر قراءة ملف الإدخال '{InputFilePath}': {ex.Message}";
+                }
+
+                if (read == 0)
+                {
+                    return null;
+                }
+
+                await standardInput.WriteAsync(buffer.AsMemory(0, read)).ConfigureAwait(false);
+            }
+        }
+        finally
+        {
+            ArrayPool<byte>.Shared.Return(buffer);
+        }
+    }
+
+    private static async Task WritePipelineInputAsync(Stream standardInput, PipelineChannel input)
+    {
+        await using var writer = new StreamWriter(standardInput, Utf8NoBom, BufferSize, leaveOpen: true);
+        while (await input.WaitToReadAsync())
+        {
+            while (input.TryRead(out ArraySegment<PipelineObject> batch))
+            {
+                try
+                {
+                    foreach (PipelineObject item in batch)
+                    {
+                        await writer.WriteLineAsync(item.ToString());
+                    }
+                }
+                finally
+                {
+                    input.Release(batch);
+                }
+
+                // One flush per batch keeps the process fed without a write per line.
+                await writer.FlushAsync();
+            }
+        }
+    }
+
+    private async Task PipeToDownstreamAsync(Process process)
+    {
+        Stream standardOutput = process.StandardOutput.BaseStream;
+        try
+        {
+            if (!await CopyToDownstreamAsync(standardOutput).ConfigureAwait(false))
+            {
+                // The downstream process did not start: stop this one and read what it already wrote,
+                // so it never blocks on a full pipe and its exit can be awaited.
+                CoreConsole.LogDebug("ExternalProcess", $"Downstream of '{_commandName}' did not start; stopping it.");
+                Stop(process);
+                await standardOutput.CopyToAsync(Stream.Null, BufferSize).ConfigureAwait(false);
+            }
+        }
+        catch (IOException ex)
+        {
+            // The downstream process exited without reading everything (e.g. head); stop this one as well.
+            CoreConsole.LogDebug("ExternalProcess", $"Pipe from '{_commandName}' closed early: {ex.Message}");
+            Stop(process);
+        }
+    }
+
+    /// <summary>
+    /// Copies <paramref name="source"/> to the downstream process's stdin and closes it.
+    /// </summary>
+    /// <returns>False if the downstream process did not start; <paramref name="source"/> is then left unread.</returns>
+    private async Task<bool> CopyToDownstreamAsync(Stream source)
+    {
+        ExternalProcessStage downstream = _downstream!;
+        Stream destination;
+        try
+        {
+            destination = await downstream._standardInputReady.Task;
+        }
+        catch (Exception)
+        {
+            // Its failure is reported by its own stage.
+            return false;
+        }
+
+        try
+        {
+            await source.CopyToAsync(destination, BufferSize).ConfigureAwait(false);
+        }
+        finally
+        {
+            try
+            {
+                destination.Dispose();
+            }
+            catch (IOException)
+            {
+                // The downstream process already exited.
+            }
+        }
+
+        return true;
+    }
+
+    private async Task<bool> WriteChunkAsync(OutputChunk chunk, PipelineChannel output)
+    {
+        // A chunk can hold more lines than the channel may hold back, so each write waits for room.
+        for (int i = 0; i < chunk.Count; i++)
+        {
+            PipelineObject item = chunk.Items[i];
+            if (item.IsError && _downstream != null)
+            {
+                CoreConsole.Error.WriteLine(item.ToString());
+            }
+            else if (!await output.WriteAsync(item))
+            {
+                return false;
+            }
+        }
+
+        return await output.FlushAsync();
+    }
+
+    private static async Task ReadLinesAsync(Stream stream, bool isError, ChannelWriter<OutputChunk> writer)
+    {
+        byte[] bytes = ArrayPool<byte>.Shared.Rent(BufferSize);
+        char[] chars = ArrayPool<char>.Shared.Rent(Utf8NoBom.GetMaxCharCount(BufferSize));
+        Decoder decoder = Utf8NoBom.GetDecoder();
+        var partialLine = new StringBuilder();
+
+        try
+        {
+            int read;
+            while ((read = await stream.ReadAsync(bytes.AsMemory(0, BufferSize)).ConfigureAwait(false)) > 0)
+            {
+                int charCount = decoder.GetChars(bytes, 0, read, chars, 0, flush: false);
+                OutputChunk? chunk = SplitLines(chars.AsSpan(0, charCount), partialLine, isError);
+                if (chunk is OutputChunk lines)
+                {
+                    await writer.WriteAsync(lines).ConfigureAwait(false);
+                }
+
+                if (partialLine.Length >= MaxLineLength)
+                {
+                    PipelineObject[] items = ArrayPool<PipelineObject>.Shared.Rent(1);
+                    items[0] = new PipelineObject(partialLine.ToString(), isError);
+                    partialLine.Clear();
+                    await writer.WriteAsync(new OutputChunk(items, 1)).ConfigureAwait(false);
+                }
+            }
+
+            int tailCount = decoder.GetChars(bytes, 0, 0, chars, 0, flush: true);
+            partialLine.Append(chars, 0, tailCount);
+            if (partialLine.Length > 0)
+            {
+                PipelineObject[] items = ArrayPool<PipelineObject>.Shared.Rent(1);
+                items[0] = new PipelineObject(TrimCarriageReturn(partialLine.ToString()), isError);
+                await writer.WriteAsync(new OutputChunk(items, 1)).ConfigureAwait(false);
+            }
+        }
+        catch (Exception ex) when (ex is IOException or ObjectDisposedException)
+        {
+            // The pipe broke or the process was disposed while it was still being read.
+            CoreConsole.LogDebug("ExternalProcess", $"Stopped reading a pipe early: {ex.Message}");
+        }
+        finally
+        {
+            ArrayPool<byte>.Shared.Return(bytes);
+            ArrayPool<char>.Shared.Return(chars);
+        }
+    }
+
+    private static OutputChunk? SplitLines(ReadOnlySpan<char> text, StringBuilder partialLine, bool isError)
+    {
+        int lineCount = text.Count('\n');
+        if (lineCount == 0)
+        {
+            partialLine.Append(text);
+            return null;
+        }
+
+        PipelineObject[] items = ArrayPool<PipelineObject>.Shared.Rent(lineCount);
+        int count = 0;
+        int newline;
+        while ((newline = text.IndexOf('\n')) >= 0)
+        {
+            ReadOnlySpan<char> line = text[..newline];
+            string value;
+            if (partialLine.Length > 0)
+            {
+                partialLine.Append(line);
+                value = partialLine.ToString();
+                partialLine.Clear();
+            }
+            else
+            {
+                value = line.ToString();
+            }
+
+            items[count++] = new PipelineObject(TrimCarriageReturn(value), isError);
+            text = text[(newline + 1)..];
+        }
+
+        partialLine.Append(text);
+        return new OutputChunk(items, count);
+    }
+
+    private static string TrimCarriageReturn(string line)
+    {
+        return line.EndsWith('\r') ? line[..^1] : line;
+    }
+
+    private void Stop(Process process)
+    {
+        try
+        {
+            if (!process.HasExited)
+            {
+                process.Kill(entireProcessTree: true);
+            }
+        }
+        catch (Exception ex) when (ex is InvalidOperationException or Win32Exception or NotSupportedException)
+        {
+            CoreConsole.LogDebug("ExternalProcess", $"Could not stop '{_commandName}': {ex.Message}");
+        }
+    }
+
+    /// <summary>
+    /// Decoded lines from one read of a pipe. <see cref="Items"/> is rented from the shared pool.
+    /// </summary>
+    private readonly record struct OutputChunk(PipelineObject[] Items, int Count);
+}
@@ -0,0 +1,514 @@
+using System.Globalization;
+using System.Text;
+using System.Threading.Channels;
+
+namespace ArbSh.Core;
+
+/// <summary>
+/// Command history shared by the hosts: an append-only log on disk, indexed in memory for prefix recall,
+/// reverse incremental search and fuzzy search.
+/// </summary>
+/// <remarks>
+/// <para>
+/// Entries are kept in submission order and identified by their position. A prefix trie over the first
+/// <see cref="TrieDepth"/> characters and a trigram index both hold ascending position lists, so a lookup
+/// binary-searches to the starting position and walks candidates from there instead of scanning the history.
+/// Matching ignores letter case, Arabic diacritics and tatweel. A command submitted again is recalled once,
+/// at its latest position.
+/// </para>
+/// <para>
+/// <see cref="Add"/> and the lookups are called from the host's input thread. <see cref="Add"/> indexes the
+/// command and queues it for a background writer that appends each batch with one flush, so submitting a
+/// command never waits on the disk. The log is compacted on <see cref="Open"/> once it holds more than twice
+/// the retained entries.
+/// </para>
+/// <para>
+/// At most the retained number of entries is kept in memory: past it, <see cref="Add"/> drops the oldest
+/// entry. Dropped entries are skipped by the lookups and their index slots are reclaimed in one rebuild
+/// once as many were dropped as are retained, so each <see cref="Add"/> still costs the same on average.
+/// </para>
+/// </remarks>
+public sealed class CommandHistory : IDisposable
+{
+    /// <summary>
+    /// Default number of entries loaded and retained.
+    /// </summary>
+    public const int DefaultMaxEntries = 100_000;
+
+    private const int TrieDepth = 8;
+    private const int GramLength = 3;
+    private const int FuzzyPostingsPerGram = 1024;
+    private const char Tatweel = 'ـ';
+
+    private readonly List<string> _entries = new();
+    private readonly List<string> _foldedEntries = new();
+    private readonly Dictionary<string, int> _latest = new(StringComparer.Ordinal);
+    private readonly List<bool> _superseded = new();
+    private readonly TrieNode _trieRoot = new();
+    private readonly Dictionary<long, List<int>> _grams = new();
+    private readonly Channel<string>? _pending;
+    private readonly Task? _writer;
+    private readonly int _maxEntries;
+
+    // Index slot of the oldest retained entry; slots before it hold dropped entries.
+    private int _start;
+
+    /// <summary>
+    /// Creates an empty history kept in memory only.
+    /// </summary>
+    /// <param name="maxEntries">Most recent entries to retain.</param>
+    public CommandHistory(int maxEntries = DefaultMaxEntries)
+    {
+        ArgumentOutOfRangeException.ThrowIfNegativeOrZero(maxEntries);
+        _maxEntries = maxEntries;
+    }
+
+    private CommandHistory(string path, IEnumerable<string> entries, int maxEntries, IExecutionSink? diagnostics)
+        : this(maxEntries)
+    {
+        foreach (string entry in entries)
+        {
+            Index(entry);
+        }
+
+        _pending = Channel.CreateUnbounded<string>(new UnboundedChannelOptions { SingleReader = true, SingleWriter = true });
+        _writer = Task.Run(() => WriteBatchesAsync(path, _pending.Reader, diagnostics));
+    }
+
+    /// <summary>
+    /// Default log location, under the user's application data folder.
+    /// </summary>
+    public static string DefaultPath => Path.Combine(
+        Environment.GetFolderPath(Environment.SpecialFolder.ApplicationData), "ArbSh", "history.txt");
+
+    /// <summary>
+    /// Number of entries, including repeated commands.
+    /// </summary>
+    public int Count => _entries.Count - _start;
+
+    /// <summary>
+    /// The entry at a position, oldest first.
+    /// </summary>
+    /// <param name="index">Position of the entry.</param>
+    public string this[int index] => _entries[_start + index];
+
+    /// <summary>
+    /// Loads the log at a path and appends new commands to it.
+    /// </summary>
+    /// <param name="path">Path of the history log; created when missing.</param>
+    /// <param name="maxEntries">Most recent entries to load and retain.</param>
+    /// <param name="diagnostics">Sink that receives a warning when the log cannot be read or written.</param>
+    /// <returns>The loaded history, or an in-memory history when the log cannot be read.</returns>
+    public static CommandHistory Open(string path, int maxEntries = DefaultMaxEntries, IExecutionSink? diagnostics = null)
+    {
+        ArgumentException.ThrowIfNullOrEmpty(path);
+        ArgumentOutOfRangeException.ThrowIfNegativeOrZero(maxEntries);
+
+        try
+        {
+            string? directory = Path.GetDirectoryName(Path.GetFullPath(path));
+            if (!string.IsNullOrEmpty(directory))
+            {
+                Directory.CreateDirectory(directory);
+            }
+
+            var retained = new Queue<string>();
+            int lineCount = 0;
+            if (File.Exists(path))
+            {
+                foreach (string line in File.ReadLines(path, Encoding.UTF8))
+                {
+                    lineCount++;
+                    if (string.IsNullOrWhiteSpace(line))
+                    {
+                        continue;
+                    }
+
+                    retained.Enqueue(line);
+                    if (retained.Count > maxEntries)
+                    {
+                        retained.Dequeue();
+                    }
+                }
+            }
+
+            if (lineCount > 2 * maxEntries)
+            {
+                string compacted = path + ".tmp";
+                File.WriteAllLines(compacted, retained, new UTF8Encoding(false));
+                File.Move(compacted, path, overwrite: true);
+            }
+
+            return new CommandHistory(path, retained, maxEntries, diagnostics);
+        }
+        catch (Exception ex) when (ex is IOException or UnauthorizedAccessException)
+        {
+            diagnostics?.WriteDiagnostic(DiagnosticLevel.Warning, "History", $"Could not open '{path}': {ex.Message}");
+            return new CommandHistory(maxEntries);
+        }
+    }
+
+    /// <summary>
+    /// Records a submitted command. Blank commands and a repeat of the last command are ignored.
+    /// Past the retained number of entries the oldest one is dropped.
+    /// </summary>
+    /// <param name="command">The command as submitted.</param>
+    public void Add(string command)
+    {
+        ArgumentNullException.ThrowIfNull(command);
+
+        // One entry per line in the log.
+        string entry = command.ReplaceLineEndings(" ").Trim();
+        if (entry.Length == 0 || (Count > 0 && _entries[^1] == entry))
+        {
+            return;
+        }
+
+        Index(entry);
+        if (Count > _maxEntries)
+        {
+            DropOldest();
+        }
+
+        _pending?.Writer.TryWrite(entry);
+    }
+
+    /// <summary>
+    /// Finds the nearest entry starting with a prefix, for Up/Down recall.
+    /// </summary>
+    /// <param name="prefix">The typed prefix; an empty prefix matches every entry.</param>
+    /// <param name="from">Position to search from, exclusive; <see cref="Count"/> starts at the newest entry.</param>
+    /// <param name="older">Searches towards older entries when true, newer ones otherwise.</param>
+    /// <returns>Position of the match, or -1.</returns>
+    public int FindPrefix(string prefix, int from, bool older = true)
+    {
+        ArgumentNullException.ThrowIfNull(prefix);
+
+        string folded = Fold(prefix);
+        if (folded.Length == 0)
+        {
+            return Walk(null, from, older, static (_, _) => true, folded);
+        }
+
+        TrieNode? node = _trieRoot;
+        for (int i = 0; i < folded.Length && i < TrieDepth && node != null; i++)
+        {
+            node = node.Children?.GetValueOrDefault(folded[i]);
+        }
+
+        if (node == null)
+        {
+            return -1;
+        }
+
+        return folded.Length <= TrieDepth
+            ? Walk(node.Positions, from, older, static (_, _) => true, folded)
+            : Walk(node.Positions, from, older, static (entry, query) => entry.StartsWith(query, StringComparison.Ordinal), folded);
+    }
+
+    /// <summary>
+    /// Finds the nearest entry containing text, for reverse incremental search.
+    /// </summary>
+    /// <param name="text">The search text.</param>
+    /// <param name="from">Position to search from, exclusive; <see cref="Count"/> starts at the newest entry.</param>
+    /// <param name="older">Searches towards older entries when true, newer ones otherwise.</param>
+    /// <returns>Position of the match, or -1.</returns>
+    public int FindContaining(string text, int from, bool older = true)
+    {
+        ArgumentNullException.ThrowIfNull(text);
+
+        string folded = Fold(text);
+        if (folded.Length == 0)
+        {
+            return -1;
+        }
+
+        // Every match contains every trigram of the query, so the rarest one gives the fewest candidates.
+        List<int>? candidates = null;
+        if (folded.Length >= GramLength)
+        {
+            for (int i = 0; i + GramLength <= folded.Length; i++)
+            {
+                if (!_grams.TryGetValue(GramKey(folded, i), out List<int>? positions))
+                {
+                    return -1;
+                }
+
+                if (candidates == null || positions.Count < candidates.Count)
+                {
+                    candidates = positions;
+                }
+            }
+        }
+
+        return Walk(candidates, from, older, static (entry, query) => entry.Contains(query, StringComparison.Ordinal), folded);
+    }
+
+    /// <summary>
+    /// Ranks recent entries by how many trigrams they share with a query, so near misses and reordered
+    /// words still match.
+    /// </summary>
+    /// <param name="query">The search text.</param>
+    /// <param name="maxResults">Most entries to return.</param>
+    /// <returns>Positions of the best matches, best first; newer entries win ties.</returns>
+    public IReadOnlyList<int> FindFuzzy(string query, int maxResults = 10)
+    {
+        ArgumentNullException.ThrowIfNull(query);
+        ArgumentOutOfRangeException.ThrowIfNegativeOrZero(maxResults);
+
+        string folded = Fold(query);
+        if (folded.Length < GramLength)
+        {
+            int match = FindContaining(query, Count);
+            return match < 0 ? [] : [match];
+        }
+
+        var scores = new Dictionary<int, int>();
+        var seenGrams = new HashSet<long>();
+        for (int i = 0; i + GramLength <= folded.Length; i++)
+        {
+            long gram = GramKey(folded, i);
+            if (!seenGrams.Add(gram) || !_grams.TryGetValue(gram, out List<int>? positions))
+            {
+                continue;
+            }
+
+            // Only the newest postings of common trigrams are scored, which bounds the work per query.
+            for (int p = positions.Count - 1; p >= 0 && p >= positions.Count - FuzzyPostingsPerGram; p--)
+            {
+                int position = positions[p];
+                if (position < _start)
+                {
+                    break;
+                }
+
+                if (IsLatest(position))
+                {
+                    scores[position] = scores.GetValueOrDefault(position) + 1;
+                }
+            }
+        }
+
+        int required = Math.Max(1, seenGrams.Count / 2);
+        var ranked = new List<KeyValuePair<int, int>>();
+        foreach (KeyValuePair<int, int> score in scores)
+        {
+            if (score.Value >= required)
+            {
+                ranked.Add(score);
+            }
+        }
+
+        ranked.Sort(static (a, b) => a.Value != b.Value ? b.Value.CompareTo(a.Value) : b.Key.CompareTo(a.Key));
+        var best = new List<int>(Math.Min(maxResults, ranked.Count));
+        for (int i = 0; i < ranked.Count && i < maxResults; i++)
+        {
+            best.Add(ranked[i].Key - _start);
+        }
+
+        return best;
+    }
+
+    /// <summary>
+    /// Writes the queued commands and stops the background writer.
+    /// </summary>
+    public void Dispose()
+    {
+        if (_pending == null || !_pending.Writer.TryComplete())
+        {
+            return;
+        }
+
+        _writer!.GetAwaiter().GetResult();
+    }
+
+    private void Index(string entry)
+    {
+        int position = _entries.Count;
+        string folded = Fold(entry);
+        _entries.Add(entry);
+        _foldedEntries.Add(folded);
+        _superseded.Add(false);
+        if (_latest.TryGetValue(entry, out int previous))
+        {
+            _superseded[previous] = true;
+        }
+
+        _latest[entry] = position;
+
+        TrieNode node = _trieRoot;
+        for (int i = 0; i < folded.Length && i < TrieDepth; i++)
+        {
+            node.Children ??= new Dictionary<char, TrieNode>();
+            if (!node.Children.TryGetValue(folded[i], out TrieNode? child))
+            {
+                child = new TrieNode();
+                node.Children.Add(folded[i], child);
+            }
+
+            node = child;
+            node.Positions.Add(position);
+        }
+
+        for (int i = 0; i + GramLength <= folded.Length; i++)
+        {
+            long gram = GramKey(folded, i);
+            if (!_grams.TryGetValue(gram, out List<int>? positions))
+            {
+                positions = new List<int>();
+                _grams.Add(gram, positions);
+            }
+
+            // A trigram repeated within one entry is posted once.
+            if (positions.Count == 0 || positions[^1] != position)
+            {
+                positions.Add(position);
+            }
+        }
+    }
+
+    /// <summary>
+    /// Drops the oldest retained entry, and rebuilds the index once the dropped slots are as many as the
+    /// retained entries.
+    /// </summary>
+    private void DropOldest()
+    {
+        string oldest = _entries[_start];
+        if (_latest.TryGetValue(oldest, out int latest) && latest == _start)
+        {
+            _latest.Remove(oldest);
+        }
+
+        // The slot stays until the rebuild; only the text is released.
+        _entries[_start] = string.Empty;
+        _foldedEntries[_start] = string.Empty;
+        _start++;
+
+        if (_start < _maxEntries)
+        {
+            return;
+        }
+
+        List<string> retained = _entries.GetRange(_start, Count);
+        _entries.Clear();
+        _foldedEntries.Clear();
+        _superseded.Clear();
+        _latest.Clear();
+        _grams.Clear();
+        _trieRoot.Children = null;
+        _start = 0;
+        foreach (string entry in retained)
+        {
+            Index(entry);
+        }
+    }
+
+    /// <summary>
+    /// Walks candidate positions from a start position and returns the first one that matches.
+    /// A null list walks every position. Candidates are index slots; dropped slots are never returned.
+    /// </summary>
+    private int Walk(List<int>? candidates, int from, bool older, Func<string, string, bool> matches, string query)
+    {
+        int slot = _start + from;
+        int count = candidates?.Count ?? _entries.Count;
+        int start = candidates == null ? slot : LowerBound(candidates, older ? slot : Math.Max(slot, _start));
+        if (!older && start < count && (candidates?[start] ?? start) == slot)
+        {
+            start++;
+        }
+
+        int step = older ? -1 : 1;
+        for (int i = older ? start - 1 : start; i >= 0 && i < count; i += step)
+        {
+            int position = candidates?[i] ?? i;
+            if (position < _start)
+            {
+                // Only reached walking older: everything further back was dropped.
+                break;
+            }
+
+            if (IsLatest(position) && matches(_foldedEntries[position], query))
+            {
+                return position - _start;
+            }
+        }
+
+        return -1;
+    }
+
+    private bool IsLatest(int position)
+    {
+        return !_superseded[position];
+    }
+
+    private static int LowerBound(List<int> positions, int value)
+    {
+        int low = 0;
+        int high = positions.Count;
+        while (low < high)
+        {
+            int mid = (low + high) >>> 1;
+            if (positions[mid] < value)
+            {
+                low = mid + 1;
+            }
+            else
+            {
+                high = mid;
+            }
+        }
+
+        return low;
+    }
+
+    private static long GramKey(string folded, int start)
+    {
+        return ((long)folded[start] << 32) | ((long)folded[start + 1] << 16) | folded[start + 2];
+    }
+
+    private static string Fold(string text)
+    {
+        var builder = new StringBuilder(text.Length);
+        foreach (char c in text)
+        {
+            if (c == Tatweel || CharUnicodeInfo.GetUnicodeCategory(c) == UnicodeCategory.NonSpacingMark)
+            {
+                continue;
+            }
+
+            builder.Append(char.ToLowerInvariant(c));
+        }
+
+        return builder.ToString();
+    }
+
+    private static async Task WriteBatchesAsync(string path, ChannelReader<string> pending, IExecutionSink? diagnostics)
+    {
+        try
+        {
+            await using var stream = new FileStream(path, FileMode.Append, FileAccess.Write, FileShare.ReadWrite);
+            await using var writer = new StreamWriter(stream, new UTF8Encoding(false));
+            while (await pending.WaitToReadAsync().ConfigureAwait(false))
+            {
+                while (pending.TryRead(out string? entry))
+                {
+                    await writer.WriteLineAsync(entry).ConfigureAwait(false);
+                }
+
+                await writer.FlushAsync().ConfigureAwait(false);
+            }
+        }
+        catch (Exception ex) when (ex is IOException or UnauthorizedAccessException)
+        {
+            // The session keeps its history in memory; later commands are not persisted.
+            diagnostics?.WriteDiagnostic(DiagnosticLevel.Warning, "History", $"Could not write '{path}': {ex.Message}");
+        }
+    }
+
+    private sealed class TrieNode
+    {
+        public Dictionary<char, TrieNode>? Children { get; set; }
+
+        public List<int> Positions { get; } = new();
+    }
+}
@@ -12,15 +12,21 @@ internal static class CoreConsole
     private static readonly AsyncLocal<ExecutionContext?> CurrentContext = new();
     private static readonly SinkTextWriter StdOutWriter = new(isError: false);
     private static readonly SinkTextWriter StdErrWriter = new(isError: true);
-    private static ConsoleColor _foregroundColor = ConsoleColor.Gray;
 
     /// <summary>
-    /// Gets or sets the current foreground color.
+    /// Gets or sets the foreground color of the active sink scope. It is kept per scope so concurrent
+    /// sessions do not share it; outside a scope it is always the default.
     /// </summary>
     public static ConsoleColor ForegroundColor
     {
-        get => _foregroundColor;
-        set => _foregroundColor = value;
+        get => CurrentContext.Value?.ForegroundColor ?? ConsoleColor.Gray;
+        set
+        {
+            if (CurrentContext.Value is { } context)
+            {
+                context.ForegroundColor = value;
+            }
+        }
     }
 
     /// <summary>
@@ -33,6 +39,17 @@ internal static class CoreConsole
     /// </summary>
     public static TextWriter Error => StdErrWriter;
 
+    /// <summary>
+    /// Gets the execution options of the active sink scope, or null outside a scope.
+    /// </summary>
+    public static ExecutionOptions? Options => CurrentContext.Value?.Options;
+
+    /// <summary>
+    /// Gets the number of warnings and errors logged in the active sink scope, including ones its
+    /// options filtered out. Lets a caller tell whether a step reported a problem.
+    /// </summary>
+    public static int ProblemCount => CurrentContext.Value?.ProblemCount ?? 0;
+
     /// <summary>
     /// Begins an execution sink scope for current async flow.
     /// </summary>
@@ -47,47 +64,94 @@ internal static class CoreConsole
     }
 
     /// <summary>
-    /// Writes a line using sink classification rules.
+    /// Determines whether diagnostics of a level reach the active sink.
     /// </summary>
-    /// <param name="message">The message to emit.</param>
-    public static void WriteLine(string? message)
+    /// <param name="level">The diagnostic level.</param>
+    /// <returns>True when a sink scope is active and the level is enabled by its options.</returns>
+    public static bool IsEnabled(DiagnosticLevel level)
     {
-        if (string.IsNullOrEmpty(message))
+        var context = CurrentContext.Value;
+        if (context is null)
         {
-            return;
+            return false;
         }
 
-        var context = CurrentContext.Value;
-        if (context is null)
+        return level switch
+        {
+            DiagnosticLevel.Debug => context.Options.EmitDebug,
+            DiagnosticLevel.Warning => context.Options.EmitWarnings,
+            _ => true
+        };
+    }
+
+    /// <summary>
+    /// Writes a debug diagnostic. The interpolated message is only formatted when debug output is enabled.
+    /// </summary>
+    /// <param name="category">The emitting component.</param>
+    /// <param name="message">The interpolated message.</param>
+    public static void LogDebug(string category, ref DebugInterpolatedStringHandler message)
+    {
+        if (!message.IsEnabled)
         {
             return;
         }
 
-        if (IsDebug(message))
+        Emit(DiagnosticLevel.Debug, category, message.ToStringAndClear());
+    }
+
+    /// <summary>
+    /// Writes a debug diagnostic.
+    /// </summary>
+    /// <param name="category">The emitting component.</param>
+    /// <param name="message">The message.</param>
+    public static void LogDebug(string category, string message)
+    {
+        if (IsEnabled(DiagnosticLevel.Debug))
         {
-            if (context.Options.EmitDebug)
-            {
-                context.Sink.WriteDebug(message);
-            }
-            return;
+            Emit(DiagnosticLevel.Debug, category, message);
         }
+    }
 
-        if (IsWarning(message))
+    /// <summary>
+    /// Writes a warning diagnostic.
+    /// </summary>
+    /// <param name="category">The emitting component.</param>
+    /// <param name="message">The message.</param>
+    public static void LogWarning(string category, string message)
+    {
+        CountProblem();
+        if (IsEnabled(DiagnosticLevel.Warning))
         {
-            if (context.Options.EmitWarnings)
-            {
-                context.Sink.WriteWarning(message);
-            }
-            return;
+            Emit(DiagnosticLevel.Warning, category, message);
         }
+    }
 
-        if (IsError(message))
+    /// <summary>
+    /// Writes an error diagnostic.
+    /// </summary>
+    /// <param name="category">The emitting component.</param>
+    /// <param name="message">The message.</param>
+    public static void LogError(string category, string message)
+    {
+        CountProblem();
+        if (IsEnabled(DiagnosticLevel.Error))
+        {
+            Emit(DiagnosticLevel.Error, category, message);
+        }
+    }
+
+    /// <summary>
+    /// Writes an output line to the active sink.
+    /// </summary>
+    /// <param name="message">The message to emit.</param>
+    public static void WriteLine(string? message)
+    {
+        if (string.IsNullOrEmpty(message))
         {
-            context.Sink.WriteError(message);
             return;
         }
 
-        context.Sink.WriteOutput(message);
+        CurrentContext.Value?.Sink.WriteOutput(message);
     }
 
     /// <summary>
@@ -110,25 +174,25 @@ internal static class CoreConsole
     /// </summary>
     public static void ResetColor()
     {
-        _foregroundColor = ConsoleColor.Gray;
+        ForegroundColor = ConsoleColor.Gray;
     }
 
-    private static bool IsDebug(string message)
+    private static void CountProblem()
     {
-        return message.StartsWith("DEBUG", StringComparison.OrdinalIgnoreCase);
+        if (CurrentContext.Value is { } context)
+        {
+            context.ProblemCount++;
+        }
     }
 
-    private static bool IsWarning(string message)
+    private static void Emit(DiagnosticLevel level, string category, string message)
     {
-        return message.StartsWith("WARN", StringComparison.OrdinalIgnoreCase)
-            || message.StartsWith("WARNING", StringComparison.OrdinalIgnoreCase);
-    }
+        if (string.IsNullOrEmpty(message))
+        {
+            return;
+        }
 
-    private static bool IsError(string message)
-    {
-        return message.StartsWith("ERROR", StringComparison.OrdinalIgnoreCase)
-            || message.StartsWith("Task Error", StringComparison.OrdinalIgnoreCase)
-            || message.StartsWith("[ERROR", StringComparison.OrdinalIgnoreCase);
+        CurrentContext.Value?.Sink.WriteDiagnostic(level, category, message);
     }
 
     private sealed class ExecutionContext
@@ -142,6 +206,10 @@ internal static class CoreConsole
         public IExecutionSink Sink { get; }
 
         public ExecutionOptions Options { get; }
+
+        public ConsoleColor ForegroundColor { get; set; } = ConsoleColor.Gray;
+
+        public int ProblemCount { get; set; }
     }
 
     private sealed class Scope : IDisposable
@@ -0,0 +1,53 @@
+using System;
+using System.Runtime.CompilerServices;
+
+namespace ArbSh.Core;
+
+/// <summary>
+/// Interpolated string handler for <see cref="CoreConsole.LogDebug(string, ref DebugInterpolatedStringHandler)"/>.
+/// When debug output is disabled for the current scope the compiler skips every append,
+/// so the message is never formatted.
+/// </summary>
+[InterpolatedStringHandler]
+internal ref struct DebugInterpolatedStringHandler
+{
+    private DefaultInterpolatedStringHandler _builder;
+
+    /// <summary>
+    /// Creates the handler and reports whether debug output is enabled.
+    /// </summary>
+    /// <param name="literalLength">Total length of the literal parts.</param>
+    /// <param name="formattedCount">Number of interpolation holes.</param>
+    /// <param name="isEnabled">Whether the compiler should evaluate the holes.</param>
+    public DebugInterpolatedStringHandler(int literalLength, int formattedCount, out bool isEnabled)
+    {
+        IsEnabled = CoreConsole.IsEnabled(DiagnosticLevel.Debug);
+        _builder = IsEnabled ? new DefaultInterpolatedStringHandler(literalLength, formattedCount) : default;
+        isEnabled = IsEnabled;
+    }
+
+    /// <summary>
+    /// Gets a value indicating whether the message is being built.
+    /// </summary>
+    public bool IsEnabled { get; }
+
+    public void AppendLiteral(string value) => _builder.AppendLiteral(value);
+
+    public void AppendFormatted<T>(T value) => _builder.AppendFormatted(value);
+
+    public void AppendFormatted<T>(T value, string? format) => _builder.AppendFormatted(value, format);
+
+    public void AppendFormatted<T>(T value, int alignment) => _builder.AppendFormatted(value, alignment);
+
+    public void AppendFormatted<T>(T value, int alignment, string? format) => _builder.AppendFormatted(value, alignment, format);
+
+    public void AppendFormatted(ReadOnlySpan<char> value) => _builder.AppendFormatted(value);
+
+    public void AppendFormatted(string? value) => _builder.AppendFormatted(value);
+
+    /// <summary>
+    /// Returns the built message and releases the pooled buffer.
+    /// </summary>
+    /// <returns>The formatted message, or empty when disabled.</returns>
+    public string ToStringAndClear() => IsEnabled ? _builder.ToStringAndClear() : string.Empty;
+}
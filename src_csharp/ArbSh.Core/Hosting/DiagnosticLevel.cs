@@ -0,0 +1,49 @@
+namespace ArbSh.Core;
+
+/// <summary>
+/// Severity of an engine diagnostic delivered to an <see cref="IExecutionSink"/>.
+/// </summary>
+public enum DiagnosticLevel
+{
+    /// <summary>
+    /// Trace output, only emitted when <see cref="ExecutionOptions.EmitDebug"/> is set.
+    /// </summary>
+    Debug,
+
+    /// <summary>
+    /// Recoverable problem, emitted unless <see cref="ExecutionOptions.EmitWarnings"/> is cleared.
+    /// </summary>
+    Warning,
+
+    /// <summary>
+    /// Failure, always emitted.
+    /// </summary>
+    Error
+}
+
+/// <summary>
+/// Text formatting shared by sinks that render diagnostics as plain lines.
+/// </summary>
+public static class DiagnosticFormatter
+{
+    /// <summary>
+    /// Formats a diagnostic as <c>LEVEL (category): message</c>.
+    /// </summary>
+    /// <param name="level">The diagnostic level.</param>
+    /// <param name="category">The emitting component, or empty.</param>
+    /// <param name="message">The diagnostic message.</param>
+    /// <returns>The formatted line.</returns>
+    public static string Format(DiagnosticLevel level, string category, string message)
+    {
+        string prefix = level switch
+        {
+            DiagnosticLevel.Debug => "DEBUG",
+            DiagnosticLevel.Warning => "WARN",
+            _ => "ERROR"
+        };
+
+        return string.IsNullOrEmpty(category)
+            ? $"{prefix}: {message}"
+            : $"{prefix} ({category}): {message}";
+    }
+}
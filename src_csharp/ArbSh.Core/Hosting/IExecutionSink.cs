@@ -28,6 +28,30 @@ public interface IExecutionSink
     /// </summary>
     /// <param name="message">The debug message.</param>
     void WriteDebug(string message);
+
+    /// <summary>
+    /// Writes an engine diagnostic with its level and emitting category.
+    /// The default implementation formats the line and routes it to the matching writer.
+    /// </summary>
+    /// <param name="level">The diagnostic level.</param>
+    /// <param name="category">The emitting component (for example <c>Executor</c>).</param>
+    /// <param name="message">The diagnostic message, without level or category prefix.</param>
+    void WriteDiagnostic(DiagnosticLevel level, string category, string message)
+    {
+        string line = DiagnosticFormatter.Format(level, category, message);
+        switch (level)
+        {
+            case DiagnosticLevel.Debug:
+                WriteDebug(line);
+                break;
+            case DiagnosticLevel.Warning:
+                WriteWarning(line);
+                break;
+            default:
+                WriteError(line);
+                break;
+        }
+    }
 }
 
 /// <summary>
@@ -44,6 +68,28 @@ public sealed class ExecutionOptions
     /// Gets or sets a value indicating whether warning messages should be emitted.
     /// </summary>
     public bool EmitWarnings { get; init; } = true;
+
+    /// <summary>
+    /// Gets or sets the maximum number of objects buffered between two pipeline stages
+    /// before the producing stage waits for the consumer. Zero or less disables the limit.
+    /// </summary>
+    public int PipelineCapacity { get; init; } = PipelineChannel.DefaultCapacity;
+
+    /// <summary>
+    /// Gets or sets the number of objects moved between pipeline stages per batch.
+    /// </summary>
+    public int PipelineBatchSize { get; init; } = PipelineChannel.DefaultBatchSize;
+
+    /// <summary>
+    /// Gets or sets the size, in bytes, of the buffers used to read and write redirected files.
+    /// </summary>
+    public int RedirectionBufferSize { get; init; } = RedirectionFile.DefaultBufferSize;
+
+    /// <summary>
+    /// Gets or sets the input file size, in bytes, from which <c>&lt;</c> reads through a memory mapping.
+    /// Zero or less always uses buffered file reads.
+    /// </summary>
+    public long RedirectionMemoryMapThreshold { get; init; } = RedirectionFile.DefaultMemoryMapThreshold;
 }
 
 /// <summary>
@@ -29,6 +29,17 @@ namespace ArbSh.Core
             }
         }
 
+        /// <summary>
+        /// يرجع قيمة متغير من الجلسة النشطة، أو من المتغيرات المدمجة خارج أي جلسة.
+        /// </summary>
+        /// <param name="name">اسم المتغير دون علامة $.</param>
+        /// <returns>قيمة المتغير أو نص فارغ.</returns>
+        internal static string GetVariable(string name)
+        {
+            ShellSessionState? state = CurrentState.Value;
+            return state is null ? ShellSessionState.GetDefaultVariable(name) : state.GetVariable(name);
+        }
+
         /// <summary>
         /// يدخل حالة جلسة في نطاق التنفيذ الحالي.
         /// </summary>
@@ -1,6 +1,6 @@
 ﻿using System;
-using System.Collections.Generic;
-using System.Text;
+using System.Buffers;
+using System.Collections.Concurrent;
 
 namespace ArbSh.Core.I18n
 {
@@ -11,26 +11,28 @@ namespace ArbSh.Core.I18n
     /// </summary>
     public static class ArabicShaper
     {
-        // Define the 4 forms for each letter
-        private class ArabicChar
-        {
-            public char Isolated;
-            public char Final;
-            public char Initial;
-            public char Medial;
-            public bool ConnectsToEnd; // Can connect to the next char (left in visual RTL)?
+        // First code point of the Arabic block covered by the flat tables (U+0600–U+06FF).
+        private const char BlockStart = '\u0600';
+        private const int BlockSize = 0x100;
 
-            public ArabicChar(char iso, char fin, char ini, char med, bool connectsToEnd)
-            {
-                Isolated = iso;
-                Final = fin;
-                Initial = ini;
-                Medial = med;
-                ConnectsToEnd = connectsToEnd;
-            }
-        }
+        // Form slots inside Forms: four entries per code point of the block.
+        private const int IsolatedForm = 0;
+        private const int FinalForm = 1;
+        private const int InitialForm = 2;
+        private const int MedialForm = 3;
+
+        // Lines longer than this are shaped on demand and never cached.
+        private const int MaxCachedLength = 256;
+        private const int CacheCapacity = 512;
+
+        // Presentation forms indexed by (c - BlockStart) * 4 + form; zero when c is not shaped.
+        private static readonly char[] Forms = new char[BlockSize * 4];
+
+        // Per code point: whether the letter is shaped at all, and whether it joins the following letter.
+        private static readonly bool[] IsShaped = new bool[BlockSize];
+        private static readonly bool[] ConnectsToEnd = new bool[BlockSize];
 
-        private static readonly Dictionary<char, ArabicChar> Map = new Dictionary<char, ArabicChar>();
+        private static readonly ConcurrentDictionary<string, string> Cache = new(StringComparer.Ordinal);
 
         static ArabicShaper()
         {
@@ -113,135 +115,134 @@ namespace ArbSh.Core.I18n
 
         private static void AddChar(char c, char iso, char fin, char ini, char med, bool connects)
         {
-            Map[c] = new ArabicChar(iso, fin, ini, med, connects);
+            int index = c - BlockStart;
+            Forms[index * 4 + IsolatedForm] = iso;
+            Forms[index * 4 + FinalForm] = fin;
+            Forms[index * 4 + InitialForm] = ini;
+            Forms[index * 4 + MedialForm] = med;
+            IsShaped[index] = true;
+            ConnectsToEnd[index] = connects;
         }
 
         /// <summary>
         /// يقوم بتشكيل النص العربي في السلسلة النصية المعطاة.
         /// Shapes the Arabic text in the given string, connecting letters based on context.
+        /// Short results are cached, so repeated lines such as prompts and help text are shaped once.
         /// </summary>
         public static string Shape(string text)
         {
             if (string.IsNullOrEmpty(text)) return text;
 
-            StringBuilder sb = new StringBuilder(text.Length);
-            
+            // Text with no shapeable letter is returned as is, without a copy.
+            if (text.AsSpan().IndexOfAnyInRange('\u0621', '\u064A') < 0) return text;
+
+            if (text.Length <= MaxCachedLength && Cache.TryGetValue(text, out string? cached))
+            {
+                return cached;
+            }
+
+            string shaped = ShapeToString(text);
+
+            if (text.Length <= MaxCachedLength)
+            {
+                if (Cache.Count >= CacheCapacity)
+                {
+                    Cache.Clear();
+                }
+
+                Cache.TryAdd(text, shaped);
+            }
+
+            return shaped;
+        }
+
+        /// <summary>
+        /// يشكّل النص في المخزن المعطى دون إنشاء سلاسل جديدة.
+        /// Shapes <paramref name="text"/> into <paramref name="destination"/> without allocating.
+        /// Lam-Alef pairs become one ligature, so the result is never longer than the input.
+        /// </summary>
+        /// <param name="text">The logical text.</param>
+        /// <param name="destination">Receives the shaped text; must be at least as long as <paramref name="text"/>.</param>
+        /// <returns>The number of characters written.</returns>
+        public static int Shape(ReadOnlySpan<char> text, Span<char> destination)
+        {
+            if (destination.Length < text.Length)
+            {
+                throw new ArgumentException("Destination must be at least as long as the source text.", nameof(destination));
+            }
+
+            int written = 0;
             for (int i = 0; i < text.Length; i++)
             {
                 char current = text[i];
+                int index = current - BlockStart;
+
+                // Non-Arabic or not in our table (e.g. spaces, numbers, diacritics)
+                if ((uint)index >= BlockSize || !IsShaped[index])
+                {
+                    destination[written++] = current;
+                    continue;
+                }
 
-                // Handle Lam-Alef Ligatures
+                bool prevConnects = i > 0 && JoinsNext(text[i - 1]);
+
+                // Handle Lam-Alef Ligatures. Lam-Alef only has Isolated and Final forms (it ends with Alef).
                 if (current == '\u0644' && i + 1 < text.Length)
                 {
-                    char next = text[i + 1];
-                    char ligature = GetLamAlef(next);
+                    char ligature = GetLamAlef(text[i + 1]);
                     if (ligature != '\0')
                     {
-                        // Found a Lam-Alef combination
-                        // Determine form based on previous char
-                        bool prevConnects = CanConnectToPrevious(text, i);
-                        
-                        // Lam-Alef only has Isolated and Final forms (it ends with Alef)
-                        // Example: LRM + LamAlef -> Isolated (U+FEFB)
-                        //          Beh + LamAlef -> Final (U+FEFC)
-                        
-                        // We need the specific ligature char from the table
-                        // But since we are simplifying, we can check the Unicode block
-                        // Ligatures: 
-                        // Lam-Alef Mad: FEF5 (Iso), FEF6 (Fin)
-                        // Lam-Alef Hamza Above: FEF7 (Iso), FEF8 (Fin)
-                        // Lam-Alef Hamza Below: FEF9 (Iso), FEFA (Fin)
-                        // Lam-Alef: FEFB (Iso), FEFC (Fin)
-
-                        char shapedLigature;
-                        if (prevConnects)
-                        {
-                            // Final form
-                            if (ligature == '\uFEFB') shapedLigature = '\uFEFC'; // Basic
-                            else if (ligature == '\uFEF5') shapedLigature = '\uFEF6'; // Mad
-                            else if (ligature == '\uFEF7') shapedLigature = '\uFEF8'; // Hamza Up
-                            else if (ligature == '\uFEF9') shapedLigature = '\uFEFA'; // Hamza Down
-                            else shapedLigature = ligature; // Fallback
-                        }
-                        else
-                        {
-                            // Isolated form (default returned by GetLamAlef)
-                            shapedLigature = ligature;
-                        }
-
-                        sb.Append(shapedLigature);
+                        // The Final form follows the Isolated one in each ligature pair.
+                        destination[written++] = prevConnects ? (char)(ligature + 1) : ligature;
                         i++; // Skip the Alef
                         continue;
                     }
                 }
 
-                if (Map.ContainsKey(current))
-                {
-                    bool prevConnects = CanConnectToPrevious(text, i);
-                    bool nextConnects = CanConnectToNext(text, i);
-
-                    ArabicChar info = Map[current];
-                    char shapedChar;
+                bool nextConnects = ConnectsToEnd[index] && i + 1 < text.Length && IsShapedLetter(text[i + 1]);
 
-                    if (!prevConnects && !nextConnects)
-                    {
-                        shapedChar = info.Isolated;
-                    }
-                    else if (prevConnects && !nextConnects)
-                    {
-                        shapedChar = info.Final;
-                    }
-                    else if (!prevConnects && nextConnects)
-                    {
-                        shapedChar = info.Initial;
-                    }
-                    else // prevConnects && nextConnects
-                    {
-                        shapedChar = info.Medial;
-                    }
+                int form = prevConnects
+                    ? (nextConnects ? MedialForm : FinalForm)
+                    : (nextConnects ? InitialForm : IsolatedForm);
 
-                    sb.Append(shapedChar);
-                }
-                else
-                {
-                    // Non-Arabic or not in our map (e.g. spaces, numbers, diacritics)
-                    sb.Append(current);
-                }
+                destination[written++] = Forms[index * 4 + form];
             }
 
-            return sb.ToString();
+            return written;
         }
 
-        private static bool CanConnectToPrevious(string text, int currentIndex)
+        private static string ShapeToString(string text)
         {
-            if (currentIndex == 0) return false;
-            char prev = text[currentIndex - 1];
-            
-            // Skip non-spacing marks (Harakat) if we want to support them (simplified: we don't skip yet)
-            // Ideally we'd look back further if prev is a diacritic.
+            char[]? rented = null;
+            Span<char> buffer = text.Length <= 256
+                ? stackalloc char[256]
+                : (rented = ArrayPool<char>.Shared.Rent(text.Length));
 
-            if (Map.TryGetValue(prev, out ArabicChar? info))
+            try
             {
-                // The previous char must be able to connect to its END (left)
-                return info.ConnectsToEnd;
+                int written = Shape(text, buffer);
+                return new string(buffer[..written]);
             }
-            return false; // Prev char is not an Arabic letter (e.g. space) or doesn't connect
-        }
-
-        private static bool CanConnectToNext(string text, int currentIndex)
-        {
-            // First, does the CURRENT char support connecting to the end?
-            char current = text[currentIndex];
-            if (!Map.TryGetValue(current, out ArabicChar? currentInfo) || !currentInfo.ConnectsToEnd)
+            finally
             {
-                return false;
+                if (rented != null)
+                {
+                    ArrayPool<char>.Shared.Return(rented);
+                }
             }
+        }
 
-            if (currentIndex >= text.Length - 1) return false;
-            char next = text[currentIndex + 1];
+        // All Arabic letters connect to their beginning (right); only some connect to their end.
+        private static bool IsShapedLetter(char c)
+        {
+            int index = c - BlockStart;
+            return (uint)index < BlockSize && IsShaped[index];
+        }
 
-            // Does the NEXT char exist in map? (All Arabic letters connect to their beginning/right)
-            return Map.ContainsKey(next);
+        private static bool JoinsNext(char c)
+        {
+            int index = c - BlockStart;
+            return (uint)index < BlockSize && ConnectsToEnd[index];
         }
 
         private static char GetLamAlef(char candidate)
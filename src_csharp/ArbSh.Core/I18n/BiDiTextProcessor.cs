@@ -227,7 +227,7 @@ namespace ArbSh.Core.I18n
             }
             catch (Exception ex)
             {
-                CoreConsole.WriteLine($"WARNING (BiDi): BiDi processing failed: {ex.Message}");
+                CoreConsole.LogWarning("BiDi", $"BiDi processing failed: {ex.Message}");
                 // Fallback to original text if BiDi processing fails
                 return text;
             }
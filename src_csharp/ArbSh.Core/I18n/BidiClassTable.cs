@@ -0,0 +1,107 @@
+﻿using System;
+using System.Threading;
+
+namespace ArbSh.Core.I18n
+{
+    /// <summary>
+    /// Two-stage lookup table for Bidi_Class values (UAX #9 Table 4).
+    /// Stage 1 is indexed by the high bits of a codepoint and points at a 256-entry stage 2
+    /// block of <see cref="BidiCharacterType"/> values. Blocks are populated from ICU's UCD
+    /// data the first time any codepoint in them is looked up; after that a lookup is two
+    /// array reads with no ICU property call.
+    /// </summary>
+    /// <remarks>
+    /// Blocks whose entries all share one class (unassigned ranges, most CJK) collapse onto a
+    /// single shared block per class. Concurrent first lookups may build the same block twice;
+    /// both results are identical and only fully built blocks are published.
+    /// </remarks>
+    internal static class BidiClassTable
+    {
+        private const int BlockShift = 8;
+        private const int BlockSize = 1 << BlockShift;
+        private const int BlockMask = BlockSize - 1;
+        private const int MaxCodepoint = 0x10FFFF;
+
+        private static readonly byte[]?[] Stage1 = new byte[]?[(MaxCodepoint >> BlockShift) + 1];
+        private static readonly byte[]?[] UniformBlocks = new byte[]?[(int)BidiCharacterType.BN + 1];
+
+        /// <summary>
+        /// Looks up the Bidi_Class of a codepoint.
+        /// </summary>
+        /// <param name="codepoint">The Unicode codepoint.</param>
+        /// <returns>The BidiCharacterType.</returns>
+        public static BidiCharacterType Lookup(int codepoint)
+        {
+            if ((uint)codepoint > MaxCodepoint)
+            {
+                return BidiAlgorithm.GetCharTypeFromIcu(codepoint);
+            }
+
+            int blockIndex = codepoint >> BlockShift;
+            byte[] block = Volatile.Read(ref Stage1[blockIndex]) ?? FillBlock(blockIndex);
+            return (BidiCharacterType)block[codepoint & BlockMask];
+        }
+
+        /// <summary>
+        /// Classifies every UTF-16 code unit of <paramref name="text"/> in one pass.
+        /// </summary>
+        /// <param name="text">The text to classify.</param>
+        /// <param name="types">Receives one type per code unit.</param>
+        public static void Classify(ReadOnlySpan<char> text, Span<BidiCharacterType> types)
+        {
+            if (types.Length < text.Length)
+            {
+                throw new ArgumentException("Destination must be at least as long as the text.", nameof(types));
+            }
+
+            // Consecutive characters almost always fall in the same block; keep it in hand.
+            int currentBlockIndex = -1;
+            byte[] currentBlock = Array.Empty<byte>();
+
+            for (int i = 0; i < text.Length; i++)
+            {
+                int codepoint = text[i];
+                bool isPair = char.IsHighSurrogate(text[i]) && i + 1 < text.Length && char.IsLowSurrogate(text[i + 1]);
+                if (isPair)
+                {
+                    codepoint = char.ConvertToUtf32(text[i], text[i + 1]);
+                }
+
+                int blockIndex = codepoint >> BlockShift;
+                if (blockIndex != currentBlockIndex)
+                {
+                    currentBlock = Volatile.Read(ref Stage1[blockIndex]) ?? FillBlock(blockIndex);
+                    currentBlockIndex = blockIndex;
+                }
+
+                BidiCharacterType type = (BidiCharacterType)currentBlock[codepoint & BlockMask];
+                types[i] = type;
+                if (isPair)
+                {
+                    types[++i] = type; // Surrogate pair shares the same type
+                }
+            }
+        }
+
+        private static byte[] FillBlock(int blockIndex)
+        {
+            var block = new byte[BlockSize];
+            int firstCodepoint = blockIndex << BlockShift;
+            bool uniform = true;
+
+            for (int offset = 0; offset < BlockSize; offset++)
+            {
+                block[offset] = (byte)BidiAlgorithm.GetCharTypeFromIcu(firstCodepoint + offset);
+                uniform &= block[offset] == block[0];
+            }
+
+            if (uniform)
+            {
+                block = Interlocked.CompareExchange(ref UniformBlocks[block[0]], block, null) ?? block;
+            }
+
+            Volatile.Write(ref Stage1[blockIndex], block);
+            return block;
+        }
+    }
+}
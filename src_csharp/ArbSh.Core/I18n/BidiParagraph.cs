@@ -0,0 +1,1362 @@
+using System;
+using System.Buffers;
+using System.Collections.Generic;
+
+namespace ArbSh.Core.I18n
+{
+    /// <summary>
+    /// Reusable workspace that resolves UAX #9 embedding levels for one paragraph at a time.
+    /// Working arrays are rented from <see cref="ArrayPool{T}"/> and kept between calls, and
+    /// isolating run sequences are index ranges over a shared position buffer, so processing a
+    /// paragraph that fits the current buffers allocates nothing.
+    /// </summary>
+    /// <remarks>
+    /// An instance is not thread-safe. Results exposed by <see cref="Levels"/> and
+    /// <see cref="Types"/> are valid until the next call to <see cref="Process"/> or
+    /// <see cref="Dispose"/>.
+    /// </remarks>
+    public sealed class BidiParagraph : IDisposable
+    {
+        // Corresponds to MAX_DEPTH in UAX #9 (e.g., 125)
+        internal const int MaxEmbeddingDepth = 125;
+
+        // BD16 uses a fixed 63-element bracket stack
+        private const int MaxBracketStackDepth = 63;
+
+        private readonly DirectionalStatusStackEntry[] _statusStack = new DirectionalStatusStackEntry[MaxEmbeddingDepth + 1];
+        private readonly BracketStackEntry[] _bracketStack = new BracketStackEntry[MaxBracketStackDepth];
+        private readonly List<BracketPair> _bracketPairs = new List<BracketPair>();
+        private int _statusCount;
+
+        private BidiCharacterType[] _types = Array.Empty<BidiCharacterType>();
+        private int[] _levels = Array.Empty<int>();
+        private int[] _positions = Array.Empty<int>();
+        private bool[] _processed = Array.Empty<bool>();
+        private RunSequence[] _sequences = Array.Empty<RunSequence>();
+        private int _sequenceCount;
+
+        /// <summary>
+        /// Number of UTF-16 code units in the last processed paragraph.
+        /// </summary>
+        public int Length { get; private set; }
+
+        /// <summary>
+        /// Resolved paragraph embedding level (0 = LTR, 1 = RTL) of the last processed paragraph.
+        /// </summary>
+        public int ParagraphLevel { get; private set; }
+
+        /// <summary>
+        /// Resolved embedding level of each code unit.
+        /// </summary>
+        public ReadOnlySpan<int> Levels => _levels.AsSpan(0, Length);
+
+        /// <summary>
+        /// Resolved bidirectional type of each code unit after the W and N rules.
+        /// </summary>
+        public ReadOnlySpan<BidiCharacterType> Types => _types.AsSpan(0, Length);
+
+        /// <summary>
+        /// Resolves embedding levels for <paramref name="text"/> (UAX #9 P, X, W, N and I rules).
+        /// </summary>
+        /// <param name="text">One paragraph of logical text.</param>
+        /// <param name="baseLevel">Base paragraph level (0=LTR, 1=RTL, -1=auto-detect).</param>
+        public void Process(ReadOnlySpan<char> text, int baseLevel)
+        {
+            EnsureCapacity(text.Length);
+            Length = text.Length;
+            ParagraphLevel = 0;
+            _sequenceCount = 0;
+
+            if (text.IsEmpty)
+            {
+                return;
+            }
+
+            Span<BidiCharacterType> types = _types.AsSpan(0, Length);
+            Span<int> levels = _levels.AsSpan(0, Length);
+
+            // Classify the whole paragraph once; every later phase reads from types.
+            BidiAlgorithm.GetCharTypes(text, types);
+
+            // Phase 1: Determine paragraph embedding level (P2, P3)
+            ParagraphLevel = DetermineParagraphLevel(types, baseLevel);
+
+            // Phase 2: Apply X rules for explicit formatting characters
+            // Initial embedding level is the paragraph level
+            levels.Fill(ParagraphLevel);
+            ApplyXRules(text, types, levels, ParagraphLevel);
+
+            // W and N rules share the isolating run sequences: neither changes levels or
+            // the types of isolate initiators and PDIs, which are all the sequences depend on.
+            BuildIsolatingRunSequences(types, levels);
+
+            // Phase 3: Apply W rules for weak type resolution
+            for (int s = 0; s < _sequenceCount; s++)
+            {
+                ApplyWRulesToSequence(GetSequence(s));
+            }
+
+            // Phase 4: Apply N rules for neutral type resolution
+            for (int s = 0; s < _sequenceCount; s++)
+            {
+                ApplyNRulesToSequence(text, GetSequence(s));
+            }
+
+            // Phase 5: Apply I rules for final level assignment
+            ApplyIRules(types, levels);
+        }
+
+        /// <summary>
+        /// Appends the level runs of the last processed paragraph to <paramref name="runs"/>.
+        /// </summary>
+        /// <param name="runs">Destination list.</param>
+        public void GetRuns(List<BidiAlgorithm.BidiRun> runs)
+        {
+            ArgumentNullException.ThrowIfNull(runs);
+            if (Length == 0)
+            {
+                return;
+            }
+
+            ReadOnlySpan<int> levels = Levels;
+            int currentLevel = levels[0];
+            int runStart = 0;
+
+            for (int i = 1; i < levels.Length; i++)
+            {
+                if (levels[i] != currentLevel)
+                {
+                    // End current run and start new one
+                    runs.Add(new BidiAlgorithm.BidiRun(runStart, i - runStart, currentLevel));
+                    runStart = i;
+                    currentLevel = levels[i];
+                }
+            }
+
+            // Add final run
+            runs.Add(new BidiAlgorithm.BidiRun(runStart, levels.Length - runStart, currentLevel));
+        }
+
+        /// <summary>
+        /// Reorders the last processed paragraph for display (UAX #9 L2 and L4), matching
+        /// <see cref="BidiAlgorithm.ReorderRunsForDisplay(string, List{BidiAlgorithm.BidiRun}, int)"/>.
+        /// </summary>
+        /// <param name="text">The same text that was passed to <see cref="Process"/>.</param>
+        /// <returns>The visual string.</returns>
+        public string ReorderForDisplay(ReadOnlySpan<char> text)
+        {
+            if (text.Length != Length)
+            {
+                throw new ArgumentException("Text does not match the processed paragraph.", nameof(text));
+            }
+
+            if (Length == 0)
+            {
+                return string.Empty;
+            }
+
+            char[] chars = ArrayPool<char>.Shared.Rent(Length);
+            byte[] currentLevels = ArrayPool<byte>.Shared.Rent(Length);
+            try
+            {
+                text.CopyTo(chars);
+
+                int maxLevel = 0;
+                for (int i = 0; i < Length; i++)
+                {
+                    currentLevels[i] = (byte)_levels[i];
+                    maxLevel = Math.Max(maxLevel, _levels[i]);
+                }
+
+                // L2: From the highest level down to 1, reverse every contiguous sequence at that level or higher.
+                for (int level = maxLevel; level >= 1; level--)
+                {
+                    int start = -1;
+                    for (int i = 0; i < Length; i++)
+                    {
+                        if (currentLevels[i] >= level)
+                        {
+                            if (start == -1) start = i;
+                        }
+                        else if (start != -1)
+                        {
+                            ReverseRange(chars, currentLevels, start, i - start);
+                            start = -1;
+                        }
+                    }
+
+                    if (start != -1)
+                    {
+                        ReverseRange(chars, currentLevels, start, Length - start);
+                    }
+                }
+
+                // L4: Mirror characters that ended up at an odd (RTL) level
+                for (int i = 0; i < Length; i++)
+                {
+                    if (currentLevels[i] % 2 != 0)
+                    {
+                        chars[i] = BidiAlgorithm.GetMirroredChar(chars[i]);
+                    }
+                }
+
+                return new string(chars, 0, Length);
+            }
+            finally
+            {
+                ArrayPool<char>.Shared.Return(chars);
+                ArrayPool<byte>.Shared.Return(currentLevels);
+            }
+        }
+
+        /// <summary>
+        /// Returns the rented buffers to the pool.
+        /// </summary>
+        public void Dispose()
+        {
+            ReturnBuffers();
+            Length = 0;
+            ParagraphLevel = 0;
+            _sequenceCount = 0;
+        }
+
+        private void EnsureCapacity(int length)
+        {
+            if (_types.Length >= length)
+            {
+                return;
+            }
+
+            ReturnBuffers();
+            _types = ArrayPool<BidiCharacterType>.Shared.Rent(length);
+            _levels = ArrayPool<int>.Shared.Rent(length);
+            _positions = ArrayPool<int>.Shared.Rent(length);
+            _processed = ArrayPool<bool>.Shared.Rent(length);
+            _sequences = ArrayPool<RunSequence>.Shared.Rent(length);
+        }
+
+        private void ReturnBuffers()
+        {
+            if (_types.Length == 0)
+            {
+                return;
+            }
+
+            ArrayPool<BidiCharacterType>.Shared.Return(_types);
+            ArrayPool<int>.Shared.Return(_levels);
+            ArrayPool<int>.Shared.Return(_positions);
+            ArrayPool<bool>.Shared.Return(_processed);
+            ArrayPool<RunSequence>.Shared.Return(_sequences);
+
+            _types = Array.Empty<BidiCharacterType>();
+            _levels = Array.Empty<int>();
+            _positions = Array.Empty<int>();
+            _processed = Array.Empty<bool>();
+            _sequences = Array.Empty<RunSequence>();
+            _bracketPairs.Clear();
+        }
+
+        private static void ReverseRange(char[] chars, byte[] levels, int start, int length)
+        {
+            Array.Reverse(chars, start, length);
+            Array.Reverse(levels, start, length);
+        }
+
+        // --- P Rules (Paragraph Level) ---
+
+        /// <summary>
+        /// Determines the paragraph embedding level according to UAX #9 rules P2 and P3.
+        /// P2: Find the first character of type L, AL, or R while skipping over any characters
+        ///     between an isolate initiator and its matching PDI or, if it has no matching PDI,
+        ///     the end of the paragraph.
+        /// P3: If a character is found in P2 and it is of type AL or R, then set the paragraph
+        ///     embedding level to one; otherwise, set it to zero.
+        /// </summary>
+        private static int DetermineParagraphLevel(ReadOnlySpan<BidiCharacterType> types, int baseLevel)
+        {
+            // If explicit level provided and valid, use it
+            if (baseLevel >= 0 && baseLevel <= 1)
+            {
+                return baseLevel;
+            }
+
+            // Auto-detect paragraph level (P2, P3)
+            // Surrogate pairs share one type, so stepping per code unit is equivalent to per codepoint.
+            for (int i = 0; i < types.Length; i++)
+            {
+                BidiCharacterType charType = types[i];
+
+                // P2: Skip over characters between isolate initiator and its matching PDI
+                if (IsIsolateInitiator(charType))
+                {
+                    int matchingPDI = FindMatchingPDI(types, i);
+                    if (matchingPDI == -1)
+                    {
+                        // No matching PDI, skip to end of paragraph
+                        break;
+                    }
+
+                    i = matchingPDI;
+                    continue;
+                }
+
+                // P2: Ignore embedding initiators (but not characters within the embedding)
+                if (IsEmbeddingInitiator(charType))
+                {
+                    continue;
+                }
+
+                // P2: Check for strong characters (L, AL, R)
+                if (charType == BidiCharacterType.L)
+                {
+                    return 0; // P3: LTR paragraph
+                }
+                if (charType == BidiCharacterType.AL || charType == BidiCharacterType.R)
+                {
+                    return 1; // P3: RTL paragraph
+                }
+            }
+
+            // P3: No strong characters found, default to LTR
+            return 0;
+        }
+
+        /// <summary>
+        /// Helper method to check if a character type is an embedding initiator (LRE, RLE, LRO, RLO).
+        /// </summary>
+        private static bool IsEmbeddingInitiator(BidiCharacterType charType)
+        {
+            return charType == BidiCharacterType.LRE ||
+                   charType == BidiCharacterType.RLE ||
+                   charType == BidiCharacterType.LRO ||
+                   charType == BidiCharacterType.RLO;
+        }
+
+        // --- X Rules (Explicit Levels and Directions) ---
+
+        /// <summary>
+        /// Applies UAX #9 X rules (X1-X8) for processing explicit formatting characters.
+        /// This implements the core logic for handling LRE, RLE, LRO, RLO, PDF and setting embedding levels.
+        /// </summary>
+        private void ApplyXRules(ReadOnlySpan<char> text, Span<BidiCharacterType> types, Span<int> levels, int paragraphLevel)
+        {
+            // Initialize directional status stack with paragraph level
+            _statusCount = 0;
+            PushStatus(new DirectionalStatusStackEntry(paragraphLevel, DirectionalOverrideStatus.Neutral, false));
+
+            // X1: Process each character in the text
+            for (int i = 0; i < text.Length; i++)
+            {
+                BidiCharacterType charType = types[i];
+                DirectionalStatusStackEntry current = _statusStack[_statusCount - 1];
+
+                // Every explicit code gets the level it appears at (X2-X7).
+                levels[i] = current.EmbeddingLevel;
+
+                switch (charType)
+                {
+                    case BidiCharacterType.RLE:
+                        // X2: Right-to-Left Embedding
+                        PushEmbedding(current, NextOddLevel(current), DirectionalOverrideStatus.Neutral, false);
+                        break;
+
+                    case BidiCharacterType.LRE:
+                        // X3: Left-to-Right Embedding
+                        PushEmbedding(current, NextEvenLevel(current), DirectionalOverrideStatus.Neutral, false);
+                        break;
+
+                    case BidiCharacterType.RLO:
+                        // X4: Right-to-Left Override
+                        PushEmbedding(current, NextOddLevel(current), DirectionalOverrideStatus.RightToLeft, false);
+                        break;
+
+                    case BidiCharacterType.LRO:
+                        // X5: Left-to-Right Override
+                        PushEmbedding(current, NextEvenLevel(current), DirectionalOverrideStatus.LeftToRight, false);
+                        break;
+
+                    case BidiCharacterType.PDF:
+                        // X7: Pop Directional Formatting. An unmatched PDF has no effect.
+                        if (_statusCount > 1)
+                        {
+                            _statusCount--;
+                        }
+                        break;
+
+                    case BidiCharacterType.LRI:
+                        // X5a: Left-to-Right Isolate
+                        PushEmbedding(current, NextEvenLevel(current), DirectionalOverrideStatus.Neutral, true);
+                        break;
+
+                    case BidiCharacterType.RLI:
+                        // X5b: Right-to-Left Isolate
+                        PushEmbedding(current, NextOddLevel(current), DirectionalOverrideStatus.Neutral, true);
+                        break;
+
+                    case BidiCharacterType.FSI:
+                        // X5c: First Strong Isolate, direction from the first strong character inside the isolate
+                        bool isRTL = DetermineFirstStrongDirection(types, i + 1);
+                        PushEmbedding(current, isRTL ? NextOddLevel(current) : NextEvenLevel(current), DirectionalOverrideStatus.Neutral, true);
+                        break;
+
+                    case BidiCharacterType.PDI:
+                        // X6a: Pop Directional Isolate. Only closes an isolate entry.
+                        if (_statusCount > 1 && current.IsolateStatus)
+                        {
+                            _statusCount--;
+                        }
+                        break;
+
+                    default:
+                        // X6: For all other character types, apply the directional override if active
+                        if (current.OverrideStatus == DirectionalOverrideStatus.LeftToRight)
+                        {
+                            types[i] = BidiCharacterType.L;
+                        }
+                        else if (current.OverrideStatus == DirectionalOverrideStatus.RightToLeft)
+                        {
+                            types[i] = BidiCharacterType.R;
+                        }
+                        break;
+                }
+
+                // The low surrogate of a pair follows its high surrogate.
+                if (i + 1 < text.Length && char.IsSurrogatePair(text[i], text[i + 1]))
+                {
+                    i++;
+                    levels[i] = levels[i - 1];
+                    types[i] = types[i - 1];
+                }
+            }
+        }
+
+        private static int NextOddLevel(DirectionalStatusStackEntry current)
+        {
+            return (current.EmbeddingLevel + 1) | 1; // Force to odd
+        }
+
+        private static int NextEvenLevel(DirectionalStatusStackEntry current)
+        {
+            return (current.EmbeddingLevel + 2) & ~1; // Force to even
+        }
+
+        private void PushEmbedding(DirectionalStatusStackEntry current, int newLevel, DirectionalOverrideStatus overrideStatus, bool isolateStatus)
+        {
+            // If depth limit exceeded, don't push to stack (X9 overflow handling)
+            if (newLevel <= MaxEmbeddingDepth && _statusCount < MaxEmbeddingDepth)
+            {
+                PushStatus(new DirectionalStatusStackEntry(newLevel, overrideStatus, isolateStatus));
+            }
+        }
+
+        private void PushStatus(DirectionalStatusStackEntry entry)
+        {
+            _statusStack[_statusCount++] = entry;
+        }
+
+        /// <summary>
+        /// Determines the first strong direction for FSI processing.
+        /// Scans forward from the given position to find the first strong character (L, AL, R).
+        /// </summary>
+        private static bool DetermineFirstStrongDirection(ReadOnlySpan<BidiCharacterType> types, int startIndex)
+        {
+            // Scan forward to find first strong character, respecting isolate boundaries
+            int isolateDepth = 0;
+
+            for (int i = startIndex; i < types.Length; i++)
+            {
+                BidiCharacterType charType = types[i];
+
+                // Handle nested isolates
+                if (IsIsolateInitiator(charType))
+                {
+                    isolateDepth++;
+                }
+                else if (charType == BidiCharacterType.PDI)
+                {
+                    if (isolateDepth == 0)
+                    {
+                        // This PDI matches our FSI, stop scanning
+                        break;
+                    }
+                    isolateDepth--;
+                }
+                else if (isolateDepth == 0) // Only consider characters at our isolate level
+                {
+                    if (charType == BidiCharacterType.L)
+                    {
+                        return false; // LTR
+                    }
+                    if (charType == BidiCharacterType.AL || charType == BidiCharacterType.R)
+                    {
+                        return true; // RTL
+                    }
+                }
+            }
+
+            // No strong character found, default to LTR
+            return false;
+        }
+
+        // --- Isolating Run Sequences (BD13) ---
+
+        /// <summary>
+        /// Builds isolating run sequences from the current embedding levels and character types.
+        /// An isolating run sequence is a maximal sequence of level runs connected by isolate
+        /// initiators and their matching PDIs. Each sequence is stored as a range of
+        /// <c>_positions</c>, which lists text positions in sequence order.
+        /// </summary>
+        private void BuildIsolatingRunSequences(ReadOnlySpan<BidiCharacterType> types, ReadOnlySpan<int> levels)
+        {
+            Span<bool> processed = _processed.AsSpan(0, Length);
+            processed.Clear();
+
+            int positionCount = 0;
+            _sequenceCount = 0;
+
+            for (int i = 0; i < Length; i++)
+            {
+                if (processed[i]) continue;
+
+                int start = positionCount;
+                int currentLevel = levels[i];
+                int pos = i;
+
+                // Add all characters at the same level, following isolate initiators to their matching PDI
+                while (pos < Length && levels[pos] == currentLevel && !processed[pos])
+                {
+                    _positions[positionCount++] = pos;
+                    processed[pos] = true;
+
+                    if (IsIsolateInitiator(types[pos]))
+                    {
+                        int matchingPDI = FindMatchingPDI(types, pos);
+                        if (matchingPDI != -1 && levels[matchingPDI] == currentLevel)
+                        {
+                            // Jump to the matching PDI and continue the sequence
+                            pos = matchingPDI;
+                            continue;
+                        }
+                    }
+
+                    pos++;
+                }
+
+                _sequences[_sequenceCount++] = new RunSequence(
+                    start,
+                    positionCount - start,
+                    currentLevel,
+                    DetermineSosType(levels, i),
+                    DetermineEosType(levels, _positions[positionCount - 1]));
+            }
+        }
+
+        private IsolatingRunSequence GetSequence(int index)
+        {
+            RunSequence info = _sequences[index];
+            return new IsolatingRunSequence(
+                _types.AsSpan(0, Length),
+                _positions.AsSpan(info.Start, info.Length),
+                info.EmbeddingLevel,
+                info.Sos,
+                info.Eos);
+        }
+
+        /// <summary>
+        /// Determines the start-of-sequence (sos) type for an isolating run sequence.
+        /// </summary>
+        private static BidiCharacterType DetermineSosType(ReadOnlySpan<int> levels, int startPos)
+        {
+            // Use the higher of this level and the level before the sequence
+            int prevLevel = startPos > 0 ? levels[startPos - 1] : levels[startPos];
+            int sosLevel = Math.Max(prevLevel, levels[startPos]);
+            return (sosLevel % 2 == 0) ? BidiCharacterType.L : BidiCharacterType.R;
+        }
+
+        /// <summary>
+        /// Determines the end-of-sequence (eos) type for an isolating run sequence.
+        /// </summary>
+        private static BidiCharacterType DetermineEosType(ReadOnlySpan<int> levels, int endPos)
+        {
+            // Use the higher of this level and the level after the sequence
+            int nextLevel = endPos < levels.Length - 1 ? levels[endPos + 1] : levels[endPos];
+            int eosLevel = Math.Max(nextLevel, levels[endPos]);
+            return (eosLevel % 2 == 0) ? BidiCharacterType.L : BidiCharacterType.R;
+        }
+
+        /// <summary>
+        /// Finds the matching PDI for an isolate initiator at the given position.
+        /// Returns -1 if no matching PDI is found.
+        /// </summary>
+        private static int FindMatchingPDI(ReadOnlySpan<BidiCharacterType> types, int isolatePos)
+        {
+            int depth = 1;
+
+            for (int i = isolatePos + 1; i < types.Length; i++)
+            {
+                if (IsIsolateInitiator(types[i]))
+                {
+                    depth++;
+                }
+                else if (types[i] == BidiCharacterType.PDI)
+                {
+                    depth--;
+                    if (depth == 0)
+                    {
+                        return i;
+                    }
+                }
+            }
+
+            return -1; // No matching PDI found
+        }
+
+        /// <summary>
+        /// Checks if the given character type is an isolate initiator (LRI, RLI, FSI).
+        /// </summary>
+        private static bool IsIsolateInitiator(BidiCharacterType type)
+        {
+            return type == BidiCharacterType.LRI ||
+                   type == BidiCharacterType.RLI ||
+                   type == BidiCharacterType.FSI;
+        }
+
+        /// <summary>
+        /// Checks if the given character type is an isolate initiator or PDI.
+        /// </summary>
+        private static bool IsIsolateInitiatorOrPDI(BidiCharacterType type)
+        {
+            return IsIsolateInitiator(type) || type == BidiCharacterType.PDI;
+        }
+
+        // --- W Rules (Weak Type Resolution) ---
+
+        /// <summary>
+        /// Applies all W rules (W1-W7) to a single isolating run sequence.
+        /// </summary>
+        private static void ApplyWRulesToSequence(IsolatingRunSequence sequence)
+        {
+            ApplyW1_NonspacingMarks(sequence);
+            ApplyW2_EuropeanNumberContext(sequence);
+            ApplyW3_ArabicLetterSimplification(sequence);
+            ApplyW4_NumberSeparators(sequence);
+            ApplyW5_EuropeanTerminators(sequence);
+            ApplyW6_RemainingSeparators(sequence);
+            ApplyW7_EuropeanNumberFinal(sequence);
+        }
+
+        /// <summary>
+        /// W1: Examine each nonspacing mark (NSM) in the isolating run sequence, and change the type of the NSM
+        /// to Other Neutral if the previous character is an isolate initiator or PDI, and to the type of the
+        /// previous character otherwise. If the NSM is at the start of the isolating run sequence, it will get the type of sos.
+        /// </summary>
+        private static void ApplyW1_NonspacingMarks(IsolatingRunSequence sequence)
+        {
+            for (int i = 0; i < sequence.Count; i++)
+            {
+                if (sequence[i] == BidiCharacterType.NSM)
+                {
+                    if (i == 0)
+                    {
+                        // NSM at start of sequence gets sos type
+                        sequence[i] = sequence.Sos;
+                    }
+                    else
+                    {
+                        var prevType = sequence[i - 1];
+
+                        // NSM after isolate initiator or PDI becomes ON, otherwise takes the previous type
+                        sequence[i] = IsIsolateInitiatorOrPDI(prevType) ? BidiCharacterType.ON : prevType;
+                    }
+                }
+            }
+        }
+
+        /// <summary>
+        /// W2: Search backward from each instance of a European number until the first strong type (R, L, AL, or sos) is found.
+        /// If an AL is found, change the type of the European number to Arabic number.
+        /// </summary>
+        private static void ApplyW2_EuropeanNumberContext(IsolatingRunSequence sequence)
+        {
+            for (int i = 0; i < sequence.Count; i++)
+            {
+                if (sequence[i] == BidiCharacterType.EN &&
+                    SearchBackwardForStrongType(sequence, i) == BidiCharacterType.AL)
+                {
+                    sequence[i] = BidiCharacterType.AN;
+                }
+            }
+        }
+
+        /// <summary>
+        /// W3: Change all ALs to R.
+        /// </summary>
+        private static void ApplyW3_ArabicLetterSimplification(IsolatingRunSequence sequence)
+        {
+            for (int i = 0; i < sequence.Count; i++)
+            {
+                if (sequence[i] == BidiCharacterType.AL)
+                {
+                    sequence[i] = BidiCharacterType.R;
+                }
+            }
+        }
+
+        /// <summary>
+        /// W4: A single European separator between two European numbers changes to a European number.
+        /// A single common separator between two numbers of the same type changes to that type.
+        /// </summary>
+        private static void ApplyW4_NumberSeparators(IsolatingRunSequence sequence)
+        {
+            for (int i = 1; i < sequence.Count - 1; i++)
+            {
+                var current = sequence[i];
+                var prev = sequence[i - 1];
+                var next = sequence[i + 1];
+
+                // Single ES between two EN
+                if (current == BidiCharacterType.ES &&
+                    prev == BidiCharacterType.EN &&
+                    next == BidiCharacterType.EN)
+                {
+                    sequence[i] = BidiCharacterType.EN;
+                }
+                // Single CS between two numbers of same type
+                else if (current == BidiCharacterType.CS &&
+                         IsNumberType(prev) && prev == next)
+                {
+                    sequence[i] = prev;
+                }
+            }
+        }
+
+        /// <summary>
+        /// W5: A sequence of European terminators adjacent to European numbers changes to all European numbers.
+        /// </summary>
+        private static void ApplyW5_EuropeanTerminators(IsolatingRunSequence sequence)
+        {
+            for (int i = 0; i < sequence.Count; i++)
+            {
+                if (sequence[i] != BidiCharacterType.ET)
+                {
+                    continue;
+                }
+
+                // Find the extent of the ET sequence
+                int start = i;
+                while (i < sequence.Count && sequence[i] == BidiCharacterType.ET)
+                {
+                    i++;
+                }
+                int end = i - 1;
+
+                // Check if this ET sequence is adjacent to EN on either side
+                bool adjacentToEN =
+                    (start > 0 && sequence[start - 1] == BidiCharacterType.EN) ||
+                    (end < sequence.Count - 1 && sequence[end + 1] == BidiCharacterType.EN);
+
+                if (adjacentToEN)
+                {
+                    for (int j = start; j <= end; j++)
+                    {
+                        sequence[j] = BidiCharacterType.EN;
+                    }
+                }
+
+                i = end; // Continue from end of sequence
+            }
+        }
+
+        /// <summary>
+        /// W6: All remaining separators and terminators (after the application of W4 and W5) change to Other Neutral.
+        /// </summary>
+        private static void ApplyW6_RemainingSeparators(IsolatingRunSequence sequence)
+        {
+            for (int i = 0; i < sequence.Count; i++)
+            {
+                var type = sequence[i];
+                if (type == BidiCharacterType.ES ||
+                    type == BidiCharacterType.ET ||
+                    type == BidiCharacterType.CS)
+                {
+                    sequence[i] = BidiCharacterType.ON;
+                }
+            }
+        }
+
+        /// <summary>
+        /// W7: Search backward from each instance of a European number until the first strong type (R, L, or sos) is found.
+        /// If an L is found, then change the type of the European number to L.
+        /// </summary>
+        private static void ApplyW7_EuropeanNumberFinal(IsolatingRunSequence sequence)
+        {
+            for (int i = 0; i < sequence.Count; i++)
+            {
+                if (sequence[i] == BidiCharacterType.EN &&
+                    SearchBackwardForStrongTypeW7(sequence, i) == BidiCharacterType.L)
+                {
+                    sequence[i] = BidiCharacterType.L;
+                }
+            }
+        }
+
+        /// <summary>
+        /// Searches backward from the given position for the first strong type (R, L, AL, or sos).
+        /// Used by W2 rule.
+        /// </summary>
+        private static BidiCharacterType SearchBackwardForStrongType(IsolatingRunSequence sequence, int startIndex)
+        {
+            for (int i = startIndex - 1; i >= 0; i--)
+            {
+                var type = sequence[i];
+                if (IsStrongType(type))
+                {
+                    return type;
+                }
+            }
+            return sequence.Sos;
+        }
+
+        /// <summary>
+        /// Searches backward from the given position for the first strong type (R, L, or sos).
+        /// Used by W7 rule (note: AL is not included as it was converted to R in W3).
+        /// </summary>
+        private static BidiCharacterType SearchBackwardForStrongTypeW7(IsolatingRunSequence sequence, int startIndex)
+        {
+            for (int i = startIndex - 1; i >= 0; i--)
+            {
+                var type = sequence[i];
+                if (type == BidiCharacterType.L || type == BidiCharacterType.R)
+                {
+                    return type;
+                }
+            }
+            return sequence.Sos;
+        }
+
+        /// <summary>
+        /// Checks if the given character type is a strong type (L, R, AL).
+        /// </summary>
+        private static bool IsStrongType(BidiCharacterType type)
+        {
+            return type == BidiCharacterType.L ||
+                   type == BidiCharacterType.R ||
+                   type == BidiCharacterType.AL;
+        }
+
+        /// <summary>
+        /// Checks if the given character type is a number type (EN, AN).
+        /// </summary>
+        private static bool IsNumberType(BidiCharacterType type)
+        {
+            return type == BidiCharacterType.EN || type == BidiCharacterType.AN;
+        }
+
+        // --- N Rules (Neutral Type Resolution) ---
+
+        /// <summary>
+        /// Applies all N rules (N0-N2) to a single isolating run sequence.
+        /// </summary>
+        private void ApplyNRulesToSequence(ReadOnlySpan<char> text, IsolatingRunSequence sequence)
+        {
+            ApplyN0_BracketPairs(text, sequence);
+            ApplyN1_SurroundingStrongTypes(sequence);
+            ApplyN2_EmbeddingDirection(sequence);
+        }
+
+        /// <summary>
+        /// N0: Process bracket pairs in an isolating run sequence sequentially in the logical order
+        /// of the text positions of the opening paired brackets. Within this scope, bidirectional
+        /// types EN and AN are treated as R.
+        /// </summary>
+        private void ApplyN0_BracketPairs(ReadOnlySpan<char> text, IsolatingRunSequence sequence)
+        {
+            IdentifyBracketPairs(text, sequence);
+
+            foreach (BracketPair pair in _bracketPairs)
+            {
+                ProcessBracketPair(sequence, pair);
+            }
+        }
+
+        /// <summary>
+        /// N1: Look for a sequence of neutrals (NI) between two characters of the same strong type.
+        /// If found, change the neutrals to match that strong type. EN and AN are treated as R.
+        /// </summary>
+        private static void ApplyN1_SurroundingStrongTypes(IsolatingRunSequence sequence)
+        {
+            for (int i = 0; i < sequence.Count; i++)
+            {
+                if (!IsNeutralType(sequence[i]))
+                {
+                    continue;
+                }
+
+                // Find the extent of the neutral sequence
+                int start = i;
+                while (i < sequence.Count && IsNeutralType(sequence[i]))
+                {
+                    i++;
+                }
+                int end = i - 1;
+
+                // If both sides have the same strong type, change neutrals to that type
+                var precedingType = GetPrecedingStrongType(sequence, start);
+                var followingType = GetFollowingStrongType(sequence, end);
+                if (precedingType == followingType && IsStrongTypeForN1(precedingType))
+                {
+                    for (int j = start; j <= end; j++)
+                    {
+                        sequence[j] = precedingType;
+                    }
+                }
+
+                i--; // Adjust for the outer loop increment
+            }
+        }
+
+        /// <summary>
+        /// N2: Any remaining neutrals take the embedding direction.
+        /// Even levels → L, Odd levels → R
+        /// </summary>
+        private static void ApplyN2_EmbeddingDirection(IsolatingRunSequence sequence)
+        {
+            var embeddingDirection = GetEmbeddingDirection(sequence.EmbeddingLevel);
+
+            for (int i = 0; i < sequence.Count; i++)
+            {
+                if (IsNeutralType(sequence[i]))
+                {
+                    sequence[i] = embeddingDirection;
+                }
+            }
+        }
+
+        /// <summary>
+        /// Hardcoded bracket pair mappings (fallback for missing ICU4N properties).
+        /// </summary>
+        private static readonly Dictionary<char, char> BracketPairs = new Dictionary<char, char>
+        {
+            // Basic brackets
+            { '(', ')' }, { ')', '(' },
+            { '[', ']' }, { ']', '[' },
+            { '{', '}' }, { '}', '{' },
+
+            // Angle brackets (canonical equivalence)
+            { '⟨', '⟩' }, { '⟩', '⟨' },  // U+27E8, U+27E9
+            { '〈', '〉' }, { '〉', '〈' },  // U+3008, U+3009 (canonical equivalent)
+
+            // Additional Unicode brackets
+            { '⟦', '⟧' }, { '⟧', '⟦' },  // U+27E6, U+27E7
+            { '⟪', '⟫' }, { '⟫', '⟪' },  // U+27EA, U+27EB
+            { '⦃', '⦄' }, { '⦄', '⦃' },  // U+2983, U+2984
+            { '⦅', '⦆' }, { '⦆', '⦅' },  // U+2985, U+2986
+        };
+
+        /// <summary>
+        /// Set of opening bracket characters.
+        /// </summary>
+        private static readonly HashSet<char> OpeningBrackets = new HashSet<char>
+        {
+            '(', '[', '{', '⟨', '〈', '⟦', '⟪', '⦃', '⦅'
+        };
+
+        private static readonly Comparison<BracketPair> ByOpeningPosition =
+            (a, b) => a.OpeningPosition.CompareTo(b.OpeningPosition);
+
+        /// <summary>
+        /// Identifies bracket pairs in an isolating run sequence using the BD16 algorithm,
+        /// filling <c>_bracketPairs</c> sorted by opening position.
+        /// </summary>
+        private void IdentifyBracketPairs(ReadOnlySpan<char> text, IsolatingRunSequence sequence)
+        {
+            int stackTop = -1;
+            _bracketPairs.Clear();
+
+            for (int i = 0; i < sequence.Count; i++)
+            {
+                char currentChar = text[sequence.PositionAt(i)];
+
+                if (IsOpeningBracket(currentChar, sequence[i]))
+                {
+                    if (stackTop == MaxBracketStackDepth - 1)
+                    {
+                        // Stack overflow - no pairs per BD16
+                        _bracketPairs.Clear();
+                        return;
+                    }
+
+                    stackTop++;
+                    _bracketStack[stackTop] = new BracketStackEntry(GetPairedBracket(currentChar), i);
+                }
+                else if (IsClosingBracket(currentChar, sequence[i]))
+                {
+                    // Look for matching opening bracket in stack
+                    for (int j = stackTop; j >= 0; j--)
+                    {
+                        if (_bracketStack[j].BracketChar == currentChar ||
+                            AreCanonicalEquivalent(_bracketStack[j].BracketChar, currentChar))
+                        {
+                            int openingPosition = _bracketStack[j].TextPosition;
+                            char openingChar = text[sequence.PositionAt(openingPosition)];
+                            _bracketPairs.Add(new BracketPair(openingPosition, i, openingChar, currentChar));
+
+                            // Pop stack through this element inclusively
+                            stackTop = j - 1;
+                            break;
+                        }
+                    }
+                }
+            }
+
+            // Sort pairs by opening bracket position
+            _bracketPairs.Sort(ByOpeningPosition);
+        }
+
+        /// <summary>
+        /// Gets the paired bracket character for a given bracket.
+        /// </summary>
+        private static char GetPairedBracket(char c)
+        {
+            return BracketPairs.TryGetValue(c, out char paired) ? paired : c;
+        }
+
+        /// <summary>
+        /// Checks if a character is an opening bracket with ON type (BD14).
+        /// </summary>
+        private static bool IsOpeningBracket(char c, BidiCharacterType currentType)
+        {
+            return currentType == BidiCharacterType.ON && OpeningBrackets.Contains(c);
+        }
+
+        /// <summary>
+        /// Checks if a character is a closing bracket with ON type (BD15).
+        /// </summary>
+        private static bool IsClosingBracket(char c, BidiCharacterType currentType)
+        {
+            return currentType == BidiCharacterType.ON &&
+                   BracketPairs.ContainsKey(c) &&
+                   !OpeningBrackets.Contains(c);
+        }
+
+        /// <summary>
+        /// Checks if two bracket characters are canonical equivalents.
+        /// </summary>
+        private static bool AreCanonicalEquivalent(char c1, char c2)
+        {
+            // Handle canonical equivalence for angle brackets
+            return (c1 == '⟨' && c2 == '〈') || (c1 == '〈' && c2 == '⟨') ||
+                   (c1 == '⟩' && c2 == '〉') || (c1 == '〉' && c2 == '⟩');
+        }
+
+        /// <summary>
+        /// Processes a single bracket pair according to N0 rule logic.
+        /// </summary>
+        private static void ProcessBracketPair(IsolatingRunSequence sequence, BracketPair pair)
+        {
+            // Find strong type inside the bracket pair
+            var strongTypeInside = FindStrongTypeInBrackets(sequence, pair.OpeningPosition + 1, pair.ClosingPosition - 1);
+            var embeddingDirection = GetEmbeddingDirection(sequence.EmbeddingLevel);
+
+            BidiCharacterType newType;
+
+            if (strongTypeInside == embeddingDirection)
+            {
+                // Strong type matches embedding direction
+                newType = embeddingDirection;
+            }
+            else if (strongTypeInside != null && IsStrongTypeForN1(strongTypeInside.Value))
+            {
+                // Strong type opposite to embedding direction - check context
+                var precedingType = GetPrecedingStrongType(sequence, pair.OpeningPosition);
+                newType = precedingType == strongTypeInside ? strongTypeInside.Value : embeddingDirection;
+            }
+            else
+            {
+                // No strong type inside - leave unchanged for N1/N2
+                return;
+            }
+
+            // Set both brackets to the determined type
+            sequence[pair.OpeningPosition] = newType;
+            sequence[pair.ClosingPosition] = newType;
+
+            // Handle NSM characters following brackets that changed type
+            HandleNSMAfterBrackets(sequence, pair.OpeningPosition, newType);
+            HandleNSMAfterBrackets(sequence, pair.ClosingPosition, newType);
+        }
+
+        /// <summary>
+        /// Finds the first strong type within a bracket pair (treating EN/AN as R).
+        /// </summary>
+        private static BidiCharacterType? FindStrongTypeInBrackets(IsolatingRunSequence sequence, int start, int end)
+        {
+            for (int i = start; i <= end && i < sequence.Count; i++)
+            {
+                var type = sequence[i];
+                if (type == BidiCharacterType.L)
+                    return BidiCharacterType.L;
+                if (type == BidiCharacterType.R || type == BidiCharacterType.AL ||
+                    type == BidiCharacterType.EN || type == BidiCharacterType.AN)
+                    return BidiCharacterType.R;
+            }
+            return null;
+        }
+
+        /// <summary>
+        /// Handles NSM characters following brackets that changed type in N0.
+        /// </summary>
+        private static void HandleNSMAfterBrackets(IsolatingRunSequence sequence, int bracketPosition, BidiCharacterType newType)
+        {
+            for (int i = bracketPosition + 1; i < sequence.Count && sequence[i] == BidiCharacterType.NSM; i++)
+            {
+                sequence[i] = newType;
+            }
+        }
+
+        /// <summary>
+        /// Checks if a character type is neutral (NI) for N rules processing.
+        /// </summary>
+        private static bool IsNeutralType(BidiCharacterType type)
+        {
+            return type == BidiCharacterType.ON ||
+                   type == BidiCharacterType.WS ||
+                   type == BidiCharacterType.S ||
+                   type == BidiCharacterType.B;
+        }
+
+        /// <summary>
+        /// Checks if a character type is strong for N1 rule (treating EN/AN as R).
+        /// </summary>
+        private static bool IsStrongTypeForN1(BidiCharacterType type)
+        {
+            return type == BidiCharacterType.L || type == BidiCharacterType.R;
+        }
+
+        /// <summary>
+        /// Gets the preceding strong type for N1 rule (treating EN/AN as R).
+        /// </summary>
+        private static BidiCharacterType GetPrecedingStrongType(IsolatingRunSequence sequence, int position)
+        {
+            for (int i = position - 1; i >= 0; i--)
+            {
+                var type = sequence[i];
+                if (type == BidiCharacterType.L)
+                    return BidiCharacterType.L;
+                if (type == BidiCharacterType.R || type == BidiCharacterType.AL ||
+                    type == BidiCharacterType.EN || type == BidiCharacterType.AN)
+                    return BidiCharacterType.R;
+            }
+            // Return sos if no strong type found
+            return sequence.Sos == BidiCharacterType.L ? BidiCharacterType.L : BidiCharacterType.R;
+        }
+
+        /// <summary>
+        /// Gets the following strong type for N1 rule (treating EN/AN as R).
+        /// </summary>
+        private static BidiCharacterType GetFollowingStrongType(IsolatingRunSequence sequence, int position)
+        {
+            for (int i = position + 1; i < sequence.Count; i++)
+            {
+                var type = sequence[i];
+                if (type == BidiCharacterType.L)
+                    return BidiCharacterType.L;
+                if (type == BidiCharacterType.R || type == BidiCharacterType.AL ||
+                    type == BidiCharacterType.EN || type == BidiCharacterType.AN)
+                    return BidiCharacterType.R;
+            }
+            // Return eos if no strong type found
+            return sequence.Eos == BidiCharacterType.L ? BidiCharacterType.L : BidiCharacterType.R;
+        }
+
+        /// <summary>
+        /// Gets the embedding direction from the embedding level.
+        /// Even levels → L, Odd levels → R
+        /// </summary>
+        private static BidiCharacterType GetEmbeddingDirection(int level)
+        {
+            return (level % 2 == 0) ? BidiCharacterType.L : BidiCharacterType.R;
+        }
+
+        // --- I Rules (Implicit Levels) ---
+
+        /// <summary>
+        /// Applies UAX #9 I rules (I1-I2) for final embedding level assignment.
+        /// I1: For characters with even embedding levels:
+        ///     - R characters: level + 1 (even → odd)
+        ///     - AN/EN characters: level + 2 (even → even, higher)
+        /// I2: For characters with odd embedding levels:
+        ///     - L/EN/AN characters: level + 1 (odd → even)
+        /// </summary>
+        private static void ApplyIRules(ReadOnlySpan<BidiCharacterType> types, Span<int> levels)
+        {
+            for (int i = 0; i < types.Length; i++)
+            {
+                var type = types[i];
+
+                // Skip BN characters (Boundary Neutrals) per UAX #9 specification
+                if (type == BidiCharacterType.BN)
+                    continue;
+
+                int newLevel = ResolveImplicitLevel(type, levels[i]);
+
+                // Validate against maximum depth (max_depth + 1 = 126); on overflow keep the current level
+                if (newLevel <= MaxEmbeddingDepth + 1)
+                {
+                    levels[i] = newLevel;
+                }
+            }
+        }
+
+        /// <summary>
+        /// Resolves the implicit embedding level for a character based on its type and current level.
+        /// Implements the core logic of UAX #9 I1 and I2 rules.
+        /// </summary>
+        private static int ResolveImplicitLevel(BidiCharacterType type, int currentLevel)
+        {
+            if (currentLevel % 2 == 0)
+            {
+                // I1: Even level adjustments
+                switch (type)
+                {
+                    case BidiCharacterType.R:
+                        return currentLevel + 1; // Even → Odd
+                    case BidiCharacterType.AN:
+                    case BidiCharacterType.EN:
+                        return currentLevel + 2; // Even → Even (higher)
+                    default:
+                        return currentLevel; // No change
+                }
+            }
+
+            // I2: Odd level adjustments
+            switch (type)
+            {
+                case BidiCharacterType.L:
+                case BidiCharacterType.EN:
+                case BidiCharacterType.AN:
+                    return currentLevel + 1; // Odd → Even
+                default:
+                    return currentLevel; // No change
+            }
+        }
+
+        // --- Supporting Types ---
+
+        /// <summary>
+        /// View over one isolating run sequence. Indexing reads and writes the paragraph's
+        /// type array through the sequence's position range, so rules resolve types in place.
+        /// </summary>
+        private readonly ref struct IsolatingRunSequence
+        {
+            private readonly Span<BidiCharacterType> _types;
+            private readonly ReadOnlySpan<int> _positions;
+
+            public IsolatingRunSequence(Span<BidiCharacterType> types, ReadOnlySpan<int> positions, int embeddingLevel, BidiCharacterType sos, BidiCharacterType eos)
+            {
+                _types = types;
+                _positions = positions;
+                EmbeddingLevel = embeddingLevel;
+                Sos = sos;
+                Eos = eos;
+            }
+
+            public int Count => _positions.Length;
+
+            public int EmbeddingLevel { get; }
+
+            public BidiCharacterType Sos { get; }  // Start-of-sequence type
+
+            public BidiCharacterType Eos { get; }  // End-of-sequence type
+
+            public ref BidiCharacterType this[int index] => ref _types[_positions[index]];
+
+            public int PositionAt(int index) => _positions[index]; // Original text position
+        }
+
+        /// <summary>
+        /// Position range and boundary types of one isolating run sequence.
+        /// </summary>
+        private readonly struct RunSequence
+        {
+            public RunSequence(int start, int length, int embeddingLevel, BidiCharacterType sos, BidiCharacterType eos)
+            {
+                Start = start;
+                Length = length;
+                EmbeddingLevel = embeddingLevel;
+                Sos = sos;
+                Eos = eos;
+            }
+
+            public int Start { get; }
+            public int Length { get; }
+            public int EmbeddingLevel { get; }
+            public BidiCharacterType Sos { get; }
+            public BidiCharacterType Eos { get; }
+        }
+
+        /// <summary>
+        /// Represents an entry on the directional status stack used in UAX #9 X rules.
+        /// Each entry tracks the embedding level, directional override status, and isolate status.
+        /// </summary>
+        private readonly struct DirectionalStatusStackEntry
+        {
+            public int EmbeddingLevel { get; }
+            public DirectionalOverrideStatus OverrideStatus { get; }
+            public bool IsolateStatus { get; }
+
+            public DirectionalStatusStackEntry(int embeddingLevel, DirectionalOverrideStatus overrideStatus, bool isolateStatus)
+            {
+                EmbeddingLevel = embeddingLevel;
+                OverrideStatus = overrideStatus;
+                IsolateStatus = isolateStatus;
+            }
+
+            public override string ToString() => $"StackEntry(Level:{EmbeddingLevel}, Override:{OverrideStatus}, Isolate:{IsolateStatus})";
+        }
+
+        /// <summary>
+        /// Represents the directional override status as defined in UAX #9.
+        /// </summary>
+        private enum DirectionalOverrideStatus
+        {
+            Neutral,        // No override is currently active
+            LeftToRight,    // Characters are to be reset to L
+            RightToLeft     // Characters are to be reset to R
+        }
+
+        /// <summary>
+        /// Bracket pair structure for N0 processing.
+        /// </summary>
+        private readonly struct BracketPair
+        {
+            public readonly int OpeningPosition;    // Position in isolating run sequence
+            public readonly int ClosingPosition;    // Position in isolating run sequence
+            public readonly char OpeningChar;       // Opening bracket character
+            public readonly char ClosingChar;       // Closing bracket character
+
+            public BracketPair(int openPos, int closePos, char openChar, char closeChar)
+            {
+                OpeningPosition = openPos;
+                ClosingPosition = closePos;
+                OpeningChar = openChar;
+                ClosingChar = closeChar;
+            }
+        }
+
+        /// <summary>
+        /// Stack entry for BD16 bracket pair identification algorithm.
+        /// </summary>
+        private readonly struct BracketStackEntry
+        {
+            public readonly char BracketChar;       // Bidi_Paired_Bracket property value
+            public readonly int TextPosition;       // Position in isolating run sequence
+
+            public BracketStackEntry(char bracketChar, int position)
+            {
+                BracketChar = bracketChar;
+                TextPosition = position;
+            }
+        }
+    }
+}
@@ -0,0 +1,68 @@
+﻿using System;
+using System.IO;
+
+namespace ArbSh.Core.Models
+{
+    /// <summary>
+    /// A file or directory produced by <c>اعرض</c>.
+    /// The name and kind come from the directory enumeration itself; size, times and attributes
+    /// are read from the file system only when a property is first accessed.
+    /// </summary>
+    public sealed class DirectoryEntry
+    {
+        private FileSystemInfo? _info;
+
+        /// <summary>
+        /// Initializes a new instance of the <see cref="DirectoryEntry"/> class.
+        /// </summary>
+        /// <param name="name">The entry name, relative to the listed directory.</param>
+        /// <param name="fullPath">The absolute path of the entry.</param>
+        /// <param name="isDirectory">Whether the entry is a directory.</param>
+        public DirectoryEntry(string name, string fullPath, bool isDirectory)
+        {
+            Name = name ?? throw new ArgumentNullException(nameof(name));
+            FullPath = fullPath ?? throw new ArgumentNullException(nameof(fullPath));
+            IsDirectory = isDirectory;
+        }
+
+        /// <summary>
+        /// Gets the entry name, relative to the listed directory (includes subdirectories in recursive listings).
+        /// </summary>
+        public string Name { get; }
+
+        /// <summary>
+        /// Gets the absolute path of the entry.
+        /// </summary>
+        public string FullPath { get; }
+
+        /// <summary>
+        /// Gets a value indicating whether the entry is a directory.
+        /// </summary>
+        public bool IsDirectory { get; }
+
+        /// <summary>
+        /// Gets the file size in bytes (0 for directories). Reads file metadata on first access.
+        /// </summary>
+        public long Length => Info is FileInfo file ? file.Length : 0;
+
+        /// <summary>
+        /// Gets the last write time. Reads file metadata on first access.
+        /// </summary>
+        public DateTime LastWriteTime => Info.LastWriteTime;
+
+        /// <summary>
+        /// Gets the file attributes. Reads file metadata on first access.
+        /// </summary>
+        public FileAttributes Attributes => Info.Attributes;
+
+        private FileSystemInfo Info => _info ??= IsDirectory ? new DirectoryInfo(FullPath) : new FileInfo(FullPath);
+
+        /// <summary>
+        /// Returns the entry name, with a trailing <c>/</c> for directories.
+        /// </summary>
+        public override string ToString()
+        {
+            return IsDirectory ? $"{Name}/" : Name;
+        }
+    }
+}
@@ -66,6 +66,12 @@ namespace ArbSh.Core
         /// </summary>
         public Dictionary<string, string> Parameters { get; }
 
+        /// <summary>
+        /// Arguments and parameters in the order they were typed, as strings or <c>List&lt;ParsedCommand&gt;</c> (sub-expressions).
+        /// Used to build the argument list of external commands, which <see cref="Parameters"/> cannot preserve.
+        /// </summary>
+        internal List<object> CommandLineArguments { get; } = new List<object>();
+
         /// <summary>
         /// Gets the list of redirection rules applied to this command.
         /// </summary>
@@ -77,6 +83,13 @@ namespace ArbSh.Core
         /// </summary>
         public string? InputRedirectPath { get; private set; }
 
+        /// <summary>
+        /// Binding metadata resolved when the command was compiled (see <see cref="CompiledScript"/>).
+        /// Null for commands parsed on demand or not found at compile time; the executor then looks the command up.
+        /// Set only through <see cref="WithBinding"/>, so a compiled command shared between sessions never changes.
+        /// </summary>
+        internal CmdletBindingInfo? Binding { get; private init; }
+
         // TODO: Add information about pipeline position (start, middle, end)
 
         public ParsedCommand(string commandName, List<object> arguments, Dictionary<string, string> parameters) // Updated argument type
@@ -87,13 +100,34 @@ namespace ArbSh.Core
             Redirections = new List<RedirectionInfo>(); // Initialize redirection list
         }
 
+        /// <summary>
+        /// Creates a bound copy of this command that shares its arguments, parameters and redirections.
+        /// </summary>
+        /// <param name="binding">The resolved binding metadata.</param>
+        /// <returns>A new command carrying <paramref name="binding"/>.</returns>
+        internal ParsedCommand WithBinding(CmdletBindingInfo binding)
+        {
+            return new ParsedCommand(this, binding);
+        }
+
+        private ParsedCommand(ParsedCommand source, CmdletBindingInfo binding)
+        {
+            CommandName = source.CommandName;
+            Arguments = source.Arguments;
+            Parameters = source.Parameters;
+            CommandLineArguments = source.CommandLineArguments;
+            Redirections = source.Redirections;
+            InputRedirectPath = source.InputRedirectPath;
+            Binding = binding;
+        }
+
         /// <summary>
         /// Internal method used by the parser to add a parsed redirection rule.
         /// </summary>
         internal void AddRedirection(RedirectionInfo redirection)
         {
             Redirections.Add(redirection);
-            CoreConsole.WriteLine($"DEBUG (ParsedCommand): Added output redirection: {redirection}");
+            CoreConsole.LogDebug("ParsedCommand", $"Added output redirection: {redirection}");
         }
 
         /// <summary>
@@ -102,7 +136,7 @@ namespace ArbSh.Core
         internal void SetInputRedirection(string filePath)
         {
             InputRedirectPath = filePath;
-            CoreConsole.WriteLine($"DEBUG (ParsedCommand): Set input redirection to: < {filePath}");
+            CoreConsole.LogDebug("ParsedCommand", $"Set input redirection to: < {filePath}");
         }
     }
 }
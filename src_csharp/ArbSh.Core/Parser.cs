@@ -2,7 +2,8 @@
 using System.Collections.Generic;
 using System;
 using System.Collections.Generic;
-using System.Linq; // Needed for Skip
+using System.Diagnostics; // Needed for Stopwatch
+using System.Linq; // Needed for Select
 using System.Text; // Needed for StringBuilder
 using System.Text.RegularExpressions; // Needed for Regex.Match
 using ArbSh.Core.Parsing; // Add using for Token types
@@ -14,24 +15,17 @@ namespace ArbSh.Core
     /// </summary>
     public static class Parser
     {
-        // Placeholder for variable storage (replace with proper session state later)
-        // TODO: Implement proper session state for variables
-        private static Dictionary<string, string> _variables = new Dictionary<string, string>(StringComparer.OrdinalIgnoreCase)
-        {
-            { "testVar", "Value from $testVar!" },
-            { "pathExample", "C:\\Users" },
-            { "emptyVar", "" }
-        };
-
-        // Basic variable lookup (replace with proper session state access)
+        // Variables live in the session being executed (see ShellSessionState); the parser itself is stateless,
+        // so any number of sessions can parse concurrently.
         private static string GetVariableValue(string variableName)
         {
-            // Basic lookup, returns empty string if not found (like PowerShell)
-            return _variables.TryGetValue(variableName, out var value) ? value : string.Empty;
+            // Returns empty string if not found (like PowerShell)
+            return ShellSessionContext.GetVariable(variableName);
         }
 
         // NOTE: Old state machine tokenizer and helper methods removed (IsArabicLetterChar, IsValidIdentifierChar, etc.)
-        //       as tokenization is now handled by RegexTokenizer.
+        //       as tokenization is now handled by Lexer. Statements and stages are passed around as
+        //       ranges of the input line so no substrings are made before tokenizing.
 
         /// <summary>
         /// Parses a line of input into a list of statements, where each statement is a list of commands for a pipeline.
@@ -40,7 +34,8 @@ namespace ArbSh.Core
         /// <returns>A list where each element is a list of ParsedCommand objects representing a single statement's pipeline.</returns>
         public static List<List<ParsedCommand>> Parse(string inputLine)
         {
-            CoreConsole.WriteLine($"DEBUG (Parser): Parsing '{inputLine}'...");
+            CoreConsole.LogDebug("Parser", $"Parsing '{inputLine}'...");
+            long parseStart = Stopwatch.GetTimestamp();
             var allStatementsCommands = new List<List<ParsedCommand>>();
             var statementBuilder = new StringBuilder();
             bool inDoubleQuotes = false;
@@ -55,7 +50,7 @@ namespace ArbSh.Core
                 if (c == '#' && !inDoubleQuotes && !inSingleQuotes)
                 {
                     // If # is the first char of the potential statement, ignore the whole line segment
-                    if (i == start || string.IsNullOrWhiteSpace(inputLine.Substring(start, i - start)))
+                    if (i == start || inputLine.AsSpan(start, i - start).IsWhiteSpace())
                     {
                         start = inputLine.Length; // Effectively skip the rest
                     }
@@ -82,37 +77,36 @@ namespace ArbSh.Core
                 // Split statements only if outside *both* types of quotes
                 if (c == ';' && !inDoubleQuotes && !inSingleQuotes)
                 {
-                    string statement = inputLine.Substring(start, i - start).Trim();
+                    TrimRange(inputLine, start, i, out int statementStart, out int statementLength);
                     // Ignore empty statements or statements that were just comments
-                    if (!string.IsNullOrWhiteSpace(statement) && !statement.TrimStart().StartsWith("#"))
+                    if (statementLength > 0 && inputLine[statementStart] != '#')
                     {
-                        allStatementsCommands.Add(ParseSingleStatement(statement));
+                        allStatementsCommands.Add(ParseSingleStatement(inputLine, statementStart, statementLength));
                     }
                     start = i + 1; // Start next statement after the semicolon
                 }
             }
 
             // Add the last statement (or the only statement if no semicolons)
-            string lastStatement = inputLine.Substring(start).Trim();
+            TrimRange(inputLine, Math.Min(start, inputLine.Length), inputLine.Length, out int lastStart, out int lastLength);
             // Ignore empty statements or statements that were just comments
-            if (!string.IsNullOrWhiteSpace(lastStatement) && !lastStatement.TrimStart().StartsWith("#"))
+            if (lastLength > 0 && inputLine[lastStart] != '#')
             {
                 // Also ignore if the remaining part starts with # after trimming whitespace
-                int commentIndex = lastStatement.IndexOf('#');
-                if (commentIndex == 0) { /* Ignore */ }
-                else if (commentIndex > 0)
+                int commentIndex = inputLine.AsSpan(lastStart, lastLength).IndexOf('#');
+                if (commentIndex > 0)
                 {
                     // If comment is present but not at start, parse the part before it
-                    string beforeComment = lastStatement.Substring(0, commentIndex).Trim();
-                    if (!string.IsNullOrWhiteSpace(beforeComment))
+                    TrimRange(inputLine, lastStart, lastStart + commentIndex, out int beforeStart, out int beforeLength);
+                    if (beforeLength > 0)
                     {
-                        allStatementsCommands.Add(ParseSingleStatement(beforeComment));
+                        allStatementsCommands.Add(ParseSingleStatement(inputLine, beforeStart, beforeLength));
                     }
                 }
                 else
                 {
                     // No comment found
-                    allStatementsCommands.Add(ParseSingleStatement(lastStatement));
+                    allStatementsCommands.Add(ParseSingleStatement(inputLine, lastStart, lastLength));
                 }
             }
 
@@ -120,32 +114,34 @@ namespace ArbSh.Core
             // TODO: Handle unterminated quotes at the statement level?
             if (inDoubleQuotes || inSingleQuotes)
             {
-                CoreConsole.WriteLine("WARN (Parser): Unterminated quote detected at end of input line.");
+                CoreConsole.LogWarning("Parser", "Unterminated quote detected at end of input line.");
                 // Potentially throw error or try to recover?
             }
 
 
-            CoreConsole.WriteLine($"DEBUG (Parser): Parsed into {allStatementsCommands.Count} statement(s).");
+            ShellMetrics.RecordParse(Stopwatch.GetElapsedTime(parseStart));
+            CoreConsole.LogDebug("Parser", $"Parsed into {allStatementsCommands.Count} statement(s).");
             return allStatementsCommands;
         }
 
         /// <summary>
         /// Parses a single statement (which might contain a pipeline) into a list of commands.
         /// </summary>
-        private static List<ParsedCommand> ParseSingleStatement(string statementInput)
+        private static List<ParsedCommand> ParseSingleStatement(string source, int statementStart, int statementLength)
         {
-            CoreConsole.WriteLine($"DEBUG (Parser): Processing statement: '{statementInput}'");
+            CoreConsole.LogDebug("Parser", $"Processing statement: '{source.AsSpan(statementStart, statementLength)}'");
             var commandsInStatement = new List<ParsedCommand>();
-            int stageStart = 0;
+            int statementEnd = statementStart + statementLength;
+            int stageStart = statementStart;
             bool inDoubleQuotes = false; // Track quotes specifically for pipeline splitting
             bool inSingleQuotes = false; // Track single quotes for pipeline splitting
 
-            for (int i = 0; i < statementInput.Length; i++)
+            for (int i = statementStart; i < statementEnd; i++)
             {
-                char c = statementInput[i];
+                char c = source[i];
 
                 // Handle escaping (only outside single quotes)
-                if (c == '\\' && !inSingleQuotes && i + 1 < statementInput.Length)
+                if (c == '\\' && !inSingleQuotes && i + 1 < statementEnd)
                 {
                     i++; // Skip escaped character for pipeline splitting logic
                     continue;
@@ -164,10 +160,10 @@ namespace ArbSh.Core
                 // Split pipeline only if outside *both* types of quotes
                 if (c == '|' && !inDoubleQuotes && !inSingleQuotes)
                 {
-                    string stageInput = statementInput.Substring(stageStart, i - stageStart).Trim();
-                    if (!string.IsNullOrWhiteSpace(stageInput))
+                    TrimRange(source, stageStart, i, out int trimmedStart, out int trimmedLength);
+                    if (trimmedLength > 0)
                     {
-                        ParsedCommand? command = ParseSinglePipelineStage(stageInput);
+                        ParsedCommand? command = ParseSinglePipelineStage(source, trimmedStart, trimmedLength);
                         if (command != null) commandsInStatement.Add(command);
                     }
                     stageStart = i + 1; // Start next stage after the pipe
@@ -175,38 +171,40 @@ namespace ArbSh.Core
             }
 
             // Process the last stage
-            string lastStageInput = statementInput.Substring(stageStart).Trim();
-            if (!string.IsNullOrWhiteSpace(lastStageInput))
+            TrimRange(source, stageStart, statementEnd, out int lastStageStart, out int lastStageLength);
+            if (lastStageLength > 0)
             {
-                ParsedCommand? command = ParseSinglePipelineStage(lastStageInput);
+                ParsedCommand? command = ParseSinglePipelineStage(source, lastStageStart, lastStageLength);
                 if (command != null) commandsInStatement.Add(command);
             }
 
             // TODO: Handle unterminated quotes within the statement?
 
-            CoreConsole.WriteLine($"DEBUG (Parser): Statement parsed into {commandsInStatement.Count} pipeline stage(s).");
+            CoreConsole.LogDebug("Parser", $"Statement parsed into {commandsInStatement.Count} pipeline stage(s).");
             return commandsInStatement;
         }
 
         /// <summary>
-        /// Parses a single pipeline stage string into a ParsedCommand object.
+        /// Parses a single pipeline stage range into a ParsedCommand object.
         /// Handles tokenization, redirection, arguments, parameters.
         /// </summary>
-        private static ParsedCommand? ParseSinglePipelineStage(string stageInput)
+        private static ParsedCommand? ParseSinglePipelineStage(string source, int stageStart, int stageLength)
         {
-            // Tokenize the current pipeline stage input using the new Regex Tokenizer
-            List<Token> tokens = RegexTokenizer.Tokenize(stageInput);
+            // Tokenize the current pipeline stage in place; tokens point into the source line
+            var tokens = new List<Token>();
+            Lexer.Tokenize(source, stageStart, stageLength, tokens);
             if (tokens.Count == 0) return null;
 
             // First token should be the command name (Identifier)
             if (tokens[0].Type != TokenType.Identifier)
             {
                 // Handle error: Expected a command name identifier
-                CoreConsole.WriteLine($"ERROR (Parser): Expected command name, but got token type {tokens[0].Type} ('{tokens[0].Value}')");
+                CoreConsole.LogError("Parser", $"Expected command name, but got token type {tokens[0].Type} ('{tokens[0].Value}')");
                 return null; // Or throw exception
             }
             string commandName = tokens[0].Value;
-            List<Token> remainingTokens = tokens.Skip(1).ToList(); // Start with tokens after command name
+            tokens.RemoveAt(0);
+            List<Token> remainingTokens = tokens; // Start with tokens after command name
 
             // Create the command object early so we can add redirections
             var parsedCommand = new ParsedCommand(commandName, new List<object>(), new Dictionary<string, string>(StringComparer.OrdinalIgnoreCase)); // Arguments list is List<object>
@@ -221,26 +219,21 @@ namespace ArbSh.Core
 
                 if (currentToken.Type == TokenType.Operator)
                 {
-                    string opValue = currentToken.Value;
+                    ReadOnlySpan<char> opValue = currentToken.Span;
 
                     // Handle Input Redirection '<'
-                    if (opValue == "<")
+                    if (opValue.SequenceEqual("<"))
                     {
                         if (i + 1 < remainingTokens.Count)
                         {
                             Token targetToken = remainingTokens[i + 1];
                             if (targetToken.Type == TokenType.Identifier || targetToken.Type == TokenType.StringLiteralDQ || targetToken.Type == TokenType.StringLiteralSQ)
                             {
-                                string targetPath = targetToken.Value;
-                                // Remove quotes from string literals if present
-                                if (targetToken.Type == TokenType.StringLiteralDQ || targetToken.Type == TokenType.StringLiteralSQ)
-                                {
-                                    if (targetPath.Length >= 2) targetPath = targetPath.Substring(1, targetPath.Length - 2);
-                                }
+                                string targetPath = UnquotedValue(targetToken);
 
                                 if (parsedCommand.InputRedirectPath != null)
                                 {
-                                    CoreConsole.WriteLine($"WARN (Parser): Multiple input redirections specified. Using last one: '{targetPath}'. Previous was: '{parsedCommand.InputRedirectPath}'.");
+                                    CoreConsole.LogWarning("Parser", $"Multiple input redirections specified. Using last one: '{targetPath}'. Previous was: '{parsedCommand.InputRedirectPath}'.");
                                 }
                                 parsedCommand.SetInputRedirection(targetPath);
                                 
@@ -251,7 +244,7 @@ namespace ArbSh.Core
                             }
                             else
                             {
-                                CoreConsole.WriteLine($"WARN (Parser): Input redirection operator '<' found without a valid file path target. Unexpected token type: '{targetToken.Type}'.");
+                                CoreConsole.LogWarning("Parser", $"Input redirection operator '<' found without a valid file path target. Unexpected token type: '{targetToken.Type}'.");
                                 remainingTokens.RemoveAt(i); // Remove the invalid '<' operator token
                                 processed = true;
                                 continue; // Restart check from current index
@@ -259,16 +252,16 @@ namespace ArbSh.Core
                         }
                         else
                         {
-                            CoreConsole.WriteLine($"WARN (Parser): Input redirection operator '<' found at the end of command without a target file path.");
+                            CoreConsole.LogWarning("Parser", $"Input redirection operator '<' found at the end of command without a target file path.");
                             remainingTokens.RemoveAt(i); // Remove the invalid '<' operator token
                             processed = true;
                             continue; // Restart check from current index
                         }
                     }
                     // Handle Output Redirection (>, >>, 2>, etc.)
-                    else if (opValue.Contains(">")) // Check if it's an output redirection operator
+                    else if (opValue.Contains('>')) // Check if it's an output redirection operator
                     {
-                        ParsedCommand.RedirectionInfo? redirection = TryParseRedirectionOperator(opValue, remainingTokens, i);
+                        ParsedCommand.RedirectionInfo? redirection = TryParseRedirectionOperator(currentToken.Value, remainingTokens, i);
                         if (redirection != null)
                         {
                             parsedCommand.AddRedirection(redirection.Value);
@@ -280,7 +273,7 @@ namespace ArbSh.Core
                         }
                         else
                         {
-                            CoreConsole.WriteLine($"WARN (Parser): Failed to parse output redirection for operator token '{opValue}'.");
+                            CoreConsole.LogWarning("Parser", $"Failed to parse output redirection for operator token '{currentToken.Value}'.");
                             remainingTokens.RemoveAt(i); // Remove the invalid operator token
                             processed = true;
                             continue; // Restart check from current index
@@ -300,7 +293,19 @@ namespace ArbSh.Core
             // --- Argument/Parameter Parsing (using remaining tokens AFTER redirection removal) ---
             List<object> arguments = parsedCommand.Arguments;
             Dictionary<string, string> parameters = parsedCommand.Parameters;
+            List<object> commandLine = parsedCommand.CommandLineArguments; // Source-order view for external commands
             var currentArgumentBuilder = new StringBuilder(); // Builder for concatenating argument parts
+            var commandLineWord = new StringBuilder(); // Same parts, but split into words at whitespace
+            int previousPartEnd = -1;
+
+            void AddCommandLineWord()
+            {
+                if (commandLineWord.Length > 0)
+                {
+                    commandLine.Add(commandLineWord.ToString());
+                    commandLineWord.Clear();
+                }
+            }
 
             for (int i = 0; i < remainingTokens.Count; i++)
             {
@@ -309,6 +314,7 @@ namespace ArbSh.Core
                 // Check for parameter name
                 if (currentToken.Type == TokenType.ParameterName)
                 {
+                    AddCommandLineWord();
                     // If we were building an argument, add it before processing the parameter
                     if (currentArgumentBuilder.Length > 0)
                     {
@@ -318,6 +324,7 @@ namespace ArbSh.Core
 
                     string paramName = currentToken.Value;
                     string? paramValue = null;
+                    string? commandLineValue = null; // Without quotes for external commands
 
                     // Check if the next token exists and is NOT another parameter name or operator
                     // (Operators should have been handled already, but check just in case)
@@ -330,22 +337,27 @@ namespace ArbSh.Core
                         Token valueToken = remainingTokens[i + 1];
                         if (valueToken.Type == TokenType.Variable)
                         {
-                            string varName = valueToken.Value.Substring(1);
+                            string varName = valueToken.Span.Slice(1).ToString();
                             paramValue = GetVariableValue(varName);
-                            CoreConsole.WriteLine($"DEBUG (Parser): Expanded variable '{valueToken.Value}' to '{paramValue}' for parameter '{paramName}'.");
+                            CoreConsole.LogDebug("Parser", $"Expanded variable '{valueToken.Value}' to '{paramValue}' for parameter '{paramName}'.");
                         }
                         // TODO: Handle string literal quotes/escapes for parameter values?
                         else
                         {
                             paramValue = valueToken.Value;
                         }
+                        commandLineValue = valueToken.Type == TokenType.Variable ? paramValue : UnquotedValue(valueToken);
+                        previousPartEnd = valueToken.Start + valueToken.Length;
                         i++; // Consume the value token
                     }
                     parameters[paramName] = paramValue ?? string.Empty; // Store even if value is null (for switch parameters)
+                    commandLine.Add(paramName);
+                    commandLineWord.Append(commandLineValue); // Adjacent parts (e.g. the rest of a number) continue the value
                 }
                 // --- SubExpression Parsing ---
                 else if (currentToken.Type == TokenType.SubExpressionStart)
                 {
+                    AddCommandLineWord();
                     // If we were building an argument, add it before processing the subexpression
                     if (currentArgumentBuilder.Length > 0)
                     {
@@ -384,32 +396,36 @@ namespace ArbSh.Core
                     // Check if loop finished because we ran out of tokens before finding the end
                     if (parenNestingLevel != 0)
                     {
-                        CoreConsole.WriteLine("WARN (Parser): Unterminated subexpression '$()' found.");
+                        CoreConsole.LogWarning("Parser", "Unterminated subexpression '$()' found.");
                         // Add collected tokens as a single raw string argument
                         arguments.Add(string.Join("", subExpressionTokens.Select(t => t.Value)));
+                        commandLine.Add(arguments[^1]);
                     }
                     else
                     {
                         // Successfully parsed subexpression.
                         string subExpressionInput = string.Join(" ", subExpressionTokens.Select(t => t.Value));
-                        CoreConsole.WriteLine($"DEBUG (Parser): Recursively parsing subexpression content: '{subExpressionInput}'");
+                        CoreConsole.LogDebug("Parser", $"Recursively parsing subexpression content: '{subExpressionInput}'");
                         List<List<ParsedCommand>> subStatements = Parse(subExpressionInput);
 
                         if (subStatements.Count > 0)
                         {
                             arguments.Add(subStatements[0]); // Add List<ParsedCommand>
-                            CoreConsole.WriteLine($"DEBUG (Parser): Added parsed subexpression (statement 0) as argument.");
+                            commandLine.Add(subStatements[0]);
+                            CoreConsole.LogDebug("Parser", $"Added parsed subexpression (statement 0) as argument.");
                         }
                         else
                         {
-                            CoreConsole.WriteLine($"WARN (Parser): Subexpression '$({subExpressionInput})' parsed into zero statements.");
+                            CoreConsole.LogWarning("Parser", $"Subexpression '$({subExpressionInput})' parsed into zero statements.");
                             arguments.Add(new List<ParsedCommand>());
+                            commandLine.Add(arguments[^1]);
                         }
                     }
                 }
                 // --- Type Literal Parsing ---
                 else if (currentToken.Type == TokenType.TypeLiteral)
                 {
+                    AddCommandLineWord();
                     // If we were building an argument, add it first
                     if (currentArgumentBuilder.Length > 0)
                     {
@@ -417,37 +433,43 @@ namespace ArbSh.Core
                         currentArgumentBuilder.Clear();
                     }
 
-                    string typeName = currentToken.Value.Substring(1, currentToken.Value.Length - 2).Trim(); // Remove [ and ] and trim
+                    string typeName = currentToken.Span[1..^1].Trim().ToString(); // Remove [ and ] and trim
                     arguments.Add($"TypeLiteral:{typeName}"); // Add as a special string argument for now
-                    CoreConsole.WriteLine($"DEBUG (Parser): Added TypeLiteral '{typeName}' as argument.");
+                    commandLine.Add(currentToken.Value); // External commands see the literal as typed
+                    CoreConsole.LogDebug("Parser", $"Added TypeLiteral '{typeName}' as argument.");
                 }
                 else // It's part of a regular argument (Identifier, StringLiteral, Variable, Operator not handled as redirection, etc.)
                 {
-                    string valueToAppend;
+                    // Parts separated by whitespace are separate words for external commands
+                    if (currentToken.Start > previousPartEnd) AddCommandLineWord();
+                    int partStart = currentArgumentBuilder.Length;
+
                     // Check if it's a variable token that needs expansion
                     if (currentToken.Type == TokenType.Variable)
                     {
-                        string varName = currentToken.Value.Substring(1);
-                        valueToAppend = GetVariableValue(varName);
-                        CoreConsole.WriteLine($"DEBUG (Parser): Expanding variable '{currentToken.Value}' to '{valueToAppend}' for argument building.");
+                        string varName = currentToken.Span.Slice(1).ToString();
+                        string valueToAppend = GetVariableValue(varName);
+                        CoreConsole.LogDebug("Parser", $"Expanding variable '{currentToken.Span}' to '{valueToAppend}' for argument building.");
+                        currentArgumentBuilder.Append(valueToAppend);
                     }
                     else if (currentToken.Type == TokenType.StringLiteralDQ)
                     {
                         // Remove surrounding quotes and process escapes
-                        string rawString = currentToken.Value.Length >= 2 ? currentToken.Value.Substring(1, currentToken.Value.Length - 2) : "";
-                        valueToAppend = ProcessEscapesInString(rawString);
+                        AppendUnescaped(currentArgumentBuilder, QuotedContent(currentToken));
                     }
                     else if (currentToken.Type == TokenType.StringLiteralSQ)
                     {
                         // Remove surrounding quotes, no escape processing for single quotes
-                        valueToAppend = currentToken.Value.Length >= 2 ? currentToken.Value.Substring(1, currentToken.Value.Length - 2) : "";
+                        currentArgumentBuilder.Append(QuotedContent(currentToken));
                     }
                     else
                     {
                         // Append other token types' values directly
-                        valueToAppend = currentToken.Value;
+                        currentArgumentBuilder.Append(currentToken.Span);
                     }
-                    currentArgumentBuilder.Append(valueToAppend);
+
+                    commandLineWord.Append(currentArgumentBuilder, partStart, currentArgumentBuilder.Length - partStart);
+                    previousPartEnd = currentToken.Start + currentToken.Length;
                 }
             }
 
@@ -456,6 +478,7 @@ namespace ArbSh.Core
             {
                 arguments.Add(currentArgumentBuilder.ToString());
             }
+            AddCommandLineWord();
 
             // Return the command object populated earlier
             return parsedCommand;
@@ -483,7 +506,7 @@ namespace ArbSh.Core
                 handlePart = operatorTokenValue.Substring(0, operatorSymbolIndex);
                 if (!int.TryParse(handlePart, out sourceHandle))
                 {
-                    CoreConsole.WriteLine($"WARN (Parser): Invalid source handle '{handlePart}' in redirection operator '{operatorTokenValue}'. Defaulting to 1.");
+                    CoreConsole.LogWarning("Parser", $"Invalid source handle '{handlePart}' in redirection operator '{operatorTokenValue}'. Defaulting to 1.");
                     sourceHandle = 1; // Default on parse error
                 }
             }
@@ -496,7 +519,7 @@ namespace ArbSh.Core
 
 
             // --- Determine Target ---
-            // Note: The Regex patterns in RegexTokenizer should now capture the full operator like "2>&1" or ">&2"
+            // Note: The Lexer captures the full operator like "2>&1" or ">&2"
             if (operatorTokenValue.Contains("&")) // Check if it's potentially a stream redirection
             {
                  // Use Regex to extract source (optional) and target handles
@@ -517,17 +540,17 @@ namespace ArbSh.Core
                      }
                      else if (!int.TryParse(sourceHandleStr, out sourceHandle))
                      {
-                         CoreConsole.WriteLine($"WARN (Parser): Invalid source handle '{sourceHandleStr}' in stream redirection '{operatorTokenValue}'. Defaulting to 1.");
+                         CoreConsole.LogWarning("Parser", $"Invalid source handle '{sourceHandleStr}' in stream redirection '{operatorTokenValue}'. Defaulting to 1.");
                          sourceHandle = 1;
                      }
 
-                     CoreConsole.WriteLine($"DEBUG (ParsedCommand): Added stream redirection: {operatorTokenValue} (Source: {sourceHandle}, Target: {targetHandleStr}, Append: {append})");
+                     CoreConsole.LogDebug("ParsedCommand", $"Added stream redirection: {operatorTokenValue} (Source: {sourceHandle}, Target: {targetHandleStr}, Append: {append})");
                      return new ParsedCommand.RedirectionInfo(sourceHandle, ParsedCommand.RedirectionTargetType.StreamHandle, targetHandleStr, append);
                  }
                  else
                  {
                      // Regex didn't match the expected stream redirection format
-                     CoreConsole.WriteLine($"WARN (Parser): Invalid stream redirection operator format '{operatorTokenValue}'. Could not extract target handle.");
+                     CoreConsole.LogWarning("Parser", $"Invalid stream redirection operator format '{operatorTokenValue}'. Could not extract target handle.");
                      return null; // Indicate parsing failure
                  }
             }
@@ -539,26 +562,20 @@ namespace ArbSh.Core
                     if (targetToken.Type == TokenType.Identifier || targetToken.Type == TokenType.StringLiteralDQ || targetToken.Type == TokenType.StringLiteralSQ)
                     {
                         // TODO: Handle quotes/escapes in targetToken.Value if necessary
-                        string targetPath = targetToken.Value;
-                        // Remove quotes from string literals if present
-                        if (targetToken.Type == TokenType.StringLiteralDQ || targetToken.Type == TokenType.StringLiteralSQ)
-                        {
-                             if (targetPath.Length >= 2) // Avoid error on empty strings "" or ''
-                                targetPath = targetPath.Substring(1, targetPath.Length - 2);
-                        }
+                        string targetPath = UnquotedValue(targetToken);
 
-                        CoreConsole.WriteLine($"DEBUG (ParsedCommand): Added file redirection: {operatorTokenValue} {targetPath}");
+                        CoreConsole.LogDebug("ParsedCommand", $"Added file redirection: {operatorTokenValue} {targetPath}");
                         return new ParsedCommand.RedirectionInfo(sourceHandle, ParsedCommand.RedirectionTargetType.FilePath, targetPath, append);
                     }
                     else
                     {
-                        CoreConsole.WriteLine($"WARN (Parser): Unexpected token type '{targetToken.Type}' used as redirection file path target: '{targetToken.Value}'.");
+                        CoreConsole.LogWarning("Parser", $"Unexpected token type '{targetToken.Type}' used as redirection file path target: '{targetToken.Value}'.");
                         return null; // Indicate parsing failure
                     }
                 }
                 else
                 {
-                    CoreConsole.WriteLine($"WARN (Parser): Redirection operator '{operatorTokenValue}' found without a target file path.");
+                    CoreConsole.LogWarning("Parser", $"Redirection operator '{operatorTokenValue}' found without a target file path.");
                     return null; // Indicate parsing failure
                 }
             }
@@ -568,11 +585,11 @@ namespace ArbSh.Core
         // NOTE: Old state machine tokenizer (TokenizeInput, TokenizerStateSM enum, helper methods) removed.
 
         /// <summary>
-        /// Processes escape sequences within a string that was originally double-quoted.
+        /// Appends the content of a double-quoted string with escape sequences processed.
         /// </summary>
+        /// <param name="sb">The builder receiving the processed text.</param>
         /// <param name="rawString">The raw string content without the surrounding double quotes.</param>
-        /// <returns>The string with recognized escape sequences processed.</returns>
-        private static string ProcessEscapesInString(string rawString)
+        private static void AppendUnescaped(StringBuilder sb, ReadOnlySpan<char> rawString)
         {
             // PowerShell-like escapes: ` (backtick) is the escape character.
             // Common escapes: `` (literal backtick), `0 (null), `a (alert), `b (backspace),
@@ -583,7 +600,6 @@ namespace ArbSh.Core
             // Let's assume \ is the escape char as per StringLiteralDQ regex: \" \\ \$ etc.
             // The regex `(?:\\.|[^""\\])*` in StringLiteralDQ captures `\\.` for escapes.
 
-            var sb = new StringBuilder();
             for (int i = 0; i < rawString.Length; i++)
             {
                 if (rawString[i] == '\\' && i + 1 < rawString.Length)
@@ -615,7 +631,39 @@ namespace ArbSh.Core
                     sb.Append(rawString[i]);
                 }
             }
-            return sb.ToString();
+        }
+
+        /// <summary>
+        /// Returns the content between the surrounding quotes of a string literal token (empty if too short).
+        /// </summary>
+        private static ReadOnlySpan<char> QuotedContent(Token token)
+        {
+            return token.Length >= 2 ? token.Span[1..^1] : ReadOnlySpan<char>.Empty;
+        }
+
+        /// <summary>
+        /// Returns a token's text, without the surrounding quotes for string literals.
+        /// </summary>
+        private static string UnquotedValue(Token token)
+        {
+            if (token.Type == TokenType.StringLiteralDQ || token.Type == TokenType.StringLiteralSQ)
+            {
+                // Avoid error on empty strings "" or ''
+                return token.Length >= 2 ? token.Span[1..^1].ToString() : token.Value;
+            }
+
+            return token.Value;
+        }
+
+        /// <summary>
+        /// Computes the whitespace-trimmed sub-range of <paramref name="source"/> between <paramref name="start"/> and <paramref name="end"/>.
+        /// </summary>
+        private static void TrimRange(string source, int start, int end, out int trimmedStart, out int trimmedLength)
+        {
+            while (start < end && char.IsWhiteSpace(source[start])) start++;
+            while (end > start && char.IsWhiteSpace(source[end - 1])) end--;
+            trimmedStart = start;
+            trimmedLength = end - start;
         }
     }
 }
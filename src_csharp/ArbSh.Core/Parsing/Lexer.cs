@@ -0,0 +1,252 @@
+﻿using System;
+using System.Collections.Generic;
+
+namespace ArbSh.Core.Parsing
+{
+    /// <summary>
+    /// Single-pass, allocation-free lexer over <see cref="ReadOnlySpan{T}"/> input.
+    /// Recognizes the same token grammar as <see cref="RegexTokenizer"/>, with the same
+    /// precedence at each position, and reports tokens as offsets into the source.
+    /// </summary>
+    public static class Lexer
+    {
+        /// <summary>
+        /// Tokenizes a whole string. Whitespace and comments are skipped.
+        /// </summary>
+        /// <param name="input">The input string to tokenize.</param>
+        /// <returns>A list of recognized tokens.</returns>
+        public static List<Token> Tokenize(string input)
+        {
+            ArgumentNullException.ThrowIfNull(input);
+
+            var tokens = new List<Token>();
+            Tokenize(input, 0, input.Length, tokens);
+            return tokens;
+        }
+
+        /// <summary>
+        /// Tokenizes a range of <paramref name="source"/>, appending tokens whose offsets refer to the full source.
+        /// Whitespace and comments are skipped.
+        /// </summary>
+        /// <param name="source">The source text.</param>
+        /// <param name="start">Start of the range to tokenize.</param>
+        /// <param name="length">Length of the range to tokenize.</param>
+        /// <param name="tokens">Receives the recognized tokens.</param>
+        public static void Tokenize(string source, int start, int length, List<Token> tokens)
+        {
+            ArgumentNullException.ThrowIfNull(source);
+            ArgumentNullException.ThrowIfNull(tokens);
+
+            ReadOnlySpan<char> text = source.AsSpan(start, length);
+            int position = 0;
+            while (position < text.Length)
+            {
+                int tokenLength = Scan(text, position, out TokenType type);
+                if (type != TokenType.Whitespace && type != TokenType.Comment)
+                {
+                    tokens.Add(new Token(type, source, start + position, tokenLength));
+                }
+
+                position += tokenLength;
+            }
+        }
+
+        /// <summary>
+        /// Scans the token that starts at <paramref name="position"/>.
+        /// </summary>
+        /// <param name="text">The text being tokenized.</param>
+        /// <param name="position">Offset of the token start; must be inside <paramref name="text"/>.</param>
+        /// <param name="type">The recognized token type.</param>
+        /// <returns>The token length (always at least one character).</returns>
+        public static int Scan(ReadOnlySpan<char> text, int position, out TokenType type)
+        {
+            char c = text[position];
+            int next = position + 1;
+
+            if (char.IsWhiteSpace(c))
+            {
+                type = TokenType.Whitespace;
+                return ScanWhile(text, next, static ch => char.IsWhiteSpace(ch)) - position;
+            }
+
+            switch (c)
+            {
+                case '#':
+                    {
+                        // '.' in the regex grammar stops at a line feed.
+                        int newline = text.Slice(position).IndexOf('\n');
+                        type = TokenType.Comment;
+                        return newline < 0 ? text.Length - position : newline;
+                    }
+                case '"':
+                    if (TryScanDoubleQuoted(text, position, out int dqEnd))
+                    {
+                        type = TokenType.StringLiteralDQ;
+                        return dqEnd - position;
+                    }
+                    break;
+                case '\'':
+                    {
+                        int close = text.Slice(next).IndexOf('\'');
+                        if (close >= 0)
+                        {
+                            type = TokenType.StringLiteralSQ;
+                            return close + 2;
+                        }
+                    }
+                    break;
+                case '$':
+                    if (next < text.Length && IsNameStart(text[next]))
+                    {
+                        type = TokenType.Variable;
+                        return ScanWhile(text, next + 1, static ch => IsNameStart(ch) || char.IsNumber(ch)) - position;
+                    }
+                    if (next < text.Length && text[next] == '(')
+                    {
+                        type = TokenType.SubExpressionStart;
+                        return 2;
+                    }
+                    break;
+                case '-':
+                    if (next < text.Length && IsNameStart(text[next]))
+                    {
+                        type = TokenType.ParameterName;
+                        return ScanWhile(text, next + 1, static ch => IsNameStart(ch) || char.IsNumber(ch) || ch == '-') - position;
+                    }
+                    break;
+                case '<':
+                    type = TokenType.Operator;
+                    return 1;
+                case ';':
+                    type = TokenType.Separator;
+                    return 1;
+                case '|':
+                    type = TokenType.Operator;
+                    return 1;
+                case '(':
+                    type = TokenType.GroupStart;
+                    return 1;
+                case ')':
+                    type = TokenType.GroupEnd;
+                    return 1;
+                case '[':
+                    if (TryScanTypeLiteral(text, position, out int typeEnd))
+                    {
+                        type = TokenType.TypeLiteral;
+                        return typeEnd - position;
+                    }
+                    break;
+            }
+
+            if ((c == '>' || char.IsDigit(c)) && TryScanRedirection(text, position, out int operatorEnd))
+            {
+                type = TokenType.Operator;
+                return operatorEnd - position;
+            }
+
+            if (IsArgumentChar(c))
+            {
+                type = TokenType.Identifier;
+                return ScanWhile(text, next, static ch => IsArgumentChar(ch) || char.IsNumber(ch)) - position;
+            }
+
+            type = TokenType.Unknown;
+            return 1;
+        }
+
+        // "(?:\\.|[^"\\])*" - an escape cannot swallow a line feed, and there is no partial match.
+        private static bool TryScanDoubleQuoted(ReadOnlySpan<char> text, int position, out int end)
+        {
+            for (int i = position + 1; i < text.Length; i++)
+            {
+                char c = text[i];
+                if (c == '"')
+                {
+                    end = i + 1;
+                    return true;
+                }
+
+                if (c == '\\')
+                {
+                    if (i + 1 >= text.Length || text[i + 1] == '\n')
+                    {
+                        break;
+                    }
+
+                    i++;
+                }
+            }
+
+            end = position;
+            return false;
+        }
+
+        // \[\s*[\p{L}_][\p{L}\p{N}_\.]*\s*\]
+        private static bool TryScanTypeLiteral(ReadOnlySpan<char> text, int position, out int end)
+        {
+            end = position;
+
+            int i = ScanWhile(text, position + 1, static ch => char.IsWhiteSpace(ch));
+            if (i >= text.Length || !IsNameStart(text[i]))
+            {
+                return false;
+            }
+
+            i = ScanWhile(text, i + 1, static ch => IsNameStart(ch) || char.IsNumber(ch) || ch == '.');
+            i = ScanWhile(text, i, static ch => char.IsWhiteSpace(ch));
+            if (i >= text.Length || text[i] != ']')
+            {
+                return false;
+            }
+
+            end = i + 1;
+            return true;
+        }
+
+        // \d*>>&?\d | \d*>&?\d | \d*>> | \d*>  (first alternative wins)
+        private static bool TryScanRedirection(ReadOnlySpan<char> text, int position, out int end)
+        {
+            int i = ScanWhile(text, position, static ch => char.IsDigit(ch));
+            end = position;
+            if (i >= text.Length || text[i] != '>')
+            {
+                return false;
+            }
+
+            bool isAppend = i + 1 < text.Length && text[i + 1] == '>';
+            int afterSymbol = isAppend ? i + 2 : i + 1;
+
+            if (afterSymbol < text.Length)
+            {
+                if (text[afterSymbol] == '&' && afterSymbol + 1 < text.Length && char.IsDigit(text[afterSymbol + 1]))
+                {
+                    end = afterSymbol + 2;
+                    return true;
+                }
+
+                if (char.IsDigit(text[afterSymbol]))
+                {
+                    end = afterSymbol + 1;
+                    return true;
+                }
+            }
+
+            end = afterSymbol;
+            return true;
+        }
+
+        private static int ScanWhile(ReadOnlySpan<char> text, int position, Func<char, bool> predicate)
+        {
+            while (position < text.Length && predicate(text[position]))
+            {
+                position++;
+            }
+
+            return position;
+        }
+
+        private static bool IsNameStart(char c) => char.IsLetter(c) || c == '_';
+
+        private static bool IsArgumentChar(char c) => IsNameStart(c) || c is '.' or '/' or '\\' or '-';
+    }
+}
@@ -7,6 +7,8 @@ namespace ArbSh.Core.Parsing
 {
     /// <summary>
     /// Provides functionality to tokenize an input string based on regular expressions.
+    /// The parser uses <see cref="Lexer"/>; this class is kept as the reference grammar
+    /// for equivalence tests and benchmarks.
     /// </summary>
     public static class RegexTokenizer
     {
@@ -81,7 +83,7 @@ namespace ArbSh.Core.Parsing
                 if (match.Index > currentPosition)
                 {
                     string gapText = input.Substring(currentPosition, match.Index - currentPosition);
-                    CoreConsole.WriteLine($"WARN (Tokenizer): Unrecognized characters: '{gapText}'");
+                    CoreConsole.LogWarning("Tokenizer", $"Unrecognized characters: '{gapText}'");
                     // Optionally add these as Unknown tokens
                     foreach(char c in gapText)
                     {
@@ -114,7 +116,7 @@ namespace ArbSh.Core.Parsing
                 if (!matched)
                 {
                     // This shouldn't happen if the Unknown pattern is last and correct
-                    CoreConsole.WriteLine($"ERROR (Tokenizer): Match found but no group matched? Value: '{match.Value}'");
+                    CoreConsole.LogError("Tokenizer", $"Match found but no group matched? Value: '{match.Value}'");
                     tokens.Add(new Token(TokenType.Unknown, match.Value));
                 }
 
@@ -125,7 +127,7 @@ namespace ArbSh.Core.Parsing
             if (currentPosition < input.Length)
             {
                  string remainingText = input.Substring(currentPosition);
-                 CoreConsole.WriteLine($"WARN (Tokenizer): Unconsumed trailing characters: '{remainingText}'");
+                 CoreConsole.LogWarning("Tokenizer", $"Unconsumed trailing characters: '{remainingText}'");
                  // Optionally add these as Unknown tokens
                  foreach(char c in remainingText)
                  {
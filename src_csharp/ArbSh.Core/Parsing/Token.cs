@@ -27,20 +27,51 @@ namespace ArbSh.Core.Parsing
 
     /// <summary>
     /// Represents a single token identified by the tokenizer.
+    /// A token is an offset and length into its source text; <see cref="Value"/> materializes it on demand.
+    /// <c>default(Token)</c> is an empty <see cref="TokenType.Unknown"/> token.
     /// </summary>
     public readonly struct Token
     {
+        private readonly string _source;
+
         public TokenType Type { get; }
-        public string Value { get; }
-        // TODO: Add position/line info later if needed for better error reporting
+
+        /// <summary>
+        /// Gets the offset of the token in its source text.
+        /// </summary>
+        public int Start { get; }
+
+        /// <summary>
+        /// Gets the length of the token in characters.
+        /// </summary>
+        public int Length { get; }
+
+        /// <summary>
+        /// Gets the token text without allocating.
+        /// </summary>
+        public ReadOnlySpan<char> Span => Source.AsSpan(Start, Length);
+
+        /// <summary>
+        /// Gets the token text as a string (allocates unless the token covers its whole source).
+        /// </summary>
+        public string Value => Start == 0 && Length == Source.Length ? Source : Source.Substring(Start, Length);
+
+        // Null only for default(Token).
+        private string Source => _source ?? string.Empty;
 
         public Token(TokenType type, string value)
+            : this(type, value, 0, value.Length)
+        {
+        }
+
+        public Token(TokenType type, string source, int start, int length)
         {
             Type = type;
-            Value = value;
+            _source = source;
+            Start = start;
+            Length = length;
         }
 
         public override string ToString() => $"[{Type}: '{Value}']";
     }
 }
-
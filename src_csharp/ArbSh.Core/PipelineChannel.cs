@@ -0,0 +1,448 @@
+using System.Buffers;
+using System.Diagnostics;
+using System.Threading.Channels;
+
+namespace ArbSh.Core;
+
+/// <summary>
+/// A bounded, batched link between two pipeline stages.
+/// Objects written by the producing stage are grouped into batches before they are
+/// published. Once <see cref="Capacity"/> objects are waiting, <see cref="FlushAsync"/>
+/// suspends the producing stage (backpressure) until the next stage catches up.
+/// </summary>
+/// <remarks>
+/// The channel assumes a single producer (the stage that owns it) and a single consumer
+/// (the next stage or the executor output loop), matching how the executor wires stages.
+/// Only <see cref="WriteAsync"/> and <see cref="FlushAsync"/> apply backpressure.
+/// <see cref="Write"/> never blocks: batches that do not fit are held until the executor
+/// awaits <see cref="FlushAsync"/> between cmdlet lifecycle calls. The held batches are bounded
+/// by <see cref="MaxHeldObjects"/>; a stage that writes more than that from one synchronous call
+/// is faulted instead of buffering without limit.
+/// </remarks>
+internal sealed class PipelineChannel
+{
+    /// <summary>
+    /// Default maximum number of objects buffered between two stages.
+    /// </summary>
+    public const int DefaultCapacity = 1024;
+
+    /// <summary>
+    /// Default number of objects moved through the channel per batch.
+    /// </summary>
+    public const int DefaultBatchSize = 64;
+
+    /// <summary>
+    /// Multiple of <see cref="Capacity"/> that <see cref="Write"/> may hold back before it throws.
+    /// </summary>
+    public const int HeldCapacityFactor = 16;
+
+    private readonly Channel<ArraySegment<PipelineObject>> _channel;
+    private readonly Queue<ArraySegment<PipelineObject>> _overflow = new();
+    private PipelineObject[]? _pending;
+    private int _pendingCount;
+    private int _heldCount;
+    private volatile bool _completed;
+    private volatile bool _discarded;
+
+    // Producer and consumer run on the pipeline's scheduler thread, so the counters need no synchronization.
+    private long _objectsWritten;
+    private long _objectsPublished;
+    private long _objectsRead;
+    private long _maxQueueDepth;
+    private long _writeWaitTicks;
+    private long _readWaitTicks;
+
+    /// <summary>
+    /// Creates a pipeline channel.
+    /// </summary>
+    /// <param name="capacity">Maximum number of buffered objects. Zero or less means unbounded.</param>
+    /// <param name="batchSize">Maximum number of objects per published batch.</param>
+    public PipelineChannel(int capacity = DefaultCapacity, int batchSize = DefaultBatchSize)
+    {
+        BatchSize = Math.Max(1, batchSize);
+        Capacity = capacity > 0 ? Math.Max(capacity, BatchSize) : 0;
+        MaxHeldObjects = Capacity == 0 ? 0 : (int)Math.Min((long)Capacity * HeldCapacityFactor, int.MaxValue);
+
+        if (Capacity == 0)
+        {
+            _channel = Channel.CreateUnbounded<ArraySegment<PipelineObject>>(new UnboundedChannelOptions
+            {
+                SingleReader = true,
+                SingleWriter = true
+            });
+        }
+        else
+        {
+            // Capacity is expressed in objects; the underlying channel counts batches.
+            int batchCapacity = (Capacity + BatchSize - 1) / BatchSize;
+            _channel = Channel.CreateBounded<ArraySegment<PipelineObject>>(new BoundedChannelOptions(batchCapacity)
+            {
+                FullMode = BoundedChannelFullMode.Wait,
+                SingleReader = true,
+                SingleWriter = true
+            });
+        }
+    }
+
+    /// <summary>
+    /// Creates a channel sized from the given execution options.
+    /// </summary>
+    /// <param name="options">Execution options, or null for defaults.</param>
+    /// <returns>A new pipeline channel.</returns>
+    public static PipelineChannel Create(ExecutionOptions? options)
+    {
+        return options is null
+            ? new PipelineChannel()
+            : new PipelineChannel(options.PipelineCapacity, options.PipelineBatchSize);
+    }
+
+    /// <summary>
+    /// Maximum number of buffered objects (0 when unbounded).
+    /// </summary>
+    public int Capacity { get; }
+
+    /// <summary>
+    /// Maximum number of objects per batch.
+    /// </summary>
+    public int BatchSize { get; }
+
+    /// <summary>
+    /// Most objects <see cref="Write"/> holds back while the channel is full (0 when unbounded).
+    /// </summary>
+    public int MaxHeldObjects { get; }
+
+    /// <summary>
+    /// Indicates whether the producer has completed the channel.
+    /// </summary>
+    public bool IsCompleted => _completed;
+
+    /// <summary>
+    /// Indicates whether the consumer has abandoned the channel.
+    /// Writes to a discarded channel are silently dropped.
+    /// </summary>
+    public bool IsDiscarded => _discarded;
+
+    /// <summary>
+    /// Number of objects accepted by <see cref="Write"/>.
+    /// </summary>
+    public long ObjectsWritten => _objectsWritten;
+
+    /// <summary>
+    /// Number of objects in the batches returned by <see cref="TryRead"/>.
+    /// </summary>
+    public long ObjectsRead => _objectsRead;
+
+    /// <summary>
+    /// Most objects that were published and not yet read at once.
+    /// </summary>
+    public long MaxQueueDepth => _maxQueueDepth;
+
+    /// <summary>
+    /// Total time <see cref="FlushAsync"/> waited for room in the channel.
+    /// </summary>
+    public TimeSpan WriteWaitTime => Stopwatch.GetElapsedTime(0, _writeWaitTicks);
+
+    /// <summary>
+    /// Total time <see cref="WaitToReadAsync"/> waited for a batch.
+    /// </summary>
+    public TimeSpan ReadWaitTime => Stopwatch.GetElapsedTime(0, _readWaitTicks);
+
+    /// <summary>
+    /// Adds an object to the current batch, publishing the batch once it is full.
+    /// </summary>
+    /// <param name="item">The object to write.</param>
+    /// <returns>False if the channel was completed or discarded and the object was dropped.</returns>
+    /// <exception cref="InvalidOperationException">
+    /// The channel is full and already holds <see cref="MaxHeldObjects"/> objects back. The writer
+    /// must await <see cref="WriteAsync"/> to wait for the consumer.
+    /// </exception>
+    public bool Write(PipelineObject item)
+    {
+        if (_completed || _discarded)
+        {
+            return false;
+        }
+
+        if (MaxHeldObjects > 0 && _heldCount >= MaxHeldObjects)
+        {
+            throw new InvalidOperationException(
+                $"The pipeline stage wrote more than {MaxHeldObjects} objects without waiting for the next stage; write them with WriteObjectAsync.");
+        }
+
+        // Batch arrays are pooled: the consumer hands each one back through Release.
+        _pending ??= ArrayPool<PipelineObject>.Shared.Rent(BatchSize);
+        _pending[_pendingCount++] = item;
+        _objectsWritten++;
+
+        if (_pendingCount >= BatchSize)
+        {
+            PublishPending();
+        }
+
+        return true;
+    }
+
+    /// <summary>
+    /// Adds an object and waits for room if the channel is at capacity.
+    /// </summary>
+    /// <param name="item">The object to write.</param>
+    /// <returns>False if the channel was completed or discarded and the object was dropped.</returns>
+    public async ValueTask<bool> WriteAsync(PipelineObject item)
+    {
+        if (!Write(item))
+        {
+            return false;
+        }
+
+        return _overflow.Count == 0 || await FlushAsync();
+    }
+
+    /// <summary>
+    /// Publishes any partially filled batch and waits until every held batch fits in the channel.
+    /// The executor awaits this after every cmdlet lifecycle step to keep output latency low
+    /// and to apply backpressure without blocking a thread.
+    /// </summary>
+    /// <returns>False if the channel was discarded and pending objects were dropped.</returns>
+    public async ValueTask<bool> FlushAsync()
+    {
+        if (_pendingCount > 0)
+        {
+            PublishPending();
+        }
+
+        while (_overflow.Count > 0)
+        {
+            if (_discarded)
+            {
+                ReleaseOverflow();
+                return false;
+            }
+
+            try
+            {
+                ArraySegment<PipelineObject> batch = _overflow.Peek();
+                ValueTask write = _channel.Writer.WriteAsync(batch);
+                if (!write.IsCompletedSuccessfully)
+                {
+                    long waitStart = Stopwatch.GetTimestamp();
+                    try
+                    {
+                        await write;
+                    }
+                    finally
+                    {
+                        _writeWaitTicks += Stopwatch.GetTimestamp() - waitStart;
+                    }
+                }
+
+                _overflow.Dequeue();
+                _heldCount -= batch.Count;
+                _objectsPublished += batch.Count;
+            }
+            catch (ChannelClosedException)
+            {
+                ReleaseOverflow();
+                return false;
+            }
+        }
+
+        return !_discarded;
+    }
+
+    /// <summary>
+    /// Flushes pending objects and marks the channel as complete.
+    /// </summary>
+    public async ValueTask CompleteAsync()
+    {
+        if (_completed)
+        {
+            return;
+        }
+
+        await FlushAsync();
+        _completed = true;
+        _channel.Writer.TryComplete();
+    }
+
+    /// <summary>
+    /// Marks the channel as complete from synchronous setup code.
+    /// Only valid while the channel has room for its pending objects (e.g. a fresh channel
+    /// holding a single error record); anything that does not fit is dropped.
+    /// </summary>
+    public void Complete()
+    {
+        if (_completed)
+        {
+            return;
+        }
+
+        if (_pendingCount > 0)
+        {
+            PublishPending();
+        }
+
+        while (_overflow.Count > 0 && _channel.Writer.TryWrite(_overflow.Peek()))
+        {
+            int count = _overflow.Dequeue().Count;
+            _heldCount -= count;
+            _objectsPublished += count;
+        }
+
+        ReleaseOverflow();
+        _completed = true;
+        _channel.Writer.TryComplete();
+    }
+
+    /// <summary>
+    /// Abandons the channel from the consumer side. Pending and future writes are dropped,
+    /// and a producer waiting on a full channel is released.
+    /// </summary>
+    public void Discard()
+    {
+        _discarded = true;
+        _channel.Writer.TryComplete();
+        while (_channel.Reader.TryRead(out ArraySegment<PipelineObject> batch))
+        {
+            Release(batch);
+        }
+    }
+
+    /// <summary>
+    /// Waits until a batch is available or the channel is complete.
+    /// </summary>
+    /// <returns>False when the channel is complete and fully drained.</returns>
+    public ValueTask<bool> WaitToReadAsync()
+    {
+        ValueTask<bool> wait = _channel.Reader.WaitToReadAsync();
+        return wait.IsCompletedSuccessfully ? wait : TimeReadWaitAsync(wait);
+    }
+
+    /// <summary>
+    /// Reads the next published batch without waiting.
+    /// </summary>
+    /// <param name="batch">The batch that was read. Pass it to <see cref="Release"/> once its items are processed.</param>
+    /// <returns>True if a batch was available.</returns>
+    public bool TryRead(out ArraySegment<PipelineObject> batch)
+    {
+        if (!_channel.Reader.TryRead(out batch))
+        {
+            return false;
+        }
+
+        _maxQueueDepth = Math.Max(_maxQueueDepth, _objectsPublished - _objectsRead);
+        _objectsRead += batch.Count;
+        return true;
+    }
+
+    /// <summary>
+    /// Returns a batch obtained from <see cref="TryRead"/> to the pool. The batch must not be used afterwards.
+    /// </summary>
+    /// <param name="batch">The processed batch.</param>
+    public void Release(ArraySegment<PipelineObject> batch)
+    {
+        if (batch.Array is { Length: > 0 } array)
+        {
+            // Clear the used slots so pooled arrays do not keep pipeline values alive.
+            batch.AsSpan().Clear();
+            ArrayPool<PipelineObject>.Shared.Return(array);
+        }
+    }
+
+    /// <summary>
+    /// Reads the next published batch, pumping <paramref name="scheduler"/> on the calling thread
+    /// until the producing stages publish one.
+    /// </summary>
+    /// <param name="scheduler">The scheduler running the producing stages.</param>
+    /// <param name="batch">The batch that was read.</param>
+    /// <returns>False when the channel is complete and fully drained.</returns>
+    public bool TryReadBatch(PipelineScheduler scheduler, out ArraySegment<PipelineObject> batch)
+    {
+        while (true)
+        {
+            if (TryRead(out batch))
+            {
+                return true;
+            }
+
+            ValueTask<bool> wait = WaitToReadAsync();
+            if (!wait.IsCompleted)
+            {
+                Task<bool> waitTask = wait.AsTask();
+                scheduler.RunUntilComplete(waitTask);
+                wait = new ValueTask<bool>(waitTask);
+            }
+
+            if (!wait.Result)
+            {
+                return false;
+            }
+        }
+    }
+
+    /// <summary>
+    /// Enumerates every object until the producer completes the channel,
+    /// pumping <paramref name="scheduler"/> whenever no batch is ready.
+    /// </summary>
+    /// <param name="scheduler">The scheduler running the producing stages.</param>
+    /// <returns>The consumed objects in write order.</returns>
+    public IEnumerable<PipelineObject> GetConsumingEnumerable(PipelineScheduler scheduler)
+    {
+        while (TryReadBatch(scheduler, out ArraySegment<PipelineObject> batch))
+        {
+            for (int i = 0; i < batch.Count; i++)
+            {
+                yield return batch[i];
+            }
+
+            Release(batch);
+        }
+    }
+
+    private void PublishPending()
+    {
+        var batch = new ArraySegment<PipelineObject>(_pending!, 0, _pendingCount);
+        _pending = null;
+        _pendingCount = 0;
+
+        if (_discarded)
+        {
+            Release(batch);
+            return;
+        }
+
+        // Preserve order: once a batch is held back, later batches queue behind it.
+        if (_overflow.Count > 0 || !_channel.Writer.TryWrite(batch))
+        {
+            _overflow.Enqueue(batch);
+            _heldCount += batch.Count;
+            return;
+        }
+
+        _objectsPublished += batch.Count;
+    }
+
+    private async ValueTask<bool> TimeReadWaitAsync(ValueTask<bool> wait)
+    {
+        // No scheduler hop here: TryReadBatch waits on this from inside another pipeline's stage,
+        // whose scheduler is not pumped until the wait completes.
+        long waitStart = Stopwatch.GetTimestamp();
+        try
+        {
+            return await wait.ConfigureAwait(false);
+        }
+        finally
+        {
+            _readWaitTicks += Stopwatch.GetTimestamp() - waitStart;
+        }
+    }
+
+    private void ReleaseOverflow()
+    {
+        while (_overflow.Count > 0)
+        {
+            Release(_overflow.Dequeue());
+        }
+
+        _heldCount = 0;
+    }
+}
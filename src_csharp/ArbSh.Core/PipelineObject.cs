@@ -1,14 +1,44 @@
-﻿namespace ArbSh.Core
+﻿using System;
+using System.Globalization;
+using ArbSh.Core.Models;
+
+namespace ArbSh.Core
 {
+    /// <summary>
+    /// Identifies how a <see cref="PipelineObject"/> stores its value.
+    /// </summary>
+    public enum PipelineValueKind : byte
+    {
+        /// <summary>No value (null).</summary>
+        None,
+        /// <summary>A <see cref="string"/>.</summary>
+        String,
+        /// <summary>An <see cref="int"/>, stored unboxed.</summary>
+        Int32,
+        /// <summary>A <see cref="long"/>, stored unboxed.</summary>
+        Int64,
+        /// <summary>A <see cref="double"/>, stored unboxed.</summary>
+        Double,
+        /// <summary>A <see cref="Models.DirectoryEntry"/> produced by directory listings.</summary>
+        DirectoryEntry,
+        /// <summary>Any other object.</summary>
+        Object
+    }
+
     /// <summary>
     /// Represents a single object flowing through the pipeline.
     /// Can represent regular output or an error record.
     /// </summary>
-    public class PipelineObject
+    /// <remarks>
+    /// A value type, so pipeline batches hold items inline with no per-item allocation.
+    /// The common numeric types have typed constructors and are kept unboxed until <see cref="Value"/>
+    /// is read; every reference (strings and directory entries included) goes through the object
+    /// constructor, so <c>new PipelineObject(null)</c> is unambiguous.
+    /// </remarks>
+    public readonly struct PipelineObject
     {
-        // Basic properties or methods common to all pipeline objects can go here.
-        public object? Value { get; } // Make Value readonly after construction
-        public bool IsError { get; } // Flag to indicate if this is an error
+        private readonly object? _reference;
+        private readonly long _bits;
 
         // Constructor for regular output
         public PipelineObject(object? value) : this(value, false) { }
@@ -16,14 +46,147 @@
         // Primary constructor
         public PipelineObject(object? value, bool isError)
         {
-            Value = value;
             IsError = isError;
+            _bits = 0;
+            _reference = null;
+
+            switch (value)
+            {
+                case null:
+                    Kind = PipelineValueKind.None;
+                    break;
+                case string text:
+                    Kind = PipelineValueKind.String;
+                    _reference = text;
+                    break;
+                case int number:
+                    Kind = PipelineValueKind.Int32;
+                    _bits = number;
+                    break;
+                case long number:
+                    Kind = PipelineValueKind.Int64;
+                    _bits = number;
+                    break;
+                case double number:
+                    Kind = PipelineValueKind.Double;
+                    _bits = BitConverter.DoubleToInt64Bits(number);
+                    break;
+                case DirectoryEntry entry:
+                    Kind = PipelineValueKind.DirectoryEntry;
+                    _reference = entry;
+                    break;
+                default:
+                    Kind = PipelineValueKind.Object;
+                    _reference = value;
+                    break;
+            }
+        }
+
+        public PipelineObject(int value, bool isError = false)
+        {
+            Kind = PipelineValueKind.Int32;
+            _reference = null;
+            _bits = value;
+            IsError = isError;
+        }
+
+        public PipelineObject(long value, bool isError = false)
+        {
+            Kind = PipelineValueKind.Int64;
+            _reference = null;
+            _bits = value;
+            IsError = isError;
+        }
+
+        public PipelineObject(double value, bool isError = false)
+        {
+            Kind = PipelineValueKind.Double;
+            _reference = null;
+            _bits = BitConverter.DoubleToInt64Bits(value);
+            IsError = isError;
+        }
+
+        /// <summary>
+        /// Gets how the value is stored.
+        /// </summary>
+        public PipelineValueKind Kind { get; }
+
+        /// <summary>
+        /// Gets the value as an object. Numeric values are boxed on each read; prefer the typed accessors.
+        /// </summary>
+        public object? Value => Kind switch
+        {
+            PipelineValueKind.Int32 => (int)_bits,
+            PipelineValueKind.Int64 => _bits,
+            PipelineValueKind.Double => BitConverter.Int64BitsToDouble(_bits),
+            _ => _reference
+        };
+
+        public bool IsError { get; } // Flag to indicate if this is an error
+
+        /// <summary>
+        /// Gets the runtime type of the value without boxing numbers.
+        /// </summary>
+        /// <returns>The value's type, or null when there is no value.</returns>
+        public Type? GetValueType()
+        {
+            return Kind switch
+            {
+                PipelineValueKind.Int32 => typeof(int),
+                PipelineValueKind.Int64 => typeof(long),
+                PipelineValueKind.Double => typeof(double),
+                _ => _reference?.GetType()
+            };
+        }
+
+        /// <summary>
+        /// Gets the value if it is a string.
+        /// </summary>
+        public bool TryGetString(out string value)
+        {
+            value = Kind == PipelineValueKind.String ? (string)_reference! : string.Empty;
+            return Kind == PipelineValueKind.String;
+        }
+
+        /// <summary>
+        /// Gets the value if it is an <see cref="int"/> or <see cref="long"/>.
+        /// </summary>
+        public bool TryGetInt64(out long value)
+        {
+            bool isInteger = Kind is PipelineValueKind.Int32 or PipelineValueKind.Int64;
+            value = isInteger ? _bits : 0;
+            return isInteger;
+        }
+
+        /// <summary>
+        /// Gets the value if it is a <see cref="double"/>.
+        /// </summary>
+        public bool TryGetDouble(out double value)
+        {
+            value = Kind == PipelineValueKind.Double ? BitConverter.Int64BitsToDouble(_bits) : 0;
+            return Kind == PipelineValueKind.Double;
+        }
+
+        /// <summary>
+        /// Gets the value if it is a <see cref="Models.DirectoryEntry"/>.
+        /// </summary>
+        public bool TryGetDirectoryEntry(out DirectoryEntry? value)
+        {
+            value = _reference as DirectoryEntry;
+            return Kind == PipelineValueKind.DirectoryEntry;
         }
 
         public override string ToString()
         {
-            return Value?.ToString() ?? string.Empty;
+            return Kind switch
+            {
+                PipelineValueKind.None => string.Empty,
+                PipelineValueKind.String => (string)_reference!,
+                PipelineValueKind.Int32 => ((int)_bits).ToString(CultureInfo.CurrentCulture),
+                PipelineValueKind.Int64 => _bits.ToString(CultureInfo.CurrentCulture),
+                PipelineValueKind.Double => BitConverter.Int64BitsToDouble(_bits).ToString(CultureInfo.CurrentCulture),
+                _ => _reference!.ToString() ?? string.Empty
+            };
         }
     }
 }
-
@@ -0,0 +1,100 @@
+namespace ArbSh.Core;
+
+/// <summary>
+/// A cooperative, single-threaded task scheduler for one pipeline.
+/// Stages are started as async tasks on the scheduler and only run while the thread that
+/// owns the pipeline pumps it (see <see cref="RunUntilComplete"/>), so a pipeline of any
+/// depth occupies exactly one thread and never parks thread-pool workers on blocking reads.
+/// </summary>
+/// <remarks>
+/// Nested subexpressions create their own scheduler and pump it on the current thread,
+/// which keeps them independent of the outer pipeline's queue.
+/// </remarks>
+internal sealed class PipelineScheduler : TaskScheduler
+{
+    private readonly Queue<Task> _queue = new();
+    private readonly object _gate = new();
+
+    /// <inheritdoc />
+    public override int MaximumConcurrencyLevel => 1;
+
+    /// <summary>
+    /// Queues an async stage body on this scheduler. The body does not run until the scheduler is pumped.
+    /// </summary>
+    /// <param name="body">The stage body.</param>
+    /// <returns>A task that completes when the stage body completes.</returns>
+    public Task Start(Func<Task> body)
+    {
+        return Task.Factory.StartNew(body, CancellationToken.None, TaskCreationOptions.DenyChildAttach, this).Unwrap();
+    }
+
+    /// <summary>
+    /// Runs queued work on the calling thread until <paramref name="task"/> completes.
+    /// Waits without spinning when every stage is suspended on external I/O.
+    /// This method does not throw for a faulted <paramref name="task"/>; observe it afterwards.
+    /// </summary>
+    /// <param name="task">The task to wait for.</param>
+    public void RunUntilComplete(Task task)
+    {
+        if (!task.IsCompleted)
+        {
+            task.ContinueWith(_ => Signal(), CancellationToken.None, TaskContinuationOptions.ExecuteSynchronously, TaskScheduler.Default);
+        }
+
+        while (!task.IsCompleted)
+        {
+            Task? next = null;
+            lock (_gate)
+            {
+                while (_queue.Count == 0 && !task.IsCompleted)
+                {
+                    Monitor.Wait(_gate);
+                }
+
+                if (_queue.Count > 0)
+                {
+                    next = _queue.Dequeue();
+                }
+            }
+
+            if (next != null)
+            {
+                TryExecuteTask(next);
+            }
+        }
+    }
+
+    /// <inheritdoc />
+    protected override void QueueTask(Task task)
+    {
+        lock (_gate)
+        {
+            _queue.Enqueue(task);
+            Monitor.Pulse(_gate);
+        }
+    }
+
+    /// <inheritdoc />
+    protected override bool TryExecuteTaskInline(Task task, bool taskWasPreviouslyQueued)
+    {
+        // Always go through the queue so stage continuations never re-enter each other.
+        return false;
+    }
+
+    /// <inheritdoc />
+    protected override IEnumerable<Task> GetScheduledTasks()
+    {
+        lock (_gate)
+        {
+            return _queue.ToArray();
+        }
+    }
+
+    private void Signal()
+    {
+        lock (_gate)
+        {
+            Monitor.Pulse(_gate);
+        }
+    }
+}
@@ -0,0 +1,73 @@
+using System.Diagnostics;
+
+namespace ArbSh.Core;
+
+/// <summary>
+/// Object counts and timings of one pipeline stage, taken when the stage finishes.
+/// </summary>
+/// <remarks>
+/// Counts and waits come from the channels on either side of the stage, so they cover every read and
+/// write the stage made, including <c>WriteObjectAsync</c> calls inside a cmdlet.
+/// </remarks>
+public sealed class PipelineStageStats
+{
+    internal PipelineStageStats(string commandName)
+    {
+        CommandName = commandName;
+    }
+
+    /// <summary>
+    /// The command the stage ran.
+    /// </summary>
+    public string CommandName { get; }
+
+    /// <summary>
+    /// Objects the stage read from the previous stage.
+    /// </summary>
+    public long ObjectsIn { get; private set; }
+
+    /// <summary>
+    /// Objects the stage wrote to its output.
+    /// </summary>
+    public long ObjectsOut { get; private set; }
+
+    /// <summary>
+    /// Most objects that were waiting in the stage's input channel at once.
+    /// </summary>
+    public long MaxQueueDepth { get; private set; }
+
+    /// <summary>
+    /// Time the stage was suspended waiting for input.
+    /// </summary>
+    public TimeSpan InputWaitTime { get; private set; }
+
+    /// <summary>
+    /// Time the stage was suspended because the next stage was behind.
+    /// </summary>
+    public TimeSpan OutputWaitTime { get; private set; }
+
+    /// <summary>
+    /// Time spent binding the stage's parameters.
+    /// </summary>
+    public TimeSpan BindTime { get; internal set; }
+
+    /// <summary>
+    /// Time from the stage's start to its completion, waits included.
+    /// </summary>
+    public TimeSpan Elapsed { get; private set; }
+
+    internal void Complete(PipelineChannel? input, PipelineChannel output, long startTimestamp)
+    {
+        if (input != null)
+        {
+            ObjectsIn = input.ObjectsRead;
+            MaxQueueDepth = input.MaxQueueDepth;
+            InputWaitTime = input.ReadWaitTime;
+        }
+
+        ObjectsOut = output.ObjectsWritten;
+        OutputWaitTime = output.WriteWaitTime;
+        Elapsed = Stopwatch.GetElapsedTime(startTimestamp);
+        ShellMetrics.RecordStage(this);
+    }
+}
@@ -0,0 +1,59 @@
+using System.Text;
+
+namespace ArbSh.Core;
+
+/// <summary>
+/// Shared settings and factories for file redirection (<c>&lt;</c>, <c>&gt;</c>, <c>&gt;&gt;</c>, <c>2&gt;</c>).
+/// </summary>
+internal static class RedirectionFile
+{
+    /// <summary>
+    /// Default size of the read and write buffers, in bytes.
+    /// </summary>
+    public const int DefaultBufferSize = 256 * 1024;
+
+    /// <summary>
+    /// Default input file size from which <c>&lt;</c> reads through a memory mapping.
+    /// </summary>
+    public const long DefaultMemoryMapThreshold = 64L * 1024 * 1024;
+
+    private const int MinimumBufferSize = 16;
+
+    /// <summary>
+    /// UTF-8 without a byte order mark, the encoding used for redirected files.
+    /// </summary>
+    public static readonly Encoding Utf8 = new UTF8Encoding(encoderShouldEmitUTF8Identifier: false);
+
+    /// <summary>
+    /// Gets the effective buffer size for the given options.
+    /// </summary>
+    /// <param name="options">Execution options, or null for defaults.</param>
+    /// <returns>The buffer size in bytes.</returns>
+    public static int GetBufferSize(ExecutionOptions? options)
+    {
+        return Math.Max(MinimumBufferSize, options?.RedirectionBufferSize ?? DefaultBufferSize);
+    }
+
+    /// <summary>
+    /// Opens an output redirection file. Lines are encoded into one large buffer and written
+    /// to disk when it fills or when the writer is disposed, not once per line.
+    /// </summary>
+    /// <param name="path">The resolved file path.</param>
+    /// <param name="append">True for <c>&gt;&gt;</c>, false to truncate.</param>
+    /// <param name="options">Execution options, or null for defaults.</param>
+    /// <returns>A buffered writer that owns the file.</returns>
+    public static StreamWriter OpenWriter(string path, bool append, ExecutionOptions? options)
+    {
+        int bufferSize = GetBufferSize(options);
+        var file = new FileStream(
+            path,
+            append ? FileMode.Append : FileMode.Create,
+            FileAccess.Write,
+            FileShare.Read,
+            bufferSize: 1,
+            FileOptions.SequentialScan);
+
+        // StreamWriter's buffer is measured in chars; size it so one flush fills the byte budget.
+        return new StreamWriter(file, Utf8, Math.Max(MinimumBufferSize, bufferSize / 2)) { AutoFlush = false };
+    }
+}
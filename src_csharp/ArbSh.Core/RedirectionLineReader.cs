@@ -0,0 +1,212 @@
+using System.Buffers;
+using System.IO.MemoryMappedFiles;
+using System.Text;
+
+namespace ArbSh.Core;
+
+/// <summary>
+/// Reads the lines of an input redirection file (<c>&lt; file</c>) in large chunks.
+/// Bytes are read into a pooled buffer and decoded in bulk; each line then costs a single
+/// string allocation. Files at or above <see cref="ExecutionOptions.RedirectionMemoryMapThreshold"/>
+/// are read through a read-only memory mapping instead of <see cref="FileStream"/> reads.
+/// </summary>
+/// <remarks>
+/// Line breaks and encoding match <see cref="StreamReader.ReadLine"/> over UTF-8:
+/// <c>\n</c>, <c>\r</c> and <c>\r\n</c> end a line, a UTF-8 or UTF-16 byte order mark selects
+/// the decoder and is skipped, and invalid bytes decode to U+FFFD.
+/// </remarks>
+internal sealed class RedirectionLineReader : IDisposable
+{
+    private readonly Stream _stream;
+    private readonly MemoryMappedFile? _mapping;
+    private long _remainingBytes;
+    private byte[] _bytes;
+    private char[] _chars;
+    private Encoding? _encoding;
+    private Decoder? _decoder;
+    private int _charStart;
+    private int _charEnd;
+    private int _scanFrom;
+    private bool _endOfFile;
+    private bool _disposed;
+
+    private RedirectionLineReader(Stream stream, MemoryMappedFile? mapping, long length, int bufferSize)
+    {
+        _stream = stream;
+        _mapping = mapping;
+        _remainingBytes = length;
+        _bytes = ArrayPool<byte>.Shared.Rent(bufferSize);
+        _chars = ArrayPool<char>.Shared.Rent(RedirectionFile.Utf8.GetMaxCharCount(_bytes.Length) * 2);
+    }
+
+    /// <summary>
+    /// Opens a redirection input file.
+    /// </summary>
+    /// <param name="path">The resolved file path.</param>
+    /// <param name="options">Execution options, or null for defaults.</param>
+    /// <returns>A reader positioned at the first line.</returns>
+    public static RedirectionLineReader Open(string path, ExecutionOptions? options)
+    {
+        int bufferSize = RedirectionFile.GetBufferSize(options);
+        long threshold = options?.RedirectionMemoryMapThreshold ?? RedirectionFile.DefaultMemoryMapThreshold;
+
+        var file = new FileStream(path, FileMode.Open, FileAccess.Read, FileShare.Read, bufferSize: 1, FileOptions.SequentialScan);
+        long length = file.Length;
+        if (threshold <= 0 || length < threshold)
+        {
+            return new RedirectionLineReader(file, mapping: null, length, bufferSize);
+        }
+
+        try
+        {
+            MemoryMappedFile mapping = MemoryMappedFile.CreateFromFile(
+                file, mapName: null, capacity: 0, MemoryMappedFileAccess.Read, HandleInheritability.None, leaveOpen: false);
+            Stream view = mapping.CreateViewStream(0, length, MemoryMappedFileAccess.Read);
+            return new RedirectionLineReader(view, mapping, length, bufferSize);
+        }
+        catch
+        {
+            file.Dispose();
+            throw;
+        }
+    }
+
+    /// <summary>
+    /// Reads the next line without its terminator.
+    /// </summary>
+    /// <returns>The line, or null at end of file.</returns>
+    public async ValueTask<string?> ReadLineAsync()
+    {
+        ObjectDisposedException.ThrowIf(_disposed, this);
+
+        while (true)
+        {
+            int available = _charEnd - _scanFrom;
+            int index = available > 0 ? _chars.AsSpan(_scanFrom, available).IndexOfAny('\r', '\n') : -1;
+            if (index >= 0)
+            {
+                int end = _scanFrom + index;
+                if (_chars[end] == '\r' && end + 1 == _charEnd && !_endOfFile)
+                {
+                    // A trailing '\r' may be the first half of "\r\n"; decide after the next chunk.
+                    _scanFrom = end;
+                    await FillAsync();
+                    continue;
+                }
+
+                string line = new(_chars, _charStart, end - _charStart);
+                int next = end + 1;
+                if (_chars[end] == '\r' && next < _charEnd && _chars[next] == '\n')
+                {
+                    next++;
+                }
+
+                _charStart = next;
+                _scanFrom = next;
+                return line;
+            }
+
+            _scanFrom = _charEnd;
+            if (_endOfFile)
+            {
+                if (_charStart == _charEnd)
+                {
+                    return null;
+                }
+
+                string last = new(_chars, _charStart, _charEnd - _charStart);
+                _charStart = _charEnd;
+                return last;
+            }
+
+            await FillAsync();
+        }
+    }
+
+    /// <inheritdoc />
+    public void Dispose()
+    {
+        if (_disposed)
+        {
+            return;
+        }
+
+        _disposed = true;
+        _stream.Dispose();
+        _mapping?.Dispose();
+        ArrayPool<byte>.Shared.Return(_bytes);
+        ArrayPool<char>.Shared.Return(_chars);
+        _bytes = [];
+        _chars = [];
+    }
+
+    private async ValueTask FillAsync()
+    {
+        int toRead = (int)Math.Min(_bytes.Length, _remainingBytes);
+        int read = toRead > 0 ? await _stream.ReadAsync(_bytes.AsMemory(0, toRead)) : 0;
+        _remainingBytes -= read;
+
+        int offset = 0;
+        if (_decoder == null)
+        {
+            _encoding = DetectEncoding(_bytes.AsSpan(0, read), out offset);
+            _decoder = _encoding.GetDecoder();
+        }
+
+        EnsureCharSpace(_encoding!.GetMaxCharCount(read - offset));
+        int decoded = _decoder.GetChars(_bytes.AsSpan(offset, read - offset), _chars.AsSpan(_charEnd), flush: read == 0);
+        _charEnd += decoded;
+        _endOfFile = read == 0;
+    }
+
+    // Moves the unread line to the front of the buffer and grows it when a line outgrows it.
+    private void EnsureCharSpace(int needed)
+    {
+        int pending = _charEnd - _charStart;
+        if (_chars.Length - _charEnd >= needed)
+        {
+            return;
+        }
+
+        char[] target = _chars;
+        if (pending + needed > _chars.Length)
+        {
+            target = ArrayPool<char>.Shared.Rent(Math.Max(_chars.Length * 2, pending + needed));
+        }
+
+        _chars.AsSpan(_charStart, pending).CopyTo(target);
+        if (!ReferenceEquals(target, _chars))
+        {
+            ArrayPool<char>.Shared.Return(_chars);
+            _chars = target;
+        }
+
+        _scanFrom -= _charStart;
+        _charStart = 0;
+        _charEnd = pending;
+    }
+
+    private static Encoding DetectEncoding(ReadOnlySpan<byte> prefix, out int preambleLength)
+    {
+        if (prefix.StartsWith((ReadOnlySpan<byte>)[0xEF, 0xBB, 0xBF]))
+        {
+            preambleLength = 3;
+            return RedirectionFile.Utf8;
+        }
+
+        if (prefix.StartsWith((ReadOnlySpan<byte>)[0xFF, 0xFE]))
+        {
+            preambleLength = 2;
+            return Encoding.Unicode;
+        }
+
+        if (prefix.StartsWith((ReadOnlySpan<byte>)[0xFE, 0xFF]))
+        {
+            preambleLength = 2;
+            return Encoding.BigEndianUnicode;
+        }
+
+        preambleLength = 0;
+        return RedirectionFile.Utf8;
+    }
+}
@@ -6,7 +6,18 @@ namespace ArbSh.Core;
 public static class ShellEngine
 {
     /// <summary>
-    /// Parses and executes a single input line.
+    /// Maximum number of distinct input lines kept in the interactive compile cache.
+    /// </summary>
+    public const int InputCacheCapacity = 1024;
+
+    // Least recently used lines are evicted first; the list is ordered newest to oldest.
+    private static readonly object InputCacheSync = new();
+    private static readonly Dictionary<string, LinkedListNode<KeyValuePair<string, CompiledScript>>> InputCache = new(StringComparer.Ordinal);
+    private static readonly LinkedList<KeyValuePair<string, CompiledScript>> InputCacheOrder = new();
+
+    /// <summary>
+    /// Parses and executes a single input line. Lines seen before reuse their parsed commands,
+    /// except lines whose parsing reported a warning or an error.
     /// </summary>
     /// <param name="inputLine">The logical input line.</param>
     /// <param name="sink">The host sink for output.</param>
@@ -25,7 +36,109 @@ public static class ShellEngine
 
         using var sessionScope = ShellSessionContext.Push(session);
         using var scope = CoreConsole.PushSink(sink, options);
-        var commands = Parser.Parse(inputLine);
-        Executor.Execute(commands, sink, options);
+        ExecuteCompiled(GetOrCompileInput(inputLine), sink, options);
+    }
+
+    /// <summary>
+    /// Compiles a script once so it can be executed repeatedly without re-parsing.
+    /// Each non-empty line is one logical input line, as if typed interactively.
+    /// </summary>
+    /// <param name="source">The script text.</param>
+    /// <param name="sink">Receives parse diagnostics; discarded when null.</param>
+    /// <param name="options">Options for parse diagnostics.</param>
+    /// <returns>The compiled script.</returns>
+    public static CompiledScript Compile(string source, IExecutionSink? sink = null, ExecutionOptions? options = null)
+    {
+        ArgumentNullException.ThrowIfNull(source);
+
+        using var scope = CoreConsole.PushSink(sink, options);
+        return CompiledScript.Compile(source, source.Split('\n').Select(line => line.TrimEnd('\r')));
+    }
+
+    /// <summary>
+    /// Reads and compiles a script file.
+    /// </summary>
+    /// <param name="path">Path of the script file.</param>
+    /// <param name="sink">Receives parse diagnostics; discarded when null.</param>
+    /// <param name="options">Options for parse diagnostics.</param>
+    /// <returns>The compiled script.</returns>
+    public static CompiledScript CompileFile(string path, IExecutionSink? sink = null, ExecutionOptions? options = null)
+    {
+        ArgumentNullException.ThrowIfNull(path);
+
+        return Compile(File.ReadAllText(path), sink, options);
+    }
+
+    /// <summary>
+    /// Executes a compiled script line by line.
+    /// </summary>
+    /// <param name="script">The compiled script.</param>
+    /// <param name="sink">The host sink for output.</param>
+    /// <param name="options">Execution options.</param>
+    /// <param name="session">حالة الجلسة الحالية (مثل المجلد الحالي).</param>
+    public static void Execute(
+        CompiledScript script,
+        IExecutionSink sink,
+        ExecutionOptions? options = null,
+        ShellSessionState? session = null)
+    {
+        ArgumentNullException.ThrowIfNull(script);
+        ArgumentNullException.ThrowIfNull(sink);
+
+        session ??= new ShellSessionState();
+
+        using var sessionScope = ShellSessionContext.Push(session);
+        using var scope = CoreConsole.PushSink(sink, options);
+        ExecuteCompiled(script, sink, options);
+    }
+
+    private static void ExecuteCompiled(CompiledScript script, IExecutionSink sink, ExecutionOptions? options)
+    {
+        foreach (CompiledScript.CompiledLine line in script.Lines)
+        {
+            Executor.Execute(line.Statements ?? Parser.Parse(line.Source), sink, options);
+        }
+    }
+
+    private static CompiledScript GetOrCompileInput(string inputLine)
+    {
+        lock (InputCacheSync)
+        {
+            if (InputCache.TryGetValue(inputLine, out LinkedListNode<KeyValuePair<string, CompiledScript>>? cached))
+            {
+                InputCacheOrder.Remove(cached);
+                InputCacheOrder.AddFirst(cached);
+                return cached.Value.Value;
+            }
+        }
+
+        // Interactive input is a single logical line; it is not split on embedded line feeds.
+        // Compiled outside the lock: parsing reports diagnostics to the caller's sink.
+        int problemsBefore = CoreConsole.ProblemCount;
+        CompiledScript compiled = CompiledScript.Compile(inputLine, [inputLine]);
+
+        // A line with parse warnings or errors is not cached, so running it again reports them again.
+        if (CoreConsole.ProblemCount != problemsBefore)
+        {
+            return compiled;
+        }
+
+        lock (InputCacheSync)
+        {
+            if (InputCache.TryGetValue(inputLine, out LinkedListNode<KeyValuePair<string, CompiledScript>>? raced))
+            {
+                return raced.Value.Value;
+            }
+
+            if (InputCache.Count >= InputCacheCapacity)
+            {
+                InputCache.Remove(InputCacheOrder.Last!.Value.Key);
+                InputCacheOrder.RemoveLast();
+            }
+
+            InputCache[inputLine] = InputCacheOrder.AddFirst(new KeyValuePair<string, CompiledScript>(inputLine, compiled));
+        }
+
+        return compiled;
     }
 }
@@ -0,0 +1,66 @@
+using System.Diagnostics.Metrics;
+
+namespace ArbSh.Core;
+
+/// <summary>
+/// Publishes engine instrumentation through <see cref="System.Diagnostics.Metrics"/> under the
+/// <see cref="MeterName"/> meter, so it can be collected with <c>dotnet-counters</c> or <c>dotnet-trace</c>
+/// in any build.
+/// </summary>
+/// <remarks>
+/// Stage instruments are recorded once per stage when it finishes and carry the command name in the
+/// <c>arbsh.command</c> tag. Recording without a listener is a no-op, so the executor always reports.
+/// </remarks>
+public static class ShellMetrics
+{
+    /// <summary>
+    /// Name of the meter that publishes the engine instruments.
+    /// </summary>
+    public const string MeterName = "ArbSh.Core";
+
+    private const string CommandTag = "arbsh.command";
+
+    private static readonly Meter Meter = new(MeterName);
+
+    private static readonly Counter<long> StageObjectsIn = Meter.CreateCounter<long>(
+        "arbsh.pipeline.stage.objects_in", "{object}", "Objects read by a pipeline stage.");
+
+    private static readonly Counter<long> StageObjectsOut = Meter.CreateCounter<long>(
+        "arbsh.pipeline.stage.objects_out", "{object}", "Objects written by a pipeline stage.");
+
+    private static readonly Histogram<long> StageQueueDepth = Meter.CreateHistogram<long>(
+        "arbsh.pipeline.stage.queue_depth", "{object}", "Most objects waiting in a stage's input channel.");
+
+    private static readonly Histogram<double> StageInputWait = Meter.CreateHistogram<double>(
+        "arbsh.pipeline.stage.input_wait", "ms", "Time a stage was suspended waiting for input.");
+
+    private static readonly Histogram<double> StageOutputWait = Meter.CreateHistogram<double>(
+        "arbsh.pipeline.stage.output_wait", "ms", "Time a stage was suspended on a full output channel.");
+
+    private static readonly Histogram<double> StageBindTime = Meter.CreateHistogram<double>(
+        "arbsh.pipeline.stage.bind_time", "ms", "Time spent binding a stage's parameters.");
+
+    private static readonly Histogram<double> StageDuration = Meter.CreateHistogram<double>(
+        "arbsh.pipeline.stage.duration", "ms", "Time from a stage's start to its completion.");
+
+    private static readonly Histogram<double> ParseDuration = Meter.CreateHistogram<double>(
+        "arbsh.parse.duration", "ms", "Time spent parsing one input line.");
+
+    internal static void RecordStage(PipelineStageStats stats)
+    {
+        var command = new KeyValuePair<string, object?>(CommandTag, stats.CommandName);
+
+        StageObjectsIn.Add(stats.ObjectsIn, command);
+        StageObjectsOut.Add(stats.ObjectsOut, command);
+        StageQueueDepth.Record(stats.MaxQueueDepth, command);
+        StageInputWait.Record(stats.InputWaitTime.TotalMilliseconds, command);
+        StageOutputWait.Record(stats.OutputWaitTime.TotalMilliseconds, command);
+        StageBindTime.Record(stats.BindTime.TotalMilliseconds, command);
+        StageDuration.Record(stats.Elapsed.TotalMilliseconds, command);
+    }
+
+    internal static void RecordParse(TimeSpan elapsed)
+    {
+        ParseDuration.Record(elapsed.TotalMilliseconds);
+    }
+}
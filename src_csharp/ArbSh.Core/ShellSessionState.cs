@@ -1,13 +1,27 @@
 using System;
+using System.Collections.Concurrent;
+using System.Collections.Generic;
 using System.IO;
 
 namespace ArbSh.Core
 {
     /// <summary>
-    /// يمثل حالة جلسة أربش (مثل المجلد الحالي) عبر أوامر متعددة.
+    /// يمثل حالة جلسة أربش (مثل المجلد الحالي والمتغيرات) عبر أوامر متعددة.
+    /// كل الحالة القابلة للتغيير في المفسّر تعيش هنا، لذا يمكن تنفيذ عدة جلسات على التوازي في العملية نفسها.
     /// </summary>
     public sealed class ShellSessionState
     {
+        // Built-in sample variables every session starts with.
+        private static readonly KeyValuePair<string, string>[] DefaultVariables =
+        [
+            new("testVar", "Value from $testVar!"),
+            new("pathExample", "C:\\Users"),
+            new("emptyVar", "")
+        ];
+
+        // Stages of one pipeline run as parallel tasks of the same session, so the store is concurrent.
+        private readonly ConcurrentDictionary<string, string> _variables = new(DefaultVariables, StringComparer.OrdinalIgnoreCase);
+
         /// <summary>
         /// ينشئ حالة جلسة جديدة.
         /// </summary>
@@ -22,6 +36,56 @@ namespace ArbSh.Core
         /// </summary>
         public string CurrentDirectory { get; set; }
 
+        /// <summary>
+        /// يرجع قيمة متغير في الجلسة، أو نصًا فارغًا إذا لم يكن معرّفًا.
+        /// </summary>
+        /// <param name="name">اسم المتغير دون علامة $.</param>
+        /// <returns>قيمة المتغير.</returns>
+        public string GetVariable(string name)
+        {
+            ArgumentNullException.ThrowIfNull(name);
+            return _variables.TryGetValue(name, out string? value) ? value : string.Empty;
+        }
+
+        /// <summary>
+        /// يعيّن قيمة متغير في الجلسة.
+        /// </summary>
+        /// <param name="name">اسم المتغير دون علامة $.</param>
+        /// <param name="value">القيمة الجديدة.</param>
+        public void SetVariable(string name, string value)
+        {
+            ArgumentNullException.ThrowIfNull(name);
+            ArgumentNullException.ThrowIfNull(value);
+            _variables[name] = value;
+        }
+
+        /// <summary>
+        /// يحذف متغيرًا من الجلسة.
+        /// </summary>
+        /// <param name="name">اسم المتغير دون علامة $.</param>
+        /// <returns>صحيح إذا كان المتغير معرّفًا.</returns>
+        public bool RemoveVariable(string name)
+        {
+            ArgumentNullException.ThrowIfNull(name);
+            return _variables.TryRemove(name, out _);
+        }
+
+        /// <summary>
+        /// يرجع قيمة متغير مدمج عندما لا توجد جلسة نشطة.
+        /// </summary>
+        internal static string GetDefaultVariable(string name)
+        {
+            foreach (KeyValuePair<string, string> variable in DefaultVariables)
+            {
+                if (string.Equals(variable.Key, name, StringComparison.OrdinalIgnoreCase))
+                {
+                    return variable.Value;
+                }
+            }
+
+            return string.Empty;
+        }
+
         private static string ResolveInitialDirectory(string? initialDirectory)
         {
             if (!string.IsNullOrWhiteSpace(initialDirectory))
@@ -0,0 +1,66 @@
+using System;
+using System.Collections;
+using System.Collections.Generic;
+using System.Linq;
+
+namespace ArbSh.Generators;
+
+/// <summary>
+/// Equatable snapshot of one discovered command, kept free of symbols so the
+/// incremental pipeline can cache it between compilations.
+/// </summary>
+internal sealed record CommandModel(string CommandName, string TypeName, EquatableArray<ParameterModel> Parameters);
+
+/// <summary>
+/// Equatable snapshot of one <c>[Parameter]</c> property.
+/// </summary>
+/// <param name="Name">The CLR property name.</param>
+/// <param name="TypeName">The fully qualified property type.</param>
+/// <param name="ArabicName">The Arabic parameter name, if declared.</param>
+/// <param name="AttributeInitializer">C# object-initializer body reproducing the attribute's named arguments.</param>
+internal sealed record ParameterModel(string Name, string TypeName, string? ArabicName, string AttributeInitializer);
+
+/// <summary>
+/// Immutable array with value equality, for use inside incremental generator models.
+/// </summary>
+internal readonly struct EquatableArray<T> : IEquatable<EquatableArray<T>>, IEnumerable<T>
+    where T : IEquatable<T>
+{
+    private readonly T[]? _items;
+
+    public EquatableArray(T[] items)
+    {
+        _items = items;
+    }
+
+    public bool Equals(EquatableArray<T> other)
+    {
+        return (_items ?? Array.Empty<T>()).SequenceEqual(other._items ?? Array.Empty<T>());
+    }
+
+    public override bool Equals(object? obj)
+    {
+        return obj is EquatableArray<T> other && Equals(other);
+    }
+
+    public override int GetHashCode()
+    {
+        int hash = 17;
+        foreach (T item in _items ?? Array.Empty<T>())
+        {
+            hash = unchecked((hash * 31) + item.GetHashCode());
+        }
+
+        return hash;
+    }
+
+    public IEnumerator<T> GetEnumerator()
+    {
+        return ((IEnumerable<T>)(_items ?? Array.Empty<T>())).GetEnumerator();
+    }
+
+    IEnumerator IEnumerable.GetEnumerator()
+    {
+        return GetEnumerator();
+    }
+}
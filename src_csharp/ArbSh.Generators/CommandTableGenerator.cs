@@ -0,0 +1,189 @@
+using System.Collections.Generic;
+using System.Collections.Immutable;
+using System.Linq;
+using System.Text;
+using System.Threading;
+using Microsoft.CodeAnalysis;
+using Microsoft.CodeAnalysis.CSharp;
+using Microsoft.CodeAnalysis.CSharp.Syntax;
+using Microsoft.CodeAnalysis.Text;
+
+namespace ArbSh.Generators;
+
+/// <summary>
+/// يولّد جدول الأوامر وبيانات ربط المعاملات وقت الترجمة.
+/// Emits <c>ArbSh.Core.GeneratedCommandTable</c> from <c>[ArabicName]</c> / <c>[Parameter]</c>
+/// attributes on <c>CmdletBase</c> subclasses, so command discovery and binding need no
+/// runtime reflection scan.
+/// </summary>
+[Generator(LanguageNames.CSharp)]
+public sealed class CommandTableGenerator : IIncrementalGenerator
+{
+    private const string ArabicNameAttributeName = "ArbSh.Core.ArabicNameAttribute";
+    private const string ParameterAttributeName = "ArbSh.Core.ParameterAttribute";
+    private const string CmdletBaseName = "ArbSh.Core.CmdletBase";
+
+    /// <inheritdoc />
+    public void Initialize(IncrementalGeneratorInitializationContext context)
+    {
+        IncrementalValuesProvider<CommandModel?> commands = context.SyntaxProvider.ForAttributeWithMetadataName(
+            ArabicNameAttributeName,
+            static (node, _) => node is ClassDeclarationSyntax,
+            static (ctx, ct) => CreateModel(ctx, ct));
+
+        IncrementalValueProvider<ImmutableArray<CommandModel?>> collected = commands.Collect();
+
+        context.RegisterSourceOutput(collected, static (spc, models) =>
+        {
+            CommandModel[] ordered = models
+                .Where(m => m != null)
+                .Select(m => m!)
+                .GroupBy(m => m.TypeName)
+                .Select(g => g.First())
+                .OrderBy(m => m.TypeName, System.StringComparer.Ordinal)
+                .ToArray();
+
+            spc.AddSource("GeneratedCommandTable.g.cs", SourceText.From(Emit(ordered), Encoding.UTF8));
+        });
+    }
+
+    private static CommandModel? CreateModel(GeneratorAttributeSyntaxContext context, CancellationToken cancellationToken)
+    {
+        if (context.TargetSymbol is not INamedTypeSymbol type
+            || type.IsAbstract
+            || type.IsGenericType
+            || type.DeclaredAccessibility == Accessibility.Private
+            || !DerivesFromCmdletBase(type))
+        {
+            return null;
+        }
+
+        bool hasParameterlessConstructor = type.InstanceConstructors
+            .Any(c => c.Parameters.Length == 0 && c.DeclaredAccessibility is Accessibility.Public or Accessibility.Internal);
+        if (!hasParameterlessConstructor)
+        {
+            return null;
+        }
+
+        string? commandName = context.Attributes
+            .Select(a => a.ConstructorArguments.Length == 1 ? a.ConstructorArguments[0].Value as string : null)
+            .FirstOrDefault(n => !string.IsNullOrWhiteSpace(n));
+        if (commandName == null)
+        {
+            return null;
+        }
+
+        var parameters = new List<ParameterModel>();
+        var seen = new HashSet<string>();
+
+        // Match Type.GetProperties(): derived declarations first, then base types.
+        for (INamedTypeSymbol? current = type; current != null && current.ToDisplayString() != CmdletBaseName; current = current.BaseType)
+        {
+            cancellationToken.ThrowIfCancellationRequested();
+
+            foreach (IPropertySymbol property in current.GetMembers().OfType<IPropertySymbol>())
+            {
+                if (property.IsStatic
+                    || property.IsIndexer
+                    || property.DeclaredAccessibility != Accessibility.Public
+                    || property.SetMethod is not { DeclaredAccessibility: Accessibility.Public or Accessibility.Internal }
+                    || !seen.Add(property.Name))
+                {
+                    continue;
+                }
+
+                AttributeData? parameterAttribute = property.GetAttributes()
+                    .FirstOrDefault(a => a.AttributeClass?.ToDisplayString() == ParameterAttributeName);
+                if (parameterAttribute == null)
+                {
+                    continue;
+                }
+
+                string? arabicName = property.GetAttributes()
+                    .Where(a => a.AttributeClass?.ToDisplayString() == ArabicNameAttributeName && a.ConstructorArguments.Length == 1)
+                    .Select(a => a.ConstructorArguments[0].Value as string)
+                    .FirstOrDefault();
+
+                string initializer = string.Join(", ", parameterAttribute.NamedArguments
+                    .Select(arg => $"{arg.Key} = {arg.Value.ToCSharpString()}"));
+
+                parameters.Add(new ParameterModel(
+                    property.Name,
+                    property.Type.ToDisplayString(SymbolDisplayFormat.FullyQualifiedFormat),
+                    arabicName,
+                    initializer));
+            }
+        }
+
+        return new CommandModel(
+            commandName!,
+            type.ToDisplayString(SymbolDisplayFormat.FullyQualifiedFormat),
+            new EquatableArray<ParameterModel>(parameters.ToArray()));
+    }
+
+    private static bool DerivesFromCmdletBase(INamedTypeSymbol type)
+    {
+        for (INamedTypeSymbol? current = type.BaseType; current != null; current = current.BaseType)
+        {
+            if (current.ToDisplayString() == CmdletBaseName)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    private static string Emit(IReadOnlyList<CommandModel> commands)
+    {
+        var sb = new StringBuilder();
+        sb.AppendLine("// <auto-generated/>");
+        sb.AppendLine("#nullable enable");
+        sb.AppendLine();
+        sb.AppendLine("namespace ArbSh.Core;");
+        sb.AppendLine();
+        sb.AppendLine("/// <summary>");
+        sb.AppendLine("/// Command table generated at compile time by ArbSh.Generators.");
+        sb.AppendLine("/// </summary>");
+        sb.AppendLine("internal static partial class GeneratedCommandTable");
+        sb.AppendLine("{");
+        sb.AppendLine("    /// <summary>");
+        sb.AppendLine("    /// Creates binding metadata for every discovered command.");
+        sb.AppendLine("    /// </summary>");
+        sb.AppendLine("    public static global::ArbSh.Core.CmdletBindingInfo[] CreateBindings()");
+        sb.AppendLine("    {");
+        sb.AppendLine("        return new global::ArbSh.Core.CmdletBindingInfo[]");
+        sb.AppendLine("        {");
+
+        foreach (CommandModel command in commands)
+        {
+            sb.AppendLine("            new global::ArbSh.Core.CmdletBindingInfo(");
+            sb.AppendLine($"                {SymbolDisplay.FormatLiteral(command.CommandName, quote: true)},");
+            sb.AppendLine($"                typeof({command.TypeName}),");
+            sb.AppendLine($"                static () => new {command.TypeName}(),");
+            sb.AppendLine("                new global::ArbSh.Core.CmdletParameterInfo[]");
+            sb.AppendLine("                {");
+
+            foreach (ParameterModel parameter in command.Parameters)
+            {
+                string arabicName = parameter.ArabicName == null
+                    ? "null"
+                    : SymbolDisplay.FormatLiteral(parameter.ArabicName, quote: true);
+
+                sb.AppendLine("                    new global::ArbSh.Core.CmdletParameterInfo(");
+                sb.AppendLine($"                        {SymbolDisplay.FormatLiteral(parameter.Name, quote: true)},");
+                sb.AppendLine($"                        typeof({parameter.TypeName}),");
+                sb.AppendLine($"                        {arabicName},");
+                sb.AppendLine($"                        new global::ArbSh.Core.ParameterAttribute {{ {parameter.AttributeInitializer} }},");
+                sb.AppendLine($"                        static (cmdlet, value) => (({command.TypeName})cmdlet).{parameter.Name} = ({parameter.TypeName})value!),");
+            }
+
+            sb.AppendLine("                }),");
+        }
+
+        sb.AppendLine("        };");
+        sb.AppendLine("    }");
+        sb.AppendLine("}");
+        return sb.ToString();
+    }
+}
@@ -0,0 +1,8 @@
+namespace System.Runtime.CompilerServices;
+
+/// <summary>
+/// Enables <c>init</c> accessors and records on netstandard2.0.
+/// </summary>
+internal static class IsExternalInit
+{
+}
@@ -1,6 +1,7 @@
 ﻿using Avalonia;
 using Avalonia.Controls.ApplicationLifetimes;
 using Avalonia.Markup.Xaml;
+using ArbSh.Core;
 using ArbSh.Terminal.ViewModels;
 
 namespace ArbSh.Terminal;
@@ -18,7 +19,9 @@ public partial class App : Application
         {
             desktop.MainWindow = new MainWindow
             {
-                DataContext = new MainWindowViewModel(Program.InitialWorkingDirectory)
+                DataContext = new MainWindowViewModel(
+                    Program.InitialWorkingDirectory,
+                    historyPath: CommandHistory.DefaultPath)
             };
         }
 
@@ -60,6 +60,28 @@ public sealed class OutputSelectionBuffer
         _activeLineIndex = Math.Max(0, lineIndex);
     }
 
+    /// <summary>
+    /// يزيح التحديد بعد إخراج أسطر من بداية سجل المخرجات.
+    /// Shifts the selection after lines were evicted from the head of the scrollback.
+    /// </summary>
+    /// <param name="evictedLineCount">عدد الأسطر المُخرجة.</param>
+    public void ShiftForEviction(int evictedLineCount)
+    {
+        if (!HasSelection || evictedLineCount <= 0)
+        {
+            return;
+        }
+
+        if (Math.Max(_anchorLineIndex!.Value, _activeLineIndex!.Value) < evictedLineCount)
+        {
+            Clear();
+            return;
+        }
+
+        _anchorLineIndex = Math.Max(0, _anchorLineIndex.Value - evictedLineCount);
+        _activeLineIndex = Math.Max(0, _activeLineIndex.Value - evictedLineCount);
+    }
+
     /// <summary>
     /// يحاول إرجاع حدود التحديد (شاملة الطرفين).
     /// Tries to return selection bounds (inclusive).
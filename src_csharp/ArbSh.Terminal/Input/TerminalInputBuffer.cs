@@ -1,3 +1,4 @@
+using System.Buffers;
 using System.Globalization;
 
 namespace ArbSh.Terminal.Input;
@@ -6,9 +7,26 @@ namespace ArbSh.Terminal.Input;
 /// يمثل مخزن إدخال منطقي مع موضع مؤشر وتحديد.
 /// Represents a logical input buffer with caret and selection state.
 /// </summary>
+/// <remarks>
+/// النص مخزن في مخزن فجوة تتبع المؤشر، فتكلفة الإدراج والحذف عند المؤشر لا تتعلق بطول السطر.
+/// Text is stored in a gap buffer that follows the caret, so inserts and deletes at the caret
+/// cost the edit size rather than the line length. <see cref="Text"/> is materialized on demand.
+/// Grapheme cluster starts are kept in a parallel gap array and re-segmented only around each edit,
+/// so moving or deleting by text element never reads the whole line.
+/// </remarks>
 public sealed class TerminalInputBuffer
 {
-    private string _text = string.Empty;
+    private const int InitialCapacity = 64;
+
+    private const int StackWindowLength = 256;
+
+    private char[] _buffer = new char[InitialCapacity];
+
+    // Same layout as _buffer: true where a grapheme cluster starts.
+    private bool[] _clusterStarts = new bool[InitialCapacity];
+    private int _gapStart;
+    private int _gapEnd = InitialCapacity;
+    private string? _text = string.Empty;
     private int _caretIndex;
     private int? _selectionAnchor;
     private SelectionRange? _selection;
@@ -17,7 +35,13 @@ public sealed class TerminalInputBuffer
     /// النص المنطقي الحالي للمستخدم.
     /// Current logical input text.
     /// </summary>
-    public string Text => _text;
+    public string Text => _text ??= BuildText();
+
+    /// <summary>
+    /// طول النص المنطقي الحالي.
+    /// Current logical input length.
+    /// </summary>
+    public int Length => _buffer.Length - (_gapEnd - _gapStart);
 
     /// <summary>
     /// موضع المؤشر المنطقي الحالي.
@@ -43,6 +67,8 @@ public sealed class TerminalInputBuffer
     /// </summary>
     public void Clear()
     {
+        _gapStart = 0;
+        _gapEnd = _buffer.Length;
         _text = string.Empty;
         _caretIndex = 0;
         _selection = null;
@@ -57,7 +83,7 @@ public sealed class TerminalInputBuffer
     /// <param name="extendSelection">تمديد التحديد الحالي.</param>
     public void SetCaretFromLogicalIndex(int index, bool extendSelection = false)
     {
-        int clamped = Clamp(index, 0, _text.Length);
+        int clamped = Clamp(index, 0, Length);
 
         if (extendSelection)
         {
@@ -80,7 +106,7 @@ public sealed class TerminalInputBuffer
     /// <param name="extendSelection">تمديد التحديد الحالي.</param>
     public void MoveCaretLeft(bool extendSelection)
     {
-        int previous = GetPreviousTextElementIndex(_text, _caretIndex);
+        int previous = GetPreviousTextElementIndex(_caretIndex);
         SetCaretFromLogicalIndex(previous, extendSelection);
     }
 
@@ -91,7 +117,7 @@ public sealed class TerminalInputBuffer
     /// <param name="extendSelection">تمديد التحديد الحالي.</param>
     public void MoveCaretRight(bool extendSelection)
     {
-        int next = GetNextTextElementIndex(_text, _caretIndex);
+        int next = GetNextTextElementIndex(_caretIndex);
         SetCaretFromLogicalIndex(next, extendSelection);
     }
 
@@ -112,7 +138,7 @@ public sealed class TerminalInputBuffer
     /// <param name="extendSelection">تمديد التحديد الحالي.</param>
     public void MoveCaretEnd(bool extendSelection)
     {
-        SetCaretFromLogicalIndex(_text.Length, extendSelection);
+        SetCaretFromLogicalIndex(Length, extendSelection);
     }
 
     /// <summary>
@@ -128,7 +154,12 @@ public sealed class TerminalInputBuffer
         }
 
         DeleteSelectionIfAny();
-        _text = _text.Insert(_caretIndex, text);
+        MoveGapTo(_caretIndex);
+        EnsureGap(text.Length);
+        text.CopyTo(_buffer.AsSpan(_gapStart));
+        _gapStart += text.Length;
+        _text = null;
+        UpdateClusterStarts(_caretIndex, _caretIndex + text.Length);
         _caretIndex += text.Length;
         _selection = null;
         _selectionAnchor = null;
@@ -150,10 +181,9 @@ public sealed class TerminalInputBuffer
             return;
         }
 
-        int previous = GetPreviousTextElementIndex(_text, _caretIndex);
-        int length = _caretIndex - previous;
+        int previous = GetPreviousTextElementIndex(_caretIndex);
 
-        _text = _text.Remove(previous, length);
+        RemoveRange(previous, _caretIndex - previous);
         _caretIndex = previous;
         _selection = null;
         _selectionAnchor = null;
@@ -170,15 +200,14 @@ public sealed class TerminalInputBuffer
             return;
         }
 
-        if (_caretIndex >= _text.Length)
+        if (_caretIndex >= Length)
         {
             return;
         }
 
-        int next = GetNextTextElementIndex(_text, _caretIndex);
-        int length = next - _caretIndex;
+        int next = GetNextTextElementIndex(_caretIndex);
 
-        _text = _text.Remove(_caretIndex, length);
+        RemoveRange(_caretIndex, next - _caretIndex);
         _selection = null;
         _selectionAnchor = null;
     }
@@ -190,8 +219,8 @@ public sealed class TerminalInputBuffer
     public void SelectAll()
     {
         _selectionAnchor = 0;
-        _selection = new SelectionRange(0, _text.Length);
-        _caretIndex = _text.Length;
+        _selection = new SelectionRange(0, Length);
+        _caretIndex = Length;
     }
 
     /// <summary>
@@ -217,9 +246,8 @@ public sealed class TerminalInputBuffer
         }
 
         int start = selection.Start;
-        int length = selection.Length;
 
-        _text = _text.Remove(start, length);
+        RemoveRange(start, selection.Length);
         _caretIndex = start;
         _selection = null;
         _selectionAnchor = null;
@@ -238,54 +266,174 @@ public sealed class TerminalInputBuffer
             return string.Empty;
         }
 
-        return _text.Substring(selection.Start, selection.Length);
+        return Text.Substring(selection.Start, selection.Length);
+    }
+
+    private void RemoveRange(int start, int length)
+    {
+        // Deleting at the gap only widens it.
+        MoveGapTo(start);
+        _gapEnd += length;
+        _text = null;
+        UpdateClusterStarts(start, start);
     }
 
-    private static int GetPreviousTextElementIndex(string text, int index)
+    private void MoveGapTo(int index)
     {
-        if (index <= 0 || string.IsNullOrEmpty(text))
+        if (index < _gapStart)
         {
-            return 0;
+            int count = _gapStart - index;
+            Array.Copy(_buffer, index, _buffer, _gapEnd - count, count);
+            Array.Copy(_clusterStarts, index, _clusterStarts, _gapEnd - count, count);
+            _gapStart = index;
+            _gapEnd -= count;
         }
-
-        int[] elements = StringInfo.ParseCombiningCharacters(text);
-        int best = 0;
-
-        for (int i = 0; i < elements.Length; i++)
+        else if (index > _gapStart)
         {
-            if (elements[i] >= index)
-            {
-                break;
-            }
+            int count = index - _gapStart;
+            Array.Copy(_buffer, _gapEnd, _buffer, _gapStart, count);
+            Array.Copy(_clusterStarts, _gapEnd, _clusterStarts, _gapStart, count);
+            _gapStart += count;
+            _gapEnd += count;
+        }
+    }
 
-            best = elements[i];
+    private void EnsureGap(int required)
+    {
+        if (_gapEnd - _gapStart >= required)
+        {
+            return;
         }
 
-        return best;
+        int length = Length;
+        int capacity = Math.Max(_buffer.Length * 2, length + required + InitialCapacity);
+        var buffer = new char[capacity];
+        var clusterStarts = new bool[capacity];
+        int tail = _buffer.Length - _gapEnd;
+
+        Array.Copy(_buffer, 0, buffer, 0, _gapStart);
+        Array.Copy(_buffer, _gapEnd, buffer, capacity - tail, tail);
+        Array.Copy(_clusterStarts, 0, clusterStarts, 0, _gapStart);
+        Array.Copy(_clusterStarts, _gapEnd, clusterStarts, capacity - tail, tail);
+        _buffer = buffer;
+        _clusterStarts = clusterStarts;
+        _gapEnd = capacity - tail;
     }
 
-    private static int GetNextTextElementIndex(string text, int index)
+    private string BuildText()
     {
-        if (string.IsNullOrEmpty(text))
+        return string.Create(Length, this, static (span, buffer) =>
+        {
+            buffer._buffer.AsSpan(0, buffer._gapStart).CopyTo(span);
+            buffer._buffer.AsSpan(buffer._gapEnd).CopyTo(span.Slice(buffer._gapStart));
+        });
+    }
+
+    // Re-segments the clusters an edit can merge or split: the edited range [start, end) plus one
+    // cluster more than its neighbours on each side, since an edit can complete a surrogate pair that
+    // then joins the cluster beyond. Flags pair regional indicators by their parity in the whole run,
+    // so touching runs of them are re-segmented too. Everything outside keeps its starts.
+    private void UpdateClusterStarts(int start, int end)
+    {
+        int from = GetPreviousTextElementIndex(GetPreviousTextElementIndex(start));
+        while (from > 0 && IsRegionalIndicatorAt(from - 2))
         {
-            return 0;
+            from = GetPreviousTextElementIndex(from);
         }
 
-        if (index >= text.Length)
+        int to = GetNextTextElementIndex(GetNextTextElementIndex(end));
+        while (to < Length && IsRegionalIndicatorAt(to))
         {
-            return text.Length;
+            to = GetNextTextElementIndex(to);
         }
 
-        int[] elements = StringInfo.ParseCombiningCharacters(text);
-        for (int i = 0; i < elements.Length; i++)
+        int windowLength = to - from;
+        if (windowLength == 0)
+        {
+            return;
+        }
+
+        char[]? rented = null;
+        Span<char> window = windowLength <= StackWindowLength
+            ? stackalloc char[StackWindowLength]
+            : (rented = ArrayPool<char>.Shared.Rent(windowLength));
+        window = window[..windowLength];
+
+        try
         {
-            if (elements[i] > index)
+            CopyTo(from, window);
+            for (int offset = 0; offset < windowLength;)
             {
-                return elements[i];
+                int next = offset + StringInfo.GetNextTextElementLength(window[offset..]);
+                SetClusterStart(from + offset, true);
+                for (int i = offset + 1; i < next; i++)
+                {
+                    SetClusterStart(from + i, false);
+                }
+
+                offset = next;
             }
         }
+        finally
+        {
+            if (rented is not null)
+            {
+                ArrayPool<char>.Shared.Return(rented);
+            }
+        }
+    }
+
+    // Copies the logical text starting at `index` into `destination`, across the gap.
+    private void CopyTo(int index, Span<char> destination)
+    {
+        int beforeGap = Math.Clamp(_gapStart - index, 0, destination.Length);
+        _buffer.AsSpan(index, beforeGap).CopyTo(destination);
+        int afterGap = destination.Length - beforeGap;
+        _buffer.AsSpan(index + beforeGap + (_gapEnd - _gapStart), afterGap).CopyTo(destination[beforeGap..]);
+    }
+
+    // Regional indicators (U+1F1E6..U+1F1FF) are surrogate pairs D83C DDE6..DDFF.
+    private bool IsRegionalIndicatorAt(int index)
+    {
+        return index >= 0
+            && index + 1 < Length
+            && _buffer[ToPhysicalIndex(index)] == '\uD83C'
+            && _buffer[ToPhysicalIndex(index + 1)] is >= '\uDDE6' and <= '\uDDFF';
+    }
+
+    private int ToPhysicalIndex(int index)
+    {
+        return index < _gapStart ? index : index + (_gapEnd - _gapStart);
+    }
+
+    private void SetClusterStart(int index, bool value)
+    {
+        _clusterStarts[ToPhysicalIndex(index)] = value;
+    }
+
+    // Start of the text element containing index - 1, i.e. the element before the caret at `index`.
+    private int GetPreviousTextElementIndex(int index)
+    {
+        int i = Math.Min(index, Length) - 1;
+        while (i > 0 && !_clusterStarts[ToPhysicalIndex(i)])
+        {
+            i--;
+        }
+
+        return Math.Max(0, i);
+    }
+
+    // First text element start after `index`, or the end of the text.
+    private int GetNextTextElementIndex(int index)
+    {
+        int length = Length;
+        int i = index + 1;
+        while (i < length && !_clusterStarts[ToPhysicalIndex(i)])
+        {
+            i++;
+        }
 
-        return text.Length;
+        return Math.Min(i, length);
     }
 
     private static int Clamp(int value, int min, int max)
@@ -37,6 +37,7 @@ public partial class MainWindow : Window
         if (_viewModel is not null)
         {
             _viewModel.ExitRequested -= HandleExitRequested;
+            _viewModel.Dispose();
             _viewModel = null;
         }
 
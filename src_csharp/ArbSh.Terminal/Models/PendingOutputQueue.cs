@@ -0,0 +1,88 @@
+using System.Collections.Concurrent;
+
+namespace ArbSh.Terminal.Models;
+
+/// <summary>
+/// طابور خالٍ من الأقفال لأسطر المخرجات القادمة من خيوط التنفيذ قبل تفريغها دفعة واحدة في خيط الواجهة.
+/// Lock-free queue of output lines written by execution threads, drained in batches on the UI thread.
+/// </summary>
+/// <remarks>
+/// يطلب الكاتب جدولة تفريغ واحدة فقط لكل دفعة. Writers only schedule one drain per batch:
+/// <see cref="Enqueue"/> returns <see langword="true"/> for the first line after a drain, so
+/// the dispatcher sees one message per frame instead of one per line. Only the scheduled drain
+/// (<see cref="DrainTo"/>) releases the claim; <see cref="FlushTo"/> moves lines without it, so a
+/// second drain is never queued while one is pending.
+/// </remarks>
+public sealed class PendingOutputQueue
+{
+    private readonly ConcurrentQueue<TerminalLine> _pending = new();
+    private int _drainScheduled;
+
+    /// <summary>
+    /// هل توجد أسطر بانتظار التفريغ.
+    /// Indicates whether lines are waiting to be drained.
+    /// </summary>
+    public bool HasPending => !_pending.IsEmpty;
+
+    /// <summary>
+    /// يضيف سطرًا إلى الطابور من أي خيط.
+    /// Adds a line from any thread.
+    /// </summary>
+    /// <param name="line">السطر المضاف.</param>
+    /// <returns>صحيح إذا كان على المستدعي جدولة تفريغ.</returns>
+    public bool Enqueue(TerminalLine line)
+    {
+        ArgumentNullException.ThrowIfNull(line);
+
+        _pending.Enqueue(line);
+        return Interlocked.Exchange(ref _drainScheduled, 1) == 0;
+    }
+
+    /// <summary>
+    /// يحجز تفريغًا جديدًا إذا بقيت أسطر ولم يُجدول تفريغ بعد.
+    /// Claims a new drain when lines remain and none is scheduled.
+    /// </summary>
+    /// <returns>صحيح إذا كان على المستدعي جدولة تفريغ.</returns>
+    public bool TryClaimDrain()
+    {
+        return !_pending.IsEmpty && Interlocked.Exchange(ref _drainScheduled, 1) == 0;
+    }
+
+    /// <summary>
+    /// ينفذ التفريغ المجدول: يحرر الحجز ثم ينقل الأسطر المنتظرة بالترتيب (من خيط الواجهة).
+    /// Runs the scheduled drain: releases the claim, then moves pending lines into the scrollback in order (UI thread).
+    /// </summary>
+    /// <param name="target">سجل المخرجات.</param>
+    /// <param name="maxLines">أقصى عدد للأسطر في هذه الدفعة.</param>
+    /// <returns>عدد الأسطر المنقولة.</returns>
+    public int DrainTo(ScrollbackBuffer target, int maxLines)
+    {
+        ArgumentNullException.ThrowIfNull(target);
+
+        // Re-arm before dequeuing so a line written mid-drain schedules the next batch.
+        Volatile.Write(ref _drainScheduled, 0);
+
+        return FlushTo(target, maxLines);
+    }
+
+    /// <summary>
+    /// ينقل الأسطر المنتظرة بالترتيب دون تحرير تفريغ مجدول (من خيط الواجهة).
+    /// Moves pending lines into the scrollback in order without releasing a scheduled drain (UI thread).
+    /// </summary>
+    /// <param name="target">سجل المخرجات.</param>
+    /// <param name="maxLines">أقصى عدد للأسطر في هذه الدفعة.</param>
+    /// <returns>عدد الأسطر المنقولة.</returns>
+    public int FlushTo(ScrollbackBuffer target, int maxLines)
+    {
+        ArgumentNullException.ThrowIfNull(target);
+
+        int drained = 0;
+        while (drained < maxLines && _pending.TryDequeue(out TerminalLine? line))
+        {
+            target.Append(line);
+            drained++;
+        }
+
+        return drained;
+    }
+}
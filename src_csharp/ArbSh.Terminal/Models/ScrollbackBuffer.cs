@@ -0,0 +1,124 @@
+using System.Collections;
+
+namespace ArbSh.Terminal.Models;
+
+/// <summary>
+/// مخزن دائري لأسطر الطرفية بسعة ثابتة: الإضافة والإخراج بتكلفة ثابتة مع وصول مفهرس.
+/// Fixed-capacity ring buffer of terminal lines with O(1) append/eviction and indexed access.
+/// </summary>
+/// <remarks>
+/// الفهرس 0 هو أقدم سطر محفوظ. Index 0 is the oldest retained line; once full, each append
+/// evicts it. Lines are kept as the same <see cref="TerminalLine"/> instances so identity-keyed
+/// render caches stay valid while a line is retained.
+/// </remarks>
+public sealed class ScrollbackBuffer : IReadOnlyList<TerminalLine>
+{
+    /// <summary>
+    /// السعة الافتراضية لسجل المخرجات.
+    /// Default scrollback capacity in lines.
+    /// </summary>
+    public const int DefaultCapacity = 100_000;
+
+    private readonly TerminalLine[] _items;
+    private int _head;
+    private int _count;
+
+    /// <summary>
+    /// ينشئ مخزنًا بسعة محددة.
+    /// Creates a scrollback buffer with the given capacity.
+    /// </summary>
+    /// <param name="capacity">أقصى عدد للأسطر المحفوظة.</param>
+    public ScrollbackBuffer(int capacity = DefaultCapacity)
+    {
+        ArgumentOutOfRangeException.ThrowIfLessThan(capacity, 1);
+        _items = new TerminalLine[capacity];
+    }
+
+    /// <summary>
+    /// أقصى عدد للأسطر المحفوظة.
+    /// Maximum number of retained lines.
+    /// </summary>
+    public int Capacity => _items.Length;
+
+    /// <summary>
+    /// عدد الأسطر المحفوظة حاليًا.
+    /// Number of retained lines.
+    /// </summary>
+    public int Count => _count;
+
+    /// <summary>
+    /// إجمالي الأسطر المضافة منذ الإنشاء، بما فيها المُخرجة.
+    /// Total lines appended since creation, including evicted ones.
+    /// </summary>
+    public long TotalAppended { get; private set; }
+
+    /// <summary>
+    /// إجمالي الأسطر المُخرجة من بداية المخزن.
+    /// Total lines evicted from the head.
+    /// </summary>
+    public long TotalEvicted => TotalAppended - _count;
+
+    /// <summary>
+    /// يرجع السطر عند الفهرس المنطقي (0 = الأقدم).
+    /// Gets the line at a logical index (0 = oldest).
+    /// </summary>
+    /// <param name="index">الفهرس.</param>
+    public TerminalLine this[int index]
+    {
+        get
+        {
+            if ((uint)index >= (uint)_count)
+            {
+                throw new ArgumentOutOfRangeException(nameof(index));
+            }
+
+            return _items[(_head + index) % _items.Length];
+        }
+    }
+
+    /// <summary>
+    /// يضيف سطرًا في النهاية ويُخرج الأقدم عند الامتلاء.
+    /// Appends a line, evicting the oldest when full.
+    /// </summary>
+    /// <param name="line">السطر المضاف.</param>
+    /// <returns>صحيح إذا أُخرج سطر قديم.</returns>
+    public bool Append(TerminalLine line)
+    {
+        ArgumentNullException.ThrowIfNull(line);
+
+        TotalAppended++;
+
+        if (_count < _items.Length)
+        {
+            _items[(_head + _count) % _items.Length] = line;
+            _count++;
+            return false;
+        }
+
+        _items[_head] = line;
+        _head = (_head + 1) % _items.Length;
+        return true;
+    }
+
+    /// <summary>
+    /// يفرغ المخزن؛ تُحتسب الأسطر المحذوفة ضمن المُخرجة.
+    /// Removes all lines; they count towards <see cref="TotalEvicted"/>.
+    /// </summary>
+    public void Clear()
+    {
+        Array.Clear(_items);
+        _head = 0;
+        _count = 0;
+    }
+
+    /// <inheritdoc />
+    public IEnumerator<TerminalLine> GetEnumerator()
+    {
+        for (int i = 0; i < _count; i++)
+        {
+            yield return _items[(_head + i) % _items.Length];
+        }
+    }
+
+    IEnumerator IEnumerable.GetEnumerator() => GetEnumerator();
+}
@@ -0,0 +1,348 @@
+using System.Threading.Channels;
+using ArbSh.Terminal.Rendering;
+
+namespace ArbSh.Terminal.Models;
+
+/// <summary>
+/// مطابقة بحث في سجل المخرجات.
+/// A search match in the scrollback.
+/// </summary>
+/// <param name="LineNumber">رقم السطر المطلق منذ إنشاء المخزن.</param>
+/// <param name="Start">بداية المطابقة في النص النظيف.</param>
+/// <param name="Length">طول المطابقة في النص النظيف.</param>
+public readonly record struct ScrollbackMatch(long LineNumber, int Start, int Length);
+
+/// <summary>
+/// بحث في سجل المخرجات يعمل في الخلفية ويُحدَّث مع وصول أسطر جديدة.
+/// Background find-in-scrollback that keeps matching lines as they arrive.
+/// </summary>
+/// <remarks>
+/// <see cref="Start"/> and <see cref="Append"/> run on the thread that owns the buffer: they only copy
+/// line references into batches. A worker strips ANSI styling and matches each batch with
+/// <see cref="SearchTextFolding"/>, so typing a query over a full scrollback never blocks input.
+/// The retained lines are queued newest first, so the matches nearest the prompt arrive first.
+/// Matches use absolute line numbers (<see cref="ScrollbackBuffer.TotalEvicted"/> + index), so they stay
+/// valid while old lines are evicted. Each line reports its first match only.
+/// </remarks>
+public sealed class ScrollbackSearch : IDisposable
+{
+    /// <summary>
+    /// عدد الأسطر الافتراضي في كل دفعة بحث.
+    /// Default number of lines matched per batch.
+    /// </summary>
+    public const int DefaultBatchSize = 4096;
+
+    private readonly ScrollbackBuffer _lines;
+    private readonly int _batchSize;
+    private readonly object _gate = new();
+    private readonly List<ScrollbackMatch> _matches = [];
+    private SearchRun? _run;
+    private long _queuedThrough;
+    private long _firstRetainedLine;
+
+    /// <summary>
+    /// ينشئ بحثًا فوق مخزن أسطر.
+    /// Creates a search over a scrollback buffer.
+    /// </summary>
+    /// <param name="lines">مخزن الأسطر.</param>
+    /// <param name="batchSize">عدد الأسطر في كل دفعة.</param>
+    public ScrollbackSearch(ScrollbackBuffer lines, int batchSize = DefaultBatchSize)
+    {
+        ArgumentNullException.ThrowIfNull(lines);
+        ArgumentOutOfRangeException.ThrowIfLessThan(batchSize, 1);
+
+        _lines = lines;
+        _batchSize = batchSize;
+    }
+
+    /// <summary>
+    /// يُطلق من خيط البحث بعد إيجاد مطابقات جديدة أو انتهاء الأسطر المعلقة.
+    /// Raised on the search thread after new matches are found or the pending lines are done.
+    /// </summary>
+    public event EventHandler? MatchesChanged;
+
+    /// <summary>
+    /// نص البحث الحالي.
+    /// The current query.
+    /// </summary>
+    public string Query { get; private set; } = string.Empty;
+
+    /// <summary>
+    /// هل توجد أسطر لم يُبحث فيها بعد.
+    /// Indicates whether queued lines are still being matched.
+    /// </summary>
+    public bool IsSearching
+    {
+        get
+        {
+            SearchRun? run = Volatile.Read(ref _run);
+            return run is not null && Volatile.Read(ref run.PendingLines) > 0;
+        }
+    }
+
+    /// <summary>
+    /// عدد المطابقات المعروفة حتى الآن.
+    /// Number of matches found so far.
+    /// </summary>
+    public int MatchCount
+    {
+        get
+        {
+            lock (_gate)
+            {
+                return _matches.Count;
+            }
+        }
+    }
+
+    /// <summary>
+    /// يبدأ بحثًا جديدًا فوق كل الأسطر المحفوظة ويلغي السابق.
+    /// Starts a new search over all retained lines, cancelling the previous one.
+    /// </summary>
+    /// <param name="query">نص البحث؛ يُتجاهل فيه التشكيل والتطويل.</param>
+    public void Start(string query)
+    {
+        ArgumentNullException.ThrowIfNull(query);
+
+        Stop();
+        Query = query;
+
+        string foldedQuery = SearchTextFolding.Fold(query);
+        if (foldedQuery.Length == 0)
+        {
+            return;
+        }
+
+        var run = new SearchRun(foldedQuery);
+        lock (_gate)
+        {
+            _run = run;
+            _firstRetainedLine = _lines.TotalEvicted;
+        }
+
+        QueueLines(run, _lines.TotalEvicted, _lines.TotalAppended, newestFirst: true);
+        _ = Task.Run(() => RunAsync(run));
+    }
+
+    /// <summary>
+    /// يضيف إلى البحث الجاري الأسطر المضافة منذ آخر استدعاء.
+    /// Queues the lines appended since the last call, and drops matches on evicted lines.
+    /// </summary>
+    public void Append()
+    {
+        SearchRun? run = _run;
+        if (run is null)
+        {
+            return;
+        }
+
+        long evicted = _lines.TotalEvicted;
+        QueueLines(run, Math.Max(_queuedThrough, evicted), _lines.TotalAppended, newestFirst: false);
+
+        lock (_gate)
+        {
+            _firstRetainedLine = evicted;
+            int stale = FindFirstAtOrAfter(evicted);
+            if (stale > 0)
+            {
+                _matches.RemoveRange(0, stale);
+            }
+        }
+    }
+
+    /// <summary>
+    /// هل في السطر مطابقة.
+    /// Indicates whether a line has a match.
+    /// </summary>
+    /// <param name="lineNumber">رقم السطر المطلق.</param>
+    public bool IsMatch(long lineNumber)
+    {
+        lock (_gate)
+        {
+            int index = FindFirstAtOrAfter(lineNumber);
+            return index < _matches.Count && _matches[index].LineNumber == lineNumber;
+        }
+    }
+
+    /// <summary>
+    /// يجد أقرب مطابقة قبل سطر أو بعده.
+    /// Finds the nearest match before or after a line.
+    /// </summary>
+    /// <param name="fromLineNumber">رقم السطر الذي يبدأ منه البحث؛ لا يُحتسب هو نفسه.</param>
+    /// <param name="older">صحيح للبحث نحو الأسطر الأقدم.</param>
+    /// <param name="match">المطابقة الموجودة.</param>
+    /// <returns>صحيح إذا وُجدت مطابقة.</returns>
+    public bool TryFindMatch(long fromLineNumber, bool older, out ScrollbackMatch match)
+    {
+        lock (_gate)
+        {
+            int index = older
+                ? FindFirstAtOrAfter(fromLineNumber) - 1
+                : FindFirstAtOrAfter(fromLineNumber == long.MaxValue ? long.MaxValue : fromLineNumber + 1);
+
+            if (index >= 0 && index < _matches.Count)
+            {
+                match = _matches[index];
+                return true;
+            }
+        }
+
+        match = default;
+        return false;
+    }
+
+    /// <summary>
+    /// يوقف البحث الجاري ويمسح المطابقات.
+    /// Cancels the running search and clears its matches.
+    /// </summary>
+    public void Stop()
+    {
+        SearchRun? run;
+        lock (_gate)
+        {
+            run = _run;
+            _run = null;
+            _matches.Clear();
+        }
+
+        Query = string.Empty;
+        if (run is not null)
+        {
+            run.Batches.Writer.TryComplete();
+            run.Cancellation.Cancel();
+        }
+    }
+
+    /// <inheritdoc />
+    public void Dispose()
+    {
+        Stop();
+    }
+
+    private void QueueLines(SearchRun run, long first, long end, bool newestFirst)
+    {
+        long evicted = _lines.TotalEvicted;
+        int batchCount = (int)((end - first + _batchSize - 1) / _batchSize);
+        for (int b = 0; b < batchCount; b++)
+        {
+            long batchStart = newestFirst
+                ? Math.Max(first, end - ((long)(b + 1) * _batchSize))
+                : first + ((long)b * _batchSize);
+            long batchEnd = newestFirst
+                ? end - ((long)b * _batchSize)
+                : Math.Min(end, batchStart + _batchSize);
+
+            int count = (int)(batchEnd - batchStart);
+            int index = (int)(batchStart - evicted);
+
+            var batch = new TerminalLine[count];
+            for (int i = 0; i < count; i++)
+            {
+                batch[i] = _lines[index + i];
+            }
+
+            Interlocked.Add(ref run.PendingLines, count);
+            run.Batches.Writer.TryWrite(new SearchBatch(batchStart, batch));
+        }
+
+        _queuedThrough = end;
+    }
+
+    private async Task RunAsync(SearchRun run)
+    {
+        var parser = new AnsiSgrParser();
+        var found = new List<ScrollbackMatch>();
+        CancellationToken token = run.Cancellation.Token;
+
+        try
+        {
+            await foreach (SearchBatch batch in run.Batches.Reader.ReadAllAsync(token).ConfigureAwait(false))
+            {
+                found.Clear();
+                for (int i = 0; i < batch.Lines.Length && !token.IsCancellationRequested; i++)
+                {
+                    string plain = parser.Parse(batch.Lines[i].Text).PlainText;
+                    int start = SearchTextFolding.IndexOf(plain, run.FoldedQuery, out int length);
+                    if (start >= 0)
+                    {
+                        found.Add(new ScrollbackMatch(batch.FirstLineNumber + i, start, length));
+                    }
+                }
+
+                lock (_gate)
+                {
+                    if (!ReferenceEquals(_run, run))
+                    {
+                        return;
+                    }
+
+                    // Batches never overlap, so each one's matches go in as a block at its position.
+                    int stale = 0;
+                    while (stale < found.Count && found[stale].LineNumber < _firstRetainedLine)
+                    {
+                        stale++;
+                    }
+
+                    if (stale < found.Count)
+                    {
+                        _matches.InsertRange(
+                            FindFirstAtOrAfter(batch.FirstLineNumber),
+                            stale == 0 ? found : found.GetRange(stale, found.Count - stale));
+                    }
+                }
+
+                int pending = Interlocked.Add(ref run.PendingLines, -batch.Lines.Length);
+                if (found.Count > 0 || pending == 0)
+                {
+                    MatchesChanged?.Invoke(this, EventArgs.Empty);
+                }
+            }
+        }
+        catch (OperationCanceledException)
+        {
+        }
+    }
+
+    private int FindFirstAtOrAfter(long lineNumber)
+    {
+        int lo = 0;
+        int hi = _matches.Count;
+        while (lo < hi)
+        {
+            int mid = lo + ((hi - lo) >> 1);
+            if (_matches[mid].LineNumber < lineNumber)
+            {
+                lo = mid + 1;
+            }
+            else
+            {
+                hi = mid;
+            }
+        }
+
+        return lo;
+    }
+
+    private readonly record struct SearchBatch(long FirstLineNumber, TerminalLine[] Lines);
+
+    /// <summary>
+    /// حالة بحث واحد: الاستعلام وطابور الدفعات والإلغاء.
+    /// State of one search: its query, batch queue and cancellation.
+    /// </summary>
+    private sealed class SearchRun
+    {
+        public SearchRun(string foldedQuery)
+        {
+            FoldedQuery = foldedQuery;
+        }
+
+        public string FoldedQuery { get; }
+
+        public Channel<SearchBatch> Batches { get; } = Channel.CreateUnbounded<SearchBatch>(
+            new UnboundedChannelOptions { SingleReader = true, SingleWriter = true });
+
+        public CancellationTokenSource Cancellation { get; } = new();
+
+        public int PendingLines;
+    }
+}
@@ -0,0 +1,154 @@
+using System.Buffers;
+
+namespace ArbSh.Terminal.Models;
+
+/// <summary>
+/// مطابقة نصية للبحث تتجاهل التشكيل والتطويل وحالة الأحرف.
+/// Search matching that ignores Arabic diacritics, tatweel and letter case.
+/// </summary>
+/// <remarks>
+/// The query is folded once with <see cref="Fold"/>; <see cref="IndexOf"/> then matches it against text
+/// as typed and maps the hit back to the original positions, so marks on the matched letters are part of
+/// the match. Text without ignorable marks is searched directly with an ordinal ignore-case search.
+/// </remarks>
+public static class SearchTextFolding
+{
+    private const int StackFoldLimit = 256;
+
+    // Tatweel, harakat and the combining Quranic marks.
+    private static readonly SearchValues<char> IgnorableChars = SearchValues.Create(
+        "ـ" +
+        "ًٌٍَُِّْٕٖٜٟٓٔٗ٘ٙٚٛٝٞ" +
+        "ٰ" +
+        "ۣ۪ۭۖۗۘۙۚۛۜ۟۠ۡۢۤۧۨ۫۬");
+
+    /// <summary>
+    /// هل يتجاهل البحث هذا المحرف.
+    /// Indicates whether search ignores a character.
+    /// </summary>
+    /// <param name="c">المحرف.</param>
+    public static bool IsIgnorable(char c)
+    {
+        return IgnorableChars.Contains(c);
+    }
+
+    /// <summary>
+    /// يزيل التشكيل والتطويل من النص.
+    /// Removes diacritics and tatweel from text.
+    /// </summary>
+    /// <param name="text">النص.</param>
+    /// <returns>النص بعد الطي.</returns>
+    public static string Fold(string text)
+    {
+        ArgumentNullException.ThrowIfNull(text);
+
+        if (text.AsSpan().IndexOfAny(IgnorableChars) < 0)
+        {
+            return text;
+        }
+
+        return string.Create(CountKept(text), text, static (destination, source) =>
+        {
+            int written = 0;
+            foreach (char c in source)
+            {
+                if (!IgnorableChars.Contains(c))
+                {
+                    destination[written++] = c;
+                }
+            }
+        });
+    }
+
+    /// <summary>
+    /// يبحث عن استعلام مطوي داخل نص.
+    /// Finds a folded query in text.
+    /// </summary>
+    /// <param name="text">النص كما هو.</param>
+    /// <param name="foldedQuery">الاستعلام بعد <see cref="Fold"/>.</param>
+    /// <param name="matchLength">طول المطابقة في النص الأصلي، بما فيها العلامات على أحرفها.</param>
+    /// <returns>موضع أول مطابقة في النص الأصلي، أو -1.</returns>
+    public static int IndexOf(ReadOnlySpan<char> text, string foldedQuery, out int matchLength)
+    {
+        ArgumentNullException.ThrowIfNull(foldedQuery);
+
+        matchLength = 0;
+        if (foldedQuery.Length == 0)
+        {
+            return -1;
+        }
+
+        if (text.IndexOfAny(IgnorableChars) < 0)
+        {
+            int direct = text.IndexOf(foldedQuery, StringComparison.OrdinalIgnoreCase);
+            matchLength = direct >= 0 ? foldedQuery.Length : 0;
+            return direct;
+        }
+
+        char[]? rentedChars = null;
+        int[]? rentedMap = null;
+        Span<char> folded = text.Length <= StackFoldLimit
+            ? stackalloc char[StackFoldLimit]
+            : rentedChars = ArrayPool<char>.Shared.Rent(text.Length);
+        Span<int> map = text.Length <= StackFoldLimit
+            ? stackalloc int[StackFoldLimit]
+            : rentedMap = ArrayPool<int>.Shared.Rent(text.Length);
+
+        try
+        {
+            int length = 0;
+            for (int i = 0; i < text.Length; i++)
+            {
+                if (!IgnorableChars.Contains(text[i]))
+                {
+                    folded[length] = text[i];
+                    map[length] = i;
+                    length++;
+                }
+            }
+
+            ReadOnlySpan<char> foldedText = folded[..length];
+            int index = foldedText.IndexOf(foldedQuery, StringComparison.OrdinalIgnoreCase);
+            if (index < 0)
+            {
+                return -1;
+            }
+
+            int start = map[index];
+            int end = map[index + foldedQuery.Length - 1] + 1;
+            while (end < text.Length && IgnorableChars.Contains(text[end]))
+            {
+                end++;
+            }
+
+            matchLength = end - start;
+            return start;
+        }
+        finally
+        {
+            if (rentedChars is not null)
+            {
+                ArrayPool<char>.Shared.Return(rentedChars);
+            }
+
+            if (rentedMap is not null)
+            {
+                ArrayPool<int>.Shared.Return(rentedMap);
+            }
+        }
+    }
+
+    private static int CountKept(string text)
+    {
+        int kept = 0;
+        foreach (char c in text)
+        {
+            if (!IgnorableChars.Contains(c))
+            {
+                kept++;
+            }
+        }
+
+        return kept;
+    }
+}
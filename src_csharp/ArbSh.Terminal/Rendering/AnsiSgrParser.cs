@@ -1,16 +1,24 @@
+using System.Buffers;
+using System.Collections.ObjectModel;
 using System.Globalization;
-using System.Text;
 
 namespace ArbSh.Terminal.Rendering;
 
 /// <summary>
 /// محلل تسلسلات ANSI SGR لتحويل النص إلى نص نظيف + نطاقات تنسيق.
 /// ANSI SGR parser that converts text to plain text + style spans.
+/// Text without escapes is returned as is; escaped text is parsed over spans into pooled buffers.
 /// </summary>
 public sealed class AnsiSgrParser
 {
     private const char Escape = '\u001B';
 
+    private static readonly SearchValues<char> SgrParameterChars = SearchValues.Create(";0123456789");
+
+    // Plain lines share one read-only default span list per length.
+    private const int MaxCachedPlainLength = 512;
+    private static readonly IReadOnlyList<AnsiStyleSpan>?[] PlainSpans = new IReadOnlyList<AnsiStyleSpan>?[MaxCachedPlainLength + 1];
+
     /// <summary>
     /// يحلل النص المنطقي ويستخرج تنسيقات ANSI SGR.
     /// Parses logical text and extracts ANSI SGR styling.
@@ -25,136 +33,168 @@ public sealed class AnsiSgrParser
             return new ParsedTerminalText(string.Empty, []);
         }
 
-        var plain = new StringBuilder(source.Length);
-        var spans = new List<AnsiStyleSpan>();
-        AnsiStyleState current = AnsiStyleState.Default;
-        int spanStart = 0;
+        int firstEscape = source.AsSpan().IndexOf(Escape);
+        if (firstEscape < 0)
+        {
+            return new ParsedTerminalText(source, GetPlainSpans(source.Length));
+        }
 
-        int i = 0;
-        while (i < source.Length)
+        return ParseEscaped(source, firstEscape);
+    }
+
+    private static ParsedTerminalText ParseEscaped(string source, int firstEscape)
+    {
+        ReadOnlySpan<char> text = source;
+        char[] plain = ArrayPool<char>.Shared.Rent(source.Length);
+        AnsiStyleSpan[] spans = ArrayPool<AnsiStyleSpan>.Shared.Rent(8);
+        int[] codes = ArrayPool<int>.Shared.Rent(16);
+        int plainLength = 0;
+        int spanCount = 0;
+
+        try
         {
-            if (source[i] == Escape && TryParseSgrSequence(source, i, out int consumedChars, out List<int> codes))
+            AnsiStyleState current = AnsiStyleState.Default;
+            int spanStart = 0;
+
+            text[..firstEscape].CopyTo(plain);
+            plainLength = firstEscape;
+
+            int i = firstEscape;
+            while (i < text.Length)
             {
-                AppendSpanIfAny(spans, spanStart, plain.Length - spanStart, current);
-                ApplyCodes(ref current, codes);
-                spanStart = plain.Length;
-                i += consumedChars;
-                continue;
+                // i is at an escape character.
+                if (TryParseSgrSequence(text, i, ref codes, out int consumedChars, out int codeCount))
+                {
+                    AppendSpanIfAny(ref spans, ref spanCount, spanStart, plainLength - spanStart, current);
+                    ApplyCodes(ref current, codes.AsSpan(0, codeCount));
+                    spanStart = plainLength;
+                    i += consumedChars;
+                }
+                else
+                {
+                    plain[plainLength++] = text[i++];
+                }
+
+                int next = text[i..].IndexOf(Escape);
+                int runEnd = next < 0 ? text.Length : i + next;
+                text[i..runEnd].CopyTo(plain.AsSpan(plainLength));
+                plainLength += runEnd - i;
+                i = runEnd;
             }
 
-            plain.Append(source[i]);
-            i++;
-        }
+            AppendSpanIfAny(ref spans, ref spanCount, spanStart, plainLength - spanStart, current);
 
-        AppendSpanIfAny(spans, spanStart, plain.Length - spanStart, current);
+            if (plainLength == 0)
+            {
+                return new ParsedTerminalText(string.Empty, []);
+            }
 
-        string plainText = plain.ToString();
-        if (plainText.Length == 0)
+            string plainText = new(plain, 0, plainLength);
+            return new ParsedTerminalText(
+                plainText,
+                spanCount == 0 ? GetPlainSpans(plainLength) : spans.AsSpan(0, spanCount).ToArray());
+        }
+        finally
         {
-            return new ParsedTerminalText(string.Empty, []);
+            ArrayPool<char>.Shared.Return(plain);
+            ArrayPool<AnsiStyleSpan>.Shared.Return(spans);
+            ArrayPool<int>.Shared.Return(codes);
         }
+    }
 
-        if (spans.Count == 0)
+    private static IReadOnlyList<AnsiStyleSpan> GetPlainSpans(int length)
+    {
+        if (length > MaxCachedPlainLength)
         {
-            spans.Add(new AnsiStyleSpan(0, plainText.Length, AnsiStyleState.Default));
+            return new ReadOnlyCollection<AnsiStyleSpan>([new AnsiStyleSpan(0, length, AnsiStyleState.Default)]);
         }
 
-        return new ParsedTerminalText(plainText, spans);
+        return PlainSpans[length] ??= new ReadOnlyCollection<AnsiStyleSpan>([new AnsiStyleSpan(0, length, AnsiStyleState.Default)]);
     }
 
-    private static void AppendSpanIfAny(List<AnsiStyleSpan> spans, int start, int length, AnsiStyleState style)
+    private static void AppendSpanIfAny(ref AnsiStyleSpan[] spans, ref int count, int start, int length, AnsiStyleState style)
     {
         if (length <= 0)
         {
             return;
         }
 
-        spans.Add(new AnsiStyleSpan(start, length, style));
+        if (count == spans.Length)
+        {
+            AnsiStyleSpan[] larger = ArrayPool<AnsiStyleSpan>.Shared.Rent(spans.Length * 2);
+            spans.AsSpan(0, count).CopyTo(larger);
+            ArrayPool<AnsiStyleSpan>.Shared.Return(spans);
+            spans = larger;
+        }
+
+        spans[count++] = new AnsiStyleSpan(start, length, style);
     }
 
-    private static bool TryParseSgrSequence(string source, int index, out int consumedChars, out List<int> codes)
+    private static bool TryParseSgrSequence(ReadOnlySpan<char> source, int index, ref int[] codes, out int consumedChars, out int codeCount)
     {
         consumedChars = 0;
-        codes = [];
+        codeCount = 0;
 
         if (index + 2 >= source.Length || source[index] != Escape || source[index + 1] != '[')
         {
             return false;
         }
 
-        int j = index + 2;
-        var token = new StringBuilder();
-        while (j < source.Length)
+        ReadOnlySpan<char> parameters = source[(index + 2)..];
+        int end = parameters.IndexOfAnyExcept(SgrParameterChars);
+        if (end < 0 || parameters[end] != 'm')
         {
-            char c = source[j];
-            if (c == 'm')
-            {
-                if (token.Length == 0)
-                {
-                    codes.Add(0);
-                }
-                else
-                {
-                    if (!TryParseCodeList(token.ToString(), codes))
-                    {
-                        return false;
-                    }
-                }
-
-                consumedChars = j - index + 1;
-                return true;
-            }
-
-            if (!char.IsDigit(c) && c != ';')
-            {
-                return false;
-            }
-
-            token.Append(c);
-            j++;
+            // Only ASCII digits and ';' may appear before the final 'm'.
+            return false;
         }
 
-        return false;
-    }
-
-    private static bool TryParseCodeList(string raw, List<int> codes)
-    {
-        string[] parts = raw.Split(';');
-        if (parts.Length == 0)
+        parameters = parameters[..end];
+        int needed = parameters.Count(';') + 1;
+        if (needed > codes.Length)
         {
-            codes.Add(0);
-            return true;
+            ArrayPool<int>.Shared.Return(codes);
+            codes = ArrayPool<int>.Shared.Rent(needed);
         }
 
-        foreach (string part in parts)
+        // An empty parameter (including "ESC[m") means 0.
+        int partStart = 0;
+        for (int p = 0; p <= parameters.Length; p++)
         {
-            if (string.IsNullOrEmpty(part))
+            if (p < parameters.Length && parameters[p] != ';')
+            {
+                continue;
+            }
+
+            ReadOnlySpan<char> digits = parameters[partStart..p];
+            partStart = p + 1;
+            if (digits.IsEmpty)
             {
-                codes.Add(0);
+                codes[codeCount++] = 0;
                 continue;
             }
 
-            if (!int.TryParse(part, NumberStyles.Integer, CultureInfo.InvariantCulture, out int value))
+            if (!int.TryParse(digits, NumberStyles.None, CultureInfo.InvariantCulture, out int value))
             {
                 return false;
             }
 
-            codes.Add(value);
+            codes[codeCount++] = value;
         }
 
+        consumedChars = end + 3;
         return true;
     }
 
-    private static void ApplyCodes(ref AnsiStyleState state, List<int> codes)
+    private static void ApplyCodes(ref AnsiStyleState state, ReadOnlySpan<int> codes)
     {
-        if (codes.Count == 0)
+        if (codes.Length == 0)
         {
             state = AnsiStyleState.Default;
             return;
         }
 
         int i = 0;
-        while (i < codes.Count)
+        while (i < codes.Length)
         {
             int code = codes[i];
             switch (code)
@@ -263,12 +303,12 @@ public sealed class AnsiSgrParser
         }
     }
 
-    private static bool TryParseExtendedColor(List<int> codes, int codeIndex, out int consumedExtraCodes, out AnsiColorSpec color)
+    private static bool TryParseExtendedColor(ReadOnlySpan<int> codes, int codeIndex, out int consumedExtraCodes, out AnsiColorSpec color)
     {
         consumedExtraCodes = 0;
         color = AnsiColorSpec.Default;
 
-        if (codeIndex + 1 >= codes.Count)
+        if (codeIndex + 1 >= codes.Length)
         {
             return false;
         }
@@ -276,7 +316,7 @@ public sealed class AnsiSgrParser
         int mode = codes[codeIndex + 1];
         if (mode == 5)
         {
-            if (codeIndex + 2 >= codes.Count)
+            if (codeIndex + 2 >= codes.Length)
             {
                 return false;
             }
@@ -288,7 +328,7 @@ public sealed class AnsiSgrParser
 
         if (mode == 2)
         {
-            if (codeIndex + 4 >= codes.Count)
+            if (codeIndex + 4 >= codes.Length)
             {
                 return false;
             }
@@ -61,6 +61,6 @@ public readonly record struct AnsiStyleSpan(int Start, int Length, AnsiStyleStat
 /// </summary>
 /// <param name="PlainText">النص بعد إزالة تسلسلات ANSI.</param>
 /// <param name="StyleSpans">نطاقات الأنماط على النص الناتج.</param>
-public sealed record ParsedTerminalText(
+public readonly record struct ParsedTerminalText(
     string PlainText,
     IReadOnlyList<AnsiStyleSpan> StyleSpans);
@@ -0,0 +1,174 @@
+using Avalonia.Media;
+
+namespace ArbSh.Terminal.Rendering;
+
+/// <summary>
+/// مقياس نص يخزن عروض المحارف والأسطر لكل خط ومقاس.
+/// Text measurer that caches advance widths per typeface and font size.
+/// Printable ASCII in a monospace font is measured arithmetically from cached glyph advances;
+/// Arabic, mixed and other runs are shaped once and their width is cached by text.
+/// </summary>
+public sealed class CachedTextMeasurer : ITextMeasurer
+{
+    /// <summary>
+    /// السعة الافتراضية لذاكرة عروض الأسطر المشكّلة لكل خط.
+    /// Default capacity of the shaped-width cache per font.
+    /// </summary>
+    public const int DefaultWidthCacheCapacity = 2048;
+
+    private const char FirstAsciiChar = ' ';
+    private const char LastAsciiChar = '~';
+    private const int MaxCachedFonts = 16;
+
+    private readonly ITextMeasurer _shapingMeasurer;
+    private readonly int _widthCacheCapacity;
+    private readonly Dictionary<FontKey, FontAdvances> _fonts = new();
+
+    /// <summary>
+    /// ينشئ المقياس مع مقياس التشكيل الكامل المستخدم للنصوص غير ASCII.
+    /// Creates the measurer over the full shaping measurer used for non-ASCII runs.
+    /// </summary>
+    /// <param name="shapingMeasurer">مقياس التشكيل الكامل (اختياري).</param>
+    /// <param name="widthCacheCapacity">أقصى عدد للأسطر المخزنة لكل خط.</param>
+    public CachedTextMeasurer(ITextMeasurer? shapingMeasurer = null, int widthCacheCapacity = DefaultWidthCacheCapacity)
+    {
+        ArgumentOutOfRangeException.ThrowIfLessThan(widthCacheCapacity, 1);
+
+        _shapingMeasurer = shapingMeasurer ?? new AvaloniaTextMeasurer();
+        _widthCacheCapacity = widthCacheCapacity;
+    }
+
+    /// <inheritdoc />
+    public double MeasureWidth(string visualText, TerminalRenderConfig config)
+    {
+        if (string.IsNullOrEmpty(visualText))
+        {
+            return 0;
+        }
+
+        FontAdvances font = GetFont(config);
+        if (IsPrintableAscii(visualText) && font.TryGetAsciiAdvances(out double[] advances))
+        {
+            return MeasureAscii(visualText, advances);
+        }
+
+        // Outside ASCII an advance depends on its neighbours (Arabic joining, combining marks,
+        // font fallback), so the whole run is shaped and the result kept per distinct text.
+        if (!font.ShapedWidths.TryGetValue(visualText, out double width))
+        {
+            width = _shapingMeasurer.MeasureWidth(visualText, config);
+            font.ShapedWidths.Set(visualText, width);
+        }
+
+        return width;
+    }
+
+    private FontAdvances GetFont(TerminalRenderConfig config)
+    {
+        var key = new FontKey(config.Typeface, config.FontSize);
+        if (!_fonts.TryGetValue(key, out FontAdvances? font))
+        {
+            if (_fonts.Count >= MaxCachedFonts)
+            {
+                _fonts.Clear();
+            }
+
+            font = new FontAdvances(key, _widthCacheCapacity);
+            _fonts[key] = font;
+        }
+
+        return font;
+    }
+
+    private static bool IsPrintableAscii(string text)
+    {
+        foreach (char c in text)
+        {
+            if (c < FirstAsciiChar || c > LastAsciiChar)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    // Matches FormattedText.Width, which excludes trailing whitespace.
+    private static double MeasureAscii(string text, double[] advances)
+    {
+        double width = 0;
+        double inkWidth = 0;
+        foreach (char c in text)
+        {
+            width += advances[c - FirstAsciiChar];
+            if (c != ' ')
+            {
+                inkWidth = width;
+            }
+        }
+
+        return inkWidth;
+    }
+
+    private readonly record struct FontKey(Typeface Typeface, double FontSize);
+
+    /// <summary>
+    /// عروض المحارف والأسطر المخزنة لخط ومقاس واحد.
+    /// Cached advances and shaped widths for one typeface and size.
+    /// </summary>
+    private sealed class FontAdvances
+    {
+        private readonly FontKey _key;
+        private double[]? _asciiAdvances;
+        private bool _asciiResolved;
+
+        public FontAdvances(FontKey key, int widthCacheCapacity)
+        {
+            _key = key;
+            ShapedWidths = new LruCache<string, double>(widthCacheCapacity, StringComparer.Ordinal);
+        }
+
+        public LruCache<string, double> ShapedWidths { get; }
+
+        /// <summary>
+        /// Gets advances for printable ASCII, resolved on first use. They are only available when the
+        /// primary typeface is monospace and has every printable ASCII glyph, so text layout would not
+        /// kern or fall back to another font.
+        /// </summary>
+        public bool TryGetAsciiAdvances(out double[] advances)
+        {
+            if (!_asciiResolved)
+            {
+                _asciiAdvances = ResolveAsciiAdvances(_key);
+                _asciiResolved = true;
+            }
+
+            advances = _asciiAdvances!;
+            return _asciiAdvances is not null;
+        }
+
+        private static double[]? ResolveAsciiAdvances(FontKey key)
+        {
+            if (!FontManager.Current.TryGetGlyphTypeface(key.Typeface, out IGlyphTypeface? glyphTypeface)
+                || !glyphTypeface.Metrics.IsFixedPitch
+                || glyphTypeface.Metrics.DesignEmHeight <= 0)
+            {
+                return null;
+            }
+
+            double scale = key.FontSize / glyphTypeface.Metrics.DesignEmHeight;
+            var advances = new double[LastAsciiChar - FirstAsciiChar + 1];
+            for (char c = FirstAsciiChar; c <= LastAsciiChar; c++)
+            {
+                if (!glyphTypeface.TryGetGlyph(c, out ushort glyph) || glyph == 0)
+                {
+                    return null;
+                }
+
+                advances[c - FirstAsciiChar] = glyphTypeface.GetGlyphAdvance(glyph) * scale;
+            }
+
+            return advances;
+        }
+    }
+}
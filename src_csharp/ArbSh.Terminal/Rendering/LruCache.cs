@@ -0,0 +1,89 @@
+namespace ArbSh.Terminal.Rendering;
+
+/// <summary>
+/// ذاكرة تخزين مؤقت محدودة السعة تُخرج العنصر الأقدم استخدامًا عند الامتلاء.
+/// Fixed-capacity cache that evicts the least recently used entry when full.
+/// </summary>
+/// <typeparam name="TKey">نوع المفتاح.</typeparam>
+/// <typeparam name="TValue">نوع القيمة.</typeparam>
+internal sealed class LruCache<TKey, TValue>
+    where TKey : notnull
+{
+    private readonly Dictionary<TKey, LinkedListNode<KeyValuePair<TKey, TValue>>> _entries;
+    private readonly LinkedList<KeyValuePair<TKey, TValue>> _order = new();
+    private readonly int _capacity;
+
+    /// <summary>
+    /// ينشئ ذاكرة مؤقتة بسعة ومقارن مفاتيح محددين.
+    /// Creates a cache with the given capacity and key comparer.
+    /// </summary>
+    /// <param name="capacity">أقصى عدد للعناصر.</param>
+    /// <param name="comparer">مقارن المفاتيح (اختياري).</param>
+    public LruCache(int capacity, IEqualityComparer<TKey>? comparer = null)
+    {
+        ArgumentOutOfRangeException.ThrowIfLessThan(capacity, 1);
+
+        _capacity = capacity;
+        _entries = new Dictionary<TKey, LinkedListNode<KeyValuePair<TKey, TValue>>>(capacity, comparer);
+    }
+
+    /// <summary>
+    /// عدد العناصر المخزنة.
+    /// Number of cached entries.
+    /// </summary>
+    public int Count => _entries.Count;
+
+    /// <summary>
+    /// يبحث عن قيمة ويجعلها الأحدث استخدامًا.
+    /// Looks up a value and marks it most recently used.
+    /// </summary>
+    /// <param name="key">المفتاح.</param>
+    /// <param name="value">القيمة إن وجدت.</param>
+    /// <returns>صحيح إذا وُجد المفتاح.</returns>
+    public bool TryGetValue(TKey key, out TValue value)
+    {
+        if (_entries.TryGetValue(key, out LinkedListNode<KeyValuePair<TKey, TValue>>? node))
+        {
+            _order.Remove(node);
+            _order.AddFirst(node);
+            value = node.Value.Value;
+            return true;
+        }
+
+        value = default!;
+        return false;
+    }
+
+    /// <summary>
+    /// يضيف قيمة أو يستبدلها، مع إخراج الأقدم عند تجاوز السعة.
+    /// Adds or replaces a value, evicting the least recently used entry when over capacity.
+    /// </summary>
+    /// <param name="key">المفتاح.</param>
+    /// <param name="value">القيمة.</param>
+    public void Set(TKey key, TValue value)
+    {
+        if (_entries.TryGetValue(key, out LinkedListNode<KeyValuePair<TKey, TValue>>? existing))
+        {
+            _order.Remove(existing);
+            _entries.Remove(key);
+        }
+        else if (_entries.Count >= _capacity)
+        {
+            LinkedListNode<KeyValuePair<TKey, TValue>> oldest = _order.Last!;
+            _order.RemoveLast();
+            _entries.Remove(oldest.Value.Key);
+        }
+
+        _entries[key] = _order.AddFirst(new KeyValuePair<TKey, TValue>(key, value));
+    }
+
+    /// <summary>
+    /// يفرغ الذاكرة المؤقتة.
+    /// Removes all entries.
+    /// </summary>
+    public void Clear()
+    {
+        _entries.Clear();
+        _order.Clear();
+    }
+}
@@ -0,0 +1,18 @@
+namespace ArbSh.Terminal.Rendering;
+
+/// <summary>
+/// يصف الصفوف التي تغيرت بين إطارين متتاليين.
+/// Describes which rows changed between two consecutive frames.
+/// </summary>
+/// <param name="IsFullRepaint">هل يجب إعادة رسم كل الصفوف (أول إطار أو تغير الحجم).</param>
+/// <param name="ScrolledRows">
+/// عدد الصفوف التي انزاح بها المحتوى للأعلى (سالب للأسفل): الصف r في الإطار الجديد يعرض ما كان في الصف r + ScrolledRows.
+/// Rows the content moved up by (negative: down); row r of the new frame shows what row r + ScrolledRows showed.
+/// </param>
+/// <param name="ChangedOutputRows">صفوف المخرجات التي يجب رسمها من جديد بعد تطبيق الإزاحة.</param>
+/// <param name="PromptChanged">هل تغير سطر الموجه.</param>
+public sealed record TerminalFrameDamage(
+    bool IsFullRepaint,
+    int ScrolledRows,
+    IReadOnlyList<int> ChangedOutputRows,
+    bool PromptChanged);
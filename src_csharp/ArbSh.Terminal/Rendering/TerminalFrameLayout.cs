@@ -5,11 +5,11 @@ namespace ArbSh.Terminal.Rendering;
 /// Represents the computed layout for one terminal frame.
 /// </summary>
 /// <param name="Instructions">تعليمات الرسم المحسوبة.</param>
-/// <param name="FirstVisibleOutputLineIndex">فهرس أول سطر مخرجات ظاهر.</param>
-/// <param name="VisibleOutputLineCount">عدد أسطر المخرجات الظاهرة.</param>
-/// <param name="MaxVisibleOutputLines">الحد الأقصى لأسطر المخرجات الممكن عرضها في الإطار.</param>
-/// <param name="ScrollbackOffsetLines">الإزاحة الحالية عن ذيل المخرجات.</param>
-/// <param name="MaxScrollbackOffsetLines">أقصى إزاحة مسموحة ضمن حجم المخرجات.</param>
+/// <param name="FirstVisibleOutputLineIndex">فهرس السطر المنطقي لأول صف مخرجات ظاهر.</param>
+/// <param name="VisibleOutputLineCount">عدد صفوف المخرجات الظاهرة.</param>
+/// <param name="MaxVisibleOutputLines">الحد الأقصى لصفوف المخرجات الممكن عرضها في الإطار.</param>
+/// <param name="ScrollbackOffsetLines">الإزاحة الحالية عن ذيل المخرجات بالصفوف.</param>
+/// <param name="MaxScrollbackOffsetLines">أقصى إزاحة مسموحة بالصفوف ضمن حجم المخرجات.</param>
 public sealed record TerminalFrameLayout(
     IReadOnlyList<TerminalDrawInstruction> Instructions,
     int FirstVisibleOutputLineIndex,
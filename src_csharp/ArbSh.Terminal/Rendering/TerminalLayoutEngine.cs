@@ -1,3 +1,4 @@
+using System.Diagnostics;
 using Avalonia;
 using ArbSh.Terminal.Models;
 
@@ -9,6 +10,54 @@ namespace ArbSh.Terminal.Rendering;
 /// </summary>
 public sealed class TerminalLayoutEngine
 {
+    /// <summary>
+    /// السعة الافتراضية لذاكرة الأسطر المرئية.
+    /// Default capacity of the visual run cache.
+    /// </summary>
+    public const int DefaultRunCacheCapacity = 512;
+
+    // TerminalLine is immutable, so a line's measured run depends only on the line instance and the
+    // config/pipeline that built it; its rows also depend on the wrap width they were split at.
+    // Lines are keyed by identity to avoid hashing their text.
+    private readonly LruCache<TerminalLine, LineRows> _runCache;
+    private TerminalRenderConfig? _cachedConfig;
+    private TerminalTextPipeline? _cachedPipeline;
+
+    // Row counts of every retained line, kept in step with the scrollback so a frame can find its first
+    // line without wrapping the lines above it.
+    private readonly TerminalWrapIndex _wrapIndex = new();
+    private IReadOnlyList<TerminalLine>? _indexedLines;
+    private TerminalLine? _lastIndexedLine;
+    private long _indexedEvicted;
+    private double _indexedWrapWidth = double.NaN;
+
+    /// <summary>
+    /// ينشئ محرك التخطيط مع ذاكرة مؤقتة للأسطر المرئية.
+    /// Creates a layout engine with a visual run cache.
+    /// </summary>
+    /// <param name="runCacheCapacity">أقصى عدد للأسطر المخزنة.</param>
+    public TerminalLayoutEngine(int runCacheCapacity = DefaultRunCacheCapacity)
+    {
+        _runCache = new LruCache<TerminalLine, LineRows>(runCacheCapacity, ReferenceEqualityComparer.Instance);
+    }
+
+    /// <summary>
+    /// عدد الأسطر المرئية المخزنة حاليًا.
+    /// Number of lines whose visual runs are currently cached.
+    /// </summary>
+    public int CachedRunCount => _runCache.Count;
+
+    /// <summary>
+    /// يفرغ ذاكرة الأسطر المرئية (مثلاً بعد تغيير الخط).
+    /// Clears cached visual runs, e.g. after a font change. A resize does not need this: a new wrap
+    /// width only re-wraps the wide lines that come into view.
+    /// </summary>
+    public void InvalidateCache()
+    {
+        _runCache.Clear();
+        _wrapIndex.Clear();
+        _indexedLines = null;
+    }
     /// <summary>
     /// يبني تعليمات الرسم فقط (توافق رجعي للاختبارات/الاستخدامات القديمة).
     /// Builds draw instructions only (backward compatibility for older call sites).
@@ -48,7 +97,7 @@ public sealed class TerminalLayoutEngine
     /// <param name="surfaceSize">حجم سطح الرسم.</param>
     /// <param name="config">إعدادات الرسم.</param>
     /// <param name="pipeline">خط معالجة النص.</param>
-    /// <param name="scrollbackOffsetLines">عدد الأسطر المخفية من ذيل المخرجات.</param>
+    /// <param name="scrollbackOffsetLines">عدد الصفوف المخفية من ذيل المخرجات (السطر الملتف يشغل عدة صفوف).</param>
     /// <returns>ناتج تخطيط الإطار.</returns>
     public TerminalFrameLayout BuildFrameLayout(
         IReadOnlyList<TerminalLine> logicalLines,
@@ -63,34 +112,57 @@ public sealed class TerminalLayoutEngine
         ArgumentNullException.ThrowIfNull(config);
         ArgumentNullException.ThrowIfNull(pipeline);
 
+        long layoutStart = Stopwatch.GetTimestamp();
+        double wrapWidth = ResolveWrapWidth(surfaceSize, config);
+        SyncWrapIndex(logicalLines, wrapWidth, config, pipeline);
+
         var instructions = new List<TerminalDrawInstruction>();
 
         double lineHeight = config.LineHeight;
         double top = config.Padding.Top;
         double bottom = config.Padding.Bottom;
 
+        // Scrolling works in rows: a wrapped line takes several, and the wrap index maps the first
+        // visible row back to its line in O(log n).
         double availableOutputHeight = Math.Max(0, surfaceSize.Height - top - bottom - lineHeight);
         int maxVisibleOutputLines = Math.Max(1, (int)Math.Floor(availableOutputHeight / lineHeight));
-        int maxScrollbackOffsetLines = Math.Max(0, logicalLines.Count - maxVisibleOutputLines);
-        int clampedOffset = Math.Clamp(scrollbackOffsetLines, 0, maxScrollbackOffsetLines);
-        int start = Math.Max(0, logicalLines.Count - maxVisibleOutputLines - clampedOffset);
-        int end = Math.Min(logicalLines.Count, start + maxVisibleOutputLines);
+        int totalRows, maxScrollbackOffsetLines, clampedOffset, startRow, endRow, firstLine;
+
+        // After a resize the rows of wide lines are estimates. Lines in and near the view are wrapped
+        // exactly and the window is placed again until it no longer changes; each line is wrapped at
+        // most once, and lines far from the view keep their estimates until they scroll in.
+        do
+        {
+            totalRows = _wrapIndex.TotalRows;
+            maxScrollbackOffsetLines = Math.Max(0, totalRows - maxVisibleOutputLines);
+            clampedOffset = Math.Clamp(scrollbackOffsetLines, 0, maxScrollbackOffsetLines);
+            startRow = Math.Max(0, totalRows - maxVisibleOutputLines - clampedOffset);
+            endRow = Math.Min(totalRows, startRow + maxVisibleOutputLines);
+            firstLine = startRow < totalRows ? _wrapIndex.FindLine(startRow) : 0;
+        }
+        while (RefineRows(logicalLines, startRow - maxVisibleOutputLines, endRow + maxVisibleOutputLines, wrapWidth, config, pipeline));
 
         double y = top;
-        for (int i = start; i < end; i++)
+        int row = startRow;
+        for (int i = firstLine; row < endRow; i++)
         {
             TerminalLine line = logicalLines[i];
-            VisualTextRun run = pipeline.BuildVisualRun(line.Text, line.Kind, config);
-            double x = ResolveX(surfaceSize.Width, run.MeasuredWidth, config, alignRight: run.HasArabic);
+            LineRows rows = GetLineRows(line, wrapWidth, config, pipeline);
+
+            for (int r = row - _wrapIndex.GetFirstRow(i); r < rows.Runs.Count && row < endRow; r++, row++)
+            {
+                VisualTextRun run = rows.Runs[r];
+                double x = ResolveX(surfaceSize.Width, run.MeasuredWidth, config, alignRight: run.HasArabic);
 
-            instructions.Add(new TerminalDrawInstruction(
-                new Point(x, y),
-                run,
-                config.ResolveBrush(line.Kind),
-                IsPromptLine: false,
-                LogicalLineIndex: i));
+                instructions.Add(new TerminalDrawInstruction(
+                    new Point(x, y),
+                    run,
+                    config.ResolveBrush(line.Kind),
+                    IsPromptLine: false,
+                    LogicalLineIndex: i));
 
-            y += lineHeight;
+                y += lineHeight;
+            }
         }
 
         VisualTextRun promptRun = pipeline.BuildPromptRun(promptLogical, inputLogical, config);
@@ -104,15 +176,225 @@ public sealed class TerminalLayoutEngine
             IsPromptLine: true,
             LogicalLineIndex: -1));
 
+        TerminalMetrics.RecordLayout(Stopwatch.GetElapsedTime(layoutStart));
         return new TerminalFrameLayout(
             instructions,
-            FirstVisibleOutputLineIndex: start,
-            VisibleOutputLineCount: end - start,
+            FirstVisibleOutputLineIndex: firstLine,
+            VisibleOutputLineCount: endRow - startRow,
             MaxVisibleOutputLines: maxVisibleOutputLines,
             ScrollbackOffsetLines: clampedOffset,
             MaxScrollbackOffsetLines: maxScrollbackOffsetLines);
     }
 
+    /// <summary>
+    /// يقارن إطارين ويحدد صفوف المخرجات التي تغيرت، مع اكتشاف التمرير حتى يعاد استخدام الصفوف المزاحة.
+    /// Compares two frames and reports the output rows that changed. Scrolling is detected so rows that
+    /// only moved can be shifted instead of redrawn. Rows match when they hold the same cached
+    /// <see cref="VisualTextRun"/> at the same X position, so lines are never compared by text.
+    /// </summary>
+    /// <param name="previous">الإطار المرسوم سابقًا، أو null.</param>
+    /// <param name="current">الإطار الجديد.</param>
+    /// <returns>الصفوف المتضررة.</returns>
+    public static TerminalFrameDamage ComputeDamage(TerminalFrameLayout? previous, TerminalFrameLayout current)
+    {
+        ArgumentNullException.ThrowIfNull(current);
+
+        GetRows(current, out List<TerminalDrawInstruction> currentRows, out TerminalDrawInstruction? currentPrompt);
+        if (previous is null || previous.MaxVisibleOutputLines != current.MaxVisibleOutputLines)
+        {
+            return new TerminalFrameDamage(true, 0, Enumerable.Range(0, currentRows.Count).ToArray(), PromptChanged: true);
+        }
+
+        GetRows(previous, out List<TerminalDrawInstruction> previousRows, out TerminalDrawInstruction? previousPrompt);
+
+        // The first current row found in the previous frame gives the scroll distance.
+        int scrolled = 0;
+        for (int row = 0; row < currentRows.Count; row++)
+        {
+            int previousRow = previousRows.FindIndex(x => ReferenceEquals(x.Run, currentRows[row].Run));
+            if (previousRow >= 0)
+            {
+                scrolled = previousRow - row;
+                break;
+            }
+        }
+
+        var changed = new List<int>();
+        for (int row = 0; row < currentRows.Count; row++)
+        {
+            int previousRow = row + scrolled;
+            bool same = previousRow >= 0
+                && previousRow < previousRows.Count
+                && ReferenceEquals(previousRows[previousRow].Run, currentRows[row].Run)
+                && previousRows[previousRow].Position.X == currentRows[row].Position.X;
+
+            if (!same)
+            {
+                changed.Add(row);
+            }
+        }
+
+        bool promptChanged = previousPrompt is null
+            || currentPrompt is null
+            || previousPrompt.Position != currentPrompt.Position
+            || !string.Equals(previousPrompt.Run.LogicalText, currentPrompt.Run.LogicalText, StringComparison.Ordinal);
+
+        return new TerminalFrameDamage(false, scrolled, changed, promptChanged);
+    }
+
+    /// <summary>
+    /// يحسب عدد الصفوف التي تشغلها آخر الأسطر.
+    /// Counts the rows the last lines occupy at a surface size, e.g. to keep a scrolled-back view in place
+    /// while output is appended.
+    /// </summary>
+    /// <param name="logicalLines">أسطر الطرفية بالترتيب المنطقي.</param>
+    /// <param name="lineCount">عدد الأسطر الأخيرة.</param>
+    /// <param name="surfaceSize">حجم سطح الرسم.</param>
+    /// <param name="config">إعدادات الرسم.</param>
+    /// <param name="pipeline">خط معالجة النص.</param>
+    /// <returns>عدد الصفوف.</returns>
+    public int CountTrailingRows(
+        IReadOnlyList<TerminalLine> logicalLines,
+        int lineCount,
+        Size surfaceSize,
+        TerminalRenderConfig config,
+        TerminalTextPipeline pipeline)
+    {
+        ArgumentNullException.ThrowIfNull(logicalLines);
+        ArgumentNullException.ThrowIfNull(config);
+        ArgumentNullException.ThrowIfNull(pipeline);
+
+        SyncWrapIndex(logicalLines, ResolveWrapWidth(surfaceSize, config), config, pipeline);
+
+        int count = Math.Clamp(lineCount, 0, _wrapIndex.LineCount);
+        return count == 0 ? 0 : _wrapIndex.TotalRows - _wrapIndex.GetFirstRow(_wrapIndex.LineCount - count);
+    }
+
+    private static double ResolveWrapWidth(Size surfaceSize, TerminalRenderConfig config)
+    {
+        return config.WrapLines
+            ? Math.Max(1, surfaceSize.Width - config.Padding.Left - config.Padding.Right)
+            : double.PositiveInfinity;
+    }
+
+    // Brings the wrap index up to date: evicted lines are dropped from the head, a new wrap width
+    // estimates rows from the stored widths without wrapping anything (see RefineRows), and
+    // appended lines are measured once each. Anything else, like a different line source, rebuilds it.
+    private void SyncWrapIndex(IReadOnlyList<TerminalLine> lines, double wrapWidth, TerminalRenderConfig config, TerminalTextPipeline pipeline)
+    {
+        if (!ReferenceEquals(config, _cachedConfig) || !ReferenceEquals(pipeline, _cachedPipeline))
+        {
+            _runCache.Clear();
+            _wrapIndex.Clear();
+            _cachedConfig = config;
+            _cachedPipeline = pipeline;
+        }
+
+        long evicted = 0;
+        if (ReferenceEquals(lines, _indexedLines) && lines is ScrollbackBuffer buffer)
+        {
+            evicted = buffer.TotalEvicted - _indexedEvicted;
+        }
+
+        long kept = _wrapIndex.LineCount - evicted;
+        bool isIncremental = evicted >= 0
+            && kept >= 0
+            && kept <= lines.Count
+            && (kept == 0 || ReferenceEquals(lines[(int)kept - 1], _lastIndexedLine));
+
+        if (isIncremental)
+        {
+            _wrapIndex.RemoveFirst((int)evicted);
+        }
+        else
+        {
+            _wrapIndex.Clear();
+            kept = 0;
+        }
+
+        if (!wrapWidth.Equals(_indexedWrapWidth))
+        {
+            _indexedWrapWidth = wrapWidth;
+            _wrapIndex.Reflow(wrapWidth);
+        }
+
+        for (int i = (int)kept; i < lines.Count; i++)
+        {
+            LineRows rows = GetLineRows(lines[i], wrapWidth, config, pipeline);
+            _wrapIndex.Append(rows.Line.MeasuredWidth, rows.Runs.Count);
+        }
+
+        _indexedLines = lines;
+        _indexedEvicted = lines is ScrollbackBuffer current ? current.TotalEvicted : 0;
+        _lastIndexedLine = lines.Count > 0 ? lines[lines.Count - 1] : null;
+    }
+
+    // Wraps the lines with estimated rows that overlap [fromRow, toRow) and records their exact counts.
+    // Returns true when a count changed, so the caller places its window again.
+    private bool RefineRows(IReadOnlyList<TerminalLine> lines, int fromRow, int toRow, double wrapWidth, TerminalRenderConfig config, TerminalTextPipeline pipeline)
+    {
+        int totalRows = _wrapIndex.TotalRows;
+        fromRow = Math.Max(0, fromRow);
+        toRow = Math.Min(totalRows, toRow);
+        if (fromRow >= toRow)
+        {
+            return false;
+        }
+
+        bool changed = false;
+        int lastLine = _wrapIndex.FindLine(toRow - 1);
+        for (int i = _wrapIndex.FindLine(fromRow); i <= lastLine; i++)
+        {
+            if (_wrapIndex.IsEstimated(i))
+            {
+                int rows = GetLineRows(lines[i], wrapWidth, config, pipeline).Runs.Count;
+                changed |= rows != _wrapIndex.GetRowCount(i);
+                _wrapIndex.SetRowCount(i, rows);
+            }
+        }
+
+        return changed;
+    }
+
+    private LineRows GetLineRows(TerminalLine line, double wrapWidth, TerminalRenderConfig config, TerminalTextPipeline pipeline)
+    {
+        if (_runCache.TryGetValue(line, out LineRows? rows))
+        {
+            // A line that fits both widths keeps its single row; a wider one is split again without measuring the line.
+            if (rows.WrapWidth.Equals(wrapWidth) || (rows.Runs.Count == 1 && rows.Line.MeasuredWidth <= wrapWidth))
+            {
+                return rows;
+            }
+
+            rows = new LineRows(rows.Line, wrapWidth, pipeline.WrapVisualRun(rows.Line, wrapWidth, config));
+        }
+        else
+        {
+            VisualTextRun run = pipeline.BuildVisualRun(line.Text, line.Kind, config);
+            rows = new LineRows(run, wrapWidth, pipeline.WrapVisualRun(run, wrapWidth, config));
+        }
+
+        _runCache.Set(line, rows);
+        return rows;
+    }
+
+    private static void GetRows(TerminalFrameLayout frame, out List<TerminalDrawInstruction> outputRows, out TerminalDrawInstruction? prompt)
+    {
+        outputRows = new List<TerminalDrawInstruction>(frame.VisibleOutputLineCount);
+        prompt = null;
+        foreach (TerminalDrawInstruction instruction in frame.Instructions)
+        {
+            if (instruction.IsPromptLine)
+            {
+                prompt = instruction;
+            }
+            else
+            {
+                outputRows.Add(instruction);
+            }
+        }
+    }
+
     private static double ResolveX(double width, double textWidth, TerminalRenderConfig config, bool alignRight)
     {
         double left = config.Padding.Left;
@@ -124,4 +406,10 @@ public sealed class TerminalLayoutEngine
         double right = config.Padding.Right;
         return Math.Max(left, width - right - textWidth);
     }
+
+    /// <summary>
+    /// صفوف سطر منطقي مع سطره المرئي الكامل والعرض الذي قُسم عليه.
+    /// The visual rows of one logical line, with its unwrapped run and the wrap width they were split at.
+    /// </summary>
+    private sealed record LineRows(VisualTextRun Line, double WrapWidth, IReadOnlyList<VisualTextRun> Runs);
 }
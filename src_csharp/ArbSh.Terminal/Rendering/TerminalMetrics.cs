@@ -0,0 +1,39 @@
+using System.Diagnostics.Metrics;
+
+namespace ArbSh.Terminal.Rendering;
+
+/// <summary>
+/// مقاييس الرسم في الطرفية، تُنشر عبر <see cref="System.Diagnostics.Metrics"/>.
+/// Rendering instrumentation published through <see cref="System.Diagnostics.Metrics"/> under the
+/// <see cref="MeterName"/> meter, for <c>dotnet-counters</c> and <c>dotnet-trace</c>.
+/// </summary>
+public static class TerminalMetrics
+{
+    /// <summary>
+    /// اسم المقياس الذي ينشر أدوات الطرفية.
+    /// Name of the meter that publishes the terminal instruments.
+    /// </summary>
+    public const string MeterName = "ArbSh.Terminal";
+
+    private static readonly Meter Meter = new(MeterName);
+
+    private static readonly Histogram<double> FrameDuration = Meter.CreateHistogram<double>(
+        "arbsh.terminal.frame.duration", "ms", "Time to lay out a frame and update its changed rows.");
+
+    private static readonly Histogram<double> LayoutDuration = Meter.CreateHistogram<double>(
+        "arbsh.terminal.layout.duration", "ms", "Time to build a frame layout.");
+
+    private static readonly Counter<long> RowsUpdated = Meter.CreateCounter<long>(
+        "arbsh.terminal.frame.rows_updated", "{row}", "Rows given new content by a frame.");
+
+    internal static void RecordFrame(TimeSpan elapsed, int rowsUpdated)
+    {
+        FrameDuration.Record(elapsed.TotalMilliseconds);
+        RowsUpdated.Add(rowsUpdated);
+    }
+
+    internal static void RecordLayout(TimeSpan elapsed)
+    {
+        LayoutDuration.Record(elapsed.TotalMilliseconds);
+    }
+}
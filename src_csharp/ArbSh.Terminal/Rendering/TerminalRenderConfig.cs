@@ -75,12 +75,24 @@ public sealed class TerminalRenderConfig
     /// </summary>
     public IBrush OutputSelectionBrush { get; init; } = new SolidColorBrush(Color.FromArgb(72, 75, 130, 220));
 
+    /// <summary>
+    /// لون خلفية أسطر المخرجات المطابقة للبحث.
+    /// Background brush for output lines that match the search.
+    /// </summary>
+    public IBrush SearchMatchBrush { get; init; } = new SolidColorBrush(Color.FromArgb(56, 230, 180, 60));
+
     /// <summary>
     /// عدد الأسطر التي يتم تمريرها لكل خطوة عجلة.
     /// Number of lines to scroll per wheel step.
     /// </summary>
     public int ScrollLinesPerWheelStep { get; init; } = 3;
 
+    /// <summary>
+    /// هل تلتف أسطر المخرجات الطويلة إلى عدة صفوف.
+    /// Whether long output lines wrap onto several rows instead of overflowing.
+    /// </summary>
+    public bool WrapLines { get; init; } = true;
+
     /// <summary>
     /// نوع الخط المستخدم في الرسم.
     /// Typeface used by Avalonia text layout.
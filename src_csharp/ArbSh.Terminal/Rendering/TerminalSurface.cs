@@ -1,9 +1,13 @@
+using System.Diagnostics;
 using Avalonia;
 using Avalonia.Controls;
 using Avalonia.Input;
 using Avalonia.Input.Platform;
+using Avalonia.Interactivity;
 using Avalonia.Media;
 using Avalonia.Media.TextFormatting;
+using Avalonia.Threading;
+using ArbSh.Core;
 using ArbSh.Core.I18n;
 using ArbSh.Terminal.Input;
 using ArbSh.Terminal.Models;
@@ -15,28 +19,57 @@ public sealed class TerminalSurface : Control
 {
     private const double CaretDistanceEpsilon = 0.01;
     private const int PageScrollOverlapLines = 1;
+    private const string SearchPromptLabel = "بحث";
+    private const string HistorySearchPromptLabel = "السجل";
 
     private MainWindowViewModel? _viewModel;
     private bool _isPromptPointerSelecting;
     private bool _isOutputPointerSelecting;
     private int _scrollbackOffsetLines;
-    private int _lastKnownLineCount;
-
-    private readonly TerminalInputBuffer _inputBuffer = new();
+    private long _lastKnownAppended;
+    private long _lastKnownEvicted;
+    private TerminalInputBuffer _inputBuffer;
+    private ScrollbackSearch? _search;
+    private string? _searchPrompt;
+    private long? _searchMatchLine;
+    private int _searchRefreshPosted;
+    private bool _isHistorySearch;
+    private int _historyMatch = -1;
+    private int _historyRecallIndex = -1;
+    private string? _historyRecallPrefix;
+
+    // The prompt line edits either the command or, while searching, the scrollback or history query.
+    private readonly TerminalInputBuffer _commandInput = new();
+    private readonly TerminalInputBuffer _searchInput = new();
+    private readonly TerminalInputBuffer _historyQuery = new();
     private readonly OutputSelectionBuffer _outputSelection = new();
     private readonly TerminalRenderConfig _renderConfig = new();
     private readonly TerminalTextPipeline _textPipeline = new();
     private readonly TerminalLayoutEngine _layoutEngine = new();
+    private readonly BidiParagraph _bidiParagraph = new();
+    private readonly LruCache<VisualTextRun, OutputLineVisual> _outputVisualCache =
+        new(TerminalLayoutEngine.DefaultRunCacheCapacity, ReferenceEqualityComparer.Instance);
+
+    // Rows are retained child visuals: each re-renders only when its content changes, and rows that
+    // merely scroll are moved, not redrawn.
+    private readonly List<TerminalRowVisual> _outputRows = [];
+    private readonly TerminalRowVisual _promptRow;
+    private TerminalFrameLayout? _renderedFrame;
+    private PromptRenderState _renderedPromptState;
 
     private PromptLayoutSnapshot? _promptSnapshot;
     private TerminalFrameLayout? _frameSnapshot;
     private string _frameSnapshotInputText = string.Empty;
-    private int _frameSnapshotLineCount;
+    private string _frameSnapshotPrompt = string.Empty;
+    private long _frameSnapshotAppended;
     private Size _frameSnapshotSize;
 
     public TerminalSurface()
     {
         Focusable = true;
+        _inputBuffer = _commandInput;
+        _promptRow = new TerminalRowVisual(this);
+        VisualChildren.Add(_promptRow);
     }
 
     protected override void OnDataContextChanged(EventArgs e)
@@ -48,26 +81,45 @@ public sealed class TerminalSurface : Control
             _viewModel.BufferChanged -= HandleBufferChanged;
         }
 
+        EndSearch();
+        EndHistorySearch(accept: false);
         _viewModel = DataContext as MainWindowViewModel;
         if (_viewModel is not null)
         {
             _viewModel.BufferChanged += HandleBufferChanged;
-            _lastKnownLineCount = _viewModel.Lines.Count;
+            _lastKnownAppended = _viewModel.Lines.TotalAppended;
+            _lastKnownEvicted = _viewModel.Lines.TotalEvicted;
         }
         else
         {
-            _lastKnownLineCount = 0;
+            _lastKnownAppended = 0;
+            _lastKnownEvicted = 0;
         }
 
         _scrollbackOffsetLines = 0;
         _outputSelection.Clear();
+        _layoutEngine.InvalidateCache();
+        _outputVisualCache.Clear();
         _frameSnapshot = null;
         _frameSnapshotInputText = string.Empty;
-        _frameSnapshotLineCount = _lastKnownLineCount;
+        _frameSnapshotAppended = _lastKnownAppended;
         _frameSnapshotSize = Bounds.Size;
         _promptSnapshot = null;
+        _renderedFrame = null;
+
+        InvalidateFrame();
+    }
+
+    protected override void OnGotFocus(GotFocusEventArgs e)
+    {
+        base.OnGotFocus(e);
+        InvalidateFrame();
+    }
 
-        InvalidateVisual();
+    protected override void OnLostFocus(RoutedEventArgs e)
+    {
+        base.OnLostFocus(e);
+        InvalidateFrame();
     }
 
     protected override void OnPointerPressed(PointerPressedEventArgs e)
@@ -183,8 +235,8 @@ public sealed class TerminalSurface : Control
 
         _outputSelection.Clear();
         _inputBuffer.InsertText(e.Text);
-        _scrollbackOffsetLines = 0;
-        InvalidateVisual();
+        HandleInputEdited();
+        InvalidateFrame();
         e.Handled = true;
     }
 
@@ -202,7 +254,7 @@ public sealed class TerminalSurface : Control
                 case Key.A:
                     _outputSelection.Clear();
                     _inputBuffer.SelectAll();
-                    InvalidateVisual();
+                    InvalidateFrame();
                     e.Handled = true;
                     return;
 
@@ -213,13 +265,64 @@ public sealed class TerminalSurface : Control
 
                 case Key.X:
                     await CutSelectionAsync();
-                    InvalidateVisual();
+                    InvalidateFrame();
                     e.Handled = true;
                     return;
 
                 case Key.V:
                     await PasteClipboardAsync();
-                    InvalidateVisual();
+                    InvalidateFrame();
+                    e.Handled = true;
+                    return;
+
+                case Key.F:
+                    EndHistorySearch(accept: false);
+                    BeginSearch();
+                    e.Handled = true;
+                    return;
+
+                case Key.R:
+                    BeginHistorySearch();
+                    e.Handled = true;
+                    return;
+            }
+        }
+
+        if (_search is not null)
+        {
+            switch (e.Key)
+            {
+                case Key.Enter:
+                case Key.F3:
+                    MoveToSearchMatch(older: !shift);
+                    e.Handled = true;
+                    return;
+
+                case Key.Escape:
+                    // The current match stays selected so it can be copied.
+                    EndSearch();
+                    e.Handled = true;
+                    return;
+            }
+        }
+
+        if (_isHistorySearch)
+        {
+            switch (e.Key)
+            {
+                case Key.Enter:
+                    EndHistorySearch(accept: true);
+                    e.Handled = true;
+                    return;
+
+                case Key.Escape:
+                    EndHistorySearch(accept: false);
+                    e.Handled = true;
+                    return;
+
+                case Key.Up:
+                case Key.Down:
+                    MoveToHistoryMatch(older: e.Key == Key.Up);
                     e.Handled = true;
                     return;
             }
@@ -229,64 +332,72 @@ public sealed class TerminalSurface : Control
         {
             case Key.PageUp:
                 ScrollbackByPage(upward: true);
-                InvalidateVisual();
+                InvalidateFrame();
                 e.Handled = true;
                 break;
 
             case Key.PageDown:
                 ScrollbackByPage(upward: false);
-                InvalidateVisual();
+                InvalidateFrame();
+                e.Handled = true;
+                break;
+
+            case Key.Up when _search is null:
+            case Key.Down when _search is null:
+                _outputSelection.Clear();
+                RecallHistory(older: e.Key == Key.Up);
+                InvalidateFrame();
                 e.Handled = true;
                 break;
 
             case Key.Left:
                 _outputSelection.Clear();
                 MoveCaretVisual(moveLeft: true, extendSelection: shift);
-                InvalidateVisual();
+                InvalidateFrame();
                 e.Handled = true;
                 break;
 
             case Key.Right:
                 _outputSelection.Clear();
                 MoveCaretVisual(moveLeft: false, extendSelection: shift);
-                InvalidateVisual();
+                InvalidateFrame();
                 e.Handled = true;
                 break;
 
             case Key.Home:
                 _outputSelection.Clear();
                 _inputBuffer.MoveCaretHome(shift);
-                InvalidateVisual();
+                InvalidateFrame();
                 e.Handled = true;
                 break;
 
             case Key.End:
                 _outputSelection.Clear();
                 _inputBuffer.MoveCaretEnd(shift);
-                InvalidateVisual();
+                InvalidateFrame();
                 e.Handled = true;
                 break;
 
             case Key.Back:
                 _outputSelection.Clear();
                 _inputBuffer.Backspace();
-                _scrollbackOffsetLines = 0;
-                InvalidateVisual();
+                HandleInputEdited();
+                InvalidateFrame();
                 e.Handled = true;
                 break;
 
             case Key.Delete:
                 _outputSelection.Clear();
                 _inputBuffer.DeleteForward();
-                _scrollbackOffsetLines = 0;
-                InvalidateVisual();
+                HandleInputEdited();
+                InvalidateFrame();
                 e.Handled = true;
                 break;
 
             case Key.Escape:
                 _inputBuffer.ClearSelection();
                 _outputSelection.Clear();
-                InvalidateVisual();
+                InvalidateFrame();
                 e.Handled = true;
                 break;
 
@@ -303,19 +414,52 @@ public sealed class TerminalSurface : Control
     {
         base.Render(context);
 
+        // The rows draw themselves as child visuals; the surface only paints the background.
         context.DrawRectangle(_renderConfig.BackgroundBrush, null, new Rect(Bounds.Size));
+    }
 
+    protected override Size ArrangeOverride(Size finalSize)
+    {
+        UpdateRows(finalSize);
+
+        double lineHeight = _renderConfig.LineHeight;
+        foreach (TerminalRowVisual row in _outputRows)
+        {
+            row.Arrange(new Rect(0, row.Top, finalSize.Width, lineHeight));
+        }
+
+        _promptRow.Arrange(new Rect(0, _promptRow.Top, finalSize.Width, lineHeight));
+        return finalSize;
+    }
+
+    /// <summary>
+    /// يطلب إعادة بناء الإطار؛ ترسم الصفوف التي تغيرت فقط.
+    /// Requests a new frame. The layout is rebuilt on the next arrange pass and only changed rows re-render.
+    /// </summary>
+    private void InvalidateFrame()
+    {
+        InvalidateArrange();
+    }
+
+    private void UpdateRows(Size size)
+    {
         if (_viewModel is null)
         {
+            RemoveOutputRows(0);
+            _promptRow.Clear();
+            _renderedFrame = null;
             return;
         }
 
-        IReadOnlyList<TerminalLine> lineSnapshot = [.. _viewModel.Lines];
+        // Lines only change on the UI thread, so the collection can be laid out without a copy.
+        long frameStart = Stopwatch.GetTimestamp();
+        IReadOnlyList<TerminalLine> lineSnapshot = _viewModel.Lines;
+        string prompt = ActivePrompt;
         TerminalFrameLayout frame = _layoutEngine.BuildFrameLayout(
             lineSnapshot,
-            _viewModel.Prompt,
+            prompt,
             _inputBuffer.Text,
-            Bounds.Size,
+            size,
             _renderConfig,
             _textPipeline,
             _scrollbackOffsetLines);
@@ -323,23 +467,165 @@ public sealed class TerminalSurface : Control
         _scrollbackOffsetLines = frame.ScrollbackOffsetLines;
         _frameSnapshot = frame;
         _frameSnapshotInputText = _inputBuffer.Text;
-        _frameSnapshotLineCount = lineSnapshot.Count;
-        _frameSnapshotSize = Bounds.Size;
+        _frameSnapshotPrompt = prompt;
+        _frameSnapshotAppended = _viewModel.Lines.TotalAppended;
+        _frameSnapshotSize = size;
 
-        _promptSnapshot = null;
-        DrawOutputSelection(context, frame);
+        TerminalFrameDamage damage = TerminalLayoutEngine.ComputeDamage(_renderedFrame, frame);
+        _renderedFrame = frame;
 
+        int rowsUpdated = UpdateOutputRows(frame, damage);
+        UpdatePromptRow(frame, damage);
+        TerminalMetrics.RecordFrame(Stopwatch.GetElapsedTime(frameStart), rowsUpdated);
+    }
+
+    private int UpdateOutputRows(TerminalFrameLayout frame, TerminalFrameDamage damage)
+    {
+        if (!damage.IsFullRepaint)
+        {
+            ShiftOutputRows(damage.ScrolledRows);
+        }
+
+        var instructions = new List<TerminalDrawInstruction>(frame.VisibleOutputLineCount);
+        foreach (TerminalDrawInstruction instruction in frame.Instructions)
+        {
+            if (!instruction.IsPromptLine)
+            {
+                instructions.Add(instruction);
+            }
+        }
+
+        RemoveOutputRows(instructions.Count);
+        while (_outputRows.Count < instructions.Count)
+        {
+            var row = new TerminalRowVisual(this);
+            _outputRows.Add(row);
+            VisualChildren.Add(row);
+        }
+
+        bool hasSelection = _outputSelection.TryGetRange(out int selectionStart, out int selectionEnd);
+        long firstLineNumber = _viewModel?.Lines.TotalEvicted ?? 0;
+        int nextChanged = 0;
+        int updated = 0;
+        for (int i = 0; i < instructions.Count; i++)
+        {
+            bool changed = damage.IsFullRepaint;
+            if (!changed && nextChanged < damage.ChangedOutputRows.Count && damage.ChangedOutputRows[nextChanged] == i)
+            {
+                changed = true;
+                nextChanged++;
+            }
+
+            if (changed)
+            {
+                updated++;
+            }
+
+            TerminalDrawInstruction instruction = instructions[i];
+            bool selected = hasSelection
+                && instruction.LogicalLineIndex >= selectionStart
+                && instruction.LogicalLineIndex <= selectionEnd;
+
+            IBrush? highlight = selected
+                ? _renderConfig.OutputSelectionBrush
+                : _search is not null && _search.IsMatch(firstLineNumber + instruction.LogicalLineIndex)
+                    ? _renderConfig.SearchMatchBrush
+                    : null;
+
+            _outputRows[i].SetOutput(instruction, highlight, changed);
+        }
+
+        return updated;
+    }
+
+    // Rows that scrolled keep their recorded content; the rows that scrolled out are reused for the
+    // newly exposed lines, which the damage always reports as changed.
+    private void ShiftOutputRows(int scrolledRows)
+    {
+        int count = _outputRows.Count;
+        if (scrolledRows == 0 || Math.Abs(scrolledRows) >= count)
+        {
+            return;
+        }
+
+        if (scrolledRows > 0)
+        {
+            List<TerminalRowVisual> scrolledOut = _outputRows.GetRange(0, scrolledRows);
+            _outputRows.RemoveRange(0, scrolledRows);
+            _outputRows.AddRange(scrolledOut);
+        }
+        else
+        {
+            int shift = -scrolledRows;
+            List<TerminalRowVisual> scrolledOut = _outputRows.GetRange(count - shift, shift);
+            _outputRows.RemoveRange(count - shift, shift);
+            _outputRows.InsertRange(0, scrolledOut);
+        }
+    }
+
+    private void RemoveOutputRows(int keep)
+    {
+        while (_outputRows.Count > keep)
+        {
+            TerminalRowVisual row = _outputRows[^1];
+            _outputRows.RemoveAt(_outputRows.Count - 1);
+            VisualChildren.Remove(row);
+        }
+    }
+
+    private void UpdatePromptRow(TerminalFrameLayout frame, TerminalFrameDamage damage)
+    {
+        TerminalDrawInstruction? promptInstruction = null;
         foreach (TerminalDrawInstruction instruction in frame.Instructions)
         {
             if (instruction.IsPromptLine)
             {
-                DrawPromptLine(context, instruction);
-                continue;
+                promptInstruction = instruction;
             }
+        }
+
+        if (promptInstruction is null)
+        {
+            _promptRow.Clear();
+            return;
+        }
+
+        SelectionRange? selection = _inputBuffer.Selection;
+        var state = new PromptRenderState(
+            _inputBuffer.CaretIndex,
+            selection is { HasSelection: true } ? selection.Value.Start : 0,
+            selection is { HasSelection: true } ? selection.Value.Length : 0,
+            IsFocused);
 
-            DrawOutputLine(context, instruction);
+        bool changed = damage.IsFullRepaint || damage.PromptChanged || state != _renderedPromptState;
+        if (damage.IsFullRepaint || damage.PromptChanged)
+        {
+            _promptSnapshot = null;
         }
 
+        _renderedPromptState = state;
+        _promptRow.SetPrompt(promptInstruction, changed);
+    }
+
+    private void RenderOutputRow(DrawingContext context, TerminalDrawInstruction instruction, IBrush? highlight)
+    {
+        if (highlight is not null)
+        {
+            double width = Math.Max(0, Bounds.Width - _renderConfig.Padding.Left - _renderConfig.Padding.Right);
+            if (width > 0)
+            {
+                var rect = new Rect(_renderConfig.Padding.Left, instruction.Position.Y, width, _renderConfig.LineHeight);
+                context.DrawRectangle(highlight, null, rect);
+            }
+        }
+
+        DrawOutputLine(context, instruction);
+    }
+
+    private void RenderPromptRow(DrawingContext context, TerminalDrawInstruction instruction)
+    {
+        DrawPromptLine(context, instruction);
+
         if (IsFocused && _promptSnapshot is not null)
         {
             DrawCaret(context, _promptSnapshot);
@@ -353,11 +639,12 @@ public sealed class TerminalSurface : Control
             return;
         }
 
-        bool isPromptRtl = IsTextRtl(instruction.Run.LogicalText);
+        // The pipeline resolves the prompt's direction once per prompt, not per keystroke.
+        bool isPromptRtl = instruction.Run.IsRightToLeft == true;
         FlowDirection flow = isPromptRtl ? FlowDirection.RightToLeft : FlowDirection.LeftToRight;
 
         TextLayout layout = _renderConfig.CreateTextLayout(instruction.Run.LogicalText, instruction.Brush, flow);
-        var snapshot = new PromptLayoutSnapshot(layout, instruction.Position, instruction.Run.LogicalText, _viewModel.Prompt.Length);
+        var snapshot = new PromptLayoutSnapshot(layout, instruction.Position, instruction.Run.LogicalText, ActivePrompt.Length);
         _promptSnapshot = snapshot;
 
         DrawSelection(context, snapshot);
@@ -371,15 +658,29 @@ public sealed class TerminalSurface : Control
             return;
         }
 
-        bool isRtl = IsTextRtl(instruction.Run.VisualText);
-        FlowDirection flow = isRtl ? FlowDirection.RightToLeft : FlowDirection.LeftToRight;
+        // Runs are cached per line, so an unchanged line reuses its shaped layout across frames.
+        if (!_outputVisualCache.TryGetValue(instruction.Run, out OutputLineVisual visual))
+        {
+            bool isRtl = instruction.Run.IsRightToLeft ?? IsTextRtl(instruction.Run.VisualText);
+            FlowDirection flow = isRtl ? FlowDirection.RightToLeft : FlowDirection.LeftToRight;
+
+            // The layout is only needed to place ANSI backgrounds; width comes from the run's measurement.
+            TextLayout? layout = HasAnsiBackground(instruction.Run)
+                ? _renderConfig.CreateTextLayout(instruction.Run.VisualText, instruction.Brush, flow)
+                : null;
+            FormattedText formatted = _renderConfig.CreateFormattedText(instruction.Run.VisualText, instruction.Brush, flow);
+            ApplyAnsiForegroundStyles(formatted, instruction);
 
-        TextLayout layout = _renderConfig.CreateTextLayout(instruction.Run.VisualText, instruction.Brush, flow);
-        DrawAnsiBackgrounds(context, instruction, layout);
+            visual = new OutputLineVisual(layout, formatted);
+            _outputVisualCache.Set(instruction.Run, visual);
+        }
+
+        if (visual.Layout is not null)
+        {
+            DrawAnsiBackgrounds(context, instruction, visual.Layout);
+        }
 
-        FormattedText formatted = _renderConfig.CreateFormattedText(instruction.Run.VisualText, instruction.Brush, flow);
-        ApplyAnsiForegroundStyles(formatted, instruction);
-        context.DrawText(formatted, instruction.Position);
+        context.DrawText(visual.Text, instruction.Position);
     }
 
     private void DrawSelection(DrawingContext context, PromptLayoutSnapshot snapshot)
@@ -396,29 +697,17 @@ public sealed class TerminalSurface : Control
         }
     }
 
-    private void DrawOutputSelection(DrawingContext context, TerminalFrameLayout frame)
+    private bool HasAnsiBackground(VisualTextRun run)
     {
-        if (!_outputSelection.TryGetRange(out int selectionStart, out int selectionEnd))
-        {
-            return;
-        }
-
-        double width = Math.Max(0, Bounds.Width - _renderConfig.Padding.Left - _renderConfig.Padding.Right);
-        if (width <= 0)
+        foreach (AnsiStyleSpan span in run.StyleSpans)
         {
-            return;
-        }
-
-        foreach (TerminalDrawInstruction instruction in frame.Instructions)
-        {
-            if (instruction.IsPromptLine || instruction.LogicalLineIndex < selectionStart || instruction.LogicalLineIndex > selectionEnd)
+            if (_renderConfig.ResolveAnsiBackgroundBrush(run.Kind, span.Style) is not null)
             {
-                continue;
+                return true;
             }
-
-            var rect = new Rect(_renderConfig.Padding.Left, instruction.Position.Y, width, _renderConfig.LineHeight);
-            context.DrawRectangle(_renderConfig.OutputSelectionBrush, null, rect);
         }
+
+        return false;
     }
 
     private void DrawAnsiBackgrounds(DrawingContext context, TerminalDrawInstruction instruction, TextLayout layout)
@@ -546,9 +835,10 @@ public sealed class TerminalSurface : Control
 
         string input = _inputBuffer.Text;
         _inputBuffer.Clear();
+        ResetHistoryRecall();
         _scrollbackOffsetLines = 0;
         _outputSelection.Clear();
-        InvalidateVisual();
+        InvalidateFrame();
 
         if (string.IsNullOrWhiteSpace(input))
         {
@@ -558,6 +848,319 @@ public sealed class TerminalSurface : Control
         await _viewModel.SubmitInputAsync(input);
     }
 
+    /// <summary>
+    /// الموجّه الظاهر: موجّه الأوامر، أو في وضع البحث عدد المطابقات.
+    /// The prompt shown on the prompt line; while searching it shows the match count or the recalled command.
+    /// </summary>
+    private string ActivePrompt => _searchPrompt ?? _viewModel?.Prompt ?? string.Empty;
+
+    // The search prompt only changes on the UI thread, so a frame and its prompt snapshot agree on it.
+    private void UpdateSearchPrompt()
+    {
+        if (_search is null)
+        {
+            _searchPrompt = null;
+        }
+        else if (_search.Query.Length == 0)
+        {
+            _searchPrompt = $"{SearchPromptLabel}> ";
+        }
+        else
+        {
+            string progress = _search.IsSearching ? "…" : string.Empty;
+            _searchPrompt = $"{SearchPromptLabel} [{_search.MatchCount}{progress}]> ";
+        }
+    }
+
+    private void HandleInputEdited()
+    {
+        if (_search is not null)
+        {
+            RestartSearch();
+            return;
+        }
+
+        if (_isHistorySearch)
+        {
+            RestartHistorySearch();
+            return;
+        }
+
+        ResetHistoryRecall();
+        _scrollbackOffsetLines = 0;
+    }
+
+    /// <summary>
+    /// يستدعي الأمر السابق أو التالي الذي يبدأ بالنص المكتوب.
+    /// Recalls the previous or next command that starts with the text typed before the first recall.
+    /// </summary>
+    private void RecallHistory(bool older)
+    {
+        if (_viewModel is null)
+        {
+            return;
+        }
+
+        CommandHistory history = _viewModel.History;
+        _historyRecallPrefix ??= _commandInput.Text;
+        int from = _historyRecallIndex < 0 ? history.Count : _historyRecallIndex;
+        int match = history.FindPrefix(_historyRecallPrefix, from, older);
+        if (match >= 0)
+        {
+            _historyRecallIndex = match;
+            ReplaceCommandInput(history[match]);
+        }
+        else if (!older && _historyRecallIndex >= 0)
+        {
+            // Stepping past the newest match returns to the text as typed.
+            ReplaceCommandInput(_historyRecallPrefix);
+            ResetHistoryRecall();
+        }
+    }
+
+    private void ResetHistoryRecall()
+    {
+        _historyRecallIndex = -1;
+        _historyRecallPrefix = null;
+    }
+
+    private void ReplaceCommandInput(string text)
+    {
+        _commandInput.Clear();
+        _commandInput.InsertText(text);
+        _scrollbackOffsetLines = 0;
+    }
+
+    private void BeginHistorySearch()
+    {
+        if (_viewModel is null)
+        {
+            return;
+        }
+
+        // Ctrl+R again steps to the next older match, as in readline.
+        if (_isHistorySearch)
+        {
+            MoveToHistoryMatch(older: true);
+            return;
+        }
+
+        EndSearch();
+        _isHistorySearch = true;
+        _inputBuffer = _historyQuery;
+        _historyQuery.Clear();
+        RestartHistorySearch();
+        _frameSnapshot = null;
+        _promptSnapshot = null;
+        InvalidateFrame();
+    }
+
+    private void EndHistorySearch(bool accept)
+    {
+        if (!_isHistorySearch)
+        {
+            return;
+        }
+
+        if (accept && _historyMatch >= 0 && _viewModel is not null)
+        {
+            ReplaceCommandInput(_viewModel.History[_historyMatch]);
+        }
+
+        _isHistorySearch = false;
+        _historyMatch = -1;
+        _inputBuffer = _commandInput;
+        ResetHistoryRecall();
+        UpdateSearchPrompt();
+        _frameSnapshot = null;
+        _promptSnapshot = null;
+        InvalidateFrame();
+    }
+
+    private void RestartHistorySearch()
+    {
+        string query = _historyQuery.Text;
+        CommandHistory? history = _viewModel?.History;
+        _historyMatch = history is null || query.Length == 0 ? -1 : history.FindContaining(query, history.Count);
+        if (_historyMatch < 0 && history is not null && query.Length > 0)
+        {
+            // No command contains the query as typed; offer the closest one so a typo still finds it.
+            IReadOnlyList<int> fuzzy = history.FindFuzzy(query, maxResults: 1);
+            _historyMatch = fuzzy.Count > 0 ? fuzzy[0] : -1;
+        }
+
+        UpdateHistorySearchPrompt();
+    }
+
+    private void MoveToHistoryMatch(bool older)
+    {
+        CommandHistory? history = _viewModel?.History;
+        string query = _historyQuery.Text;
+        if (history is null || query.Length == 0)
+        {
+            return;
+        }
+
+        int from = _historyMatch < 0 ? history.Count : _historyMatch;
+        int match = history.FindContaining(query, from, older);
+        if (match < 0)
+        {
+            return;
+        }
+
+        _historyMatch = match;
+        UpdateHistorySearchPrompt();
+        _frameSnapshot = null;
+        _promptSnapshot = null;
+        InvalidateFrame();
+    }
+
+    private void UpdateHistorySearchPrompt()
+    {
+        if (_historyQuery.Length == 0)
+        {
+            _searchPrompt = $"{HistorySearchPromptLabel}> ";
+        }
+        else if (_historyMatch < 0 || _viewModel is null)
+        {
+            _searchPrompt = $"{HistorySearchPromptLabel} [0]> ";
+        }
+        else
+        {
+            _searchPrompt = $"{HistorySearchPromptLabel} [{_viewModel.History[_historyMatch]}]> ";
+        }
+    }
+
+    private void BeginSearch()
+    {
+        if (_viewModel is null)
+        {
+            return;
+        }
+
+        if (_search is null)
+        {
+            _search = new ScrollbackSearch(_viewModel.Lines);
+            _search.MatchesChanged += HandleSearchMatchesChanged;
+            _inputBuffer = _searchInput;
+
+            // The previous query is kept, selected so typing replaces it.
+            RestartSearch();
+        }
+
+        UpdateSearchPrompt();
+
+        _searchInput.SelectAll();
+        _frameSnapshot = null;
+        _promptSnapshot = null;
+        InvalidateFrame();
+    }
+
+    private void EndSearch()
+    {
+        if (_search is null)
+        {
+            return;
+        }
+
+        _search.MatchesChanged -= HandleSearchMatchesChanged;
+        _search.Dispose();
+        _search = null;
+        _searchMatchLine = null;
+        _inputBuffer = _commandInput;
+        UpdateSearchPrompt();
+        _frameSnapshot = null;
+        _promptSnapshot = null;
+        InvalidateFrame();
+    }
+
+    private void RestartSearch()
+    {
+        _search?.Start(_searchInput.Text);
+        _searchMatchLine = null;
+        _outputSelection.Clear();
+        UpdateSearchPrompt();
+    }
+
+    private void MoveToSearchMatch(bool older)
+    {
+        if (_search is null)
+        {
+            return;
+        }
+
+        // Without a current match both directions start from the prompt; past the last match they wrap.
+        long from = _searchMatchLine ?? long.MaxValue;
+        if (_search.TryFindMatch(from, older, out ScrollbackMatch match)
+            || _search.TryFindMatch(older ? long.MaxValue : long.MinValue, older, out match))
+        {
+            ShowSearchMatch(match);
+        }
+    }
+
+    private void ShowSearchMatch(ScrollbackMatch match)
+    {
+        if (_viewModel is null)
+        {
+            return;
+        }
+
+        ScrollbackBuffer lines = _viewModel.Lines;
+        long index = match.LineNumber - lines.TotalEvicted;
+        if (index < 0 || index >= lines.Count)
+        {
+            return;
+        }
+
+        int lineIndex = (int)index;
+        _searchMatchLine = match.LineNumber;
+        _outputSelection.BeginOrExtend(lineIndex, extendSelection: false);
+
+        if (TryGetFrameSnapshot(out TerminalFrameLayout frame)
+            && !frame.Instructions.Any(x => !x.IsPromptLine && x.LogicalLineIndex == lineIndex))
+        {
+            // The offset counts rows hidden below the view; place the line's first row mid-view.
+            int rowsFromTail = _layoutEngine.CountTrailingRows(lines, lines.Count - lineIndex, Bounds.Size, _renderConfig, _textPipeline);
+            int target = rowsFromTail - 1 - (frame.MaxVisibleOutputLines / 2);
+            _scrollbackOffsetLines = Math.Clamp(target, 0, frame.MaxScrollbackOffsetLines);
+        }
+
+        _frameSnapshot = null;
+        _promptSnapshot = null;
+        InvalidateFrame();
+    }
+
+    private void HandleSearchMatchesChanged(object? sender, EventArgs e)
+    {
+        // Raised on the search thread once per batch; a burst of batches becomes one UI update.
+        if (Interlocked.Exchange(ref _searchRefreshPosted, 1) == 0)
+        {
+            Dispatcher.UIThread.Post(ApplySearchResults);
+        }
+    }
+
+    private void ApplySearchResults()
+    {
+        Volatile.Write(ref _searchRefreshPosted, 0);
+        if (_search is null)
+        {
+            return;
+        }
+
+        UpdateSearchPrompt();
+
+        // Lines are searched newest first, so the first match reported is the one nearest the prompt.
+        if (_searchMatchLine is null && _search.TryFindMatch(long.MaxValue, older: true, out ScrollbackMatch match))
+        {
+            ShowSearchMatch(match);
+            return;
+        }
+
+        _frameSnapshot = null;
+        _promptSnapshot = null;
+        InvalidateFrame();
+    }
+
     private void MoveCaretVisual(bool moveLeft, bool extendSelection)
     {
         if (!TryGetPromptSnapshot(out PromptLayoutSnapshot snapshot) || snapshot.Layout.TextLines.Count == 0)
@@ -695,7 +1298,7 @@ public sealed class TerminalSurface : Control
         int inputIndex = snapshot.GetInputIndexFromPoint(point);
         _inputBuffer.SetCaretFromLogicalIndex(inputIndex, extendSelection);
         _scrollbackOffsetLines = 0;
-        InvalidateVisual();
+        InvalidateFrame();
         return true;
     }
 
@@ -708,7 +1311,8 @@ public sealed class TerminalSurface : Control
             return false;
         }
 
-        string expectedText = string.Concat(_viewModel.Prompt, _inputBuffer.Text);
+        string prompt = ActivePrompt;
+        string expectedText = string.Concat(prompt, _inputBuffer.Text);
         if (_promptSnapshot is not null && _promptSnapshot.LogicalText == expectedText)
         {
             snapshot = _promptSnapshot;
@@ -726,11 +1330,11 @@ public sealed class TerminalSurface : Control
             return false;
         }
 
-        bool isPromptRtl = IsTextRtl(promptInstruction.Run.LogicalText);
+        bool isPromptRtl = promptInstruction.Run.IsRightToLeft == true;
         FlowDirection flow = isPromptRtl ? FlowDirection.RightToLeft : FlowDirection.LeftToRight;
 
         TextLayout layout = _renderConfig.CreateTextLayout(promptInstruction.Run.LogicalText, promptInstruction.Brush, flow);
-        _promptSnapshot = new PromptLayoutSnapshot(layout, promptInstruction.Position, promptInstruction.Run.LogicalText, _viewModel.Prompt.Length);
+        _promptSnapshot = new PromptLayoutSnapshot(layout, promptInstruction.Position, promptInstruction.Run.LogicalText, prompt.Length);
 
         snapshot = _promptSnapshot;
         return true;
@@ -756,7 +1360,7 @@ public sealed class TerminalSurface : Control
         }
 
         _outputSelection.BeginOrExtend(lineIndex, extendSelection);
-        InvalidateVisual();
+        InvalidateFrame();
         return true;
     }
 
@@ -773,7 +1377,7 @@ public sealed class TerminalSurface : Control
         }
 
         _outputSelection.UpdateActive(lineIndex);
-        InvalidateVisual();
+        InvalidateFrame();
     }
 
     private bool TryGetOutputLineIndexFromPoint(Point point, TerminalFrameLayout frame, out int lineIndex)
@@ -809,9 +1413,11 @@ public sealed class TerminalSurface : Control
             return false;
         }
 
+        string prompt = ActivePrompt;
         bool isSnapshotCurrent = _frameSnapshot is not null
             && _frameSnapshotInputText == _inputBuffer.Text
-            && _frameSnapshotLineCount == _viewModel.Lines.Count
+            && _frameSnapshotPrompt == prompt
+            && _frameSnapshotAppended == _viewModel.Lines.TotalAppended
             && _frameSnapshotSize == Bounds.Size
             && _frameSnapshot.ScrollbackOffsetLines == _scrollbackOffsetLines;
 
@@ -821,10 +1427,10 @@ public sealed class TerminalSurface : Control
             return true;
         }
 
-        IReadOnlyList<TerminalLine> lineSnapshot = [.. _viewModel.Lines];
+        IReadOnlyList<TerminalLine> lineSnapshot = _viewModel.Lines;
         frame = _layoutEngine.BuildFrameLayout(
             lineSnapshot,
-            _viewModel.Prompt,
+            prompt,
             _inputBuffer.Text,
             Bounds.Size,
             _renderConfig,
@@ -833,7 +1439,8 @@ public sealed class TerminalSurface : Control
 
         _frameSnapshot = frame;
         _frameSnapshotInputText = _inputBuffer.Text;
-        _frameSnapshotLineCount = lineSnapshot.Count;
+        _frameSnapshotPrompt = prompt;
+        _frameSnapshotAppended = _viewModel.Lines.TotalAppended;
         _frameSnapshotSize = Bounds.Size;
         _scrollbackOffsetLines = frame.ScrollbackOffsetLines;
         return true;
@@ -868,7 +1475,7 @@ public sealed class TerminalSurface : Control
         _scrollbackOffsetLines = clamped;
         _promptSnapshot = null;
         _frameSnapshot = null;
-        InvalidateVisual();
+        InvalidateFrame();
     }
 
     private async Task CopySelectionAsync()
@@ -877,7 +1484,7 @@ public sealed class TerminalSurface : Control
 
         if (_outputSelection.HasSelection && _viewModel is not null)
         {
-            selected = _outputSelection.GetSelectedText([.. _viewModel.Lines]);
+            selected = _outputSelection.GetSelectedText(_viewModel.Lines);
         }
         else if (_inputBuffer.HasSelection)
         {
@@ -919,6 +1526,14 @@ public sealed class TerminalSurface : Control
 
         await clipboard.SetTextAsync(selected);
         _inputBuffer.DeleteSelectionIfAny();
+        if (_search is not null)
+        {
+            RestartSearch();
+        }
+        else if (_isHistorySearch)
+        {
+            RestartHistorySearch();
+        }
     }
 
     private async Task PasteClipboardAsync()
@@ -937,7 +1552,7 @@ public sealed class TerminalSurface : Control
 
         _outputSelection.Clear();
         _inputBuffer.InsertText(text);
-        _scrollbackOffsetLines = 0;
+        HandleInputEdited();
     }
 
     private static int ToFullIndex(CharacterHit hit)
@@ -945,7 +1560,7 @@ public sealed class TerminalSurface : Control
         return hit.FirstCharacterIndex + Math.Max(0, hit.TrailingLength);
     }
 
-    private static bool IsTextRtl(string logical)
+    private bool IsTextRtl(string logical)
     {
         if (string.IsNullOrWhiteSpace(logical))
         {
@@ -954,8 +1569,9 @@ public sealed class TerminalSurface : Control
 
         try
         {
-            var runs = BidiAlgorithm.ProcessRuns(logical, -1);
-            return runs.Count > 0 && (runs[0].Level % 2 != 0);
+            // Runs on every repaint; the shared workspace keeps level resolution allocation-free.
+            _bidiParagraph.Process(logical, -1);
+            return _bidiParagraph.Levels[0] % 2 != 0;
         }
         catch
         {
@@ -967,19 +1583,102 @@ public sealed class TerminalSurface : Control
     {
         if (_viewModel is not null)
         {
-            int currentCount = _viewModel.Lines.Count;
-            int delta = currentCount - _lastKnownLineCount;
+            // A full scrollback keeps Count constant, so measure growth and eviction by totals.
+            ScrollbackBuffer lines = _viewModel.Lines;
+            int appended = (int)Math.Min(lines.TotalAppended - _lastKnownAppended, int.MaxValue);
+            int evicted = (int)Math.Min(lines.TotalEvicted - _lastKnownEvicted, int.MaxValue);
 
-            if (delta > 0 && _scrollbackOffsetLines > 0)
+            if (appended > 0 && _scrollbackOffsetLines > 0)
             {
-                _scrollbackOffsetLines += delta;
+                // The offset counts rows from the tail; wrapped lines push the view up by several.
+                _scrollbackOffsetLines += _layoutEngine.CountTrailingRows(lines, appended, Bounds.Size, _renderConfig, _textPipeline);
             }
 
-            _lastKnownLineCount = currentCount;
+            _outputSelection.ShiftForEviction(evicted);
+            _lastKnownAppended = lines.TotalAppended;
+            _lastKnownEvicted = lines.TotalEvicted;
+            _search?.Append();
         }
 
         _frameSnapshot = null;
         _promptSnapshot = null;
-        InvalidateVisual();
+        InvalidateFrame();
+    }
+
+    private sealed record OutputLineVisual(TextLayout? Layout, FormattedText Text);
+
+    private readonly record struct PromptRenderState(int CaretIndex, int SelectionStart, int SelectionLength, bool IsFocused);
+
+    /// <summary>
+    /// صف واحد محفوظ من سطح الطرفية.
+    /// One retained row of the terminal surface. It keeps its recorded drawing until its content changes;
+    /// moving it to another row only re-arranges it.
+    /// </summary>
+    private sealed class TerminalRowVisual : Control
+    {
+        private readonly TerminalSurface _owner;
+        private TerminalDrawInstruction? _instruction;
+        private IBrush? _highlight;
+
+        public TerminalRowVisual(TerminalSurface owner)
+        {
+            _owner = owner;
+            IsHitTestVisible = false;
+        }
+
+        /// <summary>
+        /// The row's top edge on the surface.
+        /// </summary>
+        public double Top => _instruction?.Position.Y ?? 0;
+
+        public void SetOutput(TerminalDrawInstruction instruction, IBrush? highlight, bool changed)
+        {
+            changed |= !ReferenceEquals(highlight, _highlight) || _instruction is null || !ReferenceEquals(_instruction.Run, instruction.Run);
+            _instruction = instruction;
+            _highlight = highlight;
+            if (changed)
+            {
+                InvalidateVisual();
+            }
+        }
+
+        public void SetPrompt(TerminalDrawInstruction instruction, bool changed)
+        {
+            _instruction = instruction;
+            if (changed)
+            {
+                InvalidateVisual();
+            }
+        }
+
+        public void Clear()
+        {
+            if (_instruction is not null)
+            {
+                _instruction = null;
+                InvalidateVisual();
+            }
+        }
+
+        public override void Render(DrawingContext context)
+        {
+            if (_instruction is null)
+            {
+                return;
+            }
+
+            // Instructions are in surface coordinates; draw them relative to this row.
+            using (context.PushTransform(Matrix.CreateTranslation(0, -_instruction.Position.Y)))
+            {
+                if (_instruction.IsPromptLine)
+                {
+                    _owner.RenderPromptRow(context, _instruction);
+                }
+                else
+                {
+                    _owner.RenderOutputRow(context, _instruction, _highlight);
+                }
+            }
+        }
     }
 }
@@ -1,3 +1,5 @@
+using System.Globalization;
+using System.Text;
 using ArbSh.Core.I18n;
 using ArbSh.Terminal.Models;
 
@@ -11,6 +13,14 @@ public sealed class TerminalTextPipeline
 {
     private readonly ITextMeasurer _measurer;
     private readonly AnsiSgrParser _ansiParser = new();
+    private readonly BidiParagraph _wrapBidiParagraph = new();
+
+    // The prompt itself changes rarely; it is analyzed once and each edit only analyzes the input.
+    private string? _lastPrompt;
+    private TerminalRenderConfig? _lastPromptConfig;
+    private PromptPart? _promptPart;
+    private string? _lastInput;
+    private VisualTextRun? _lastPromptRun;
 
     /// <summary>
     /// ينشئ معالج النص مع مقياس العرض المطلوب.
@@ -19,7 +29,7 @@ public sealed class TerminalTextPipeline
     /// <param name="measurer">مقياس النص (اختياري).</param>
     public TerminalTextPipeline(ITextMeasurer? measurer = null)
     {
-        _measurer = measurer ?? new AvaloniaTextMeasurer();
+        _measurer = measurer ?? new CachedTextMeasurer();
     }
 
     /// <summary>
@@ -44,6 +54,9 @@ public sealed class TerminalTextPipeline
     /// <summary>
     /// يبني سطرًا مرئيًا لسطر الموجه والمدخلات الحالية.
     /// Builds a visual run for prompt + current input buffer.
+    /// The prompt is rebuilt on every repaint, so an unchanged prompt and input reuse the previous run.
+    /// The prompt part is parsed, scanned and measured once; after an edit only the input is scanned
+    /// for Arabic and measured, and the run's direction comes from the prompt's first strong character.
     /// </summary>
     /// <param name="promptLogical">نص الموجه المنطقي.</param>
     /// <param name="inputLogical">نص الإدخال المنطقي.</param>
@@ -51,8 +64,268 @@ public sealed class TerminalTextPipeline
     /// <returns>بيانات السطر المرئي للموجه.</returns>
     public VisualTextRun BuildPromptRun(string promptLogical, string inputLogical, TerminalRenderConfig config)
     {
-        string logical = string.Concat(promptLogical ?? string.Empty, inputLogical ?? string.Empty);
-        return BuildVisualRun(logical, TerminalLineKind.Input, config);
+        string prompt = promptLogical ?? string.Empty;
+        string input = inputLogical ?? string.Empty;
+
+        if (_lastPromptRun is not null
+            && ReferenceEquals(config, _lastPromptConfig)
+            && string.Equals(prompt, _lastPrompt, StringComparison.Ordinal)
+            && string.Equals(input, _lastInput, StringComparison.Ordinal))
+        {
+            return _lastPromptRun;
+        }
+
+        if (_promptPart is null
+            || !ReferenceEquals(config, _lastPromptConfig)
+            || !string.Equals(prompt, _lastPrompt, StringComparison.Ordinal))
+        {
+            _promptPart = BuildPromptPart(prompt, config);
+            _lastPrompt = prompt;
+            _lastPromptConfig = config;
+        }
+
+        string logical = string.Concat(prompt, input);
+        VisualTextRun run;
+        if (_promptPart.CanAppendInput && input.AsSpan().IndexOf('\u001B') < 0)
+        {
+            bool hasArabic = _promptPart.Run.HasArabic || BiDiTextProcessor.ContainsArabicText(input);
+            double inputWidth = input.Length == 0 ? 0 : _measurer.MeasureWidth(ToVisual(input, hasArabic), config);
+            run = new VisualTextRun(
+                logical,
+                ToVisual(logical, hasArabic),
+                hasArabic,
+                _promptPart.Run.MeasuredWidth + inputWidth,
+                TerminalLineKind.Input,
+                _ansiParser.Parse(logical).StyleSpans,
+                _promptPart.IsRightToLeft ?? FindFirstStrongIsRtl(logical) ?? false);
+        }
+        else
+        {
+            // Escapes in the prompt or input can style across the join, so the line is analyzed as a whole.
+            run = BuildVisualRun(logical, TerminalLineKind.Input, config);
+            run = run with { IsRightToLeft = FindFirstStrongIsRtl(run.VisualText) ?? false };
+        }
+
+        _lastInput = input;
+        _lastPromptRun = run;
+        return run;
+    }
+
+    private PromptPart BuildPromptPart(string prompt, TerminalRenderConfig config)
+    {
+        VisualTextRun run = BuildVisualRun(prompt, TerminalLineKind.Input, config);
+
+        // The input is measured on its own only where the join cannot change shaping or kerning:
+        // after whitespace (or an empty prompt) and with no escapes that could style the input.
+        bool canAppendInput = prompt.AsSpan().IndexOf('\u001B') < 0
+            && (prompt.Length == 0 || char.IsWhiteSpace(prompt[^1]));
+
+        return new PromptPart(run, FindFirstStrongIsRtl(run.VisualText), canAppendInput);
+    }
+
+    // UAX #9 P2/P3: the first strong character outside isolates gives the paragraph direction,
+    // or null when there is none. For the prompt this is found in the prompt text itself.
+    private static bool? FindFirstStrongIsRtl(ReadOnlySpan<char> text)
+    {
+        int isolateDepth = 0;
+        foreach (Rune rune in text.EnumerateRunes())
+        {
+            switch (BidiAlgorithm.GetCharType(rune.Value))
+            {
+                case BidiCharacterType.LRI or BidiCharacterType.RLI or BidiCharacterType.FSI:
+                    isolateDepth++;
+                    break;
+                case BidiCharacterType.PDI when isolateDepth > 0:
+                    isolateDepth--;
+                    break;
+                case BidiCharacterType.L when isolateDepth == 0:
+                    return false;
+                case BidiCharacterType.R or BidiCharacterType.AL when isolateDepth == 0:
+                    return true;
+            }
+        }
+
+        return null;
+    }
+
+    /// <summary>
+    /// يقسم سطرًا مرئيًا إلى صفوف يتسع كل منها في العرض المتاح.
+    /// Splits a visual run into rows that fit the available width. A row breaks after the last whitespace
+    /// that fits, or at a grapheme boundary when a word is wider than a row, so clusters and combining marks
+    /// are never split. Rows keep the line's base direction and their slice of the ANSI style spans.
+    /// </summary>
+    /// <param name="run">السطر المرئي.</param>
+    /// <param name="maxWidth">العرض المتاح للصف.</param>
+    /// <param name="config">إعدادات الرسم.</param>
+    /// <returns>صفوف السطر، أو السطر نفسه إذا كان يتسع.</returns>
+    public IReadOnlyList<VisualTextRun> WrapVisualRun(VisualTextRun run, double maxWidth, TerminalRenderConfig config)
+    {
+        ArgumentNullException.ThrowIfNull(run);
+
+        string text = run.VisualText;
+        if (run.MeasuredWidth <= maxWidth || text.Length < 2)
+        {
+            return [run];
+        }
+
+        int[] boundaries = GetGraphemeBoundaries(text);
+        int graphemes = boundaries.Length - 1;
+        if (graphemes < 2)
+        {
+            return [run];
+        }
+
+        bool isRtl = IsRightToLeft(text);
+        double averageAdvance = run.MeasuredWidth / graphemes;
+        var rows = new List<VisualTextRun>();
+        for (int first = 0; first < graphemes;)
+        {
+            int last = FindRowEnd(text, boundaries, first, maxWidth, averageAdvance, config);
+            last = MoveToWhitespaceBreak(text, boundaries, first, last);
+            rows.Add(SliceRun(run, boundaries[first], boundaries[last], isRtl, config));
+            first = last;
+        }
+
+        return rows;
+    }
+
+    // Returns the last grapheme boundary after `first` whose row still fits (at least one grapheme).
+    // It gallops from an estimate based on the line's average advance, so only a few row-sized
+    // slices are measured per row.
+    private int FindRowEnd(string text, int[] boundaries, int first, double maxWidth, double averageAdvance, TerminalRenderConfig config)
+    {
+        int end = boundaries.Length - 1;
+        int estimate = (int)Math.Min(end - first, Math.Max(1, maxWidth / Math.Max(averageAdvance, double.Epsilon)));
+        int fits = first + 1;
+        int overflows = first + estimate;
+
+        if (RowFits(text, boundaries, first, overflows, maxWidth, config))
+        {
+            fits = overflows;
+            int step = estimate;
+            while (true)
+            {
+                if (fits == end)
+                {
+                    return end;
+                }
+
+                overflows = Math.Min(end, fits + step);
+                if (!RowFits(text, boundaries, first, overflows, maxWidth, config))
+                {
+                    break;
+                }
+
+                fits = overflows;
+                step *= 2;
+            }
+        }
+        else if (overflows == fits || !RowFits(text, boundaries, first, fits, maxWidth, config))
+        {
+            return fits;
+        }
+
+        while (overflows - fits > 1)
+        {
+            int mid = fits + ((overflows - fits) >> 1);
+            if (RowFits(text, boundaries, first, mid, maxWidth, config))
+            {
+                fits = mid;
+            }
+            else
+            {
+                overflows = mid;
+            }
+        }
+
+        return fits;
+    }
+
+    private bool RowFits(string text, int[] boundaries, int first, int last, double maxWidth, TerminalRenderConfig config)
+    {
+        string row = text.Substring(boundaries[first], boundaries[last] - boundaries[first]);
+        return _measurer.MeasureWidth(row, config) <= maxWidth;
+    }
+
+    // Keeps whitespace at the end of the row it follows (it takes no width) and otherwise moves the break
+    // back to just after the row's last whitespace, so words are only split when they do not fit a row.
+    private static int MoveToWhitespaceBreak(string text, int[] boundaries, int first, int last)
+    {
+        int end = boundaries.Length - 1;
+        if (last == end)
+        {
+            return last;
+        }
+
+        if (char.IsWhiteSpace(text[boundaries[last]]))
+        {
+            while (last < end && char.IsWhiteSpace(text[boundaries[last]]))
+            {
+                last++;
+            }
+
+            return last;
+        }
+
+        for (int candidate = last; candidate > first + 1; candidate--)
+        {
+            if (char.IsWhiteSpace(text[boundaries[candidate] - 1]))
+            {
+                return candidate;
+            }
+        }
+
+        return last;
+    }
+
+    private VisualTextRun SliceRun(VisualTextRun run, int start, int end, bool isRtl, TerminalRenderConfig config)
+    {
+        string text = run.VisualText[start..end];
+        var spans = new List<AnsiStyleSpan>();
+        foreach (AnsiStyleSpan span in run.StyleSpans)
+        {
+            int spanStart = Math.Max(span.Start, start);
+            int spanEnd = Math.Min(span.Start + span.Length, end);
+            if (spanEnd > spanStart)
+            {
+                spans.Add(span with { Start = spanStart - start, Length = spanEnd - spanStart });
+            }
+        }
+
+        double width = _measurer.MeasureWidth(text, config);
+        return new VisualTextRun(text, text, run.HasArabic, width, run.Kind, spans, isRtl);
+    }
+
+    private static int[] GetGraphemeBoundaries(string text)
+    {
+        var boundaries = new List<int>(text.Length + 1) { 0 };
+        for (int index = 0; index < text.Length;)
+        {
+            index += StringInfo.GetNextTextElementLength(text.AsSpan(index));
+            boundaries.Add(index);
+        }
+
+        return boundaries.ToArray();
+    }
+
+    // Same rule the surface applies to an unwrapped line, resolved once for the whole logical line.
+    // Text below U+0590 has no right-to-left characters, so it skips level resolution.
+    private bool IsRightToLeft(string text)
+    {
+        if (string.IsNullOrWhiteSpace(text) || text.AsSpan().IndexOfAnyInRange('\u0590', '\uFFFF') < 0)
+        {
+            return false;
+        }
+
+        try
+        {
+            _wrapBidiParagraph.Process(text, -1);
+            return _wrapBidiParagraph.Levels[0] % 2 != 0;
+        }
+        catch
+        {
+            return false;
+        }
     }
 
     private static string ToVisual(string logicalText, bool hasArabic)
@@ -71,4 +344,11 @@ public sealed class TerminalTextPipeline
         // Reordering here would cause a second BiDi pass and broken visual output.
         return logicalText;
     }
+
+    /// <summary>
+    /// جزء الموجه المحلل مرة واحدة.
+    /// The prompt analyzed once: its run, its paragraph direction if it has a strong character, and
+    /// whether input can be measured separately after it.
+    /// </summary>
+    private sealed record PromptPart(VisualTextRun Run, bool? IsRightToLeft, bool CanAppendInput);
 }
@@ -0,0 +1,241 @@
+namespace ArbSh.Terminal.Rendering;
+
+/// <summary>
+/// فهرس الالتفاف: مجاميع تراكمية لعدد الصفوف المرئية لكل سطر منطقي.
+/// Wrap index: a prefix sum of visual row counts per logical line.
+/// </summary>
+/// <remarks>
+/// Lines are appended at the tail and removed from the head, matching the scrollback buffer, so both
+/// are O(1) amortized. Mapping a row back to its line is a binary search over the prefix sums. The
+/// measured width of each line is kept so a resize can estimate rows without measuring or wrapping;
+/// estimated lines are corrected with <see cref="SetRowCount"/> when they are wrapped for display, and
+/// the prefix sums are rebuilt once from the first corrected line on the next read.
+/// </remarks>
+public sealed class TerminalWrapIndex
+{
+    private const int MinCompactedEntries = 4096;
+
+    // _rowEnds[i] is the cumulative row count through entry i; entries before _start were removed.
+    // Entries from _dirtyFrom on are stale and rebuilt from _rowCounts before the next read.
+    private readonly List<long> _rowEnds = [];
+    private readonly List<int> _rowCounts = [];
+    private readonly List<double> _widths = [];
+    private readonly List<bool> _estimated = [];
+    private long _baseRows;
+    private int _start;
+    private int _dirtyFrom = int.MaxValue;
+
+    /// <summary>
+    /// عدد الأسطر المفهرسة.
+    /// Number of indexed lines.
+    /// </summary>
+    public int LineCount => _rowEnds.Count - _start;
+
+    /// <summary>
+    /// إجمالي الصفوف المرئية للأسطر المفهرسة.
+    /// Total visual rows of the indexed lines.
+    /// </summary>
+    public int TotalRows => (int)(RowsBefore(LineCount) - RowsBefore(0));
+
+    /// <summary>
+    /// يضيف سطرًا في النهاية بعدد صفوف دقيق.
+    /// Appends a line at the tail with an exact row count.
+    /// </summary>
+    /// <param name="measuredWidth">العرض المقاس للسطر كاملاً.</param>
+    /// <param name="rowCount">عدد الصفوف التي يشغلها.</param>
+    public void Append(double measuredWidth, int rowCount)
+    {
+        ArgumentOutOfRangeException.ThrowIfLessThan(rowCount, 1);
+
+        _rowEnds.Add(RowsBefore(LineCount) + rowCount);
+        _rowCounts.Add(rowCount);
+        _widths.Add(measuredWidth);
+        _estimated.Add(false);
+    }
+
+    /// <summary>
+    /// يزيل أقدم الأسطر المفهرسة.
+    /// Removes the oldest indexed lines.
+    /// </summary>
+    /// <param name="count">عدد الأسطر المزالة.</param>
+    public void RemoveFirst(int count)
+    {
+        _start += Math.Clamp(count, 0, LineCount);
+
+        if (_start >= MinCompactedEntries && _start * 2 >= _rowEnds.Count)
+        {
+            _baseRows = RowsBefore(0);
+            _rowEnds.RemoveRange(0, _start);
+            _rowCounts.RemoveRange(0, _start);
+            _widths.RemoveRange(0, _start);
+            _estimated.RemoveRange(0, _start);
+            _start = 0;
+        }
+    }
+
+    /// <summary>
+    /// يفرغ الفهرس.
+    /// Removes all lines.
+    /// </summary>
+    public void Clear()
+    {
+        _rowEnds.Clear();
+        _rowCounts.Clear();
+        _widths.Clear();
+        _estimated.Clear();
+        _baseRows = 0;
+        _start = 0;
+        _dirtyFrom = int.MaxValue;
+    }
+
+    /// <summary>
+    /// يقدّر عدد الصفوف لكل سطر من عرضه المخزن بعد تغيير عرض الالتفاف، دون قياس.
+    /// Estimates the rows of every line from its stored width after the wrap width changed, without
+    /// measuring. A line that fits a row is exact; a wider one gets <c>ceil(width / wrapWidth)</c> rows
+    /// and stays estimated until <see cref="SetRowCount"/> corrects it.
+    /// </summary>
+    /// <param name="wrapWidth">عرض الالتفاف الجديد.</param>
+    public void Reflow(double wrapWidth)
+    {
+        long rows = RowsBefore(0);
+        for (int entry = _start; entry < _rowEnds.Count; entry++)
+        {
+            double width = _widths[entry];
+            bool fits = width <= wrapWidth;
+            int count = fits ? 1 : (int)Math.Clamp(Math.Ceiling(width / wrapWidth), 1, int.MaxValue);
+
+            rows += count;
+            _rowCounts[entry] = count;
+            _rowEnds[entry] = rows;
+            _estimated[entry] = !fits;
+        }
+
+        _dirtyFrom = int.MaxValue;
+    }
+
+    /// <summary>
+    /// هل عدد صفوف السطر تقديري.
+    /// Indicates whether a line's row count is an estimate.
+    /// </summary>
+    /// <param name="line">فهرس السطر.</param>
+    public bool IsEstimated(int line)
+    {
+        return _estimated[_start + CheckLine(line)];
+    }
+
+    /// <summary>
+    /// يثبت عدد الصفوف الدقيق لسطر بعد التفافه.
+    /// Records a line's exact row count once it has been wrapped.
+    /// </summary>
+    /// <param name="line">فهرس السطر.</param>
+    /// <param name="rowCount">عدد الصفوف الدقيق.</param>
+    public void SetRowCount(int line, int rowCount)
+    {
+        ArgumentOutOfRangeException.ThrowIfLessThan(rowCount, 1);
+
+        int entry = _start + CheckLine(line);
+        _estimated[entry] = false;
+        if (_rowCounts[entry] != rowCount)
+        {
+            _rowCounts[entry] = rowCount;
+            _dirtyFrom = Math.Min(_dirtyFrom, entry);
+        }
+    }
+
+    /// <summary>
+    /// يرجع العرض المقاس لسطر.
+    /// Gets the measured width of a line.
+    /// </summary>
+    /// <param name="line">فهرس السطر.</param>
+    public double GetMeasuredWidth(int line)
+    {
+        return _widths[_start + CheckLine(line)];
+    }
+
+    /// <summary>
+    /// يرجع فهرس أول صف للسطر.
+    /// Gets the index of the first row of a line.
+    /// </summary>
+    /// <param name="line">فهرس السطر.</param>
+    public int GetFirstRow(int line)
+    {
+        return (int)(RowsBefore(CheckLine(line)) - RowsBefore(0));
+    }
+
+    /// <summary>
+    /// يرجع عدد صفوف السطر.
+    /// Gets the number of rows of a line.
+    /// </summary>
+    /// <param name="line">فهرس السطر.</param>
+    public int GetRowCount(int line)
+    {
+        return _rowCounts[_start + CheckLine(line)];
+    }
+
+    /// <summary>
+    /// يجد السطر الذي يحتوي الصف المطلوب.
+    /// Finds the line that contains a row.
+    /// </summary>
+    /// <param name="row">فهرس الصف.</param>
+    /// <returns>فهرس السطر.</returns>
+    public int FindLine(int row)
+    {
+        if ((uint)row >= (uint)TotalRows)
+        {
+            throw new ArgumentOutOfRangeException(nameof(row));
+        }
+
+        long target = RowsBefore(0) + row;
+        int lo = _start;
+        int hi = _rowEnds.Count - 1;
+        while (lo < hi)
+        {
+            int mid = lo + ((hi - lo) >> 1);
+            if (_rowEnds[mid] > target)
+            {
+                hi = mid;
+            }
+            else
+            {
+                lo = mid + 1;
+            }
+        }
+
+        return lo - _start;
+    }
+
+    private long RowsBefore(int line)
+    {
+        RebuildPrefix();
+        int entry = _start + line;
+        return entry == 0 ? _baseRows : _rowEnds[entry - 1];
+    }
+
+    private void RebuildPrefix()
+    {
+        if (_dirtyFrom >= _rowEnds.Count)
+        {
+            _dirtyFrom = int.MaxValue;
+            return;
+        }
+
+        long rows = _dirtyFrom == 0 ? _baseRows : _rowEnds[_dirtyFrom - 1];
+        for (int entry = _dirtyFrom; entry < _rowEnds.Count; entry++)
+        {
+            rows += _rowCounts[entry];
+            _rowEnds[entry] = rows;
+        }
+
+        _dirtyFrom = int.MaxValue;
+    }
+
+    private int CheckLine(int line)
+    {
+        if ((uint)line >= (uint)LineCount)
+        {
+            throw new ArgumentOutOfRangeException(nameof(line));
+        }
+
+        return line;
+    }
+}
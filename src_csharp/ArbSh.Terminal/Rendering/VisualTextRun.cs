@@ -12,10 +12,12 @@ namespace ArbSh.Terminal.Rendering;
 /// <param name="MeasuredWidth">العرض المقاس للنص المرئي.</param>
 /// <param name="Kind">نوع السطر المنطقي.</param>
 /// <param name="StyleSpans">نطاقات تنسيق ANSI المحسوبة على النص المرئي.</param>
+/// <param name="IsRightToLeft">اتجاه السطر المنطقي كاملاً عندما يكون هذا صفًا من سطر ملتف أو سطر الموجه، أو null ليُحسب من النص.</param>
 public sealed record VisualTextRun(
     string LogicalText,
     string VisualText,
     bool HasArabic,
     double MeasuredWidth,
     TerminalLineKind Kind,
-    IReadOnlyList<AnsiStyleSpan> StyleSpans);
+    IReadOnlyList<AnsiStyleSpan> StyleSpans,
+    bool? IsRightToLeft = null);
@@ -1,21 +1,27 @@
-﻿using System.Collections.ObjectModel;
-using Avalonia.Threading;
+﻿using Avalonia.Threading;
 using ArbSh.Core;
 using ArbSh.Terminal.Models;
 
 namespace ArbSh.Terminal.ViewModels;
 
-public sealed class MainWindowViewModel
+public sealed class MainWindowViewModel : IDisposable
 {
     private const string ExitCommand = "اخرج";
+    private static readonly TimeSpan OutputDrainInterval = TimeSpan.FromMilliseconds(16);
     private readonly ShellSessionState _session;
-    private readonly ObservableCollection<TerminalLine> _lines = [];
-    private readonly ReadOnlyObservableCollection<TerminalLine> _readonlyLines;
+    private readonly ScrollbackBuffer _lines;
+    private readonly PendingOutputQueue _pendingOutput = new();
 
-    public MainWindowViewModel(string? initialWorkingDirectory = null)
+    public MainWindowViewModel(
+        string? initialWorkingDirectory = null,
+        int scrollbackCapacity = ScrollbackBuffer.DefaultCapacity,
+        string? historyPath = null)
     {
         _session = new ShellSessionState(initialWorkingDirectory);
-        _readonlyLines = new ReadOnlyObservableCollection<TerminalLine>(_lines);
+        _lines = new ScrollbackBuffer(scrollbackCapacity);
+        History = historyPath is null
+            ? new CommandHistory()
+            : CommandHistory.Open(historyPath, diagnostics: new TerminalExecutionSink(this));
         AddLine("مرحباً بكم في أربش - الواجهة الرسومية قيد البناء.", TerminalLineKind.System);
         AddLine($"المجلد الحالي: {_session.CurrentDirectory}", TerminalLineKind.System);
         AddLine("اكتب أمرًا واضغط Enter للتنفيذ.", TerminalLineKind.System);
@@ -25,10 +31,12 @@ public sealed class MainWindowViewModel
     public event EventHandler? BufferChanged;
     public event EventHandler? ExitRequested;
 
-    public ReadOnlyObservableCollection<TerminalLine> Lines => _readonlyLines;
+    public ScrollbackBuffer Lines => _lines;
 
     public string Prompt { get; } = "أربش> ";
 
+    public CommandHistory History { get; }
+
     public async Task SubmitInputAsync(string logicalInput, CancellationToken cancellationToken = default)
     {
         if (string.IsNullOrWhiteSpace(logicalInput))
@@ -37,6 +45,7 @@ public sealed class MainWindowViewModel
         }
 
         AddLine(logicalInput, TerminalLineKind.Input);
+        History.Add(logicalInput);
 
         string trimmedInput = logicalInput.Trim();
         if (string.Equals(trimmedInput, ExitCommand, StringComparison.Ordinal))
@@ -61,6 +70,11 @@ public sealed class MainWindowViewModel
         }
     }
 
+    public void Dispose()
+    {
+        History.Dispose();
+    }
+
     internal void PostLine(string message, TerminalLineKind kind)
     {
         if (string.IsNullOrWhiteSpace(message))
@@ -68,19 +82,45 @@ public sealed class MainWindowViewModel
             return;
         }
 
-        Dispatcher.UIThread.Post(() => AddLine(message, kind));
+        if (_pendingOutput.Enqueue(new TerminalLine(message, kind, DateTimeOffset.UtcNow)))
+        {
+            ScheduleOutputDrain();
+        }
+    }
+
+    private void ScheduleOutputDrain()
+    {
+        // One dispatcher message per frame: the timer drains everything written in the meantime.
+        Dispatcher.UIThread.Post(() => DispatcherTimer.RunOnce(DrainPendingOutput, OutputDrainInterval));
     }
 
-    private void AddLine(string text, TerminalLineKind kind)
+    private void DrainPendingOutput()
     {
-        _lines.Add(new TerminalLine(text, kind, DateTimeOffset.UtcNow));
+        // Lines beyond the scrollback capacity would be evicted in the same batch anyway.
+        int drained = _pendingOutput.DrainTo(_lines, _lines.Capacity);
 
-        const int maxLines = 5000;
-        while (_lines.Count > maxLines)
+        if (_pendingOutput.TryClaimDrain())
+        {
+            ScheduleOutputDrain();
+        }
+
+        if (drained > 0)
+        {
+            BufferChanged?.Invoke(this, EventArgs.Empty);
+        }
+    }
+
+    private void AddLine(string text, TerminalLineKind kind)
+    {
+        // Keep output already written by a command ahead of lines added directly on the UI thread.
+        // A drain already scheduled stays claimed, so this never queues a second one.
+        _pendingOutput.FlushTo(_lines, _lines.Capacity);
+        if (_pendingOutput.TryClaimDrain())
         {
-            _lines.RemoveAt(0);
+            ScheduleOutputDrain();
         }
 
+        _lines.Append(new TerminalLine(text, kind, DateTimeOffset.UtcNow));
         BufferChanged?.Invoke(this, EventArgs.Empty);
     }
 
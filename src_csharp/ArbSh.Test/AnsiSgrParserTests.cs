@@ -43,4 +43,43 @@ public sealed class AnsiSgrParserTests
         Assert.Equal((byte)2, ySpan.Style.Background.Green);
         Assert.Equal((byte)3, ySpan.Style.Background.Blue);
     }
+
+    [Fact]
+    public void Parse_PlainText_ReturnsInputWithSingleDefaultSpan()
+    {
+        string source = "مرحبا plain 123";
+
+        ParsedTerminalText parsed = _parser.Parse(source);
+
+        Assert.Same(source, parsed.PlainText);
+        AnsiStyleSpan span = Assert.Single(parsed.StyleSpans);
+        Assert.Equal(new AnsiStyleSpan(0, source.Length, AnsiStyleState.Default), span);
+    }
+
+    [Theory]
+    [InlineData("\u001b[31xred", "\u001b[31xred")]
+    [InlineData("a\u001b[", "a\u001b[")]
+    [InlineData("\u001b[٣1mx", "\u001b[٣1mx")]
+    [InlineData("\u001b[99999999999mx", "\u001b[99999999999mx")]
+    [InlineData("\u001b[1;;4mx\u001b[m", "x")]
+    public void Parse_InvalidOrEmptyParameters_MatchSgrRules(string source, string expectedPlain)
+    {
+        ParsedTerminalText parsed = _parser.Parse(source);
+
+        Assert.Equal(expectedPlain, parsed.PlainText);
+        Assert.Equal(expectedPlain.Length, parsed.StyleSpans.Sum(span => span.Length));
+    }
+
+    [Fact]
+    public void Parse_ManySequences_KeepsEverySpan()
+    {
+        string source = string.Concat(Enumerable.Range(0, 40).Select(i => $"\u001b[{31 + i % 7}m{i % 10}"));
+
+        ParsedTerminalText parsed = _parser.Parse(source);
+
+        Assert.Equal(40, parsed.PlainText.Length);
+        Assert.Equal(40, parsed.StyleSpans.Count);
+        Assert.Equal(AnsiColorMode.Indexed16, parsed.StyleSpans[39].Style.Foreground.Mode);
+        Assert.Equal(1 + 39 % 7, parsed.StyleSpans[39].Style.Foreground.Index);
+    }
 }
@@ -1,3 +1,4 @@
+using System.Reflection;
 using ArbSh.Core;
 
 namespace ArbSh.Test;
@@ -52,4 +53,21 @@ public sealed class ArabicCommandSurfaceTests
         Assert.DoesNotContain("Test-Array-Binding", commands.Keys);
         Assert.DoesNotContain("Test-Type-Literal", commands.Keys);
     }
+
+    [Fact]
+    public void GetAllCommands_GeneratedTable_CoversEveryAttributedCmdlet()
+    {
+        IReadOnlyDictionary<string, Type> commands = CommandDiscovery.GetAllCommands();
+
+        IEnumerable<Type> attributedCmdlets = typeof(CmdletBase).Assembly.GetTypes()
+            .Where(t => t.IsSubclassOf(typeof(CmdletBase)) && !t.IsAbstract)
+            .Where(t => t.GetCustomAttribute<ArabicNameAttribute>() != null);
+
+        foreach (Type cmdletType in attributedCmdlets)
+        {
+            string name = cmdletType.GetCustomAttribute<ArabicNameAttribute>()!.Name;
+            Assert.True(commands.TryGetValue(name, out Type? registered), $"Missing generated entry for {cmdletType.FullName}.");
+            Assert.Equal(cmdletType, registered);
+        }
+    }
 }
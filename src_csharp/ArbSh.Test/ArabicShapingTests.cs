@@ -101,5 +101,44 @@ namespace ArbSh.Test.I18n
             Assert.Null(ArabicShaper.Shape(null!));
             Assert.Equal("", ArabicShaper.Shape(""));
         }
+
+        [Fact]
+        public void Shape_LamAlef_WritesSingleLigature()
+        {
+            // Lam(0644) + Alef(0627) -> isolated Lam-Alef; after Beh(0628) -> final Lam-Alef
+            Assert.Equal("\uFEFB", ArabicShaper.Shape("\u0644\u0627"));
+            Assert.Equal("\uFE91\uFEFC", ArabicShaper.Shape("\u0628\u0644\u0627"));
+        }
+
+        [Theory]
+        [InlineData("مرحبا بالعالم")]
+        [InlineData("Hello عالم 123")]
+        [InlineData("لا إله")]
+        public void Shape_Span_MatchesStringOverload(string input)
+        {
+            Span<char> destination = stackalloc char[input.Length];
+
+            int written = ArabicShaper.Shape(input, destination);
+
+            Assert.Equal(ArabicShaper.Shape(input), destination[..written].ToString());
+        }
+
+        [Fact]
+        public void Shape_Span_ShortDestination_Throws()
+        {
+            Assert.Throws<ArgumentException>(() => ArabicShaper.Shape("مرحبا".AsSpan(), new char[2]));
+        }
+
+        [Fact]
+        public void Shape_RepeatedInput_ReturnsSameResult()
+        {
+            string input = "السلام عليكم";
+
+            string first = ArabicShaper.Shape(input);
+            string second = ArabicShaper.Shape(new string(input.AsSpan()));
+
+            Assert.Equal(first, second);
+            Assert.Same(first, second);
+        }
     }
 }
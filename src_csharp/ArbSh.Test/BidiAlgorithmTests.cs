@@ -201,6 +201,53 @@ namespace ArbSh.Test.I18n
             Assert.Equal(BidiCharacterType.L, BidiAlgorithm.GetCharType(0x00E9));
         }
 
+        [Fact]
+        public void GetCharType_RepeatedLookups_ReturnSameTypeFromTable()
+        {
+            // First call populates the U+06xx table block, second is served from it.
+            Assert.Equal(BidiCharacterType.AL, BidiAlgorithm.GetCharType(0x0644));
+            Assert.Equal(BidiCharacterType.AL, BidiAlgorithm.GetCharType(0x0644));
+            Assert.Equal(BidiCharacterType.AN, BidiAlgorithm.GetCharType(0x0662));
+        }
+
+        // --- GetCharTypes (span) Tests ---
+
+        [Fact]
+        public void GetCharTypes_MixedText_MatchesPerCodepointLookup()
+        {
+            string text = "abc مرحبا 123 \u202B\u0661\u202C!\t\n";
+            var types = new BidiCharacterType[text.Length];
+
+            BidiAlgorithm.GetCharTypes(text, types);
+
+            for (int i = 0; i < text.Length; i++)
+            {
+                Assert.Equal(BidiAlgorithm.GetCharType(text[i]), types[i]);
+            }
+        }
+
+        [Fact]
+        public void GetCharTypes_SurrogatePair_BothUnitsShareCodepointType()
+        {
+            // U+10900 PHOENICIAN LETTER ALF -> Bidi_Class R
+            string text = "a" + char.ConvertFromUtf32(0x10900) + "b";
+            var types = new BidiCharacterType[text.Length];
+
+            BidiAlgorithm.GetCharTypes(text, types);
+
+            Assert.Equal(BidiCharacterType.L, types[0]);
+            Assert.Equal(BidiCharacterType.R, types[1]);
+            Assert.Equal(BidiCharacterType.R, types[2]);
+            Assert.Equal(BidiCharacterType.L, types[3]);
+        }
+
+        [Fact]
+        public void GetCharTypes_DestinationTooShort_Throws()
+        {
+            var types = new BidiCharacterType[2];
+            Assert.Throws<ArgumentException>(() => BidiAlgorithm.GetCharTypes("abc", types));
+        }
+
 
         // --- ProcessRuns Tests (Simplified for current placeholder implementation) ---
         // These tests assume the current placeholder ProcessRuns which includes basic P2/P3.
@@ -1095,5 +1142,84 @@ namespace ArbSh.Test.I18n
             // Should default to LTR since Hebrew is inside isolate
             Assert.True(runs.Any(r => r.Level == 0), "Should default to LTR base level");
         }
+
+        // --- BidiParagraph Workspace Tests ---
+
+        [Fact]
+        public void BidiParagraph_Levels_MatchProcessRuns()
+        {
+            string text = "abc \u05D0\u05D1 (123) \u0627\u0644";
+            List<BidiAlgorithm.BidiRun> expected = BidiAlgorithm.ProcessRuns(text, -1);
+
+            using var paragraph = new BidiParagraph();
+            paragraph.Process(text, -1);
+            var runs = new List<BidiAlgorithm.BidiRun>();
+            paragraph.GetRuns(runs);
+
+            Assert.Equal(text.Length, paragraph.Length);
+            Assert.Equal(expected.Select(r => (r.Start, r.Length, r.Level)), runs.Select(r => (r.Start, r.Length, r.Level)));
+        }
+
+        [Fact]
+        public void BidiParagraph_ReusedForShorterText_DoesNotLeakPreviousResults()
+        {
+            using var paragraph = new BidiParagraph();
+            paragraph.Process("\u05D0\u05D1\u05D2 \u2067abc\u2069 \u05D3\u05D4 (xyz) 456", -1);
+            Assert.Equal(1, paragraph.ParagraphLevel);
+
+            paragraph.Process("ab", -1);
+
+            Assert.Equal(0, paragraph.ParagraphLevel);
+            Assert.Equal(2, paragraph.Length);
+            Assert.Equal(new[] { 0, 0 }, paragraph.Levels.ToArray());
+        }
+
+        [Fact]
+        public void BidiParagraph_EmptyText_HasNoLevels()
+        {
+            using var paragraph = new BidiParagraph();
+            paragraph.Process("abc", 1);
+            paragraph.Process(ReadOnlySpan<char>.Empty, -1);
+
+            var runs = new List<BidiAlgorithm.BidiRun>();
+            paragraph.GetRuns(runs);
+
+            Assert.Equal(0, paragraph.Length);
+            Assert.Empty(runs);
+            Assert.Equal(string.Empty, paragraph.ReorderForDisplay(ReadOnlySpan<char>.Empty));
+        }
+
+        [Fact]
+        public void BidiParagraph_SurrogatePair_BothUnitsShareLevel()
+        {
+            // MATHEMATICAL BOLD CAPITAL A (U+1D400, L) embedded in an RTL paragraph
+            string text = "\u05D0 \U0001D400";
+
+            using var paragraph = new BidiParagraph();
+            paragraph.Process(text, -1);
+
+            Assert.Equal(2, paragraph.Levels[2]);
+            Assert.Equal(paragraph.Levels[2], paragraph.Levels[3]);
+        }
+
+        [Fact]
+        public void BidiParagraph_ReorderForDisplay_MatchesProcessString()
+        {
+            string text = "\u0645\u0631\u062D\u0628\u0627 (abc) 123 [\u05D0]";
+
+            using var paragraph = new BidiParagraph();
+            paragraph.Process(text, -1);
+
+            Assert.Equal(BidiAlgorithm.ProcessString(text, -1), paragraph.ReorderForDisplay(text));
+        }
+
+        [Fact]
+        public void BidiParagraph_ReorderForDisplay_DifferentText_Throws()
+        {
+            using var paragraph = new BidiParagraph();
+            paragraph.Process("abc", -1);
+
+            Assert.Throws<ArgumentException>(() => paragraph.ReorderForDisplay("abcd"));
+        }
     }
 }
@@ -0,0 +1,68 @@
+using ArbSh.Terminal.Rendering;
+
+namespace ArbSh.Test;
+
+public sealed class CachedTextMeasurerTests
+{
+    [Fact]
+    public void MeasureWidth_ArabicText_ShapesEachDistinctLineOnce()
+    {
+        var shaping = new CountingTextMeasurer();
+        var measurer = new CachedTextMeasurer(shaping);
+        var config = new TerminalRenderConfig();
+
+        double first = measurer.MeasureWidth("مرحبا بالعالم", config);
+        double second = measurer.MeasureWidth("مرحبا بالعالم", config);
+        measurer.MeasureWidth("أربش", config);
+
+        Assert.Equal(first, second);
+        Assert.Equal(2, shaping.Calls);
+    }
+
+    [Fact]
+    public void MeasureWidth_DifferentFontSize_UsesSeparateCache()
+    {
+        var shaping = new CountingTextMeasurer();
+        var measurer = new CachedTextMeasurer(shaping);
+
+        measurer.MeasureWidth("مساعدة", new TerminalRenderConfig { FontSize = 15 });
+        measurer.MeasureWidth("مساعدة", new TerminalRenderConfig { FontSize = 20 });
+
+        Assert.Equal(2, shaping.Calls);
+    }
+
+    [Fact]
+    public void MeasureWidth_EvictsLeastRecentlyUsedLine()
+    {
+        var shaping = new CountingTextMeasurer();
+        var measurer = new CachedTextMeasurer(shaping, widthCacheCapacity: 1);
+        var config = new TerminalRenderConfig();
+
+        measurer.MeasureWidth("أ", config);
+        measurer.MeasureWidth("ب", config);
+        measurer.MeasureWidth("أ", config);
+
+        Assert.Equal(3, shaping.Calls);
+    }
+
+    [Fact]
+    public void MeasureWidth_EmptyText_IsZeroWithoutShaping()
+    {
+        var shaping = new CountingTextMeasurer();
+        var measurer = new CachedTextMeasurer(shaping);
+
+        Assert.Equal(0, measurer.MeasureWidth(string.Empty, new TerminalRenderConfig()));
+        Assert.Equal(0, shaping.Calls);
+    }
+
+    private sealed class CountingTextMeasurer : ITextMeasurer
+    {
+        public int Calls { get; private set; }
+
+        public double MeasureWidth(string visualText, TerminalRenderConfig config)
+        {
+            Calls++;
+            return visualText.Length * config.FontSize;
+        }
+    }
+}
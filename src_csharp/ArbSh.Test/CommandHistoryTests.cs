@@ -0,0 +1,159 @@
+using ArbSh.Core;
+
+namespace ArbSh.Test;
+
+public sealed class CommandHistoryTests
+{
+    [Fact]
+    public void FindPrefix_StepsThroughMatchesNewestFirst()
+    {
+        var history = new CommandHistory();
+        history.Add("اطبع أول");
+        history.Add("اعرض");
+        history.Add("اطبع ثاني");
+        history.Add("اطبع ثالث طويل جدًا");
+
+        int newest = history.FindPrefix("اطبع", history.Count);
+        int previous = history.FindPrefix("اطبع", newest);
+
+        Assert.Equal("اطبع ثالث طويل جدًا", history[newest]);
+        Assert.Equal("اطبع ثاني", history[previous]);
+        Assert.Equal("اطبع أول", history[history.FindPrefix("اطبع", previous)]);
+        Assert.Equal(-1, history.FindPrefix("اطبع", 0));
+        Assert.Equal(newest, history.FindPrefix("اطبع", previous, older: false));
+        Assert.Equal(newest, history.FindPrefix("اطبع ثالث طويل", history.Count));
+        Assert.Equal(-1, history.FindPrefix("اطبع رابع", history.Count));
+    }
+
+    [Fact]
+    public void FindPrefix_EmptyPrefixWalksEveryEntry()
+    {
+        var history = new CommandHistory();
+        history.Add("أ");
+        history.Add("ب");
+
+        Assert.Equal(1, history.FindPrefix(string.Empty, history.Count));
+        Assert.Equal(0, history.FindPrefix(string.Empty, 1));
+        Assert.Equal(1, history.FindPrefix(string.Empty, 0, older: false));
+        Assert.Equal(-1, history.FindPrefix(string.Empty, 1, older: false));
+    }
+
+    [Fact]
+    public void Add_RecallsRepeatedCommandOnceAtItsLatestPosition()
+    {
+        var history = new CommandHistory();
+        history.Add("اطبع مكرر");
+        history.Add("اعرض");
+        history.Add("  اطبع مكرر  ");
+        history.Add("اطبع مكرر");
+        history.Add("   ");
+
+        Assert.Equal(3, history.Count);
+        Assert.Equal(2, history.FindPrefix("اطبع", history.Count));
+        Assert.Equal(-1, history.FindPrefix("اطبع", 2));
+    }
+
+    [Fact]
+    public void Add_PastMaxEntries_DropsOldestAndKeepsLookupsConsistent()
+    {
+        var history = new CommandHistory(maxEntries: 3);
+        for (int i = 0; i < 10; i++)
+        {
+            history.Add(i % 2 == 0 ? $"اطبع {i}" : "اعرض");
+        }
+
+        // The last three submissions are 7 (اعرض), 8 and 9 (اعرض), with the repeat recalled once.
+        Assert.Equal(3, history.Count);
+        Assert.Equal("اعرض", history[0]);
+        Assert.Equal("اطبع 8", history[1]);
+        Assert.Equal("اعرض", history[2]);
+
+        Assert.Equal(1, history.FindPrefix("اطبع", history.Count));
+        Assert.Equal(-1, history.FindPrefix("اطبع", 1));
+        Assert.Equal(-1, history.FindContaining("اطبع 6", history.Count));
+        Assert.Equal(2, history.FindPrefix("اعرض", history.Count));
+        Assert.Equal(-1, history.FindPrefix("اعرض", 2));
+        Assert.Equal(1, history.FindPrefix(string.Empty, -1, older: false));
+        Assert.Equal([1], history.FindFuzzy("اطبع 8"));
+    }
+
+    [Fact]
+    public void FindContaining_IgnoresDiacriticsTatweelAndCase()
+    {
+        var history = new CommandHistory();
+        history.Add("اطبع مَرْحَـــبًا بالعالم");
+        history.Add("Get-Help");
+        history.Add("اعرض");
+
+        Assert.Equal(0, history.FindContaining("مرحبا", history.Count));
+        Assert.Equal(1, history.FindContaining("get-h", history.Count));
+        Assert.Equal(1, history.FindContaining("et", history.Count));
+        Assert.Equal(-1, history.FindContaining("مرحبا", 0));
+        Assert.Equal(-1, history.FindContaining("وداعا", history.Count));
+    }
+
+    [Fact]
+    public void FindFuzzy_RanksEntriesSharingMostTrigrams()
+    {
+        var history = new CommandHistory();
+        history.Add("انسخ الملف.txt إلى النسخ");
+        history.Add("اطبع شيئا آخر");
+        history.Add("انقل الملف.txt إلى الأرشيف");
+
+        IReadOnlyList<int> matches = history.FindFuzzy("الملف.txt الأرشيف");
+
+        Assert.Equal(2, matches[0]);
+        Assert.Contains(0, matches);
+        Assert.DoesNotContain(1, matches);
+    }
+
+    [Fact]
+    public void Open_PersistsCommandsAcrossSessions()
+    {
+        string path = Path.Combine(Path.GetTempPath(), $"arbsh-history-{Guid.NewGuid():N}.txt");
+        try
+        {
+            using (CommandHistory history = CommandHistory.Open(path))
+            {
+                history.Add("اطبع أول");
+                history.Add("اطبع\nثاني");
+            }
+
+            using (CommandHistory reopened = CommandHistory.Open(path))
+            {
+                Assert.Equal(2, reopened.Count);
+                Assert.Equal("اطبع ثاني", reopened[1]);
+                reopened.Add("اعرض");
+            }
+
+            Assert.Equal(["اطبع أول", "اطبع ثاني", "اعرض"], File.ReadAllLines(path));
+        }
+        finally
+        {
+            File.Delete(path);
+        }
+    }
+
+    [Fact]
+    public void Open_KeepsNewestEntriesAndCompactsLongLog()
+    {
+        string path = Path.Combine(Path.GetTempPath(), $"arbsh-history-{Guid.NewGuid():N}.txt");
+        try
+        {
+            File.WriteAllLines(path, Enumerable.Range(0, 25).Select(i => $"اطبع {i}"));
+
+            using (CommandHistory history = CommandHistory.Open(path, maxEntries: 10))
+            {
+                Assert.Equal(10, history.Count);
+                Assert.Equal("اطبع 15", history[0]);
+                Assert.Equal("اطبع 24", history[9]);
+            }
+
+            Assert.Equal(10, File.ReadAllLines(path).Length);
+        }
+        finally
+        {
+            File.Delete(path);
+        }
+    }
+}
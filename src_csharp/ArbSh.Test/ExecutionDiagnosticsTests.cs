@@ -0,0 +1,127 @@
+using System.Collections.Concurrent;
+using System.Diagnostics.Metrics;
+using ArbSh.Core;
+
+namespace ArbSh.Test;
+
+public sealed class ExecutionDiagnosticsTests
+{
+    [Fact]
+    public void EmitDebug_DeliversStructuredLevelAndCategory()
+    {
+        var sink = new DiagnosticSink();
+
+        ShellEngine.ExecuteInput("اطبع مرحبا", sink, new ExecutionOptions { EmitDebug = true });
+
+        Assert.Equal(["مرحبا"], sink.Outputs);
+        Assert.Contains(sink.Diagnostics, d => d.Level == DiagnosticLevel.Debug && d.Category == "Executor");
+        Assert.DoesNotContain(sink.Diagnostics, d => d.Message.StartsWith("DEBUG", StringComparison.Ordinal));
+    }
+
+    [Fact]
+    public void DebugDisabled_EmitsNoDebugDiagnostics()
+    {
+        var sink = new DiagnosticSink();
+
+        ShellEngine.ExecuteInput("اطبع مرحبا", sink, new ExecutionOptions { EmitDebug = false });
+
+        Assert.Equal(["مرحبا"], sink.Outputs);
+        Assert.DoesNotContain(sink.Diagnostics, d => d.Level == DiagnosticLevel.Debug);
+    }
+
+    [Fact]
+    public void BindingFailure_IsReportedAsErrorDiagnostic()
+    {
+        var sink = new DiagnosticSink();
+
+        ShellEngine.ExecuteInput("اختبار-مصفوفة -مبدل نعم", sink);
+
+        Assert.Contains(sink.Diagnostics, d => d.Level == DiagnosticLevel.Error && d.Category == "ParameterBinding");
+    }
+
+    [Fact]
+    public void Format_PrefixesLevelAndCategory()
+    {
+        Assert.Equal("WARN (Parser): x", DiagnosticFormatter.Format(DiagnosticLevel.Warning, "Parser", "x"));
+        Assert.Equal("ERROR: x", DiagnosticFormatter.Format(DiagnosticLevel.Error, string.Empty, "x"));
+    }
+
+    [Fact]
+    public void Measure_ReportsEveryStageAndDropsOutput()
+    {
+        var sink = new DiagnosticSink();
+
+        ShellEngine.ExecuteInput("قس \"اطبع أ | اطبع\"", sink);
+
+        Assert.StartsWith("التحليل:", sink.Outputs[0]);
+        Assert.DoesNotContain("أ", sink.Outputs);
+        Assert.Contains(sink.Outputs, line => line.StartsWith("اطبع | 0 | 1 | 0 |", StringComparison.Ordinal));
+        Assert.Contains(sink.Outputs, line => line.StartsWith("اطبع | 1 | 1 | 1 |", StringComparison.Ordinal));
+        Assert.EndsWith("المخرجات: 1", sink.Outputs[^1]);
+    }
+
+    [Fact]
+    public void StageMetrics_ArePublishedOnTheCoreMeter()
+    {
+        var objectsOut = new ConcurrentBag<(long Value, string? Command)>();
+        using var listener = new MeterListener();
+        listener.InstrumentPublished = (instrument, meterListener) =>
+        {
+            if (instrument.Meter.Name == ShellMetrics.MeterName)
+            {
+                meterListener.EnableMeasurementEvents(instrument);
+            }
+        };
+        listener.SetMeasurementEventCallback<long>((instrument, value, tags, _) =>
+        {
+            if (instrument.Name == "arbsh.pipeline.stage.objects_out")
+            {
+                objectsOut.Add((value, tags.Length > 0 ? tags[0].Value as string : null));
+            }
+        });
+        listener.Start();
+
+        ShellEngine.ExecuteInput("اطبع مقاس | اطبع", new DiagnosticSink());
+
+        Assert.Contains(objectsOut, m => m.Command == "اطبع" && m.Value == 1);
+    }
+
+    private sealed record Diagnostic(DiagnosticLevel Level, string Category, string Message);
+
+    private sealed class DiagnosticSink : IExecutionSink
+    {
+        private readonly object _gate = new();
+
+        public List<string> Outputs { get; } = [];
+
+        public List<Diagnostic> Diagnostics { get; } = [];
+
+        public void WriteOutput(string message)
+        {
+            lock (_gate)
+            {
+                Outputs.Add(message);
+            }
+        }
+
+        public void WriteError(string message)
+        {
+        }
+
+        public void WriteWarning(string message)
+        {
+        }
+
+        public void WriteDebug(string message)
+        {
+        }
+
+        public void WriteDiagnostic(DiagnosticLevel level, string category, string message)
+        {
+            lock (_gate)
+            {
+                Diagnostics.Add(new Diagnostic(level, category, message));
+            }
+        }
+    }
+}
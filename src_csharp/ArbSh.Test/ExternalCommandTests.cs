@@ -0,0 +1,308 @@
+using ArbSh.Core;
+
+namespace ArbSh.Test;
+
+public sealed class ExternalCommandTests
+{
+    [Fact]
+    public void AdjacentExternalCommands_PipeBytesProcessToProcess()
+    {
+        string root = CreateTempDirectory();
+        WriteScript(root, "produce",
+            "i=0; while [ $i -lt $1 ]; do echo \"line $i\"; i=$((i+1)); done",
+            "@for /l %%i in (1,1,%1) do @echo line %%i");
+        WriteCountScript(root);
+
+        try
+        {
+            CaptureSink sink = Run("./produce 5000 | ./count", root);
+
+            Assert.Equal("5000", Assert.Single(sink.Outputs).Trim());
+            Assert.Empty(sink.Errors);
+        }
+        finally
+        {
+            TryDeleteDirectory(root);
+        }
+    }
+
+    [Fact]
+    public void CmdletOutput_IsWrittenToStandardInput()
+    {
+        string root = CreateTempDirectory();
+        File.WriteAllLines(Path.Combine(root, "in.txt"), Enumerable.Range(0, 500).Select(i => $"سطر {i}"));
+        WriteCountScript(root);
+
+        try
+        {
+            CaptureSink sink = Run("اطبع < in.txt | ./count", root);
+
+            Assert.Equal("500", Assert.Single(sink.Outputs).Trim());
+            Assert.Empty(sink.Errors);
+        }
+        finally
+        {
+            TryDeleteDirectory(root);
+        }
+    }
+
+    [Fact]
+    public void StandardError_BecomesErrorRecords()
+    {
+        string root = CreateTempDirectory();
+        WriteScript(root, "both",
+            "echo out; echo err >&2",
+            "@echo out\r\n@echo err 1>&2");
+
+        try
+        {
+            CaptureSink sink = Run("./both", root);
+
+            Assert.Equal(["out"], sink.Outputs.Select(line => line.Trim()));
+            Assert.Equal(["err"], sink.Errors.Select(line => line.Trim()));
+        }
+        finally
+        {
+            TryDeleteDirectory(root);
+        }
+    }
+
+    [Fact]
+    public void ConsumerExitingEarly_StopsEndlessUpstream()
+    {
+        string root = CreateTempDirectory();
+        WriteEndlessScript(root);
+        WriteScript(root, "first",
+            "head -n 1",
+            "@set /p line=\r\n@echo %line%");
+
+        try
+        {
+            CaptureSink sink = Run("./endless | ./first", root);
+
+            Assert.Equal(["y"], sink.Outputs.Select(line => line.Trim()));
+        }
+        finally
+        {
+            TryDeleteDirectory(root);
+        }
+    }
+
+    [Fact]
+    public void DownstreamFailingToStart_StopsUpstreamAndReportsError()
+    {
+        string root = CreateTempDirectory();
+        WriteEndlessScript(root);
+        string broken = Path.Combine(root, OperatingSystem.IsWindows() ? "broken.exe" : "broken");
+        File.WriteAllText(broken, "ليس برنامجا");
+        if (!OperatingSystem.IsWindows())
+        {
+            File.SetUnixFileMode(broken, UnixFileMode.UserRead | UnixFileMode.UserWrite | UnixFileMode.UserExecute);
+        }
+
+        try
+        {
+            CaptureSink sink = Run("./endless | ./broken", root);
+
+            Assert.Contains(sink.Errors, line => line.Contains("./broken", StringComparison.Ordinal));
+        }
+        finally
+        {
+            TryDeleteDirectory(root);
+        }
+    }
+
+    [Fact]
+    public void InputRedirect_CopiesFileBytesToStandardInput()
+    {
+        string root = CreateTempDirectory();
+        File.WriteAllLines(Path.Combine(root, "in.txt"), Enumerable.Range(0, 300).Select(i => $"سطر {i}"));
+        WriteCountScript(root);
+
+        try
+        {
+            CaptureSink sink = Run("./count < in.txt", root);
+
+            Assert.Equal("300", Assert.Single(sink.Outputs).Trim());
+            Assert.Empty(sink.Errors);
+        }
+        finally
+        {
+            TryDeleteDirectory(root);
+        }
+    }
+
+    [Fact]
+    public void InputRedirect_MissingFile_ReportsErrorWithoutRunningProgram()
+    {
+        string root = CreateTempDirectory();
+        WriteCountScript(root);
+
+        try
+        {
+            CaptureSink sink = Run("./count < غير-موجود.txt", root);
+
+            Assert.Empty(sink.Outputs);
+            Assert.Contains(sink.Errors, line => line.Contains("غير-موجود.txt", StringComparison.Ordinal));
+        }
+        finally
+        {
+            TryDeleteDirectory(root);
+        }
+    }
+
+    [Fact]
+    public void UnknownCommand_ReportsNotFound()
+    {
+        string root = CreateTempDirectory();
+
+        try
+        {
+            CaptureSink sink = Run("./لا-يوجد", root);
+
+            Assert.Contains(sink.Outputs, line => line.Contains("الأمر غير موجود", StringComparison.Ordinal));
+        }
+        finally
+        {
+            TryDeleteDirectory(root);
+        }
+    }
+
+    [Fact]
+    public void CommandInstalledAfterMiss_IsFoundOnNextUse()
+    {
+        string root = CreateTempDirectory();
+        string name = $"arbsh-tool-{Guid.NewGuid():N}";
+        string? originalPath = Environment.GetEnvironmentVariable("PATH");
+        Environment.SetEnvironmentVariable("PATH", originalPath + Path.PathSeparator + root);
+
+        try
+        {
+            CaptureSink missing = Run(name, root);
+            WriteScript(root, name, "echo installed", "@echo installed");
+            CaptureSink found = Run(name, root);
+
+            Assert.Contains(missing.Outputs, line => line.Contains("الأمر غير موجود", StringComparison.Ordinal));
+            Assert.Equal(["installed"], found.Outputs.Select(line => line.Trim()));
+        }
+        finally
+        {
+            Environment.SetEnvironmentVariable("PATH", originalPath);
+            TryDeleteDirectory(root);
+        }
+    }
+
+    [Fact]
+    public void OutputWithoutLineBreaks_IsSplitIntoBoundedLines()
+    {
+        string root = CreateTempDirectory();
+        string longLine = new('ب', 3 * 1024 * 1024);
+        File.WriteAllText(Path.Combine(root, "long.txt"), longLine);
+        WriteScript(root, "show", "cat \"$1\"", "@type %1");
+
+        try
+        {
+            CaptureSink sink = Run("./show long.txt", root);
+
+            Assert.True(sink.Outputs.Count > 1);
+            Assert.All(sink.Outputs, line => Assert.True(line.Length < 2 * 1024 * 1024));
+            Assert.Equal(longLine, string.Concat(sink.Outputs));
+        }
+        finally
+        {
+            TryDeleteDirectory(root);
+        }
+    }
+
+    private static CaptureSink Run(string input, string workingDirectory)
+    {
+        var sink = new CaptureSink();
+        var session = new ShellSessionState(workingDirectory);
+
+        Task execution = Task.Run(() => ShellEngine.ExecuteInput(input, sink, session: session));
+
+        Assert.True(execution.Wait(TimeSpan.FromSeconds(30)));
+        return sink;
+    }
+
+    private static void WriteCountScript(string directory)
+    {
+        WriteScript(directory, "count", "wc -l", "@find /c /v \"\"");
+    }
+
+    private static void WriteEndlessScript(string directory)
+    {
+        WriteScript(directory, "endless", "while :; do echo y; done", "@echo off\r\n:loop\r\necho y\r\ngoto loop");
+    }
+
+    /// <summary>
+    /// Writes an executable script: a <c>.cmd</c> file on Windows, a <c>/bin/sh</c> script elsewhere.
+    /// </summary>
+    private static void WriteScript(string directory, string name, string unixBody, string windowsBody)
+    {
+        if (OperatingSystem.IsWindows())
+        {
+            File.WriteAllText(Path.Combine(directory, name + ".cmd"), windowsBody + "\r\n");
+            return;
+        }
+
+        string path = Path.Combine(directory, name);
+        File.WriteAllText(path, $"#!/bin/sh\n{unixBody}\n");
+        File.SetUnixFileMode(path, UnixFileMode.UserRead | UnixFileMode.UserWrite | UnixFileMode.UserExecute);
+    }
+
+    private static string CreateTempDirectory()
+    {
+        string path = Path.Combine(Path.GetTempPath(), $"ArbSh_ExternalCommandTests_{Guid.NewGuid():N}");
+        Directory.CreateDirectory(path);
+        return path;
+    }
+
+    private static void TryDeleteDirectory(string path)
+    {
+        try
+        {
+            if (Directory.Exists(path))
+            {
+                Directory.Delete(path, recursive: true);
+            }
+        }
+        catch
+        {
+            // Ignore cleanup failures in tests.
+        }
+    }
+
+    private sealed class CaptureSink : IExecutionSink
+    {
+        private readonly object _gate = new();
+
+        public List<string> Outputs { get; } = [];
+
+        public List<string> Errors { get; } = [];
+
+        public void WriteOutput(string message)
+        {
+            lock (_gate)
+            {
+                Outputs.Add(message);
+            }
+        }
+
+        public void WriteError(string message)
+        {
+            lock (_gate)
+            {
+                Errors.Add(message);
+            }
+        }
+
+        public void WriteWarning(string message)
+        {
+        }
+
+        public void WriteDebug(string message)
+        {
+        }
+    }
+}
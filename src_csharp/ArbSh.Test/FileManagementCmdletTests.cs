@@ -65,6 +65,61 @@ public sealed class FileManagementCmdletTests
         }
     }
 
+    [Fact]
+    public void ListDirectory_Sorted_ListsDirectoriesFirstThenByName()
+    {
+        string root = CreateTempDirectory();
+        Directory.CreateDirectory(Path.Combine(root, "ب-مجلد"));
+        Directory.CreateDirectory(Path.Combine(root, "أ-مجلد"));
+        File.WriteAllText(Path.Combine(root, "ج.txt"), "c");
+        File.WriteAllText(Path.Combine(root, "ا.txt"), "a");
+
+        var sink = new CaptureSink();
+        var session = new ShellSessionState(root);
+
+        try
+        {
+            ShellEngine.ExecuteInput("اعرض -مرتب", sink, session: session);
+
+            Assert.Equal(["أ-مجلد/", "ب-مجلد/", "ا.txt", "ج.txt"], sink.Outputs);
+            Assert.Empty(sink.Errors);
+        }
+        finally
+        {
+            TryDeleteDirectory(root);
+        }
+    }
+
+    [Fact]
+    public void ListDirectory_Recurse_StreamsNestedEntriesWithRelativeNames()
+    {
+        string root = CreateTempDirectory();
+        for (int i = 0; i < 20; i++)
+        {
+            string directory = Path.Combine(root, $"مجلد{i}", "داخلي");
+            Directory.CreateDirectory(directory);
+            File.WriteAllText(Path.Combine(directory, "ملف.txt"), "x");
+        }
+
+        var sink = new CaptureSink();
+        var session = new ShellSessionState(root);
+
+        try
+        {
+            ShellEngine.ExecuteInput("اعرض -متكرر", sink, session: session);
+
+            Assert.Equal(60, sink.Outputs.Count);
+            Assert.Contains("مجلد7/", sink.Outputs);
+            Assert.Contains("مجلد7/داخلي/", sink.Outputs);
+            Assert.Contains("مجلد7/داخلي/ملف.txt", sink.Outputs);
+            Assert.Empty(sink.Errors);
+        }
+        finally
+        {
+            TryDeleteDirectory(root);
+        }
+    }
+
     [Fact]
     public void ChangeDirectory_WhenMissingPath_EmitsArabicError()
     {
@@ -0,0 +1,74 @@
+using ArbSh.Core.Parsing;
+
+namespace ArbSh.Test;
+
+public sealed class LexerTests
+{
+    [Theory]
+    [InlineData("اطبع مرحبا")]
+    [InlineData("اطبع \"سطر \\\"مقتبس\\\"\" -النص $متغير | اختبار-مصفوفة -مبدل")]
+    [InlineData("اطبع 'نص حرفي' > out.txt 2>&1 ; اطبع [int] 42 # تعليق")]
+    [InlineData("cmd 2>> err.log >>&2 >&1 2>&1 1>5 < in.txt")]
+    [InlineData("اطبع $(اطبع (داخلي)) -5 ./path\\to/file.txt")]
+    [InlineData("[ System.String ] [ غير مغلق \"غير مغلق 'ايضا")]
+    [InlineData("a\\\nb \"\\\n\" ٣>out # سطر\nاطبع بعد")]
+    [InlineData("$ $( ²³ & * = { }")]
+    public void Tokenize_MatchesRegexTokenizer(string input)
+    {
+        List<Token> expected = RegexTokenizer.Tokenize(input);
+        List<Token> actual = Lexer.Tokenize(input);
+
+        Assert.Equal(expected.Select(t => (t.Type, t.Value)), actual.Select(t => (t.Type, t.Value)));
+    }
+
+    [Fact]
+    public void DefaultToken_IsEmpty()
+    {
+        Token token = default;
+
+        Assert.Equal(TokenType.Unknown, token.Type);
+        Assert.Equal(string.Empty, token.Value);
+        Assert.True(token.Span.IsEmpty);
+        Assert.Equal("[Unknown: '']", token.ToString());
+    }
+
+    [Fact]
+    public void Tokenize_Range_ReportsOffsetsIntoSource()
+    {
+        const string source = "اطبع أ | اطبع -النص \"ب\"";
+        int stageStart = source.IndexOf('|') + 2;
+        var tokens = new List<Token>();
+
+        Lexer.Tokenize(source, stageStart, source.Length - stageStart, tokens);
+
+        Assert.Equal(3, tokens.Count);
+        Assert.Equal(stageStart, tokens[0].Start);
+        Assert.Equal(TokenType.ParameterName, tokens[1].Type);
+        Assert.Equal("-النص", tokens[1].Span.ToString());
+        Assert.Equal(TokenType.StringLiteralDQ, tokens[2].Type);
+        Assert.Equal(source.Length, tokens[2].Start + tokens[2].Length);
+    }
+
+    [Theory]
+    [InlineData("2>&1", "2>&1")]
+    [InlineData(">>&2", ">>&2")]
+    [InlineData("2>>", "2>>")]
+    [InlineData(">&x", ">")]
+    [InlineData("1>5", "1>5")]
+    public void Scan_Redirection_MatchesFirstOperatorAlternative(string input, string expected)
+    {
+        int length = Lexer.Scan(input, 0, out TokenType type);
+
+        Assert.Equal(TokenType.Operator, type);
+        Assert.Equal(expected, input[..length]);
+    }
+
+    [Fact]
+    public void Scan_UnterminatedQuote_IsSingleUnknownCharacter()
+    {
+        int length = Lexer.Scan("\"abc", 0, out TokenType type);
+
+        Assert.Equal(TokenType.Unknown, type);
+        Assert.Equal(1, length);
+    }
+}
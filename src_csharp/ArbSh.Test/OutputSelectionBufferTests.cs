@@ -43,4 +43,22 @@ public sealed class OutputSelectionBufferTests
 
         Assert.Equal("line-1", selected);
     }
+
+    [Fact]
+    public void ShiftForEviction_MovesSelectionWithRetainedLines()
+    {
+        var buffer = new OutputSelectionBuffer();
+        buffer.BeginOrExtend(2, extendSelection: false);
+        buffer.UpdateActive(5);
+
+        buffer.ShiftForEviction(3);
+
+        Assert.True(buffer.TryGetRange(out int start, out int end));
+        Assert.Equal(0, start);
+        Assert.Equal(2, end);
+
+        buffer.ShiftForEviction(3);
+
+        Assert.False(buffer.HasSelection);
+    }
 }
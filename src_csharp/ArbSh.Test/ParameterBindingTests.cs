@@ -0,0 +1,110 @@
+using ArbSh.Core;
+
+namespace ArbSh.Test;
+
+public sealed class ParameterBindingTests
+{
+    [Fact]
+    public void RepeatedInvocations_BindSwitchAndNamedParameters_Independently()
+    {
+        var sink = new CaptureSink();
+
+        for (int i = 0; i < 3; i++)
+        {
+            sink.Clear();
+            ShellEngine.ExecuteInput("اختبار-مصفوفة -مبدل", sink);
+            Assert.Contains("قيمة المبدل: True", sink.Outputs);
+
+            sink.Clear();
+            ShellEngine.ExecuteInput("اختبار-مصفوفة", sink);
+            Assert.Contains("قيمة المبدل: False", sink.Outputs);
+        }
+    }
+
+    [Fact]
+    public void TypeLiteral_ConvertsPositionalArgument_ThroughCachedBinder()
+    {
+        var sink = new CaptureSink();
+
+        ShellEngine.ExecuteInput("اختبار-نوع [int] 42", sink);
+        ShellEngine.ExecuteInput("اختبار-نوع [int] 7", sink);
+
+        Assert.Contains("عدد-صحيح: 42 (النوع: Int32)", sink.Outputs);
+        Assert.Contains("عدد-صحيح: 7 (النوع: Int32)", sink.Outputs);
+        Assert.Empty(sink.Errors);
+    }
+
+    [Fact]
+    public void ArrayParameter_ConvertsElements_ThroughTypeLiteralOverride()
+    {
+        var sink = new CaptureSink();
+
+        ShellEngine.ExecuteInput("اختبار-مصفوفة [int] 007", sink);
+
+        Assert.Contains("تم استلام 1 عنصر/عناصر نصية:", sink.Outputs);
+        Assert.Contains("  [0]: '7'", sink.Outputs);
+        Assert.Empty(sink.Errors);
+    }
+
+    [Fact]
+    public void NamedParameter_WithValue_BindsToPipelineParameterProperty()
+    {
+        var sink = new CaptureSink();
+
+        ShellEngine.ExecuteInput("اطبع -النص مرحبا", sink);
+
+        Assert.Equal(["مرحبا"], sink.Outputs);
+    }
+
+    [Fact]
+    public void SwitchParameter_WithInvalidValue_ReportsBindingError()
+    {
+        var sink = new CaptureSink();
+
+        ShellEngine.ExecuteInput("اختبار-مصفوفة -مبدل نعم", sink);
+
+        Assert.Contains(sink.Errors, line => line.Contains("ParameterBinding", StringComparison.Ordinal));
+    }
+
+    private sealed class CaptureSink : IExecutionSink
+    {
+        private readonly object _gate = new();
+
+        public List<string> Outputs { get; } = [];
+
+        public List<string> Errors { get; } = [];
+
+        public void WriteOutput(string message)
+        {
+            lock (_gate)
+            {
+                Outputs.Add(message);
+            }
+        }
+
+        public void WriteError(string message)
+        {
+            lock (_gate)
+            {
+                Errors.Add(message);
+            }
+        }
+
+        public void WriteWarning(string message)
+        {
+        }
+
+        public void WriteDebug(string message)
+        {
+        }
+
+        public void Clear()
+        {
+            lock (_gate)
+            {
+                Outputs.Clear();
+                Errors.Clear();
+            }
+        }
+    }
+}
@@ -0,0 +1,91 @@
+using ArbSh.Terminal.Models;
+
+namespace ArbSh.Test;
+
+public sealed class PendingOutputQueueTests
+{
+    [Fact]
+    public void Enqueue_RequestsOneDrainPerBatch()
+    {
+        var queue = new PendingOutputQueue();
+        var lines = new ScrollbackBuffer(capacity: 16);
+
+        Assert.True(queue.Enqueue(Line("a")));
+        Assert.False(queue.Enqueue(Line("b")));
+        Assert.False(queue.Enqueue(Line("c")));
+
+        Assert.Equal(3, queue.DrainTo(lines, maxLines: 16));
+        Assert.Equal(new[] { "a", "b", "c" }, lines.Select(l => l.Text).ToArray());
+        Assert.False(queue.HasPending);
+
+        Assert.True(queue.Enqueue(Line("d")));
+    }
+
+    [Fact]
+    public void DrainTo_RespectsBatchLimitAndLeavesRemainderClaimable()
+    {
+        var queue = new PendingOutputQueue();
+        var lines = new ScrollbackBuffer(capacity: 16);
+
+        for (int i = 0; i < 5; i++)
+        {
+            queue.Enqueue(Line(i.ToString()));
+        }
+
+        Assert.Equal(3, queue.DrainTo(lines, maxLines: 3));
+        Assert.True(queue.HasPending);
+        Assert.True(queue.TryClaimDrain());
+        Assert.False(queue.TryClaimDrain());
+
+        Assert.Equal(2, queue.DrainTo(lines, maxLines: 3));
+        Assert.Equal(new[] { "0", "1", "2", "3", "4" }, lines.Select(l => l.Text).ToArray());
+        Assert.False(queue.TryClaimDrain());
+    }
+
+    [Fact]
+    public void FlushTo_KeepsScheduledDrainClaimed()
+    {
+        var queue = new PendingOutputQueue();
+        var lines = new ScrollbackBuffer(capacity: 16);
+
+        Assert.True(queue.Enqueue(Line("a")));
+        Assert.Equal(1, queue.FlushTo(lines, maxLines: 16));
+
+        Assert.False(queue.Enqueue(Line("b")));
+        Assert.False(queue.TryClaimDrain());
+
+        Assert.Equal(1, queue.DrainTo(lines, maxLines: 16));
+        Assert.Equal(new[] { "a", "b" }, lines.Select(l => l.Text).ToArray());
+        Assert.True(queue.Enqueue(Line("c")));
+    }
+
+    [Fact]
+    public void Enqueue_FromConcurrentWriters_KeepsPerWriterOrder()
+    {
+        const int writers = 4;
+        const int linesPerWriter = 2000;
+        var queue = new PendingOutputQueue();
+        var lines = new ScrollbackBuffer(capacity: writers * linesPerWriter);
+
+        Parallel.For(0, writers, writer =>
+        {
+            for (int i = 0; i < linesPerWriter; i++)
+            {
+                queue.Enqueue(Line($"{writer}:{i}"));
+            }
+        });
+
+        Assert.Equal(writers * linesPerWriter, queue.DrainTo(lines, int.MaxValue));
+
+        var next = new int[writers];
+        foreach (TerminalLine line in lines)
+        {
+            string[] parts = line.Text.Split(':');
+            int writer = int.Parse(parts[0]);
+            Assert.Equal(next[writer], int.Parse(parts[1]));
+            next[writer]++;
+        }
+    }
+
+    private static TerminalLine Line(string text) => new(text, TerminalLineKind.Output, DateTimeOffset.UtcNow);
+}
@@ -0,0 +1,316 @@
+using ArbSh.Core;
+
+namespace ArbSh.Test;
+
+public sealed class PipelineExecutionTests
+{
+    [Fact]
+    public void InputRedirect_ThroughSmallBoundedChannels_PreservesOrderAndCount()
+    {
+        string root = CreateTempDirectory();
+        string inputFile = Path.Combine(root, "مدخلات.txt");
+        string[] lines = Enumerable.Range(0, 2000).Select(i => $"سطر {i}").ToArray();
+        File.WriteAllLines(inputFile, lines);
+
+        var sink = new CaptureSink();
+        var session = new ShellSessionState(root);
+        var options = new ExecutionOptions { PipelineCapacity = 8, PipelineBatchSize = 3 };
+
+        try
+        {
+            ShellEngine.ExecuteInput("اطبع < مدخلات.txt | اطبع | اطبع", sink, options, session);
+
+            Assert.Equal(lines, sink.Outputs);
+            Assert.Empty(sink.Errors);
+        }
+        finally
+        {
+            TryDeleteDirectory(root);
+        }
+    }
+
+    [Fact]
+    public void OutputRedirect_WithUnboundedChannel_WritesAllLines()
+    {
+        string root = CreateTempDirectory();
+        string inputFile = Path.Combine(root, "in.txt");
+        string outputFile = Path.Combine(root, "out.txt");
+        string[] lines = Enumerable.Range(0, 500).Select(i => $"line {i}").ToArray();
+        File.WriteAllLines(inputFile, lines);
+
+        var sink = new CaptureSink();
+        var session = new ShellSessionState(root);
+        var options = new ExecutionOptions { PipelineCapacity = 0 };
+
+        try
+        {
+            ShellEngine.ExecuteInput("اطبع < in.txt | اطبع > out.txt", sink, options, session);
+
+            Assert.Equal(lines, File.ReadAllLines(outputFile));
+            Assert.Empty(sink.Outputs);
+        }
+        finally
+        {
+            TryDeleteDirectory(root);
+        }
+    }
+
+    [Theory]
+    [InlineData(0L)]
+    [InlineData(1L)]
+    public void InputRedirect_WithTinyBuffers_SplitsLinesLikeReadLine(long memoryMapThreshold)
+    {
+        string root = CreateTempDirectory();
+        string inputFile = Path.Combine(root, "in.txt");
+        string longLine = string.Concat(Enumerable.Repeat("طويل ", 2000));
+        File.WriteAllText(inputFile, $"أ\r\nب\rج\n{longLine}\r\nأخير", new System.Text.UTF8Encoding(true));
+
+        var sink = new CaptureSink();
+        var session = new ShellSessionState(root);
+        var options = new ExecutionOptions { RedirectionBufferSize = 16, RedirectionMemoryMapThreshold = memoryMapThreshold };
+
+        try
+        {
+            ShellEngine.ExecuteInput("اطبع < in.txt", sink, options, session);
+
+            Assert.Equal(["أ", "ب", "ج", longLine, "أخير"], sink.Outputs);
+            Assert.Empty(sink.Errors);
+        }
+        finally
+        {
+            TryDeleteDirectory(root);
+        }
+    }
+
+    [Fact]
+    public void OutputRedirect_Append_WithTinyBuffer_KeepsExistingContent()
+    {
+        string root = CreateTempDirectory();
+        string outputFile = Path.Combine(root, "out.txt");
+        File.WriteAllLines(outputFile, ["موجود"]);
+        string[] lines = Enumerable.Range(0, 300).Select(i => $"سطر {i}").ToArray();
+        File.WriteAllLines(Path.Combine(root, "in.txt"), lines);
+
+        var sink = new CaptureSink();
+        var session = new ShellSessionState(root);
+        var options = new ExecutionOptions { RedirectionBufferSize = 16 };
+
+        try
+        {
+            ShellEngine.ExecuteInput("اطبع < in.txt >> out.txt", sink, options, session);
+
+            Assert.Equal(["موجود", .. lines], File.ReadAllLines(outputFile));
+            Assert.Empty(sink.Outputs);
+        }
+        finally
+        {
+            TryDeleteDirectory(root);
+        }
+    }
+
+    [Fact]
+    public void SubExpression_WithSingleItemBatches_ReturnsInnerOutput()
+    {
+        var sink = new CaptureSink();
+        var options = new ExecutionOptions { PipelineCapacity = 1, PipelineBatchSize = 1 };
+
+        ShellEngine.ExecuteInput("اطبع $(اطبع داخلي)", sink, options);
+
+        Assert.Equal(["داخلي"], sink.Outputs);
+    }
+
+    [Fact]
+    public void SynchronousWrites_PastHoldLimit_FaultStageInsteadOfBuffering()
+    {
+        // One EndProcessing call writes every element (type literals keep the values apart).
+        // With two slots, at most 16x the capacity may be held back before the stage faults.
+        var sink = new CaptureSink();
+        var options = new ExecutionOptions { PipelineCapacity = 2, PipelineBatchSize = 1 };
+        string values = string.Join(' ', Enumerable.Range(0, 100).Select(i => $"[string] ع{i}"));
+
+        ShellEngine.ExecuteInput($"اختبار-مصفوفة {values}", sink, options);
+
+        Assert.Contains(sink.Errors, line => line.Contains("WriteObjectAsync", StringComparison.Ordinal));
+        Assert.InRange(sink.Outputs.Count, 1, 2 + 2 * 16);
+    }
+
+    [Fact]
+    public void MissingCommand_AfterProducerStage_DoesNotBlockPipeline()
+    {
+        string root = CreateTempDirectory();
+        string inputFile = Path.Combine(root, "in.txt");
+        File.WriteAllLines(inputFile, Enumerable.Range(0, 1000).Select(i => i.ToString()));
+
+        var sink = new CaptureSink();
+        var session = new ShellSessionState(root);
+        var options = new ExecutionOptions { PipelineCapacity = 4, PipelineBatchSize = 2 };
+
+        try
+        {
+            Task execution = Task.Run(() => ShellEngine.ExecuteInput("اطبع < in.txt | أمر-غير-موجود", sink, options, session));
+
+            Assert.True(execution.Wait(TimeSpan.FromSeconds(10)));
+            Assert.Contains(sink.Outputs, line => line.Contains("الأمر غير موجود", StringComparison.Ordinal));
+        }
+        finally
+        {
+            TryDeleteDirectory(root);
+        }
+    }
+
+    [Fact]
+    public void MissingCommand_AfterFaultingStage_ReportsTheFault()
+    {
+        var sink = new CaptureSink();
+
+        ShellEngine.ExecuteInput("اختبار-مصفوفة [int] س | أمر-غير-موجود", sink);
+
+        Assert.Contains(sink.Outputs, line => line.Contains("الأمر غير موجود", StringComparison.Ordinal));
+        Assert.Contains(sink.Errors, line => line.Contains("One or more pipeline tasks failed", StringComparison.Ordinal));
+    }
+
+    [Fact]
+    public void ExternalCommand_StreamsStdoutIntoCmdletStage()
+    {
+        // The test host always runs under dotnet, so it is on PATH.
+        var sink = new CaptureSink();
+
+        Task execution = Task.Run(() => ShellEngine.ExecuteInput("dotnet --version | اطبع", sink));
+
+        Assert.True(execution.Wait(TimeSpan.FromSeconds(60)));
+        string version = Assert.Single(sink.Outputs);
+        Assert.Matches(@"^\d+\.\d+", version);
+        Assert.Empty(sink.Errors);
+    }
+
+    [Fact]
+    public void ForEachParallel_Ordered_KeepsInputOrderThroughSmallChannels()
+    {
+        string root = CreateTempDirectory();
+        string inputFile = Path.Combine(root, "in.txt");
+        string[] lines = Enumerable.Range(0, 1000).Select(i => $"عنصر {i}").ToArray();
+        File.WriteAllLines(inputFile, lines);
+
+        var sink = new CaptureSink();
+        var session = new ShellSessionState(root);
+        var options = new ExecutionOptions { PipelineCapacity = 2, PipelineBatchSize = 3 };
+
+        try
+        {
+            Task execution = Task.Run(() => ShellEngine.ExecuteInput(
+                "اطبع < in.txt | لكل \"اطبع | اطبع\" -التوازي 4 -بالترتيب | اطبع", sink, options, session));
+
+            Assert.True(execution.Wait(TimeSpan.FromSeconds(30)));
+            Assert.Equal(lines, sink.Outputs);
+            Assert.Empty(sink.Errors);
+        }
+        finally
+        {
+            TryDeleteDirectory(root);
+        }
+    }
+
+    [Fact]
+    public void ForEachParallel_Unordered_WritesEveryItemOnce()
+    {
+        string root = CreateTempDirectory();
+        string inputFile = Path.Combine(root, "in.txt");
+        string[] lines = Enumerable.Range(0, 1000).Select(i => i.ToString()).ToArray();
+        File.WriteAllLines(inputFile, lines);
+
+        var sink = new CaptureSink();
+        var session = new ShellSessionState(root);
+
+        try
+        {
+            Task execution = Task.Run(() => ShellEngine.ExecuteInput("اطبع < in.txt | لكل اطبع -التوازي 3", sink, session: session));
+
+            Assert.True(execution.Wait(TimeSpan.FromSeconds(30)));
+            Assert.Equal(lines.Order(StringComparer.Ordinal), sink.Outputs.Order(StringComparer.Ordinal));
+        }
+        finally
+        {
+            TryDeleteDirectory(root);
+        }
+    }
+
+    [Fact]
+    public void ForEachParallel_MissingInnerCommand_ReportsErrorPerItemWithoutBlocking()
+    {
+        var sink = new CaptureSink();
+
+        Task execution = Task.Run(() => ShellEngine.ExecuteInput("اطبع أ | لكل أمر-غير-موجود", sink));
+
+        Assert.True(execution.Wait(TimeSpan.FromSeconds(10)));
+        Assert.Contains(sink.Errors, line => line.Contains("أمر-غير-موجود", StringComparison.Ordinal));
+    }
+
+    [Fact]
+    public void DeepPipelines_RunConcurrently_CompleteWithoutExhaustingThreadPool()
+    {
+        string statement = "اطبع عميق" + string.Concat(Enumerable.Repeat(" | اطبع", 40)) + "; اطبع $(اطبع فرعي)";
+        var sinks = Enumerable.Range(0, 32).Select(_ => new CaptureSink()).ToArray();
+
+        Task[] executions = sinks
+            .Select(sink => Task.Run(() => ShellEngine.ExecuteInput(statement, sink)))
+            .ToArray();
+
+        Assert.True(Task.WaitAll(executions, TimeSpan.FromSeconds(30)));
+        Assert.All(sinks, sink => Assert.Equal(["عميق", "فرعي"], sink.Outputs));
+    }
+
+    private static string CreateTempDirectory()
+    {
+        string path = Path.Combine(Path.GetTempPath(), $"ArbSh_PipelineTests_{Guid.NewGuid():N}");
+        Directory.CreateDirectory(path);
+        return path;
+    }
+
+    private static void TryDeleteDirectory(string path)
+    {
+        try
+        {
+            if (Directory.Exists(path))
+            {
+                Directory.Delete(path, recursive: true);
+            }
+        }
+        catch
+        {
+            // Ignore cleanup failures in tests.
+        }
+    }
+
+    private sealed class CaptureSink : IExecutionSink
+    {
+        private readonly object _gate = new();
+
+        public List<string> Outputs { get; } = [];
+
+        public List<string> Errors { get; } = [];
+
+        public void WriteOutput(string message)
+        {
+            lock (_gate)
+            {
+                Outputs.Add(message);
+            }
+        }
+
+        public void WriteError(string message)
+        {
+            lock (_gate)
+            {
+                Errors.Add(message);
+            }
+        }
+
+        public void WriteWarning(string message)
+        {
+        }
+
+        public void WriteDebug(string message)
+        {
+        }
+    }
+}
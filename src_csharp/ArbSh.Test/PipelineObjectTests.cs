@@ -0,0 +1,72 @@
+using ArbSh.Core;
+using ArbSh.Core.Models;
+
+namespace ArbSh.Test;
+
+public sealed class PipelineObjectTests
+{
+    [Fact]
+    public void TypedConstructors_KeepValuesUnboxed()
+    {
+        var number = new PipelineObject(42L);
+        var real = new PipelineObject(1.5);
+        var text = new PipelineObject("نص");
+
+        Assert.Equal(PipelineValueKind.Int64, number.Kind);
+        Assert.True(number.TryGetInt64(out long integer));
+        Assert.Equal(42L, integer);
+        Assert.True(real.TryGetDouble(out double fraction));
+        Assert.Equal(1.5, fraction);
+        Assert.True(text.TryGetString(out string value));
+        Assert.Equal("نص", value);
+        Assert.False(text.TryGetInt64(out _));
+    }
+
+    [Fact]
+    public void ObjectConstructor_NormalizesKnownTypes_AndPreservesValueType()
+    {
+        var number = new PipelineObject((object)7);
+        var entry = new PipelineObject((object)new DirectoryEntry("مجلد", "/tmp/مجلد", isDirectory: true));
+        var other = new PipelineObject((object)DayOfWeek.Friday);
+
+        Assert.Equal(PipelineValueKind.Int32, number.Kind);
+        Assert.IsType<int>(number.Value);
+        Assert.Equal(PipelineValueKind.DirectoryEntry, entry.Kind);
+        Assert.Equal("مجلد/", entry.ToString());
+        Assert.Equal(PipelineValueKind.Object, other.Kind);
+        Assert.Equal(DayOfWeek.Friday, other.Value);
+    }
+
+    [Fact]
+    public void Default_IsEmptyNonError()
+    {
+        PipelineObject empty = default;
+
+        Assert.Equal(PipelineValueKind.None, empty.Kind);
+        Assert.Null(empty.Value);
+        Assert.False(empty.IsError);
+        Assert.Equal(string.Empty, empty.ToString());
+    }
+
+    [Fact]
+    public void NullConstructor_IsEmpty_AndValueTypeIsReportedWithoutValue()
+    {
+        var empty = new PipelineObject(null);
+        var error = new PipelineObject(null, isError: true);
+
+        Assert.Equal(PipelineValueKind.None, empty.Kind);
+        Assert.Null(empty.GetValueType());
+        Assert.True(error.IsError);
+        Assert.Equal(typeof(long), new PipelineObject(3L).GetValueType());
+        Assert.Equal(typeof(string), new PipelineObject("نص").GetValueType());
+    }
+
+    [Fact]
+    public void ErrorFlag_IsCarriedByTypedConstructors()
+    {
+        var error = new PipelineObject("فشل", isError: true);
+
+        Assert.True(error.IsError);
+        Assert.Equal("فشل", error.ToString());
+    }
+}
@@ -0,0 +1,77 @@
+using ArbSh.Terminal.Models;
+
+namespace ArbSh.Test;
+
+public sealed class ScrollbackBufferTests
+{
+    [Fact]
+    public void Append_BelowCapacity_KeepsLogicalOrder()
+    {
+        var buffer = new ScrollbackBuffer(capacity: 4);
+
+        Assert.False(buffer.Append(Line("a")));
+        Assert.False(buffer.Append(Line("b")));
+        Assert.False(buffer.Append(Line("c")));
+
+        Assert.Equal(3, buffer.Count);
+        Assert.Equal(4, buffer.Capacity);
+        Assert.Equal(new[] { "a", "b", "c" }, buffer.Select(l => l.Text).ToArray());
+        Assert.Equal("c", buffer[2].Text);
+        Assert.Equal(0, buffer.TotalEvicted);
+    }
+
+    [Fact]
+    public void Append_WhenFull_EvictsOldestLine()
+    {
+        var buffer = new ScrollbackBuffer(capacity: 3);
+
+        foreach (string text in new[] { "0", "1", "2", "3", "4" })
+        {
+            buffer.Append(Line(text));
+        }
+
+        Assert.Equal(3, buffer.Count);
+        Assert.Equal("2", buffer[0].Text);
+        Assert.Equal("4", buffer[2].Text);
+        Assert.Equal(new[] { "2", "3", "4" }, buffer.Select(l => l.Text).ToArray());
+        Assert.Equal(5, buffer.TotalAppended);
+        Assert.Equal(2, buffer.TotalEvicted);
+        Assert.Throws<ArgumentOutOfRangeException>(() => buffer[3]);
+    }
+
+    [Fact]
+    public void Append_KeepsLineInstancesForIdentityCaches()
+    {
+        var buffer = new ScrollbackBuffer(capacity: 2);
+        TerminalLine line = Line("مرحبا");
+
+        buffer.Append(line);
+        buffer.Append(Line("x"));
+
+        Assert.Same(line, buffer[0]);
+    }
+
+    [Fact]
+    public void Clear_CountsRemovedLinesAsEvicted()
+    {
+        var buffer = new ScrollbackBuffer(capacity: 3);
+        buffer.Append(Line("a"));
+        buffer.Append(Line("b"));
+
+        buffer.Clear();
+        buffer.Append(Line("c"));
+
+        Assert.Single(buffer);
+        Assert.Equal("c", buffer[0].Text);
+        Assert.Equal(3, buffer.TotalAppended);
+        Assert.Equal(2, buffer.TotalEvicted);
+    }
+
+    [Fact]
+    public void Constructor_RejectsNonPositiveCapacity()
+    {
+        Assert.Throws<ArgumentOutOfRangeException>(() => new ScrollbackBuffer(0));
+    }
+
+    private static TerminalLine Line(string text) => new(text, TerminalLineKind.Output, DateTimeOffset.UtcNow);
+}
@@ -0,0 +1,110 @@
+using ArbSh.Terminal.Models;
+
+namespace ArbSh.Test;
+
+public sealed class ScrollbackSearchTests
+{
+    private static readonly TimeSpan SearchTimeout = TimeSpan.FromSeconds(10);
+
+    [Fact]
+    public void IndexOf_IgnoresDiacriticsAndTatweelInText()
+    {
+        int start = SearchTextFolding.IndexOf("قال: مَرْحَـــبًا بكم", SearchTextFolding.Fold("مرحبا"), out int length);
+
+        Assert.Equal(5, start);
+        Assert.Equal("مَرْحَـــبًا", "قال: مَرْحَـــبًا بكم".Substring(start, length));
+    }
+
+    [Fact]
+    public void IndexOf_IgnoresDiacriticsInQueryAndLatinCase()
+    {
+        Assert.Equal(0, SearchTextFolding.IndexOf("كتاب جديد", SearchTextFolding.Fold("كِتَاب"), out _));
+        Assert.Equal(4, SearchTextFolding.IndexOf("run Get-Help", SearchTextFolding.Fold("get-help"), out int length));
+        Assert.Equal(8, length);
+        Assert.Equal(-1, SearchTextFolding.IndexOf("كتاب", SearchTextFolding.Fold("ــ"), out _));
+    }
+
+    [Fact]
+    public void Start_FindsMatchesAcrossBatchesInLineOrder()
+    {
+        var buffer = new ScrollbackBuffer(capacity: 100);
+        for (int i = 0; i < 40; i++)
+        {
+            buffer.Append(Line(i % 10 == 3 ? $"خطأ: الملف {i} غير موجود" : $"سطر {i}"));
+        }
+
+        using var search = new ScrollbackSearch(buffer, batchSize: 7);
+        search.Start("خطأ");
+        WaitForSearch(search);
+
+        Assert.Equal(4, search.MatchCount);
+        Assert.True(search.TryFindMatch(long.MaxValue, older: true, out ScrollbackMatch newest));
+        Assert.Equal(33, newest.LineNumber);
+        Assert.True(search.TryFindMatch(newest.LineNumber, older: true, out ScrollbackMatch previous));
+        Assert.Equal(23, previous.LineNumber);
+        Assert.True(search.TryFindMatch(previous.LineNumber, older: false, out ScrollbackMatch next));
+        Assert.Equal(33, next.LineNumber);
+        Assert.False(search.TryFindMatch(33, older: false, out _));
+        Assert.True(search.IsMatch(3));
+        Assert.False(search.IsMatch(4));
+    }
+
+    [Fact]
+    public void Start_MatchesPlainTextOfAnsiStyledLines()
+    {
+        var buffer = new ScrollbackBuffer();
+        buffer.Append(Line("\u001b[31mمرحبا\u001b[0m"));
+
+        using var search = new ScrollbackSearch(buffer);
+        search.Start("مرحبا");
+        WaitForSearch(search);
+
+        Assert.True(search.TryFindMatch(long.MaxValue, older: true, out ScrollbackMatch match));
+        Assert.Equal(new ScrollbackMatch(0, 0, 5), match);
+    }
+
+    [Fact]
+    public void Append_MatchesNewLinesAndDropsEvictedOnes()
+    {
+        var buffer = new ScrollbackBuffer(capacity: 3);
+        buffer.Append(Line("مُطابق 0"));
+        buffer.Append(Line("آخر"));
+
+        using var search = new ScrollbackSearch(buffer);
+        search.Start("مطابق");
+        WaitForSearch(search);
+        Assert.Equal(1, search.MatchCount);
+
+        buffer.Append(Line("آخر"));
+        buffer.Append(Line("مطابق 3"));
+        search.Append();
+        WaitForSearch(search);
+
+        Assert.Equal(1, search.MatchCount);
+        Assert.False(search.IsMatch(0));
+        Assert.True(search.IsMatch(3));
+    }
+
+    [Fact]
+    public void Stop_ClearsMatchesAndQuery()
+    {
+        var buffer = new ScrollbackBuffer();
+        buffer.Append(Line("أربش"));
+
+        var search = new ScrollbackSearch(buffer);
+        search.Start("أربش");
+        WaitForSearch(search);
+        search.Dispose();
+
+        Assert.Equal(0, search.MatchCount);
+        Assert.Equal(string.Empty, search.Query);
+        Assert.False(search.IsSearching);
+    }
+
+    private static void WaitForSearch(ScrollbackSearch search)
+    {
+        Assert.True(SpinWait.SpinUntil(() => !search.IsSearching, SearchTimeout));
+    }
+
+    private static TerminalLine Line(string text) => new(text, TerminalLineKind.Output, DateTimeOffset.UtcNow);
+}
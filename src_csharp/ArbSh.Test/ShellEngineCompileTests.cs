@@ -0,0 +1,175 @@
+using ArbSh.Core;
+
+namespace ArbSh.Test;
+
+public sealed class ShellEngineCompileTests
+{
+    [Fact]
+    public void Execute_CompiledScript_RunsRepeatedlyWithSameOutput()
+    {
+        CompiledScript script = ShellEngine.Compile("اطبع أ | اطبع\nاطبع ب ; اطبع ج");
+        var first = new CaptureSink();
+        var second = new CaptureSink();
+
+        ShellEngine.Execute(script, first);
+        ShellEngine.Execute(script, second);
+
+        Assert.Equal(2, script.LineCount);
+        Assert.Equal(0, script.DeferredLineCount);
+        Assert.Equal(["أ", "ب", "ج"], first.Outputs);
+        Assert.Equal(first.Outputs, second.Outputs);
+    }
+
+    [Fact]
+    public void Compile_SkipsBlankAndCommentLines()
+    {
+        CompiledScript script = ShellEngine.Compile("# تعليق\r\n\r\nاطبع مرحبا # بعد\r\n");
+        var sink = new CaptureSink();
+
+        ShellEngine.Execute(script, sink);
+
+        Assert.Equal(["مرحبا"], sink.Outputs);
+    }
+
+    [Fact]
+    public void Compile_LineWithVariable_IsDeferredAndExpandedAtRunTime()
+    {
+        CompiledScript script = ShellEngine.Compile("اطبع $testVar\nاطبع ثابت");
+        var sink = new CaptureSink();
+
+        ShellEngine.Execute(script, sink);
+
+        Assert.Equal(1, script.DeferredLineCount);
+        Assert.Equal(["Value from $testVar!", "ثابت"], sink.Outputs);
+    }
+
+    [Fact]
+    public void ExecuteInput_CachedLineWithVariable_ExpandsPerSession()
+    {
+        var first = new ShellSessionState();
+        var second = new ShellSessionState();
+        first.SetVariable("اسم", "أولى");
+        second.SetVariable("اسم", "ثانية");
+        var sink = new CaptureSink();
+
+        ShellEngine.ExecuteInput("اطبع $اسم", sink, session: first);
+        ShellEngine.ExecuteInput("اطبع $اسم", sink, session: second);
+        ShellEngine.ExecuteInput("اطبع $testVar", sink, session: second);
+
+        Assert.Equal(["أولى", "ثانية", "Value from $testVar!"], sink.Outputs);
+    }
+
+    [Fact]
+    public void ExecuteInput_ConcurrentSessions_KeepTheirOwnVariables()
+    {
+        const int sessionCount = 16;
+        const int runsPerSession = 20;
+        var sinks = new CaptureSink[sessionCount];
+
+        Parallel.For(0, sessionCount, new ParallelOptions { MaxDegreeOfParallelism = sessionCount }, i =>
+        {
+            var session = new ShellSessionState();
+            session.SetVariable("رقم", i.ToString());
+            sinks[i] = new CaptureSink();
+            for (int run = 0; run < runsPerSession; run++)
+            {
+                ShellEngine.ExecuteInput("اطبع $رقم | اطبع", sinks[i], session: session);
+            }
+        });
+
+        for (int i = 0; i < sessionCount; i++)
+        {
+            Assert.Equal(Enumerable.Repeat(i.ToString(), runsPerSession), sinks[i].Outputs);
+        }
+    }
+
+    [Fact]
+    public void ExecuteInput_RepeatedLine_MatchesCompiledExecution()
+    {
+        const string input = "اطبع $(اطبع داخلي) خارجي";
+        var interactive = new CaptureSink();
+        var compiled = new CaptureSink();
+
+        ShellEngine.ExecuteInput(input, interactive);
+        ShellEngine.ExecuteInput(input, interactive);
+        ShellEngine.Execute(ShellEngine.Compile(input), compiled);
+
+        Assert.Equal(compiled.Outputs.Concat(compiled.Outputs), interactive.Outputs);
+    }
+
+    [Fact]
+    public void Execute_UnknownCommand_IsStillReported()
+    {
+        CompiledScript script = ShellEngine.Compile("أمر-غير-موجود");
+        var sink = new CaptureSink();
+
+        ShellEngine.Execute(script, sink);
+
+        Assert.Contains(sink.Outputs, line => line.Contains("الأمر غير موجود", StringComparison.Ordinal));
+    }
+
+    [Fact]
+    public void ExecuteInput_RepeatedInvalidLine_ReportsParseErrorEachTime()
+    {
+        var first = new CaptureSink();
+        var second = new CaptureSink();
+
+        ShellEngine.ExecuteInput("-النص مرحبا", first);
+        ShellEngine.ExecuteInput("-النص مرحبا", second);
+
+        Assert.Contains(first.Errors, line => line.Contains("Expected command name", StringComparison.Ordinal));
+        Assert.Equal(first.Errors, second.Errors);
+    }
+
+    [Fact]
+    public void CompileFile_ReadsScriptFromDisk()
+    {
+        string path = Path.Combine(Path.GetTempPath(), $"arbsh-script-{Guid.NewGuid():N}.arbsh");
+        File.WriteAllText(path, "اطبع من-ملف\n");
+        var sink = new CaptureSink();
+
+        try
+        {
+            ShellEngine.Execute(ShellEngine.CompileFile(path), sink);
+
+            Assert.Equal(["من-ملف"], sink.Outputs);
+        }
+        finally
+        {
+            File.Delete(path);
+        }
+    }
+
+    private sealed class CaptureSink : IExecutionSink
+    {
+        private readonly object _gate = new();
+
+        public List<string> Outputs { get; } = [];
+
+        public List<string> Errors { get; } = [];
+
+        public void WriteOutput(string message)
+        {
+            lock (_gate)
+            {
+                Outputs.Add(message);
+            }
+        }
+
+        public void WriteError(string message)
+        {
+            lock (_gate)
+            {
+                Errors.Add(message);
+            }
+        }
+
+        public void WriteWarning(string message)
+        {
+        }
+
+        public void WriteDebug(string message)
+        {
+        }
+    }
+}
@@ -83,4 +83,89 @@ public sealed class TerminalInputBufferTests
         Assert.Equal(0, selection.Start);
         Assert.Equal(5, selection.End);
     }
+
+    [Fact]
+    public void EditsAtDifferentPositions_KeepTextConsistent()
+    {
+        var buffer = new TerminalInputBuffer();
+        buffer.InsertText("اطبع");
+        buffer.MoveCaretHome(false);
+        buffer.InsertText("<");
+        buffer.MoveCaretEnd(false);
+        buffer.InsertText(" مرحبا");
+        buffer.SetCaretFromLogicalIndex(1);
+        buffer.DeleteForward();
+        buffer.SetCaretFromLogicalIndex(3);
+        buffer.Backspace();
+
+        Assert.Equal("<طع مرحبا", buffer.Text);
+        Assert.Equal(buffer.Text.Length, buffer.Length);
+        Assert.Equal(2, buffer.CaretIndex);
+    }
+
+    [Fact]
+    public void InsertText_LargePaste_GrowsBufferAndKeepsSurroundingText()
+    {
+        var buffer = new TerminalInputBuffer();
+        buffer.InsertText("ab");
+        buffer.SetCaretFromLogicalIndex(1);
+        string paste = new('ج', 5000);
+
+        buffer.InsertText(paste);
+
+        Assert.Equal("a" + paste + "b", buffer.Text);
+        Assert.Equal(5001, buffer.CaretIndex);
+    }
+
+    [Fact]
+    public void Clear_AfterEdits_ResetsToEmpty()
+    {
+        var buffer = new TerminalInputBuffer();
+        buffer.InsertText("hello");
+        buffer.SetCaretFromLogicalIndex(2);
+
+        buffer.Clear();
+        buffer.InsertText("x");
+
+        Assert.Equal("x", buffer.Text);
+        Assert.Equal(1, buffer.Length);
+    }
+
+    [Fact]
+    public void TextElementNavigation_AfterRandomEdits_MatchesFullSegmentation()
+    {
+        string[] pieces = ["a", "ب", "\u0651", "\u064E", "e\u0301", "👍🏽", "\u200D", "🇸🇦", " ", "لا"];
+        var random = new Random(7);
+        var buffer = new TerminalInputBuffer();
+
+        for (int step = 0; step < 2000; step++)
+        {
+            buffer.SetCaretFromLogicalIndex(random.Next(buffer.Length + 1));
+            switch (random.Next(4))
+            {
+                case 0:
+                case 1:
+                    buffer.InsertText(pieces[random.Next(pieces.Length)]);
+                    break;
+                case 2:
+                    buffer.Backspace();
+                    break;
+                default:
+                    buffer.DeleteForward();
+                    break;
+            }
+
+            string text = buffer.Text;
+            int[] starts = System.Globalization.StringInfo.ParseCombiningCharacters(text);
+            int caret = random.Next(text.Length + 1);
+
+            buffer.SetCaretFromLogicalIndex(caret);
+            buffer.MoveCaretLeft(false);
+            Assert.Equal(caret == 0 ? 0 : starts.Last(start => start < caret), buffer.CaretIndex);
+
+            buffer.SetCaretFromLogicalIndex(caret);
+            buffer.MoveCaretRight(false);
+            Assert.Equal(starts.Where(start => start > caret).DefaultIfEmpty(text.Length).First(), buffer.CaretIndex);
+        }
+    }
 }
@@ -160,10 +160,271 @@ public sealed class TerminalLayoutEngineTests
         Assert.Equal(0, frame.FirstVisibleOutputLineIndex);
     }
 
+    [Fact]
+    public void BuildFrameLayout_RepeatedFrames_ReuseRunsForSameLines()
+    {
+        var config = new TerminalRenderConfig { Padding = new Thickness(10), LineHeight = 20 };
+        var lines = new List<TerminalLine>
+        {
+            new("abc", TerminalLineKind.Output, DateTimeOffset.UtcNow),
+            new("مرحبا", TerminalLineKind.Output, DateTimeOffset.UtcNow)
+        };
+        var engine = new TerminalLayoutEngine();
+        var pipeline = new TerminalTextPipeline(new FakeTextMeasurer());
+
+        TerminalFrameLayout first = engine.BuildFrameLayout(lines, "أربش< ", string.Empty, new Size(200, 120), config, pipeline, 0);
+        TerminalFrameLayout second = engine.BuildFrameLayout(lines, "أربش< ", "x", new Size(200, 120), config, pipeline, 0);
+
+        Assert.Same(first.Instructions[0].Run, second.Instructions[0].Run);
+        Assert.Same(first.Instructions[1].Run, second.Instructions[1].Run);
+        Assert.Equal(2, engine.CachedRunCount);
+    }
+
+    [Fact]
+    public void BuildFrameLayout_NewConfig_RebuildsRuns()
+    {
+        var lines = new List<TerminalLine> { new("abc", TerminalLineKind.Output, DateTimeOffset.UtcNow) };
+        var engine = new TerminalLayoutEngine();
+        var pipeline = new TerminalTextPipeline(new FakeTextMeasurer());
+
+        TerminalFrameLayout first = engine.BuildFrameLayout(lines, "> ", string.Empty, new Size(200, 120), new TerminalRenderConfig(), pipeline, 0);
+        TerminalFrameLayout second = engine.BuildFrameLayout(lines, "> ", string.Empty, new Size(200, 120), new TerminalRenderConfig { FontSize = 20 }, pipeline, 0);
+
+        Assert.NotSame(first.Instructions[0].Run, second.Instructions[0].Run);
+    }
+
+    [Fact]
+    public void BuildFrameLayout_CacheCapacity_EvictsLeastRecentlyUsedLines()
+    {
+        var config = new TerminalRenderConfig { Padding = new Thickness(10), LineHeight = 20 };
+        var lines = Enumerable.Range(0, 10)
+            .Select(i => new TerminalLine($"line-{i}", TerminalLineKind.Output, DateTimeOffset.UtcNow))
+            .ToList();
+        var engine = new TerminalLayoutEngine(runCacheCapacity: 4);
+        var pipeline = new TerminalTextPipeline(new FakeTextMeasurer());
+
+        TerminalFrameLayout bottom = engine.BuildFrameLayout(lines, "> ", string.Empty, new Size(220, 130), config, pipeline, 0);
+        engine.BuildFrameLayout(lines, "> ", string.Empty, new Size(220, 130), config, pipeline, 6);
+        TerminalFrameLayout again = engine.BuildFrameLayout(lines, "> ", string.Empty, new Size(220, 130), config, pipeline, 0);
+
+        Assert.Equal(4, engine.CachedRunCount);
+        Assert.Equal(bottom.Instructions[0].Run.LogicalText, again.Instructions[0].Run.LogicalText);
+        Assert.NotSame(bottom.Instructions[0].Run, again.Instructions[0].Run);
+    }
+
+    [Fact]
+    public void BuildFrameLayout_WrapsLongLinesIntoRows()
+    {
+        var config = new TerminalRenderConfig { Padding = new Thickness(10), LineHeight = 20 };
+        var lines = new List<TerminalLine>
+        {
+            new("short", TerminalLineKind.Output, DateTimeOffset.UtcNow),
+            new(new string('x', 100), TerminalLineKind.Output, DateTimeOffset.UtcNow)
+        };
+        var engine = new TerminalLayoutEngine();
+        var pipeline = new TerminalTextPipeline(new FakeTextMeasurer());
+
+        TerminalFrameLayout frame = engine.BuildFrameLayout(lines, "> ", string.Empty, new Size(60, 300), config, pipeline, 0);
+
+        List<TerminalDrawInstruction> outputs = [.. frame.Instructions.Where(x => !x.IsPromptLine)];
+        Assert.Equal([0, 1, 1, 1], outputs.Select(x => x.LogicalLineIndex));
+        Assert.Equal([5, 40, 40, 20], outputs.Select(x => (int)x.Run.MeasuredWidth));
+        Assert.Equal(4, frame.VisibleOutputLineCount);
+    }
+
+    [Fact]
+    public void BuildFrameLayout_WrapDisabled_KeepsOneRowPerLine()
+    {
+        var config = new TerminalRenderConfig { Padding = new Thickness(10), LineHeight = 20, WrapLines = false };
+        var lines = new List<TerminalLine> { new(new string('x', 100), TerminalLineKind.Output, DateTimeOffset.UtcNow) };
+        var engine = new TerminalLayoutEngine();
+        var pipeline = new TerminalTextPipeline(new FakeTextMeasurer());
+
+        TerminalFrameLayout frame = engine.BuildFrameLayout(lines, "> ", string.Empty, new Size(60, 300), config, pipeline, 0);
+
+        Assert.Single(frame.Instructions.Where(x => !x.IsPromptLine));
+    }
+
+    [Fact]
+    public void BuildFrameLayout_ScrollbackOffsetCountsWrappedRows()
+    {
+        var config = new TerminalRenderConfig { Padding = new Thickness(10), LineHeight = 20 };
+        var lines = new List<TerminalLine>
+        {
+            new("line-0", TerminalLineKind.Output, DateTimeOffset.UtcNow),
+            new(new string('x', 100), TerminalLineKind.Output, DateTimeOffset.UtcNow),
+            new("line-2", TerminalLineKind.Output, DateTimeOffset.UtcNow)
+        };
+        var engine = new TerminalLayoutEngine();
+        var pipeline = new TerminalTextPipeline(new FakeTextMeasurer());
+
+        // 130 px fits four rows; the five rows leave one to scroll back.
+        TerminalFrameLayout bottom = engine.BuildFrameLayout(lines, "> ", string.Empty, new Size(60, 130), config, pipeline, 0);
+        TerminalFrameLayout top = engine.BuildFrameLayout(lines, "> ", string.Empty, new Size(60, 130), config, pipeline, 99);
+
+        Assert.Equal(1, bottom.MaxScrollbackOffsetLines);
+        Assert.Equal(1, bottom.FirstVisibleOutputLineIndex);
+        Assert.Equal("line-2", bottom.Instructions[3].Run.LogicalText);
+        Assert.Equal(1, top.ScrollbackOffsetLines);
+        Assert.Equal(0, top.FirstVisibleOutputLineIndex);
+        Assert.Equal([0, 1, 1, 1], top.Instructions.Where(x => !x.IsPromptLine).Select(x => x.LogicalLineIndex));
+    }
+
+    [Fact]
+    public void BuildFrameLayout_Resize_ReflowsWrappedRows()
+    {
+        var config = new TerminalRenderConfig { Padding = new Thickness(10), LineHeight = 20 };
+        var lines = new List<TerminalLine> { new(new string('x', 100), TerminalLineKind.Output, DateTimeOffset.UtcNow) };
+        var engine = new TerminalLayoutEngine();
+        var pipeline = new TerminalTextPipeline(new FakeTextMeasurer());
+
+        TerminalFrameLayout narrow = engine.BuildFrameLayout(lines, "> ", string.Empty, new Size(60, 300), config, pipeline, 0);
+        TerminalFrameLayout wide = engine.BuildFrameLayout(lines, "> ", string.Empty, new Size(70, 300), config, pipeline, 0);
+
+        Assert.Equal(3, narrow.VisibleOutputLineCount);
+        Assert.Equal(2, wide.VisibleOutputLineCount);
+    }
+
+    [Fact]
+    public void BuildFrameLayout_Resize_RewrapsOnlyLinesWiderThanRow()
+    {
+        var config = new TerminalRenderConfig { Padding = new Thickness(10), LineHeight = 20 };
+        string longLine = new('x', 100);
+        var lines = Enumerable.Range(0, 20)
+            .Select(i => new TerminalLine($"line-{i}", TerminalLineKind.Output, DateTimeOffset.UtcNow))
+            .Append(new TerminalLine(longLine, TerminalLineKind.Output, DateTimeOffset.UtcNow))
+            .ToList();
+        var engine = new TerminalLayoutEngine();
+        var measurer = new FakeTextMeasurer();
+        var pipeline = new TerminalTextPipeline(measurer);
+
+        TerminalFrameLayout narrow = engine.BuildFrameLayout(lines, "> ", string.Empty, new Size(60, 600), config, pipeline, 0);
+        measurer.Measured.Clear();
+        TerminalFrameLayout wide = engine.BuildFrameLayout(lines, "> ", string.Empty, new Size(70, 600), config, pipeline, 0);
+
+        // Only the long line is split again into rows; the lines that fit both widths are not measured.
+        Assert.NotEmpty(measurer.Measured);
+        Assert.All(measurer.Measured, text => Assert.True(text.Length > 0 && text.All(c => c == 'x')));
+        Assert.Same(narrow.Instructions[0].Run, wide.Instructions[0].Run);
+        Assert.Equal(23, narrow.VisibleOutputLineCount);
+        Assert.Equal(22, wide.VisibleOutputLineCount);
+    }
+
+    [Fact]
+    public void BuildFrameLayout_Resize_WrapsOnlyLinesNearTheView()
+    {
+        var config = new TerminalRenderConfig { Padding = new Thickness(10), LineHeight = 20 };
+        var lines = Enumerable.Range(0, 2_000)
+            .Select(i => new TerminalLine(new string('x', 100), TerminalLineKind.Output, DateTimeOffset.UtcNow))
+            .ToList();
+        var engine = new TerminalLayoutEngine();
+        var measurer = new FakeTextMeasurer();
+        var pipeline = new TerminalTextPipeline(measurer);
+
+        engine.BuildFrameLayout(lines, "> ", string.Empty, new Size(60, 130), config, pipeline, 0);
+        measurer.Measured.Clear();
+        TerminalFrameLayout wide = engine.BuildFrameLayout(lines, "> ", string.Empty, new Size(70, 130), config, pipeline, 0);
+        int measuredAfterResize = measurer.Measured.Count;
+        TerminalFrameLayout top = engine.BuildFrameLayout(lines, "> ", string.Empty, new Size(70, 130), config, pipeline, int.MaxValue);
+
+        // Rows of the 2,000 lines come from their stored widths; only the rows around the view are wrapped.
+        Assert.InRange(measuredAfterResize, 1, 200);
+        Assert.Equal(4, wide.VisibleOutputLineCount);
+        Assert.Equal(3_996, wide.MaxScrollbackOffsetLines);
+        Assert.Equal(0, top.FirstVisibleOutputLineIndex);
+        Assert.Equal([0, 0, 1, 1], top.Instructions.Where(x => !x.IsPromptLine).Select(x => x.LogicalLineIndex));
+    }
+
+    [Fact]
+    public void BuildFrameLayout_ScrollbackEviction_KeepsWrapIndexInStep()
+    {
+        var config = new TerminalRenderConfig { Padding = new Thickness(10), LineHeight = 20 };
+        var buffer = new ScrollbackBuffer(capacity: 3);
+        var engine = new TerminalLayoutEngine();
+        var pipeline = new TerminalTextPipeline(new FakeTextMeasurer());
+
+        buffer.Append(new TerminalLine(new string('x', 100), TerminalLineKind.Output, DateTimeOffset.UtcNow));
+        buffer.Append(new TerminalLine("b", TerminalLineKind.Output, DateTimeOffset.UtcNow));
+        engine.BuildFrameLayout(buffer, "> ", string.Empty, new Size(60, 300), config, pipeline, 0);
+
+        buffer.Append(new TerminalLine("c", TerminalLineKind.Output, DateTimeOffset.UtcNow));
+        buffer.Append(new TerminalLine(new string('y', 50), TerminalLineKind.Output, DateTimeOffset.UtcNow));
+        TerminalFrameLayout frame = engine.BuildFrameLayout(buffer, "> ", string.Empty, new Size(60, 300), config, pipeline, 0);
+
+        Assert.Equal(["b", "c", new string('y', 40), "yyyyyyyyyy"], frame.Instructions.Where(x => !x.IsPromptLine).Select(x => x.Run.VisualText));
+        Assert.Equal(2, engine.CountTrailingRows(buffer, 1, new Size(60, 300), config, pipeline));
+        Assert.Equal(4, engine.CountTrailingRows(buffer, 99, new Size(60, 300), config, pipeline));
+    }
+
+    [Fact]
+    public void ComputeDamage_FirstFrameOrResize_IsFullRepaint()
+    {
+        var config = new TerminalRenderConfig { Padding = new Thickness(10), LineHeight = 20 };
+        var lines = new List<TerminalLine> { new("abc", TerminalLineKind.Output, DateTimeOffset.UtcNow) };
+        var engine = new TerminalLayoutEngine();
+        var pipeline = new TerminalTextPipeline(new FakeTextMeasurer());
+
+        TerminalFrameLayout small = engine.BuildFrameLayout(lines, "> ", string.Empty, new Size(220, 130), config, pipeline, 0);
+        TerminalFrameLayout tall = engine.BuildFrameLayout(lines, "> ", string.Empty, new Size(220, 330), config, pipeline, 0);
+
+        Assert.True(TerminalLayoutEngine.ComputeDamage(null, small).IsFullRepaint);
+        Assert.True(TerminalLayoutEngine.ComputeDamage(small, tall).IsFullRepaint);
+    }
+
+    [Fact]
+    public void ComputeDamage_PromptEdit_LeavesOutputRowsClean()
+    {
+        var config = new TerminalRenderConfig { Padding = new Thickness(10), LineHeight = 20 };
+        var lines = new List<TerminalLine>
+        {
+            new("abc", TerminalLineKind.Output, DateTimeOffset.UtcNow),
+            new("مرحبا", TerminalLineKind.Output, DateTimeOffset.UtcNow)
+        };
+        var engine = new TerminalLayoutEngine();
+        var pipeline = new TerminalTextPipeline(new FakeTextMeasurer());
+
+        TerminalFrameLayout first = engine.BuildFrameLayout(lines, "> ", string.Empty, new Size(200, 120), config, pipeline, 0);
+        TerminalFrameLayout same = engine.BuildFrameLayout(lines, "> ", string.Empty, new Size(200, 120), config, pipeline, 0);
+        TerminalFrameLayout typed = engine.BuildFrameLayout(lines, "> ", "x", new Size(200, 120), config, pipeline, 0);
+
+        TerminalFrameDamage unchanged = TerminalLayoutEngine.ComputeDamage(first, same);
+        TerminalFrameDamage edited = TerminalLayoutEngine.ComputeDamage(same, typed);
+
+        Assert.Empty(unchanged.ChangedOutputRows);
+        Assert.False(unchanged.PromptChanged);
+        Assert.Empty(edited.ChangedOutputRows);
+        Assert.True(edited.PromptChanged);
+    }
+
+    [Fact]
+    public void ComputeDamage_NewLineOnFullScreen_ScrollsAndRedrawsOnlyExposedRow()
+    {
+        var config = new TerminalRenderConfig { Padding = new Thickness(10), LineHeight = 20 };
+        var lines = Enumerable.Range(0, 10)
+            .Select(i => new TerminalLine($"line-{i}", TerminalLineKind.Output, DateTimeOffset.UtcNow))
+            .ToList();
+        var engine = new TerminalLayoutEngine();
+        var pipeline = new TerminalTextPipeline(new FakeTextMeasurer());
+
+        TerminalFrameLayout before = engine.BuildFrameLayout(lines, "> ", string.Empty, new Size(220, 130), config, pipeline, 0);
+        lines.Add(new TerminalLine("line-10", TerminalLineKind.Output, DateTimeOffset.UtcNow));
+        TerminalFrameLayout after = engine.BuildFrameLayout(lines, "> ", string.Empty, new Size(220, 130), config, pipeline, 0);
+
+        TerminalFrameDamage damage = TerminalLayoutEngine.ComputeDamage(before, after);
+
+        Assert.False(damage.IsFullRepaint);
+        Assert.Equal(1, damage.ScrolledRows);
+        Assert.Equal(new[] { after.VisibleOutputLineCount - 1 }, damage.ChangedOutputRows);
+        Assert.False(damage.PromptChanged);
+    }
+
     private sealed class FakeTextMeasurer : ITextMeasurer
     {
+        public List<string> Measured { get; } = [];
+
         public double MeasureWidth(string visualText, TerminalRenderConfig config)
         {
+            Measured.Add(visualText);
             return visualText.Length;
         }
     }
@@ -60,11 +60,118 @@ public sealed class TerminalTextPipelineTests
         Assert.Equal("ERROR".Length, run.MeasuredWidth);
     }
 
+    [Fact]
+    public void WrapVisualRun_FittingLine_ReturnsSameRun()
+    {
+        var pipeline = new TerminalTextPipeline(new FakeTextMeasurer());
+        VisualTextRun run = pipeline.BuildVisualRun("dotnet", TerminalLineKind.Output, RenderConfig);
+
+        VisualTextRun row = Assert.Single(pipeline.WrapVisualRun(run, 10, RenderConfig));
+
+        Assert.Same(run, row);
+    }
+
+    [Fact]
+    public void WrapVisualRun_LongLine_BreaksAfterWhitespace()
+    {
+        var pipeline = new TerminalTextPipeline(new FakeTextMeasurer());
+        VisualTextRun run = pipeline.BuildVisualRun("alpha beta gamma", TerminalLineKind.Output, RenderConfig);
+
+        IReadOnlyList<VisualTextRun> rows = pipeline.WrapVisualRun(run, 12, RenderConfig);
+
+        Assert.Equal(["alpha beta ", "gamma"], rows.Select(x => x.VisualText));
+    }
+
+    [Fact]
+    public void WrapVisualRun_LongWord_BreaksAtGraphemeBoundaries()
+    {
+        var pipeline = new TerminalTextPipeline(new FakeTextMeasurer());
+        string text = string.Concat(Enumerable.Repeat("e\u0301", 5));
+        VisualTextRun run = pipeline.BuildVisualRun(text, TerminalLineKind.Output, RenderConfig);
+
+        IReadOnlyList<VisualTextRun> rows = pipeline.WrapVisualRun(run, 3, RenderConfig);
+
+        Assert.Equal(5, rows.Count);
+        Assert.All(rows, row => Assert.Equal("e\u0301", row.VisualText));
+    }
+
+    [Fact]
+    public void WrapVisualRun_RtlLine_RowsKeepLineDirection()
+    {
+        var pipeline = new TerminalTextPipeline(new FakeTextMeasurer());
+        VisualTextRun run = pipeline.BuildVisualRun("مرحبا hello world", TerminalLineKind.Output, RenderConfig);
+
+        IReadOnlyList<VisualTextRun> rows = pipeline.WrapVisualRun(run, 6, RenderConfig);
+
+        Assert.Equal(["مرحبا ", "hello ", "world"], rows.Select(x => x.VisualText));
+        Assert.All(rows, row => Assert.True(row.IsRightToLeft));
+        Assert.All(rows, row => Assert.True(row.HasArabic));
+    }
+
+    [Fact]
+    public void WrapVisualRun_SlicesAnsiSpansPerRow()
+    {
+        var pipeline = new TerminalTextPipeline(new FakeTextMeasurer());
+        VisualTextRun run = pipeline.BuildVisualRun("ab\u001b[31mcdef\u001b[0m", TerminalLineKind.Output, RenderConfig);
+
+        IReadOnlyList<VisualTextRun> rows = pipeline.WrapVisualRun(run, 3, RenderConfig);
+
+        Assert.Equal(["abc", "def"], rows.Select(x => x.VisualText));
+        AnsiStyleSpan red = Assert.Single(rows[1].StyleSpans);
+        Assert.Equal(0, red.Start);
+        Assert.Equal(3, red.Length);
+        Assert.Equal(AnsiColorMode.Indexed16, red.Style.Foreground.Mode);
+    }
+
     private sealed class FakeTextMeasurer : ITextMeasurer
     {
+        public List<string> Measured { get; } = [];
+
         public double MeasureWidth(string visualText, TerminalRenderConfig config)
         {
+            Measured.Add(visualText);
             return visualText.Length;
         }
     }
+
+    [Fact]
+    public void BuildPromptRun_UnchangedPromptAndInput_ReusesRun()
+    {
+        var pipeline = new TerminalTextPipeline(new FakeTextMeasurer());
+
+        VisualTextRun first = pipeline.BuildPromptRun("أربش< ", "اطبع", RenderConfig);
+        VisualTextRun second = pipeline.BuildPromptRun("أربش< ", "اطبع", RenderConfig);
+        VisualTextRun edited = pipeline.BuildPromptRun("أربش< ", "اطبع مرحبا", RenderConfig);
+
+        Assert.Same(first, second);
+        Assert.NotSame(first, edited);
+        Assert.Equal("أربش< اطبع مرحبا", edited.LogicalText);
+    }
+
+    [Fact]
+    public void BuildPromptRun_InputEdit_MeasuresOnlyInput()
+    {
+        var measurer = new FakeTextMeasurer();
+        var pipeline = new TerminalTextPipeline(measurer);
+
+        pipeline.BuildPromptRun("أربش< ", "اطب", RenderConfig);
+        measurer.Measured.Clear();
+        VisualTextRun edited = pipeline.BuildPromptRun("أربش< ", "اطبع abc", RenderConfig);
+
+        Assert.Equal(["اطبع abc"], measurer.Measured);
+        Assert.Equal("أربش< اطبع abc".Length, edited.MeasuredWidth);
+        Assert.True(edited.HasArabic);
+        Assert.True(edited.IsRightToLeft);
+    }
+
+    [Fact]
+    public void BuildPromptRun_DirectionFollowsFirstStrongCharacter()
+    {
+        var pipeline = new TerminalTextPipeline(new FakeTextMeasurer());
+
+        Assert.False(pipeline.BuildPromptRun("> ", "dir مجلد", RenderConfig).IsRightToLeft);
+        Assert.True(pipeline.BuildPromptRun("> ", "12 مجلد", RenderConfig).IsRightToLeft);
+        Assert.True(pipeline.BuildPromptRun("أربش< ", "dir", RenderConfig).IsRightToLeft);
+        Assert.False(pipeline.BuildPromptRun("> ", "\u2067مجلد\u2069 dir", RenderConfig).IsRightToLeft);
+    }
 }
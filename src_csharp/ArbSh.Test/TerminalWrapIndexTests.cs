@@ -0,0 +1,88 @@
+using ArbSh.Terminal.Rendering;
+
+namespace ArbSh.Test;
+
+public sealed class TerminalWrapIndexTests
+{
+    [Fact]
+    public void FindLine_MapsRowsToTheirLines()
+    {
+        var index = new TerminalWrapIndex();
+        index.Append(10, 1);
+        index.Append(30, 3);
+        index.Append(20, 2);
+
+        Assert.Equal(6, index.TotalRows);
+        Assert.Equal([0, 1, 1, 1, 2, 2], Enumerable.Range(0, 6).Select(index.FindLine));
+        Assert.Equal(4, index.GetFirstRow(2));
+        Assert.Equal(3, index.GetRowCount(1));
+    }
+
+    [Fact]
+    public void RemoveFirst_ShiftsRowsOfRemainingLines()
+    {
+        var index = new TerminalWrapIndex();
+        index.Append(30, 3);
+        index.Append(10, 1);
+        index.Append(20, 2);
+
+        index.RemoveFirst(1);
+
+        Assert.Equal(2, index.LineCount);
+        Assert.Equal(3, index.TotalRows);
+        Assert.Equal(0, index.GetFirstRow(0));
+        Assert.Equal(1, index.FindLine(2));
+        Assert.Equal(20, index.GetMeasuredWidth(1));
+    }
+
+    [Fact]
+    public void RemoveFirst_ManyLines_CompactsWithoutLosingRows()
+    {
+        var index = new TerminalWrapIndex();
+        for (int i = 0; i < 10_000; i++)
+        {
+            index.Append(i, 1 + (i % 3));
+        }
+
+        index.RemoveFirst(9_000);
+        index.Append(1, 1);
+
+        Assert.Equal(1_001, index.LineCount);
+        Assert.Equal(9_000, index.GetMeasuredWidth(0));
+        Assert.Equal(1 + (9_000 % 3), index.GetRowCount(0));
+        Assert.Equal(1_000, index.FindLine(index.TotalRows - 1));
+    }
+
+    [Fact]
+    public void Reflow_RecountsRowsFromStoredWidths()
+    {
+        var index = new TerminalWrapIndex();
+        index.Append(10, 1);
+        index.Append(100, 3);
+
+        index.Reflow(50);
+
+        Assert.Equal(3, index.TotalRows);
+        Assert.Equal(2, index.GetRowCount(1));
+        Assert.False(index.IsEstimated(0));
+        Assert.True(index.IsEstimated(1));
+    }
+
+    [Fact]
+    public void SetRowCount_CorrectsEstimateAndShiftsLaterRows()
+    {
+        var index = new TerminalWrapIndex();
+        index.Append(100, 1);
+        index.Append(100, 1);
+        index.Append(10, 1);
+        index.Reflow(50);
+
+        index.SetRowCount(0, 3);
+
+        Assert.False(index.IsEstimated(0));
+        Assert.True(index.IsEstimated(1));
+        Assert.Equal(6, index.TotalRows);
+        Assert.Equal(3, index.GetFirstRow(1));
+        Assert.Equal(2, index.FindLine(5));
+    }
+}